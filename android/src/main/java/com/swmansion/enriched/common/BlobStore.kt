@@ -0,0 +1,34 @@
+package com.swmansion.enriched.common
+
+import java.nio.ByteBuffer
+
+/**
+ * Images the HTML normalizer moved out of pasted data: URIs (cpp/parser/BlobStore). Their `src` is
+ * a short `enriched-blob:` handle; spans read the bytes through [buffer] and exporters restore the
+ * data: URI with [exportSource].
+ */
+object BlobStore {
+  const val SCHEME = "enriched-blob:"
+
+  fun isHandle(src: String): Boolean = src.startsWith(SCHEME)
+
+  /** The decoded image behind [handle], shared with native code rather than copied. */
+  fun buffer(handle: String): ByteBuffer? = nativeBuffer(handle)?.asReadOnlyBuffer()
+
+  /** [src] as it should appear in exported HTML. */
+  @JvmStatic
+  fun exportSource(src: String): String = if (isHandle(src)) nativeDataUri(src) ?: src else src
+
+  /** [src] as a view should hold it: data: URIs the store accepts become handles, as on HTML load. */
+  @JvmStatic
+  fun importSource(src: String): String = if (src.startsWith("data:")) nativePut(src) ?: src else src
+
+  @JvmStatic
+  private external fun nativeBuffer(handle: String): ByteBuffer?
+
+  @JvmStatic
+  private external fun nativeDataUri(handle: String): String?
+
+  @JvmStatic
+  private external fun nativePut(dataUri: String): String?
+}
@@ -0,0 +1,31 @@
+package com.swmansion.enriched.common
+
+/**
+ * Binary draft format shared with iOS (cpp/document/DocumentSnapshot). [runs] holds flattened
+ * (start, length, type, value) quadruples: type is a cpp/document/StyleType.hpp index and value an
+ * index into [strings], or [NO_STRING] for runs without a payload.
+ */
+class DocumentSnapshot(
+  val text: String,
+  val runs: IntArray,
+  val strings: Array<String>,
+) {
+  fun serialize(): ByteArray = nativeSerialize(text, runs, strings)
+
+  companion object {
+    const val NO_STRING = -1
+
+    /** Returns null for unknown versions and malformed or truncated bytes. */
+    fun deserialize(bytes: ByteArray): DocumentSnapshot? = nativeDeserialize(bytes)
+
+    @JvmStatic
+    private external fun nativeSerialize(
+      text: String,
+      runs: IntArray,
+      strings: Array<String>,
+    ): ByteArray
+
+    @JvmStatic
+    private external fun nativeDeserialize(bytes: ByteArray): DocumentSnapshot?
+  }
+}
@@ -0,0 +1,32 @@
+package com.swmansion.enriched.common
+
+import com.facebook.react.bridge.ReactApplicationContext
+import com.facebook.react.bridge.ReactContextBaseJavaModule
+import com.facebook.react.bridge.ReactMethod
+import com.facebook.react.module.annotations.ReactModule
+
+/**
+ * Installs the JSI binding of the native HTML engine (cpp/jsi/EnrichedHtmlHostObject) into the JS
+ * runtime. `install` is blocking so it runs on the JS thread, where the runtime may be touched.
+ */
+@ReactModule(name = EnrichedHtmlModule.NAME)
+class EnrichedHtmlModule(
+  reactContext: ReactApplicationContext,
+) : ReactContextBaseJavaModule(reactContext) {
+  override fun getName(): String = NAME
+
+  @ReactMethod(isBlockingSynchronousMethod = true)
+  fun install(): Boolean {
+    val runtime = reactApplicationContext.javaScriptContextHolder?.get() ?: 0L
+    if (runtime == 0L) return false
+    nativeInstall(runtime)
+    return true
+  }
+
+  companion object {
+    const val NAME = "EnrichedHtml"
+
+    @JvmStatic
+    private external fun nativeInstall(runtime: Long)
+  }
+}
@@ -1,5 +1,21 @@
 package com.swmansion.enriched.common
 
 object GumboNormalizer {
+  /**
+   * Canonical form of [html] for a view to load. Base64 images of 1 KB or more move to the native
+   * BlobStore and come back as `enriched-blob:` handles, which only the image spans resolve.
+   */
   external fun normalizeHtml(html: String): String?
+
+  /**
+   * Hash of [normalized], output of [normalizeHtml]; equal for values that normalize to the same
+   * HTML, never 0. Views compare it to skip re-parsing an unchanged value.
+   */
+  external fun hashNormalized(normalized: String): Long
+
+  /** [normalizeHtml] off the main thread, for pastes too large to normalize inline. */
+  fun normalizeHtmlAsync(
+    html: String,
+    onResult: (String?) -> Unit,
+  ): NormalizationTask = NormalizationTask(html, onResult)
 }
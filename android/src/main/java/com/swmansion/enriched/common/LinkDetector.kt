@@ -0,0 +1,55 @@
+package com.swmansion.enriched.common
+
+/**
+ * Native link detector compiled from the default URL grammar or a user pattern
+ * (cpp/text/LinkDetector). Not thread safe; use it from the UI thread only.
+ */
+class LinkDetector private constructor(
+  private var handle: Long,
+) {
+  /** Returns flattened [start, end) pairs of links found in whitespace-separated words of `text`. */
+  fun detect(text: String): IntArray = nativeDetect(handle, text)
+
+  /** Frees the native side right away; the object can't be used afterwards. */
+  fun release() {
+    if (handle != 0L) {
+      nativeDestroy(handle)
+      handle = 0L
+    }
+  }
+
+  // Only for instances nobody released
+  protected fun finalize() {
+    release()
+  }
+
+  companion object {
+    val default: LinkDetector by lazy { LinkDetector(nativeCreate(null, false, false)) }
+
+    /** Returns null if the pattern uses syntax the native matcher doesn't support (e.g. lookarounds). */
+    fun compile(
+      pattern: String,
+      caseInsensitive: Boolean,
+      dotAll: Boolean,
+    ): LinkDetector? {
+      val handle = nativeCreate(pattern, caseInsensitive, dotAll)
+      return if (handle == 0L) null else LinkDetector(handle)
+    }
+
+    @JvmStatic
+    private external fun nativeCreate(
+      pattern: String?,
+      caseInsensitive: Boolean,
+      dotAll: Boolean,
+    ): Long
+
+    @JvmStatic
+    private external fun nativeDestroy(handle: Long)
+
+    @JvmStatic
+    private external fun nativeDetect(
+      handle: Long,
+      text: String,
+    ): IntArray
+  }
+}
@@ -0,0 +1,119 @@
+package com.swmansion.enriched.common
+
+/**
+ * Ordered-list item numbers by paragraph (cpp/document/ListNumbering). Mirrors the text edit by
+ * edit; callers mark which paragraphs are items. Lookups and updates are O(log n).
+ */
+class ListNumbering {
+  private var handle: Long = nativeCreate()
+
+  val length: Int
+    get() = nativeLength(handle)
+
+  val paragraphCount: Int
+    get() = nativeParagraphCount(handle)
+
+  /** Paragraphs of [text], none of them items. */
+  fun reset(text: CharSequence) {
+    nativeReset(handle, text.toString())
+  }
+
+  /**
+   * [removed] characters at [start] were replaced with text[start, start + count). Returns the
+   * touched paragraphs as (first, count), or null if the index wasn't in step with the text.
+   */
+  fun applyEdit(
+    start: Int,
+    removed: Int,
+    text: CharSequence,
+    count: Int,
+  ): Pair<Int, Int>? {
+    if (length != text.length - count + removed) return null
+    val touched = nativeApplyEdit(handle, start, removed, text.subSequence(start, start + count).toString())
+    return Pair((touched ushr 32).toInt(), touched.toInt())
+  }
+
+  fun paragraphAt(offset: Int): Int = nativeParagraphAt(handle, offset)
+
+  fun paragraphStart(paragraph: Int): Int = nativeParagraphStart(handle, paragraph)
+
+  /** End of the paragraph, before its '\n'. */
+  fun paragraphEnd(paragraph: Int): Int = if (paragraph + 1 < paragraphCount) paragraphStart(paragraph + 1) - 1 else length
+
+  fun setItem(
+    paragraph: Int,
+    isItem: Boolean,
+  ) {
+    nativeSetItem(handle, paragraph, isItem)
+  }
+
+  /** 1-based number of the item in its list, 0 when it isn't an item. */
+  fun number(paragraph: Int): Int = nativeNumber(handle, paragraph)
+
+  /** Frees the native side right away; the object can't be used afterwards. */
+  fun release() {
+    if (handle != 0L) {
+      nativeDestroy(handle)
+      handle = 0L
+    }
+  }
+
+  // Only for instances nobody released
+  protected fun finalize() {
+    release()
+  }
+
+  companion object {
+    @JvmStatic
+    private external fun nativeCreate(): Long
+
+    @JvmStatic
+    private external fun nativeDestroy(handle: Long)
+
+    @JvmStatic
+    private external fun nativeReset(
+      handle: Long,
+      text: String,
+    )
+
+    /** Returns (first shl 32) or count. */
+    @JvmStatic
+    private external fun nativeApplyEdit(
+      handle: Long,
+      start: Int,
+      removed: Int,
+      replacement: String,
+    ): Long
+
+    @JvmStatic
+    private external fun nativeLength(handle: Long): Int
+
+    @JvmStatic
+    private external fun nativeParagraphCount(handle: Long): Int
+
+    @JvmStatic
+    private external fun nativeParagraphAt(
+      handle: Long,
+      offset: Int,
+    ): Int
+
+    @JvmStatic
+    private external fun nativeParagraphStart(
+      handle: Long,
+      paragraph: Int,
+    ): Int
+
+    @JvmStatic
+    private external fun nativeSetItem(
+      handle: Long,
+      paragraph: Int,
+      isItem: Boolean,
+    )
+
+    @JvmStatic
+    private external fun nativeNumber(
+      handle: Long,
+      paragraph: Int,
+    ): Int
+  }
+}
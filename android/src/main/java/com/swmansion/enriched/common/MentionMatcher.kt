@@ -0,0 +1,45 @@
+package com.swmansion.enriched.common
+
+/**
+ * Native matcher compiled once per `mentionIndicators` config (cpp/text/MentionMatcher).
+ * Lookups don't depend on how many indicators are configured.
+ */
+class MentionMatcher(
+  val indicators: Array<String>,
+) {
+  private var handle: Long = if (indicators.isEmpty()) 0L else nativeCreate(indicators)
+
+  /** Indicator the word starts with; the first configured one wins if several apply. */
+  fun indicatorAtStart(word: String): String? {
+    if (indicators.isEmpty()) return null
+    val index = nativeIndicatorAtStart(handle, word)
+    return if (index < 0) null else indicators[index]
+  }
+
+  /** Frees the native side right away; the object can't be used afterwards. */
+  fun release() {
+    if (handle != 0L) {
+      nativeDestroy(handle)
+      handle = 0L
+    }
+  }
+
+  // Only for instances nobody released
+  protected fun finalize() {
+    release()
+  }
+
+  companion object {
+    @JvmStatic
+    private external fun nativeCreate(indicators: Array<String>): Long
+
+    @JvmStatic
+    private external fun nativeDestroy(handle: Long)
+
+    @JvmStatic
+    private external fun nativeIndicatorAtStart(
+      handle: Long,
+      word: String,
+    ): Int
+  }
+}
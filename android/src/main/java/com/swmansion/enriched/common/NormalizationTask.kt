@@ -0,0 +1,67 @@
+package com.swmansion.enriched.common
+
+import android.os.Handler
+import android.os.Looper
+import androidx.annotation.Keep
+
+/**
+ * HTML normalization running on the shared native worker (cpp/parser/NormalizationWorker).
+ * [onResult] receives the canonical HTML, or null on failure, on the main thread unless [cancel]
+ * was called first.
+ */
+class NormalizationTask internal constructor(
+  html: String,
+  private val onResult: (String?) -> Unit,
+) {
+  var isCancelled = false
+    private set
+
+  private var handle: Long = nativeSubmit(html, this)
+
+  /** Must be called on the main thread. */
+  fun cancel() {
+    if (isCancelled) return
+    isCancelled = true
+    nativeCancel(handle)
+    release()
+  }
+
+  // Called from the worker thread.
+  @Keep
+  private fun onNormalized(html: String?) {
+    mainHandler.post {
+      if (isCancelled) return@post
+      release()
+      onResult(html)
+    }
+  }
+
+  /** Frees the native side right away; the object can't be used afterwards. */
+  fun release() {
+    if (handle != 0L) {
+      nativeDestroy(handle)
+      handle = 0L
+    }
+  }
+
+  // Only for instances nobody released
+  protected fun finalize() {
+    release()
+  }
+
+  companion object {
+    private val mainHandler = Handler(Looper.getMainLooper())
+
+    @JvmStatic
+    private external fun nativeSubmit(
+      html: String,
+      task: NormalizationTask,
+    ): Long
+
+    @JvmStatic
+    private external fun nativeCancel(handle: Long)
+
+    @JvmStatic
+    private external fun nativeDestroy(handle: Long)
+  }
+}
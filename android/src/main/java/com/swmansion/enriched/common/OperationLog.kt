@@ -0,0 +1,167 @@
+package com.swmansion.enriched.common
+
+/**
+ * Undo/redo history (cpp/document/OperationLog). Edits are recorded as text replacements and
+ * restyles; runs are flattened (start, end, type, value) quadruples as in [StyleIndex]. Undo and
+ * redo cost is linear in the size of the step and the history is capped at [maxSteps] steps and
+ * about [maxBytes] bytes.
+ */
+class OperationLog(
+  maxSteps: Int = 100,
+  maxBytes: Int = 1 shl 20,
+) {
+  private var handle: Long = nativeCreate(maxSteps, maxBytes)
+
+  /**
+   * [REPLACE_TEXT]: replace [removedText] at [start] with [insertedText], then style the inserted
+   * text with [runs]. [REPLACE_STYLES]: replace every style in [start, end) with [runs].
+   */
+  class Operation(
+    val kind: Int,
+    val start: Int,
+    val end: Int,
+    val removedText: String,
+    val insertedText: String,
+    val runs: IntArray,
+  )
+
+  val canUndo: Boolean
+    get() = nativeCanUndo(handle)
+
+  val canRedo: Boolean
+    get() = nativeCanRedo(handle)
+
+  /** Edits recorded between begin and end form one undo step. */
+  fun beginGroup() {
+    nativeBeginGroup(handle)
+  }
+
+  fun endGroup() {
+    nativeEndGroup(handle)
+  }
+
+  /** [removedRuns] and [insertedRuns] are the styles of the two texts in document offsets. */
+  fun recordReplace(
+    start: Int,
+    removedText: String,
+    insertedText: String,
+    timestampMs: Long,
+    removedRuns: IntArray,
+    insertedRuns: IntArray,
+  ) {
+    nativeRecordReplace(handle, start, removedText, insertedText, timestampMs, removedRuns, insertedRuns)
+  }
+
+  /** The styles of [start, end) changed from [previousRuns] to [runs]. */
+  fun recordStyles(
+    start: Int,
+    end: Int,
+    previousRuns: IntArray,
+    runs: IntArray,
+  ) {
+    nativeRecordStyles(handle, start, end, previousRuns, runs)
+  }
+
+  /** Operations reverting the last step, in application order. */
+  fun undo(): Array<Operation> = nativeUndo(handle)
+
+  /** Operations re-applying the last undone step, in application order. */
+  fun redo(): Array<Operation> = nativeRedo(handle)
+
+  fun clear() {
+    nativeClear(handle)
+  }
+
+  /** Size in bytes of the payload behind a run value; it counts toward [maxBytes] while recorded. */
+  fun setValueSize(
+    value: Int,
+    bytes: Int,
+  ) {
+    nativeSetValueSize(handle, value, bytes)
+  }
+
+  /** Whether a kept step has a run with this value. */
+  fun isValueReferenced(value: Int): Boolean = nativeIsValueReferenced(handle, value)
+
+  /** Frees the native side right away; the object can't be used afterwards. */
+  fun release() {
+    if (handle != 0L) {
+      nativeDestroy(handle)
+      handle = 0L
+    }
+  }
+
+  // Only for instances nobody released
+  protected fun finalize() {
+    release()
+  }
+
+  companion object {
+    // EditOperation::Kind values
+    const val REPLACE_TEXT = 0
+    const val REPLACE_STYLES = 4
+
+    @JvmStatic
+    private external fun nativeCreate(
+      maxSteps: Int,
+      maxBytes: Int,
+    ): Long
+
+    @JvmStatic
+    private external fun nativeDestroy(handle: Long)
+
+    @JvmStatic
+    private external fun nativeBeginGroup(handle: Long)
+
+    @JvmStatic
+    private external fun nativeEndGroup(handle: Long)
+
+    @JvmStatic
+    private external fun nativeRecordReplace(
+      handle: Long,
+      start: Int,
+      removedText: String,
+      insertedText: String,
+      timestampMs: Long,
+      removedRuns: IntArray,
+      insertedRuns: IntArray,
+    )
+
+    @JvmStatic
+    private external fun nativeRecordStyles(
+      handle: Long,
+      start: Int,
+      end: Int,
+      previousRuns: IntArray,
+      runs: IntArray,
+    )
+
+    @JvmStatic
+    private external fun nativeCanUndo(handle: Long): Boolean
+
+    @JvmStatic
+    private external fun nativeCanRedo(handle: Long): Boolean
+
+    @JvmStatic
+    private external fun nativeUndo(handle: Long): Array<Operation>
+
+    @JvmStatic
+    private external fun nativeRedo(handle: Long): Array<Operation>
+
+    @JvmStatic
+    private external fun nativeClear(handle: Long)
+
+    @JvmStatic
+    private external fun nativeSetValueSize(
+      handle: Long,
+      value: Int,
+      bytes: Int,
+    )
+
+    @JvmStatic
+    private external fun nativeIsValueReferenced(
+      handle: Long,
+      value: Int,
+    ): Boolean
+  }
+}
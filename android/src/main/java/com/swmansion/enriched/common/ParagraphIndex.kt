@@ -0,0 +1,94 @@
+package com.swmansion.enriched.common
+
+/**
+ * Paragraph boundaries of the text (cpp/document/ParagraphIndex). Mirrors the text edit by edit;
+ * offset <-> paragraph lookups are O(log n) instead of a scan for the surrounding newlines.
+ */
+class ParagraphIndex {
+  private var handle: Long = nativeCreate()
+
+  /** Set until the index is first built and after [invalidate]; [sync] rebuilds a stale index. */
+  var isStale: Boolean = true
+    private set
+
+  fun reset(text: CharSequence) {
+    nativeReset(handle, text.toString())
+    isStale = false
+  }
+
+  /** The text changed in a way the index couldn't follow. */
+  fun invalidate() {
+    isStale = true
+  }
+
+  /** [removed] characters at [start] were replaced with text[start, start + count). */
+  fun applyEdit(
+    start: Int,
+    removed: Int,
+    text: CharSequence,
+    count: Int,
+  ) {
+    if (isStale) return
+    nativeApplyEdit(handle, start, removed, text.subSequence(start, start + count).toString())
+  }
+
+  fun sync(text: CharSequence): ParagraphIndex {
+    if (isStale) reset(text)
+    return this
+  }
+
+  /**
+   * From the start of the paragraph at [start] to the end of the one at [end], before its '\n';
+   * the same bounds as Spannable.getParagraphBounds.
+   */
+  fun bounds(
+    start: Int,
+    end: Int,
+  ): Pair<Int, Int> {
+    val bounds = nativeBounds(handle, start, end)
+    return Pair((bounds ushr 32).toInt(), bounds.toInt())
+  }
+
+  /** Frees the native side right away; the object can't be used afterwards. */
+  fun release() {
+    if (handle != 0L) {
+      nativeDestroy(handle)
+      handle = 0L
+    }
+  }
+
+  // Only for instances nobody released
+  protected fun finalize() {
+    release()
+  }
+
+  companion object {
+    @JvmStatic
+    private external fun nativeCreate(): Long
+
+    @JvmStatic
+    private external fun nativeDestroy(handle: Long)
+
+    @JvmStatic
+    private external fun nativeReset(
+      handle: Long,
+      text: String,
+    )
+
+    @JvmStatic
+    private external fun nativeApplyEdit(
+      handle: Long,
+      start: Int,
+      removed: Int,
+      replacement: String,
+    )
+
+    /** Returns (start shl 32) or end. */
+    @JvmStatic
+    private external fun nativeBounds(
+      handle: Long,
+      start: Int,
+      end: Int,
+    ): Long
+  }
+}
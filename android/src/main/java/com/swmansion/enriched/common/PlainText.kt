@@ -0,0 +1,25 @@
+package com.swmansion.enriched.common
+
+/**
+ * Plain text of the input's storage string (cpp/text/PlainText): zero-width spaces removed and
+ * image placeholders mapped in one native pass.
+ */
+object PlainText {
+  /** [attachmentReplacement] is what an image placeholder becomes; '\u0000' drops it. */
+  fun visibleText(
+    text: CharSequence,
+    attachmentReplacement: Char = EnrichedConstants.ORC,
+  ): String {
+    val string = text.toString()
+    val needsPass =
+      string.indexOf(EnrichedConstants.ZWS) >= 0 ||
+        (attachmentReplacement != EnrichedConstants.ORC && string.indexOf(EnrichedConstants.ORC) >= 0)
+    return if (needsPass) nativeVisibleText(string, attachmentReplacement) else string
+  }
+
+  @JvmStatic
+  private external fun nativeVisibleText(
+    text: String,
+    attachmentReplacement: Char,
+  ): String
+}
@@ -0,0 +1,104 @@
+package com.swmansion.enriched.common
+
+/**
+ * Native engine compiled once per `textShortcuts` config (cpp/text/ShortcutEngine).
+ * Offsets in matches are relative to the text passed in.
+ */
+class ShortcutEngine(
+  val shortcuts: List<Pair<String, String>>,
+) {
+  data class Match(
+    val trigger: String,
+    val styleName: String,
+    val openStart: Int,
+    val openEnd: Int,
+    val closeStart: Int,
+    val closeEnd: Int,
+    val contentStart: Int,
+    val contentEnd: Int,
+    val finalContentStart: Int,
+    val finalContentEnd: Int,
+  )
+
+  private var handle: Long =
+    if (shortcuts.isEmpty()) {
+      0L
+    } else {
+      nativeCreate(
+        shortcuts.map { it.first }.toTypedArray(),
+        shortcuts.map { it.second }.toTypedArray(),
+      )
+    }
+
+  /**
+   * Paragraph shortcuts whose trigger spans exactly from [triggerStart] to the end of [text],
+   * in configuration order.
+   */
+  fun paragraphMatches(
+    text: String,
+    triggerStart: Int,
+  ): List<Match> = if (handle == 0L) emptyList() else decode(nativeParagraphMatches(handle, text, triggerStart))
+
+  /** Inline shortcuts closed at the end of [text], longest trigger first. */
+  fun inlineMatches(
+    text: String,
+    paragraphStart: Int,
+  ): List<Match> = if (handle == 0L) emptyList() else decode(nativeInlineMatches(handle, text, paragraphStart))
+
+  private fun decode(flat: IntArray): List<Match> =
+    (flat.indices step MATCH_STRIDE).map { i ->
+      val (trigger, styleName) = shortcuts[flat[i]]
+      Match(
+        trigger,
+        styleName,
+        flat[i + 1],
+        flat[i + 1] + flat[i + 2],
+        flat[i + 3],
+        flat[i + 3] + flat[i + 4],
+        flat[i + 5],
+        flat[i + 5] + flat[i + 6],
+        flat[i + 7],
+        flat[i + 7] + flat[i + 8],
+      )
+    }
+
+  /** Frees the native side right away; the object can't be used afterwards. */
+  fun release() {
+    if (handle != 0L) {
+      nativeDestroy(handle)
+      handle = 0L
+    }
+  }
+
+  // Only for instances nobody released
+  protected fun finalize() {
+    release()
+  }
+
+  companion object {
+    private const val MATCH_STRIDE = 9
+
+    @JvmStatic
+    private external fun nativeCreate(
+      triggers: Array<String>,
+      styles: Array<String>,
+    ): Long
+
+    @JvmStatic
+    private external fun nativeDestroy(handle: Long)
+
+    @JvmStatic
+    private external fun nativeParagraphMatches(
+      handle: Long,
+      text: String,
+      triggerStart: Int,
+    ): IntArray
+
+    @JvmStatic
+    private external fun nativeInlineMatches(
+      handle: Long,
+      text: String,
+      paragraphStart: Int,
+    ): IntArray
+  }
+}
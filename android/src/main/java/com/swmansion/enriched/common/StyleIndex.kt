@@ -0,0 +1,183 @@
+package com.swmansion.enriched.common
+
+/**
+ * Style runs of the text (cpp/document/StyleIntervalTree), answering which styles intersect or
+ * cover a range without going through the spans. Types are cpp/document/StyleType.hpp indexes and
+ * the masks have bit i set for type i. Mirrors the text edit by edit; queries are O(log n + k).
+ *
+ * Runs carry a value: the [intern]ed [RunValue] of the span. Runs of the same type only coalesce
+ * when their values match.
+ */
+class StyleIndex {
+  private var handle: Long = nativeCreate()
+
+  // Interned run values. Once neither a run nor the edit history uses one, collectPayloads drops it
+  // and its index is reused.
+  private val payloads = ArrayList<RunValue?>()
+  private val payloadValues = HashMap<RunValue, Int>()
+  private val freeValues = ArrayDeque<Int>()
+  private var collectAt = MIN_COLLECTED_PAYLOADS
+
+  /** What a span carries besides its type: its payload (href, mention JSON, ...) and span flags. */
+  data class RunValue(
+    val payload: String?,
+    val flags: Int,
+  )
+
+  /** Told the value and size in bytes of every newly interned payload. */
+  var onIntern: ((value: Int, bytes: Int) -> Unit)? = null
+
+  /**
+   * Set until the index is first built and after [invalidate]; a stale index is rebuilt from the
+   * spans instead of being edited.
+   */
+  var isStale: Boolean = true
+    private set
+
+  /** [removed] characters at [start] were replaced with [count] new ones. */
+  fun applyEdit(
+    start: Int,
+    removed: Int,
+    count: Int,
+  ) {
+    nativeApplyEdit(handle, start, removed, count)
+  }
+
+  /**
+   * Drops all runs in [start, end) and adds [runs], flattened (start, end, type, value) quadruples.
+   * Runs may stick out of the range.
+   */
+  fun replace(
+    start: Int,
+    end: Int,
+    runs: IntArray,
+  ) {
+    nativeReplace(handle, start, end, runs)
+  }
+
+  /** Runs intersecting [start, end) clipped to it, as flattened (start, end, type, value) quadruples. */
+  fun runs(
+    start: Int,
+    end: Int,
+  ): IntArray = nativeRuns(handle, start, end)
+
+  fun intern(payload: RunValue): Int {
+    payloadValues[payload]?.let { return it }
+    val value = freeValues.removeLastOrNull() ?: payloads.size.also { payloads.add(null) }
+    payloads[value] = payload
+    payloadValues[payload] = value
+    onIntern?.invoke(value, RUN_VALUE_BYTES + (payload.payload?.length ?: 0) * Char.SIZE_BYTES)
+    return value
+  }
+
+  fun payload(value: Int): RunValue? = payloads.getOrNull(value)
+
+  /**
+   * Drops the payloads that no run of the index uses and [isReferenced] doesn't keep. Scans only
+   * once the pool doubled since the last collection, so the cost is amortized over the interns.
+   */
+  fun collectPayloads(isReferenced: (Int) -> Boolean) {
+    if (payloadValues.size < collectAt) return
+    val runs = nativeRuns(handle, 0, Int.MAX_VALUE)
+    val used = HashSet<Int>()
+    for (i in 3 until runs.size step 4) {
+      used.add(runs[i])
+    }
+    val entries = payloadValues.values.iterator()
+    while (entries.hasNext()) {
+      val value = entries.next()
+      if (value in used || isReferenced(value)) continue
+      entries.remove()
+      payloads[value] = null
+      freeValues.addLast(value)
+    }
+    collectAt = maxOf(MIN_COLLECTED_PAYLOADS, payloadValues.size * 2)
+  }
+
+  /** Empties the index; it's in step again once the caller re-adds the runs of the text. */
+  fun reset() {
+    nativeClear(handle)
+    isStale = false
+  }
+
+  /** The text changed in a way the index couldn't follow. */
+  fun invalidate() {
+    isStale = true
+  }
+
+  fun stylesIntersecting(
+    start: Int,
+    end: Int,
+  ): Int = nativeStylesIntersecting(handle, start, end)
+
+  fun stylesCovering(
+    start: Int,
+    end: Int,
+  ): Int = nativeStylesCovering(handle, start, end)
+
+  /** Frees the native side right away; the object can't be used afterwards. */
+  fun release() {
+    if (handle != 0L) {
+      nativeDestroy(handle)
+      handle = 0L
+    }
+  }
+
+  // Only for instances nobody released
+  protected fun finalize() {
+    release()
+  }
+
+  companion object {
+    private const val MIN_COLLECTED_PAYLOADS = 64
+
+    // Rough size of a RunValue and its pool entries, without the payload's characters
+    private const val RUN_VALUE_BYTES = 64
+
+    @JvmStatic
+    private external fun nativeCreate(): Long
+
+    @JvmStatic
+    private external fun nativeDestroy(handle: Long)
+
+    @JvmStatic
+    private external fun nativeApplyEdit(
+      handle: Long,
+      start: Int,
+      removed: Int,
+      count: Int,
+    )
+
+    @JvmStatic
+    private external fun nativeReplace(
+      handle: Long,
+      start: Int,
+      end: Int,
+      runs: IntArray,
+    )
+
+    @JvmStatic
+    private external fun nativeRuns(
+      handle: Long,
+      start: Int,
+      end: Int,
+    ): IntArray
+
+    @JvmStatic
+    private external fun nativeClear(handle: Long)
+
+    @JvmStatic
+    private external fun nativeStylesIntersecting(
+      handle: Long,
+      start: Int,
+      end: Int,
+    ): Int
+
+    @JvmStatic
+    private external fun nativeStylesCovering(
+      handle: Long,
+      start: Int,
+      end: Int,
+    ): Int
+  }
+}
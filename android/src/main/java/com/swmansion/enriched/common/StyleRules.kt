@@ -0,0 +1,28 @@
+package com.swmansion.enriched.common
+
+/**
+ * Style conflict and blocking masks shared with iOS (cpp/document/StyleRules). Styles are
+ * cpp/document/StyleType.hpp indexes; bit i of a mask stands for style i. [boldHeadings] has bit
+ * i - 1 set when h<i> is bold, which makes the heading remove bold and block it.
+ */
+object StyleRules {
+  private val cache = arrayOfNulls<IntArray>(1 shl 6)
+
+  /** Styles removed when [type] is applied. */
+  fun conflicts(
+    type: Int,
+    boldHeadings: Int,
+  ): Int = rules(boldHeadings)[type]
+
+  /** Styles that prevent [type] from being applied. */
+  fun blocks(
+    type: Int,
+    boldHeadings: Int,
+  ): Int = rules(boldHeadings).let { it[it.size / 2 + type] }
+
+  private fun rules(boldHeadings: Int): IntArray = cache[boldHeadings] ?: nativeRules(boldHeadings).also { cache[boldHeadings] = it }
+
+  /** Conflicts of every style, then blocks of every style; its size follows the native style count. */
+  @JvmStatic
+  private external fun nativeRules(boldHeadings: Int): IntArray
+}
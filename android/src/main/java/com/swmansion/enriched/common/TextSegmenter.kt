@@ -0,0 +1,73 @@
+package com.swmansion.enriched.common
+
+import android.text.TextUtils
+
+/**
+ * Grapheme-aware word lookups (cpp/text/TextSegmenter). Tokens are runs of grapheme clusters between
+ * Unicode white space, so emoji sequences and combining marks are never split. Only a window around
+ * the requested offset is copied to native code; it grows until the token fits.
+ */
+object TextSegmenter {
+  private const val INITIAL_RADIUS = 64
+
+  /** [start, end) of the token touching caret [position]; empty between two separators. */
+  fun tokenAt(
+    text: CharSequence,
+    position: Int,
+  ): Pair<Int, Int> {
+    val length = text.length
+    val caret = position.coerceIn(0, length)
+    var radius = INITIAL_RADIUS
+    while (true) {
+      val windowStart = maxOf(0, caret - radius)
+      val windowEnd = minOf(length, caret + radius)
+      val packed = nativeTokenAt(window(text, windowStart, windowEnd), windowStart, length, caret)
+      if (packed >= 0) return Pair((packed ushr 32).toInt(), packed.toInt())
+      radius *= 4
+    }
+  }
+
+  /** Flattened [start, end) pairs of the tokens overlapping [start, end), extended to whole tokens. */
+  fun tokensIn(
+    text: CharSequence,
+    start: Int = 0,
+    end: Int = text.length,
+  ): IntArray {
+    val length = text.length
+    val rangeStart = start.coerceIn(0, length)
+    val rangeEnd = end.coerceIn(rangeStart, length)
+    var radius = INITIAL_RADIUS
+    while (true) {
+      val windowStart = maxOf(0, rangeStart - radius)
+      val windowEnd = minOf(length, rangeEnd + radius)
+      val chars = window(text, windowStart, windowEnd)
+      nativeTokensIn(chars, windowStart, length, rangeStart, rangeEnd)?.let { return it }
+      radius *= 4
+    }
+  }
+
+  private fun window(
+    text: CharSequence,
+    start: Int,
+    end: Int,
+  ): CharArray = CharArray(end - start).also { TextUtils.getChars(text, start, end, it, 0) }
+
+  /** Returns (start shl 32) or end, or -1 when the window was too small. */
+  @JvmStatic
+  private external fun nativeTokenAt(
+    chars: CharArray,
+    windowStart: Int,
+    textLength: Int,
+    position: Int,
+  ): Long
+
+  /** Returns null when the window was too small. */
+  @JvmStatic
+  private external fun nativeTokensIn(
+    chars: CharArray,
+    windowStart: Int,
+    textLength: Int,
+    start: Int,
+    end: Int,
+  ): IntArray?
+}
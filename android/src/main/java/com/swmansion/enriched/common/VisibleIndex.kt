@@ -0,0 +1,90 @@
+package com.swmansion.enriched.common
+
+/**
+ * Native visible <-> storage index translation (cpp/text/VisibleIndex). Visible indices skip the
+ * zero-width spaces the input keeps as paragraph anchors; both directions are O(log n).
+ */
+class VisibleIndex {
+  private var handle: Long = nativeCreate()
+
+  /** Set until the index is first built and after [invalidate]; [sync] rebuilds a stale index. */
+  var isStale: Boolean = true
+    private set
+
+  fun reset(text: CharSequence) {
+    nativeReset(handle, text.toString())
+    isStale = false
+  }
+
+  /** The text changed in a way the index couldn't follow. */
+  fun invalidate() {
+    isStale = true
+  }
+
+  /** [removed] characters at [start] were replaced with text[start, start + count). */
+  fun applyEdit(
+    start: Int,
+    removed: Int,
+    text: CharSequence,
+    count: Int,
+  ) {
+    if (isStale) return
+    nativeApplyEdit(handle, start, removed, text.subSequence(start, start + count).toString())
+  }
+
+  fun sync(text: CharSequence): VisibleIndex {
+    if (isStale) reset(text)
+    return this
+  }
+
+  fun visibleIndex(storageIndex: Int): Int = nativeVisibleIndex(handle, storageIndex)
+
+  fun storageIndex(visibleIndex: Int): Int = nativeStorageIndex(handle, visibleIndex)
+
+  /** Frees the native side right away; the object can't be used afterwards. */
+  fun release() {
+    if (handle != 0L) {
+      nativeDestroy(handle)
+      handle = 0L
+    }
+  }
+
+  // Only for instances nobody released
+  protected fun finalize() {
+    release()
+  }
+
+  companion object {
+    @JvmStatic
+    private external fun nativeCreate(): Long
+
+    @JvmStatic
+    private external fun nativeDestroy(handle: Long)
+
+    @JvmStatic
+    private external fun nativeReset(
+      handle: Long,
+      text: String,
+    )
+
+    @JvmStatic
+    private external fun nativeApplyEdit(
+      handle: Long,
+      start: Int,
+      removed: Int,
+      replacement: String,
+    )
+
+    @JvmStatic
+    private external fun nativeVisibleIndex(
+      handle: Long,
+      storageIndex: Int,
+    ): Int
+
+    @JvmStatic
+    private external fun nativeStorageIndex(
+      handle: Long,
+      visibleIndex: Int,
+    ): Int
+  }
+}
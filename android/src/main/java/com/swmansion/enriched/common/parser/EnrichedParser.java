@@ -6,6 +6,7 @@ import android.text.SpannableStringBuilder;
 import android.text.Spanned;
 import android.text.TextUtils;
 import android.text.style.ParagraphStyle;
+import com.swmansion.enriched.common.BlobStore;
 import com.swmansion.enriched.common.EnrichedConstants;
 import com.swmansion.enriched.common.spans.EnrichedAlignmentSpan;
 import com.swmansion.enriched.common.spans.EnrichedBoldSpan;
@@ -324,7 +325,7 @@ public class EnrichedParser {
         }
         if (style[j] instanceof EnrichedImageSpan) {
           out.append("<img src=\"");
-          out.append(((EnrichedImageSpan) style[j]).getSource());
+          out.append(BlobStore.exportSource(((EnrichedImageSpan) style[j]).getSource()));
           out.append("\"");
 
           out.append(" width=\"");
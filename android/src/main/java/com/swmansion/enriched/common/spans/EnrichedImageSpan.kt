@@ -1,6 +1,7 @@
 package com.swmansion.enriched.common.spans
 
 import android.content.res.Resources
+import android.graphics.Bitmap
 import android.graphics.BitmapFactory
 import android.graphics.Canvas
 import android.graphics.ImageDecoder
@@ -13,9 +14,11 @@ import android.os.Looper
 import android.text.Spannable
 import android.text.style.ImageSpan
 import android.util.Log
+import androidx.annotation.RequiresApi
 import androidx.core.graphics.drawable.toDrawable
 import androidx.core.graphics.withSave
 import com.swmansion.enriched.common.AsyncDrawable
+import com.swmansion.enriched.common.BlobStore
 import com.swmansion.enriched.common.ForceRedrawSpan
 import com.swmansion.enriched.common.spans.interfaces.EnrichedInlineSpan
 import java.io.File
@@ -141,6 +144,10 @@ open class EnrichedImageSpan :
         return AsyncDrawable(cleanPath)
       }
 
+      if (BlobStore.isHandle(cleanPath)) {
+        return prepareDrawableForBlob(cleanPath, width, height)
+      }
+
       if (cleanPath.startsWith("file://")) {
         cleanPath = cleanPath.substring(7)
       }
@@ -148,9 +155,7 @@ open class EnrichedImageSpan :
       if (Build.VERSION.SDK_INT < Build.VERSION_CODES.P) {
         return try {
           val bitmap = BitmapFactory.decodeFile(cleanPath) ?: return null
-          val drawable = bitmap.toDrawable(Resources.getSystem())
-          drawable.setBounds(0, 0, bitmap.width, bitmap.height)
-          return drawable
+          bitmapDrawable(bitmap)
         } catch (e: Exception) {
           Log.e("EnrichedImageSpan", "Failed to load legacy image: $cleanPath", e)
           null
@@ -158,28 +163,64 @@ open class EnrichedImageSpan :
       }
 
       return try {
-        val file = File(cleanPath)
-        val source = ImageDecoder.createSource(file)
-
-        val density = Resources.getSystem().displayMetrics.density
-        val targetWidthPx = (width * density).toInt()
-        val targetHeightPx = (height * density).toInt()
-
-        val drawable =
-          ImageDecoder.decodeDrawable(source) { decoder, info, source ->
-            decoder.setTargetSize(targetWidthPx, targetHeightPx)
-          }
-
-        if (drawable is AnimatedImageDrawable) {
-          drawable.setBounds(0, 0, drawable.intrinsicWidth, drawable.intrinsicHeight)
-          drawable.repeatCount = AnimatedImageDrawable.REPEAT_INFINITE
-          drawable.start()
-        }
-        drawable
+        decodeDrawable(ImageDecoder.createSource(File(cleanPath)), width, height)
       } catch (e: Exception) {
         Log.e("EnrichedImageSpan", "Failed to load image: $cleanPath", e)
         null
       }
     }
+
+    // Pasted data: URI images, decoded straight from the native blob store's memory.
+    private fun prepareDrawableForBlob(
+      handle: String,
+      width: Int,
+      height: Int,
+    ): Drawable? {
+      val buffer = BlobStore.buffer(handle) ?: return null
+
+      return try {
+        if (Build.VERSION.SDK_INT < Build.VERSION_CODES.P) {
+          // BitmapFactory only takes arrays (or streams that would copy anyway)
+          val bytes = ByteArray(buffer.remaining())
+          buffer.get(bytes)
+          val bitmap = BitmapFactory.decodeByteArray(bytes, 0, bytes.size) ?: return null
+          bitmapDrawable(bitmap)
+        } else {
+          decodeDrawable(ImageDecoder.createSource(buffer), width, height)
+        }
+      } catch (e: Exception) {
+        Log.e("EnrichedImageSpan", "Failed to load image: $handle", e)
+        null
+      }
+    }
+
+    private fun bitmapDrawable(bitmap: Bitmap): Drawable {
+      val drawable = bitmap.toDrawable(Resources.getSystem())
+      drawable.setBounds(0, 0, bitmap.width, bitmap.height)
+      return drawable
+    }
+
+    @RequiresApi(Build.VERSION_CODES.P)
+    private fun decodeDrawable(
+      source: ImageDecoder.Source,
+      width: Int,
+      height: Int,
+    ): Drawable {
+      val density = Resources.getSystem().displayMetrics.density
+      val targetWidthPx = (width * density).toInt()
+      val targetHeightPx = (height * density).toInt()
+
+      val drawable =
+        ImageDecoder.decodeDrawable(source) { decoder, info, source ->
+          decoder.setTargetSize(targetWidthPx, targetHeightPx)
+        }
+
+      if (drawable is AnimatedImageDrawable) {
+        drawable.setBounds(0, 0, drawable.intrinsicWidth, drawable.intrinsicHeight)
+        drawable.repeatCount = AnimatedImageDrawable.REPEAT_INFINITE
+        drawable.start()
+      }
+      return drawable
+    }
   }
 }
@@ -121,6 +121,65 @@ data class EnrichedTextStyle(
       )
     }
 
+    // Reads the layout-only htmlStyle the Fabric measurement manager passes (see conversions.h). Colors,
+    // decorations and mention styles don't change the measured size, so they are left at defaults.
+    fun forMeasurement(
+      fontSize: Int,
+      map: ReadableMap,
+      allowFontScaling: Boolean,
+    ): EnrichedTextStyle {
+      val h1 = map.getMap("h1")
+      val h2 = map.getMap("h2")
+      val h3 = map.getMap("h3")
+      val h4 = map.getMap("h4")
+      val h5 = map.getMap("h5")
+      val h6 = map.getMap("h6")
+      val blockquote = map.getMap("blockquote")
+      val orderedList = map.getMap("ol")
+      val unorderedList = map.getMap("ul")
+      val checkboxList = map.getMap("ulCheckbox")
+
+      return EnrichedTextStyle(
+        h1FontSize = parseFloat(h1, "fontSize", allowFontScaling).toInt(),
+        h1Bold = h1?.getBoolean("bold") ?: false,
+        h2FontSize = parseFloat(h2, "fontSize", allowFontScaling).toInt(),
+        h2Bold = h2?.getBoolean("bold") ?: false,
+        h3FontSize = parseFloat(h3, "fontSize", allowFontScaling).toInt(),
+        h3Bold = h3?.getBoolean("bold") ?: false,
+        h4FontSize = parseFloat(h4, "fontSize", allowFontScaling).toInt(),
+        h4Bold = h4?.getBoolean("bold") ?: false,
+        h5FontSize = parseFloat(h5, "fontSize", allowFontScaling).toInt(),
+        h5Bold = h5?.getBoolean("bold") ?: false,
+        h6FontSize = parseFloat(h6, "fontSize", allowFontScaling).toInt(),
+        h6Bold = h6?.getBoolean("bold") ?: false,
+        blockquoteColor = null,
+        blockquoteBorderColor = Color.BLACK,
+        blockquoteStripeWidth = parseFloat(blockquote, "borderWidth", allowFontScaling).toInt(),
+        blockquoteGapWidth = parseFloat(blockquote, "gapWidth", allowFontScaling).toInt(),
+        olGapWidth = parseFloat(orderedList, "gapWidth", allowFontScaling).toInt(),
+        olMarginLeft = calculateOlMarginLeft(fontSize, parseFloat(orderedList, "marginLeft", allowFontScaling).toInt()),
+        olMarkerFontWeight = null,
+        olMarkerColor = null,
+        ulGapWidth = parseFloat(unorderedList, "gapWidth", allowFontScaling).toInt(),
+        ulMarginLeft = parseFloat(unorderedList, "marginLeft", allowFontScaling).toInt(),
+        ulBulletSize = parseFloat(unorderedList, "bulletSize", allowFontScaling).toInt(),
+        ulBulletColor = Color.BLACK,
+        ulCheckboxBoxColor = Color.BLACK,
+        ulCheckboxBoxSize = parseFloat(checkboxList, "boxSize", allowFontScaling).toInt(),
+        ulCheckboxGapWidth = parseFloat(checkboxList, "gapWidth", allowFontScaling).toInt(),
+        ulCheckboxMarginLeft = parseFloat(checkboxList, "marginLeft", allowFontScaling).toInt(),
+        aColor = Color.BLACK,
+        aUnderline = false,
+        aPressColor = Color.BLACK,
+        codeBlockColor = Color.BLACK,
+        codeBlockBackgroundColor = Color.BLACK,
+        codeBlockRadius = 0f,
+        inlineCodeColor = Color.BLACK,
+        inlineCodeBackgroundColor = Color.BLACK,
+        mentionsStyle = emptyMap(),
+      )
+    }
+
     private fun parseFloat(
       map: ReadableMap?,
       key: String,
@@ -56,7 +56,20 @@ class EnrichedTextView : AppCompatTextView {
   // setText with the same instance and force the TextView to rebuild its layout.
   private var parsedText: CharSequence? = null
 
+  // What the shown spans were built from: internal HTML is parsed as is, so it's kept verbatim;
+  // external HTML goes through the normalizer, so its canonical hash is enough. Null and 0 when
+  // unknown.
+  private var shownHtml: String? = null
+  private var contentHash = 0L
+
   var useHtmlNormalizer = false
+    set(value) {
+      if (field != value) {
+        shownHtml = null
+        contentHash = 0L
+      }
+      field = value
+    }
 
   constructor(context: Context) : super(context) {
     prepareComponent()
@@ -175,49 +188,67 @@ class EnrichedTextView : AppCompatTextView {
 
     valueDirty = false
 
-    val parsed = parseText(text, style)
+    // A value equivalent to the one shown (e.g. the same HTML from a new JS string) would only
+    // rebuild identical spans. The normalizer drops things the parser renders (alignment, custom
+    // mention attributes), so only external HTML is compared by its canonical hash, taken of the
+    // same normalized HTML that is then parsed. Plain text is shown verbatim and never compared.
+    val internal = isInternalHtml(text)
+    if (internal && text == shownHtml) return
+    val normalized = if (!internal && useHtmlNormalizer) GumboNormalizer.normalizeHtml(text) else null
+    val hash = normalized?.let { GumboNormalizer.hashNormalized(it) } ?: 0L
+    if (hash != 0L && hash == contentHash) return
+
+    val parsed = parseText(text, style, normalized)
     if (parsed != null) {
       parsedText = parsed
       setText(parsed, BufferType.NORMAL)
       observeAsyncImages()
+      shownHtml = if (internal) text else null
+      contentHash = hash
     } else {
       parsedText = null
       this.text = text
+      shownHtml = null
+      contentHash = 0L
     }
   }
 
+  private fun isInternalHtml(text: String): Boolean = text.startsWith("<html>") && text.endsWith("</html>")
+
+  /** [normalizedHtml] is the normalizer's output for [text], if already known. */
   private fun parseText(
     text: String,
     style: EnrichedTextStyle,
+    normalizedHtml: String? = null,
   ): CharSequence? {
-    val isInternalHtml = text.startsWith("<html>") && text.endsWith("</html>")
-
-    if (isInternalHtml) {
+    if (isInternalHtml(text)) {
       try {
         val parsed = EnrichedParser.fromHtml(text, style, spannableFactory)
         return parsed.trimEnd('\n')
       } catch (e: Exception) {
         Log.e(TAG, "Error parsing HTML: ${e.message}")
-        return normalizeHtmlIfNeeded(text, style)
+        return normalizeHtmlIfNeeded(text, style, normalizedHtml)
       }
     }
 
-    return normalizeHtmlIfNeeded(text, style)
+    return normalizeHtmlIfNeeded(text, style, normalizedHtml)
   }
 
   private fun normalizeHtmlIfNeeded(
     text: String,
     style: EnrichedTextStyle,
+    normalizedHtml: String?,
   ): CharSequence? {
     if (!useHtmlNormalizer) return null
-    return parseNormalizedHtml(text, style)
+    return parseNormalizedHtml(text, style, normalizedHtml)
   }
 
   private fun parseNormalizedHtml(
     text: String,
     style: EnrichedTextStyle,
+    normalizedHtml: String?,
   ): CharSequence? {
-    val normalized = GumboNormalizer.normalizeHtml(text) ?: return null
+    val normalized = normalizedHtml ?: GumboNormalizer.normalizeHtml(text) ?: return null
 
     return try {
       val parsed: Spanned = EnrichedParser.fromHtml(normalized, style, spannableFactory)
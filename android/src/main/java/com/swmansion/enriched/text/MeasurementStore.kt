@@ -8,7 +8,6 @@ import android.text.StaticLayout
 import android.text.TextPaint
 import android.text.TextUtils
 import android.util.Log
-import com.facebook.react.bridge.ReactContext
 import com.facebook.react.bridge.ReadableMap
 import com.facebook.react.uimanager.PixelUtil
 import com.facebook.react.views.text.ReactTypefaceUtils.applyStyles
@@ -99,7 +98,6 @@ object MeasurementStore {
   }
 
   private fun getInitialText(
-    context: Context,
     fontSize: Int,
     props: ReadableMap?,
   ): CharSequence {
@@ -111,8 +109,7 @@ object MeasurementStore {
     try {
       val style = props?.getMap("htmlStyle") ?: return text
       val allowFontScaling = allowFontScalingFromProps(props)
-      val enrichedStyle =
-        EnrichedTextStyle.fromReadableMap(context as ReactContext, fontSize, style, allowFontScaling)
+      val enrichedStyle = EnrichedTextStyle.forMeasurement(fontSize, style, allowFontScaling)
       val factory = EnrichedTextSpanFactory()
       val parsed = EnrichedParser.fromHtml(text, enrichedStyle, factory)
       return parsed.trimEnd('\n')
@@ -139,7 +136,7 @@ object MeasurementStore {
     props: ReadableMap?,
   ): Long {
     val fontSize = getInitialFontSize(props)
-    val text = getInitialText(context, fontSize.toInt(), props)
+    val text = getInitialText(fontSize.toInt(), props)
 
     val fontFamily = props?.getString("fontFamily")
     val numberOfLines = props?.getInt("numberOfLines") ?: 0
@@ -12,9 +12,9 @@ import android.os.Build
 import android.text.InputType
 import android.text.Spannable
 import android.text.SpannableString
+import android.util.Base64
 import android.util.AttributeSet
 import android.util.Log
-import android.util.Patterns
 import android.util.TypedValue
 import android.view.ActionMode
 import android.view.Gravity
@@ -37,15 +37,24 @@ import com.facebook.react.uimanager.UIManagerHelper
 import com.facebook.react.views.text.ReactTypefaceUtils.applyStyles
 import com.facebook.react.views.text.ReactTypefaceUtils.parseFontStyle
 import com.facebook.react.views.text.ReactTypefaceUtils.parseFontWeight
+import com.swmansion.enriched.common.DocumentSnapshot
 import com.swmansion.enriched.common.EnrichedConstants
 import com.swmansion.enriched.common.GumboNormalizer
+import com.swmansion.enriched.common.LinkDetector
+import com.swmansion.enriched.common.NormalizationTask
+import com.swmansion.enriched.common.ParagraphIndex
+import com.swmansion.enriched.common.ShortcutEngine
+import com.swmansion.enriched.common.StyleIndex
+import com.swmansion.enriched.common.VisibleIndex
 import com.swmansion.enriched.common.parser.EnrichedParser
 import com.swmansion.enriched.common.pixelFromSpOrDp
 import com.swmansion.enriched.textinput.events.MentionHandler
 import com.swmansion.enriched.textinput.events.OnContextMenuItemPressEvent
 import com.swmansion.enriched.textinput.events.OnInputBlurEvent
 import com.swmansion.enriched.textinput.events.OnInputFocusEvent
+import com.swmansion.enriched.textinput.events.OnPastePendingEvent
 import com.swmansion.enriched.textinput.events.OnRequestHtmlResultEvent
+import com.swmansion.enriched.textinput.events.OnRequestSnapshotResultEvent
 import com.swmansion.enriched.textinput.events.OnSubmitEditingEvent
 import com.swmansion.enriched.textinput.spans.EnrichedInputH1Span
 import com.swmansion.enriched.textinput.spans.EnrichedInputH2Span
@@ -63,14 +72,17 @@ import com.swmansion.enriched.textinput.styles.InlineStyles
 import com.swmansion.enriched.textinput.styles.ListStyles
 import com.swmansion.enriched.textinput.styles.ParagraphStyles
 import com.swmansion.enriched.textinput.styles.ParametrizedStyles
+import com.swmansion.enriched.textinput.utils.EditHistory
 import com.swmansion.enriched.textinput.utils.EnrichedEditableFactory
 import com.swmansion.enriched.textinput.utils.EnrichedSelection
 import com.swmansion.enriched.textinput.utils.EnrichedSpanState
+import com.swmansion.enriched.textinput.utils.getParagraphBounds
 import com.swmansion.enriched.textinput.utils.RichContentReceiver
 import com.swmansion.enriched.textinput.utils.ShortcutsHandler
 import com.swmansion.enriched.textinput.utils.mergeSpannables
 import com.swmansion.enriched.textinput.utils.setCheckboxClickListener
-import com.swmansion.enriched.textinput.utils.zwsCountBefore
+import com.swmansion.enriched.textinput.utils.toDocumentSnapshot
+import com.swmansion.enriched.textinput.utils.toSpannable
 import com.swmansion.enriched.textinput.watchers.EnrichedSpanWatcher
 import com.swmansion.enriched.textinput.watchers.EnrichedTextWatcher
 import java.util.regex.Pattern
@@ -117,7 +129,10 @@ class EnrichedTextInputView :
       }
     }
 
-  var linkRegex: Pattern? = Patterns.WEB_URL
+  var linkDetector: LinkDetector? = LinkDetector.default
+
+  // Fallback for user patterns the native link detector can't compile
+  var linkRegex: Pattern? = null
   var spanWatcher: EnrichedSpanWatcher? = null
   var layoutManager: EnrichedTextInputViewLayoutManager = EnrichedTextInputViewLayoutManager(this)
 
@@ -127,7 +142,22 @@ class EnrichedTextInputView :
   var useHtmlNormalizer: Boolean = false
 
   // Pair: (trigger, style)
-  var textShortcuts: List<Pair<String, String>> = emptyList()
+  var textShortcuts: List<Pair<String, String>>
+    get() = shortcutEngine.shortcuts
+    set(value) {
+      shortcutEngine.release()
+      shortcutEngine = ShortcutEngine(value)
+    }
+  var shortcutEngine = ShortcutEngine(emptyList())
+    private set
+
+  val visibleIndex = VisibleIndex()
+
+  // Kept in step by EnrichedTextWatcher and EnrichedSpanWatcher
+  val styleIndex = StyleIndex()
+
+  // Kept in step by EnrichedTextWatcher
+  val paragraphIndex = ParagraphIndex()
 
   private var fontSizeRaw: Float? = null
   var fontSize: Float? = null
@@ -145,7 +175,11 @@ class EnrichedTextInputView :
 
   private var inputMethodManager: InputMethodManager? = null
   private val spannableFactory = EnrichedTextInputSpannableFactory()
+
+  // Recorded by EnrichedTextWatcher and EnrichedSpanWatcher
+  val history = EditHistory(this, spannableFactory)
   private var contextMenuItems: List<Pair<Int, String>> = emptyList()
+  private var pendingPaste: NormalizationTask? = null
 
   constructor(context: Context) : super(context) {
     prepareComponent()
@@ -281,6 +315,20 @@ class EnrichedTextInputView :
     )
   }
 
+  private fun emitPastePending(isPending: Boolean) {
+    val context = context as ReactContext
+    val surfaceId = UIManagerHelper.getSurfaceId(context)
+    val dispatcher = UIManagerHelper.getEventDispatcherForReactTag(context, id)
+    dispatcher?.dispatchEvent(
+      OnPastePendingEvent(
+        surfaceId,
+        id,
+        isPending,
+        experimentalSynchronousEvents,
+      ),
+    )
+  }
+
   // https://github.com/facebook/react-native/blob/36df97f500aa0aa8031098caf7526db358b6ddc1/packages/react-native/ReactAndroid/src/main/java/com/facebook/react/views/textinput/ReactEditText.kt#L295C1-L296C1
   override fun onTouchEvent(ev: MotionEvent): Boolean {
     when (ev.action) {
@@ -369,15 +417,26 @@ class EnrichedTextInputView :
   }
 
   fun handleTextPaste(item: ClipData.Item) {
-    val currentText = text as Spannable
-    val start = selectionStart.coerceAtLeast(0)
-    val end = selectionEnd.coerceAtLeast(0)
-    val lengthBefore = currentText.length
+    // A newer paste supersedes one still being normalized.
+    cancelPendingPaste()
+
+    val htmlText = item.htmlText
+    if (htmlText != null && shouldNormalizeInBackground(htmlText)) {
+      pendingPaste =
+        GumboNormalizer.normalizeHtmlAsync(htmlText) { normalized ->
+          pendingPaste = null
+          val parsed = normalized?.let { parseNormalizedHtml(it) }
+          (parsed as? Spannable)?.let { pasteSpannable(it) }
+          emitPastePending(false)
+        }
+      emitPastePending(true)
+      return
+    }
 
     val pastedSpannable: Spannable =
       when {
-        item.htmlText != null -> {
-          val parsed = parseText(item.htmlText)
+        htmlText != null -> {
+          val parsed = parseText(htmlText)
           (parsed as? Spannable) ?: return
         }
 
@@ -390,6 +449,15 @@ class EnrichedTextInputView :
         }
       }
 
+    pasteSpannable(pastedSpannable)
+  }
+
+  private fun pasteSpannable(pastedSpannable: Spannable) {
+    val currentText = text as Spannable
+    val start = selectionStart.coerceAtLeast(0)
+    val end = selectionEnd.coerceAtLeast(0)
+    val lengthBefore = currentText.length
+
     val finalText = currentText.mergeSpannables(start, end, pastedSpannable, htmlStyle)
     setValue(finalText, false)
 
@@ -402,6 +470,22 @@ class EnrichedTextInputView :
     parametrizedStyles?.detectLinksInRange(finalText, start.coerceAtMost(pasteEnd), pasteEnd)
   }
 
+  private fun cancelPendingPaste() {
+    val paste = pendingPaste ?: return
+    paste.cancel()
+    pendingPaste = null
+    emitPastePending(false)
+  }
+
+  /**
+   * Large external HTML is normalized on the native worker and pasted at the selection current
+   * when it's done, so it never blocks input handling.
+   */
+  private fun shouldNormalizeInBackground(html: String): Boolean =
+    useHtmlNormalizer && html.length >= BACKGROUND_NORMALIZATION_THRESHOLD && !isInternalHtml(html)
+
+  private fun isInternalHtml(text: CharSequence): Boolean = text.startsWith("<html>") && text.endsWith("</html>")
+
   fun requestFocusProgrammatically() {
     requestFocus()
     inputMethodManager?.showSoftInput(this, 0)
@@ -411,20 +495,20 @@ class EnrichedTextInputView :
   private fun normalizeHtmlIfNeeded(text: CharSequence): CharSequence {
     if (!useHtmlNormalizer) return text
     val normalized = GumboNormalizer.normalizeHtml(text.toString()) ?: return text
+    return parseNormalizedHtml(normalized) ?: text
+  }
 
-    return try {
+  private fun parseNormalizedHtml(normalized: String): CharSequence? =
+    try {
       val parsed = EnrichedParser.fromHtml(normalized, htmlStyle, spannableFactory)
       parsed.trimEnd('\n')
     } catch (e: Exception) {
       Log.e(TAG, "Error parsing normalized HTML: ${e.message}")
-      text
+      null
     }
-  }
 
   private fun parseText(text: CharSequence): CharSequence {
-    val isInternalHtml = text.startsWith("<html>") && text.endsWith("</html>")
-
-    if (isInternalHtml) {
+    if (isInternalHtml(text)) {
       try {
         val parsed = EnrichedParser.fromHtml(text.toString(), htmlStyle, spannableFactory)
         return parsed.trimEnd('\n')
@@ -442,6 +526,8 @@ class EnrichedTextInputView :
     shouldParseHtml: Boolean = true,
   ) {
     if (value == null) return
+    cancelPendingPaste()
+    if (shouldParseHtml && isValueShown(value)) return
 
     runAsATransaction {
       val newText = if (shouldParseHtml) parseText(value) else value
@@ -453,9 +539,22 @@ class EnrichedTextInputView :
       // Scroll to the last line of text
       setSelection(text?.length ?: 0)
     }
+    // A new value starts a new history, its edits aren't undoable
+    history.clear()
     layoutManager.invalidateLayout()
   }
 
+  /**
+   * Whether [value] is what the input holds, typically its own onChangeHtml output coming back from
+   * JS. Re-parsing it would rebuild identical spans and move the cursor. Internal HTML is parsed as
+   * is, so only the exact string is known to match: the normalizer drops alignment and custom
+   * mention attributes that the parser keeps.
+   */
+  private fun isValueShown(value: CharSequence): Boolean {
+    val shown = spanWatcher?.emittedHtml() ?: return false
+    return value.toString() == shown
+  }
+
   fun setCustomSelection(
     visibleStart: Int,
     visibleEnd: Int,
@@ -466,27 +565,24 @@ class EnrichedTextInputView :
     setSelection(actualStart, actualEnd)
   }
 
-  // Helper: Walks through the string skipping ZWSPs to find the Nth visible character
-  private fun getActualIndex(visibleIndex: Int): Int {
-    val currentText = text as Spannable
-    var currentVisibleCount = 0
-    var actualIndex = 0
-
-    while (actualIndex < currentText.length) {
-      if (currentVisibleCount == visibleIndex) {
-        return actualIndex
-      }
+  private fun getActualIndex(index: Int): Int = visibleIndex.sync(text ?: "").storageIndex(index)
 
-      // If the current char is not a hidden space, it counts towards our visible index
-      if (currentText[actualIndex] != EnrichedConstants.ZWS) {
-        currentVisibleCount++
-      }
-      actualIndex++
-    }
-
-    return actualIndex
+  /**
+   * Same as [getParagraphBounds], answered by the paragraph index when [spannable] is the input's
+   * text; other spannables (e.g. a paste being built) are scanned.
+   */
+  fun paragraphBounds(
+    spannable: Spannable,
+    start: Int,
+    end: Int = start,
+  ): Pair<Int, Int> {
+    if (spannable !== text) return spannable.getParagraphBounds(start, end)
+    return paragraphIndex.sync(spannable).bounds(start, end)
   }
 
+  /** Index in the text without zero-width spaces, as reported to JS. */
+  fun toVisibleIndex(storageIndex: Int): Int = visibleIndex.sync(text ?: "").visibleIndex(storageIndex)
+
   /**
    * Finds all async images in the current text and sets up listeners
    * to redraw the text layout when they finish downloading.
@@ -630,32 +726,55 @@ class EnrichedTextInputView :
   }
 
   fun setLinkRegex(config: ReadableMap?) {
-    val patternStr = config?.getString("pattern")
-    if (patternStr == null) {
-      linkRegex = Patterns.WEB_URL
-      return
-    }
+    releaseLinkDetector()
+    linkDetector = LinkDetector.default
+    linkRegex = null
 
-    if (config.getBoolean("isDefault")) {
-      linkRegex = Patterns.WEB_URL
-      return
-    }
+    val patternStr = config?.getString("pattern") ?: return
+    if (config.getBoolean("isDefault")) return
 
     if (config.getBoolean("isDisabled")) {
-      linkRegex = null
+      linkDetector = null
       return
     }
 
+    val caseInsensitive = config.getBoolean("caseInsensitive")
+    val dotAll = config.getBoolean("dotAll")
     var flags = 0
-    if (config.getBoolean("caseInsensitive")) flags = flags or Pattern.CASE_INSENSITIVE
-    if (config.getBoolean("dotAll")) flags = flags or Pattern.DOTALL
+    if (caseInsensitive) flags = flags or Pattern.CASE_INSENSITIVE
+    if (dotAll) flags = flags or Pattern.DOTALL
 
-    try {
-      linkRegex = Pattern.compile("(?s).*?($patternStr).*", flags)
-    } catch (_: PatternSyntaxException) {
-      Log.w(TAG, "Invalid link regex pattern: $patternStr")
-      linkRegex = Patterns.WEB_URL
-    }
+    val pattern =
+      try {
+        Pattern.compile("(?s).*?($patternStr).*", flags)
+      } catch (_: PatternSyntaxException) {
+        Log.w(TAG, "Invalid link regex pattern: $patternStr")
+        return
+      }
+
+    val detector = LinkDetector.compile(patternStr, caseInsensitive, dotAll)
+    linkDetector = detector
+    if (detector == null) linkRegex = pattern
+  }
+
+  // The default detector is shared by all inputs
+  private fun releaseLinkDetector() {
+    linkDetector?.takeIf { it !== LinkDetector.default }?.release()
+  }
+
+  /** Frees the native indexes, history and matchers; called once the view is dropped. */
+  fun releaseNativeResources() {
+    pendingPaste?.cancel()
+    pendingPaste = null
+    history.release()
+    styleIndex.release()
+    paragraphIndex.release()
+    visibleIndex.release()
+    shortcutEngine.release()
+    releaseLinkDetector()
+    linkDetector = null
+    listStyles?.release()
+    parametrizedStyles?.release()
   }
 
   fun setContextMenuItems(items: ReadableArray?) {
@@ -739,8 +858,8 @@ class EnrichedTextInputView :
     val currentText = text ?: return
     val selectedText = currentText.subSequence(start, end).toString().replace(EnrichedConstants.ZWS_STRING, "")
 
-    val visibleStart = start - currentText.zwsCountBefore(start)
-    val visibleEnd = end - currentText.zwsCountBefore(end)
+    val visibleStart = toVisibleIndex(start)
+    val visibleEnd = toVisibleIndex(end)
 
     val reactContext = context as ReactContext
     val surfaceId = UIManagerHelper.getSurfaceId(reactContext)
@@ -884,20 +1003,16 @@ class EnrichedTextInputView :
   }
 
   private fun verifyStyle(name: String): Boolean {
-    val mergingConfig = EnrichedSpans.getMergingConfigForStyle(name, htmlStyle) ?: return true
-    val conflictingStyles = mergingConfig.conflictingStyles
-    val blockingStyles = mergingConfig.blockingStyles
-    val isEnabling = spanState?.getStart(name) == null
+    val spanState = spanState ?: return true
+    val isEnabling = spanState.getStart(name) == null
     if (!isEnabling) return true
 
-    for (style in blockingStyles) {
-      if (spanState?.getStart(style) != null) {
-        spanState.setStart(name, null)
-        return false
-      }
+    if (EnrichedSpans.blocks(name, htmlStyle) and spanState.activeStyles != 0) {
+      spanState.setStart(name, null)
+      return false
     }
 
-    for (style in conflictingStyles) {
+    EnrichedSpans.forEachStyle(EnrichedSpans.conflicts(name, htmlStyle)) { style ->
       val start = selection?.start ?: 0
       val end = selection?.end ?: 0
       val lengthBefore = text?.length ?: 0
@@ -906,7 +1021,7 @@ class EnrichedTextInputView :
         val targetRange = getTargetRange(name)
         val removed = removeStyle(style, targetRange.first, targetRange.second)
         if (removed) {
-          spanState?.setStart(style, null)
+          spanState.setStart(style, null)
         }
       }
 
@@ -1016,6 +1131,37 @@ class EnrichedTextInputView :
     dispatcher?.dispatchEvent(OnRequestHtmlResultEvent(surfaceId, id, requestId, html, experimentalSynchronousEvents))
   }
 
+  fun requestSnapshot(requestId: Int) {
+    val snapshot =
+      try {
+        val bytes = (text ?: SpannableString("")).toDocumentSnapshot().serialize()
+        Base64.encodeToString(bytes, Base64.NO_WRAP)
+      } catch (_: Exception) {
+        null
+      }
+
+    val reactContext = context as ReactContext
+    val surfaceId = UIManagerHelper.getSurfaceId(reactContext)
+    val dispatcher = UIManagerHelper.getEventDispatcherForReactTag(reactContext, id)
+    dispatcher?.dispatchEvent(OnRequestSnapshotResultEvent(surfaceId, id, requestId, snapshot, experimentalSynchronousEvents))
+  }
+
+  fun setSnapshot(value: String) {
+    val spannable =
+      try {
+        DocumentSnapshot.deserialize(Base64.decode(value, Base64.NO_WRAP))?.toSpannable(htmlStyle, spannableFactory)
+      } catch (e: Exception) {
+        Log.e(TAG, "Error restoring snapshot: ${e.message}")
+        null
+      }
+    if (spannable == null) {
+      Log.w(TAG, "Ignoring malformed snapshot")
+      return
+    }
+
+    setValue(spannable, false)
+  }
+
   // Sometimes setting up style triggers many changes in sequence
   // Eg. removing conflicting styles -> changing text -> applying spans
   // In such scenario we want to prevent from handling side effects (eg. onTextChanged)
@@ -1136,6 +1282,7 @@ class EnrichedTextInputView :
   companion object {
     const val TAG = "EnrichedTextInputView"
     private const val CONTEXT_MENU_ITEM_ID = 10000
+    private const val BACKGROUND_NORMALIZATION_THRESHOLD = 16 * 1024
     const val DEFAULT_IME_ACTION_LABEL = "DONE"
   }
 }
@@ -14,10 +14,11 @@ class EnrichedTextInputViewLayoutManager(
     val needUpdate = MeasurementStore.store(view.id, text, paint)
     if (!needUpdate) return
 
-    val counter = forceHeightRecalculationCounter
+    // The counter is part of the measurement cache key, and the initial state
+    // already holds 0, so every update must send a new value.
     forceHeightRecalculationCounter++
     val state = Arguments.createMap()
-    state.putInt("forceHeightRecalculationCounter", counter)
+    state.putInt("forceHeightRecalculationCounter", forceHeightRecalculationCounter)
     view.stateWrapper?.updateState(state)
   }
 
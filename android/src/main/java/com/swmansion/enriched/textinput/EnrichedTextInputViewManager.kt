@@ -27,7 +27,9 @@ import com.swmansion.enriched.textinput.events.OnLinkDetectedEvent
 import com.swmansion.enriched.textinput.events.OnMentionDetectedEvent
 import com.swmansion.enriched.textinput.events.OnMentionEvent
 import com.swmansion.enriched.textinput.events.OnPasteImagesEvent
+import com.swmansion.enriched.textinput.events.OnPastePendingEvent
 import com.swmansion.enriched.textinput.events.OnRequestHtmlResultEvent
+import com.swmansion.enriched.textinput.events.OnRequestSnapshotResultEvent
 import com.swmansion.enriched.textinput.events.OnSubmitEditingEvent
 import com.swmansion.enriched.textinput.spans.EnrichedSpans
 import com.swmansion.enriched.textinput.styles.HtmlStyle
@@ -49,6 +51,7 @@ class EnrichedTextInputViewManager :
   override fun onDropViewInstance(view: EnrichedTextInputView) {
     super.onDropViewInstance(view)
     view.layoutManager.releaseMeasurementStore()
+    view.releaseNativeResources()
   }
 
   override fun updateState(
@@ -72,8 +75,10 @@ class EnrichedTextInputViewManager :
     map.put(OnMentionEvent.EVENT_NAME, mapOf("registrationName" to OnMentionEvent.EVENT_NAME))
     map.put(OnChangeSelectionEvent.EVENT_NAME, mapOf("registrationName" to OnChangeSelectionEvent.EVENT_NAME))
     map.put(OnRequestHtmlResultEvent.EVENT_NAME, mapOf("registrationName" to OnRequestHtmlResultEvent.EVENT_NAME))
+    map.put(OnRequestSnapshotResultEvent.EVENT_NAME, mapOf("registrationName" to OnRequestSnapshotResultEvent.EVENT_NAME))
     map.put(OnInputKeyPressEvent.EVENT_NAME, mapOf("registrationName" to OnInputKeyPressEvent.EVENT_NAME))
     map.put(OnPasteImagesEvent.EVENT_NAME, mapOf("registrationName" to OnPasteImagesEvent.EVENT_NAME))
+    map.put(OnPastePendingEvent.EVENT_NAME, mapOf("registrationName" to OnPastePendingEvent.EVENT_NAME))
     map.put(OnContextMenuItemPressEvent.EVENT_NAME, mapOf("registrationName" to OnContextMenuItemPressEvent.EVENT_NAME))
     map.put(OnSubmitEditingEvent.EVENT_NAME, mapOf("registrationName" to OnSubmitEditingEvent.EVENT_NAME))
 
@@ -472,6 +477,28 @@ class EnrichedTextInputViewManager :
     view?.requestHTML(requestId)
   }
 
+  override fun requestSnapshot(
+    view: EnrichedTextInputView?,
+    requestId: Int,
+  ) {
+    view?.requestSnapshot(requestId)
+  }
+
+  override fun setSnapshot(
+    view: EnrichedTextInputView?,
+    snapshot: String,
+  ) {
+    view?.setSnapshot(snapshot)
+  }
+
+  override fun undo(view: EnrichedTextInputView?) {
+    view?.history?.undo()
+  }
+
+  override fun redo(view: EnrichedTextInputView?) {
+    view?.history?.redo()
+  }
+
   override fun setTextAlignment(
     view: EnrichedTextInputView?,
     alignment: String,
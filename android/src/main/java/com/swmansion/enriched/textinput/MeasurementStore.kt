@@ -115,7 +115,7 @@ object MeasurementStore {
     if (!isHtml) return defaultValue
 
     try {
-      val htmlStyle = HtmlStyle(defaultView, props.getMap("htmlStyle"))
+      val htmlStyle = HtmlStyle.forMeasurement(defaultView, props.getMap("htmlStyle"))
       val factory = EnrichedTextInputSpannableFactory()
       val parsed = EnrichedParser.fromHtml(defaultValue, htmlStyle, factory)
       return parsed.trimEnd('\n')
@@ -4,7 +4,7 @@ import android.text.Editable
 import com.facebook.react.bridge.Arguments
 import com.facebook.react.bridge.WritableMap
 import com.facebook.react.uimanager.events.Event
-import com.swmansion.enriched.common.EnrichedConstants
+import com.swmansion.enriched.common.PlainText
 
 class OnChangeTextEvent(
   surfaceId: Int,
@@ -16,8 +16,7 @@ class OnChangeTextEvent(
 
   override fun getEventData(): WritableMap {
     val eventData: WritableMap = Arguments.createMap()
-    val text = editable.toString()
-    val normalizedText = text.replace(Regex(EnrichedConstants.ZWS_STRING), "")
+    val normalizedText = PlainText.visibleText(editable)
     eventData.putString("value", normalizedText)
     return eventData
   }
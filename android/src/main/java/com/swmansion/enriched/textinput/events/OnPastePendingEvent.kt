@@ -0,0 +1,26 @@
+package com.swmansion.enriched.textinput.events
+
+import com.facebook.react.bridge.Arguments
+import com.facebook.react.bridge.WritableMap
+import com.facebook.react.uimanager.events.Event
+
+class OnPastePendingEvent(
+  surfaceId: Int,
+  viewId: Int,
+  private val isPending: Boolean,
+  private val experimentalSynchronousEvents: Boolean,
+) : Event<OnPastePendingEvent>(surfaceId, viewId) {
+  override fun getEventName(): String = EVENT_NAME
+
+  override fun getEventData(): WritableMap {
+    val eventData: WritableMap = Arguments.createMap()
+    eventData.putBoolean("isPending", isPending)
+    return eventData
+  }
+
+  override fun experimental_isSynchronous(): Boolean = experimentalSynchronousEvents
+
+  companion object {
+    const val EVENT_NAME: String = "onPastePending"
+  }
+}
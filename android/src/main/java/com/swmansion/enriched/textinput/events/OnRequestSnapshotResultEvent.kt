@@ -0,0 +1,32 @@
+package com.swmansion.enriched.textinput.events
+
+import com.facebook.react.bridge.Arguments
+import com.facebook.react.bridge.WritableMap
+import com.facebook.react.uimanager.events.Event
+
+class OnRequestSnapshotResultEvent(
+  surfaceId: Int,
+  viewId: Int,
+  private val requestId: Int,
+  private val snapshot: String?,
+  private val experimentalSynchronousEvents: Boolean,
+) : Event<OnRequestSnapshotResultEvent>(surfaceId, viewId) {
+  override fun getEventName(): String = EVENT_NAME
+
+  override fun getEventData(): WritableMap {
+    val eventData: WritableMap = Arguments.createMap()
+    eventData.putInt("requestId", requestId)
+    if (snapshot != null) {
+      eventData.putString("snapshot", snapshot)
+    } else {
+      eventData.putNull("snapshot")
+    }
+    return eventData
+  }
+
+  override fun experimental_isSynchronous(): Boolean = experimentalSynchronousEvents
+
+  companion object {
+    const val EVENT_NAME: String = "onRequestSnapshotResult"
+  }
+}
@@ -4,6 +4,7 @@ import android.text.Editable
 import com.facebook.react.bridge.Arguments
 import com.facebook.react.bridge.WritableMap
 import com.facebook.react.uimanager.events.Event
+import com.swmansion.enriched.common.PlainText
 
 class OnSubmitEditingEvent(
   surfaceId: Int,
@@ -15,8 +16,7 @@ class OnSubmitEditingEvent(
 
   override fun getEventData(): WritableMap {
     val eventData: WritableMap = Arguments.createMap()
-    val text = editable.toString()
-    val normalizedText = text.replace(Regex("\\u200B"), "")
+    val normalizedText = PlainText.visibleText(editable.toString())
     eventData.putString("text", normalizedText)
     return eventData
   }
@@ -1,5 +1,6 @@
 package com.swmansion.enriched.textinput.spans
 
+import com.swmansion.enriched.common.StyleRules
 import com.swmansion.enriched.textinput.styles.HtmlStyle
 
 interface ISpanConfig {
@@ -15,13 +16,6 @@ data class ParagraphSpanConfig(
   val isContinuous: Boolean,
 ) : ISpanConfig
 
-data class StylesMergingConfig(
-  // styles that should be removed when we apply specific style
-  val conflictingStyles: Array<String> = emptyArray(),
-  // styles that should block setting specific style
-  val blockingStyles: Array<String> = emptyArray(),
-)
-
 object EnrichedSpans {
   // inline styles
   const val BOLD = "bold"
@@ -87,154 +81,82 @@ object EnrichedSpans {
 
   val allSpans: Map<String, ISpanConfig> = inlineSpans + paragraphSpans + listSpans + parametrizedStyles
 
-  fun getMergingConfigForStyle(
+  const val ALIGNMENT_STYLE_TYPE = 5
+
+  // Indexed like StyleType in cpp/document/StyleType.hpp; alignment has no span config
+  private val styleTypes =
+    arrayOf(
+      BLOCK_QUOTE,
+      CODE_BLOCK,
+      UNORDERED_LIST,
+      ORDERED_LIST,
+      CHECKBOX_LIST,
+      null,
+      H1,
+      H2,
+      H3,
+      H4,
+      H5,
+      H6,
+      LINK,
+      MENTION,
+      IMAGE,
+      INLINE_CODE,
+      BOLD,
+      ITALIC,
+      UNDERLINE,
+      STRIKETHROUGH,
+    )
+
+  private val styleIndexes: Map<String, Int> =
+    styleTypes.indices.mapNotNull { i -> styleTypes[i]?.let { it to i } }.toMap()
+
+  private val spanStyleTypes: Map<Class<*>, Int> =
+    allSpans.entries.associate { (name, config) -> config.clazz to (styleIndexes[name] ?: -1) }
+
+  /** cpp/document/StyleType.hpp index of an input span, or -1 for spans that aren't styles. */
+  fun spanStyleType(span: Any): Int =
+    if (span is EnrichedInputAlignmentSpan) ALIGNMENT_STYLE_TYPE else spanStyleTypes[span.javaClass] ?: -1
+
+  /** Bit of [style] in StyleRules masks, or 0 for styles the rules don't cover. */
+  fun styleBit(style: String): Int = styleIndexes[style]?.let { 1 shl it } ?: 0
+
+  /** Calls [action] with the name of every style in [mask]. */
+  inline fun forEachStyle(
+    mask: Int,
+    action: (String) -> Unit,
+  ) {
+    var rest = mask
+    while (rest != 0) {
+      styleName(Integer.numberOfTrailingZeros(rest))?.let(action)
+      rest = rest and (rest - 1)
+    }
+  }
+
+  fun styleName(type: Int): String? = styleTypes.getOrNull(type)
+
+  /** Styles removed when [style] is applied. */
+  fun conflicts(
     style: String,
     htmlStyle: HtmlStyle,
-  ): StylesMergingConfig? =
-    when (style) {
-      BOLD -> {
-        val blockingStyles = mutableListOf(CODE_BLOCK)
-        if (htmlStyle.h1Bold) blockingStyles.add(H1)
-        if (htmlStyle.h2Bold) blockingStyles.add(H2)
-        if (htmlStyle.h3Bold) blockingStyles.add(H3)
-        if (htmlStyle.h4Bold) blockingStyles.add(H4)
-        if (htmlStyle.h5Bold) blockingStyles.add(H5)
-        if (htmlStyle.h6Bold) blockingStyles.add(H6)
-        StylesMergingConfig(blockingStyles = blockingStyles.toTypedArray())
-      }
-
-      ITALIC -> {
-        StylesMergingConfig(
-          blockingStyles = arrayOf(CODE_BLOCK),
-        )
-      }
-
-      UNDERLINE -> {
-        StylesMergingConfig(
-          blockingStyles = arrayOf(CODE_BLOCK),
-        )
-      }
-
-      STRIKETHROUGH -> {
-        StylesMergingConfig(
-          blockingStyles = arrayOf(CODE_BLOCK),
-        )
-      }
-
-      INLINE_CODE -> {
-        StylesMergingConfig(
-          conflictingStyles = arrayOf(MENTION, LINK),
-          blockingStyles = arrayOf(CODE_BLOCK),
-        )
-      }
-
-      H1 -> {
-        val conflictingStyles = mutableListOf(H2, H3, H4, H5, H6, ORDERED_LIST, UNORDERED_LIST, CHECKBOX_LIST, BLOCK_QUOTE, CODE_BLOCK)
-        if (htmlStyle.h1Bold) conflictingStyles.add(BOLD)
-        StylesMergingConfig(conflictingStyles = conflictingStyles.toTypedArray())
-      }
-
-      H2 -> {
-        val conflictingStyles = mutableListOf(H1, H3, H4, H5, H6, ORDERED_LIST, UNORDERED_LIST, CHECKBOX_LIST, BLOCK_QUOTE, CODE_BLOCK)
-        if (htmlStyle.h2Bold) conflictingStyles.add(BOLD)
-        StylesMergingConfig(conflictingStyles = conflictingStyles.toTypedArray())
-      }
-
-      H3 -> {
-        val conflictingStyles = mutableListOf(H1, H2, H4, H5, H6, ORDERED_LIST, UNORDERED_LIST, CHECKBOX_LIST, BLOCK_QUOTE, CODE_BLOCK)
-        if (htmlStyle.h3Bold) conflictingStyles.add(BOLD)
-        StylesMergingConfig(conflictingStyles = conflictingStyles.toTypedArray())
-      }
-
-      H4 -> {
-        val conflictingStyles = mutableListOf(H1, H2, H3, H5, H6, ORDERED_LIST, UNORDERED_LIST, CHECKBOX_LIST, BLOCK_QUOTE, CODE_BLOCK)
-        if (htmlStyle.h4Bold) conflictingStyles.add(BOLD)
-        StylesMergingConfig(conflictingStyles = conflictingStyles.toTypedArray())
-      }
-
-      H5 -> {
-        val conflictingStyles = mutableListOf(H1, H2, H3, H4, H6, ORDERED_LIST, UNORDERED_LIST, CHECKBOX_LIST, BLOCK_QUOTE, CODE_BLOCK)
-        if (htmlStyle.h5Bold) conflictingStyles.add(BOLD)
-        StylesMergingConfig(conflictingStyles = conflictingStyles.toTypedArray())
-      }
-
-      H6 -> {
-        val conflictingStyles = mutableListOf(H1, H2, H3, H4, H5, ORDERED_LIST, UNORDERED_LIST, CHECKBOX_LIST, BLOCK_QUOTE, CODE_BLOCK)
-        if (htmlStyle.h6Bold) conflictingStyles.add(BOLD)
-        StylesMergingConfig(conflictingStyles = conflictingStyles.toTypedArray())
-      }
-
-      BLOCK_QUOTE -> {
-        StylesMergingConfig(
-          conflictingStyles = arrayOf(H1, H2, H3, H4, H5, H6, CODE_BLOCK, ORDERED_LIST, UNORDERED_LIST, CHECKBOX_LIST),
-        )
-      }
-
-      CODE_BLOCK -> {
-        StylesMergingConfig(
-          conflictingStyles =
-            arrayOf(
-              H1,
-              H2,
-              H3,
-              H4,
-              H5,
-              H6,
-              BOLD,
-              ITALIC,
-              UNDERLINE,
-              STRIKETHROUGH,
-              UNORDERED_LIST,
-              ORDERED_LIST,
-              CHECKBOX_LIST,
-              BLOCK_QUOTE,
-              INLINE_CODE,
-              LINK,
-              MENTION,
-            ),
-        )
-      }
-
-      UNORDERED_LIST -> {
-        StylesMergingConfig(
-          conflictingStyles = arrayOf(H1, H2, H3, H4, H5, H6, ORDERED_LIST, CHECKBOX_LIST, CODE_BLOCK, BLOCK_QUOTE),
-        )
-      }
-
-      ORDERED_LIST -> {
-        StylesMergingConfig(
-          conflictingStyles = arrayOf(H1, H2, H3, H4, H5, H6, UNORDERED_LIST, CHECKBOX_LIST, CODE_BLOCK, BLOCK_QUOTE),
-        )
-      }
-
-      CHECKBOX_LIST -> {
-        StylesMergingConfig(
-          conflictingStyles = arrayOf(H1, H2, H3, H4, H5, H6, UNORDERED_LIST, ORDERED_LIST, CODE_BLOCK, BLOCK_QUOTE),
-        )
-      }
-
-      LINK -> {
-        StylesMergingConfig(
-          blockingStyles = arrayOf(INLINE_CODE, CODE_BLOCK, MENTION),
-        )
-      }
-
-      IMAGE -> {
-        StylesMergingConfig(
-          blockingStyles = arrayOf(INLINE_CODE),
-        )
-      }
-
-      MENTION -> {
-        StylesMergingConfig(
-          blockingStyles = arrayOf(INLINE_CODE, CODE_BLOCK, LINK),
-        )
-      }
-
-      else -> {
-        null
-      }
-    }
+  ): Int = styleIndexes[style]?.let { StyleRules.conflicts(it, boldHeadings(htmlStyle)) } ?: 0
+
+  /** Styles that prevent [style] from being applied. */
+  fun blocks(
+    style: String,
+    htmlStyle: HtmlStyle,
+  ): Int = styleIndexes[style]?.let { StyleRules.blocks(it, boldHeadings(htmlStyle)) } ?: 0
+
+  private fun boldHeadings(htmlStyle: HtmlStyle): Int {
+    var mask = 0
+    if (htmlStyle.h1Bold) mask = mask or 1
+    if (htmlStyle.h2Bold) mask = mask or (1 shl 1)
+    if (htmlStyle.h3Bold) mask = mask or (1 shl 2)
+    if (htmlStyle.h4Bold) mask = mask or (1 shl 3)
+    if (htmlStyle.h5Bold) mask = mask or (1 shl 4)
+    if (htmlStyle.h6Bold) mask = mask or (1 shl 5)
+    return mask
+  }
 
   fun isTypeContinuous(type: Class<*>): Boolean = paragraphSpans.values.find { it.clazz == type }?.isContinuous == true
 }
@@ -9,7 +9,6 @@ import com.swmansion.enriched.textinput.spans.EnrichedInputAlignmentSpan
 import com.swmansion.enriched.textinput.spans.EnrichedInputCheckboxListSpan
 import com.swmansion.enriched.textinput.spans.EnrichedInputOrderedListSpan
 import com.swmansion.enriched.textinput.spans.EnrichedInputUnorderedListSpan
-import com.swmansion.enriched.textinput.utils.getParagraphBounds
 import com.swmansion.enriched.textinput.utils.getSafeSpanBoundaries
 import com.swmansion.enriched.textinput.utils.safelyInsertZWS
 
@@ -72,13 +71,13 @@ class AlignmentStyles(
     var expandedEnd = end
 
     // Expand backward through paragraphs of the same list type.
-    var (currentParaStart, currentParaEnd) = spannable.getParagraphBounds(start)
+    var (currentParaStart, currentParaEnd) = view.paragraphBounds(spannable, start)
     val activeStartType = getActiveListSpanType(spannable, currentParaStart, currentParaEnd)
 
     if (activeStartType != null) {
       expandedStart = currentParaStart
       while (currentParaStart > 0) {
-        val (prevParaStart, prevParaEnd) = spannable.getParagraphBounds(currentParaStart - 1)
+        val (prevParaStart, prevParaEnd) = view.paragraphBounds(spannable, currentParaStart - 1)
         if (getActiveListSpanType(spannable, prevParaStart, prevParaEnd) == activeStartType) {
           expandedStart = prevParaStart
           currentParaStart = prevParaStart
@@ -90,7 +89,7 @@ class AlignmentStyles(
 
     // Expand forward through paragraphs of the same list type.
     val endLoc = if (end > start) end - 1 else start
-    var (endParaStart, endParaEnd) = spannable.getParagraphBounds(endLoc)
+    var (endParaStart, endParaEnd) = view.paragraphBounds(spannable, endLoc)
     val activeEndType = getActiveListSpanType(spannable, endParaStart, endParaEnd)
 
     if (activeEndType != null) {
@@ -99,7 +98,7 @@ class AlignmentStyles(
         val nextCursor = endParaEnd + 1
         if (nextCursor >= spannable.length) break
 
-        val (nextParaStart, nextParaEnd) = spannable.getParagraphBounds(nextCursor)
+        val (nextParaStart, nextParaEnd) = view.paragraphBounds(spannable, nextCursor)
         if (getActiveListSpanType(spannable, nextParaStart, nextParaEnd) == activeEndType) {
           expandedEnd = nextParaEnd
           endParaEnd = nextParaEnd
@@ -134,8 +133,8 @@ class AlignmentStyles(
     // Exit early if no alignment spans exist in the current or previous paragraph.
     if (anchorAlignmentToRestore == null) {
       val bounded = activeCursor.coerceIn(0, s.length)
-      val (paraStart, paraEnd) = s.getParagraphBounds(bounded)
-      val prevStart = if (paraStart > 0) s.getParagraphBounds(paraStart - 1).first else 0
+      val (paraStart, paraEnd) = view.paragraphBounds(s, bounded)
+      val prevStart = if (paraStart > 0) view.paragraphBounds(s, paraStart - 1).first else 0
       if (s.getSpans(prevStart, paraEnd, EnrichedInputAlignmentSpan::class.java).isEmpty()) {
         view.selection?.validateStyles()
         return
@@ -146,7 +145,7 @@ class AlignmentStyles(
       activeCursor = handleNewlineInheritance(s, activeCursor, isOtherStyleInjectedZws)
       autoStretchAlignmentSpan(s, activeCursor)
     } else if (isZwsDeleted && anchorAlignmentToRestore != null) {
-      val (paraStart, paraEnd) = s.getParagraphBounds(activeCursor)
+      val (paraStart, paraEnd) = view.paragraphBounds(s, activeCursor)
       (s as SpannableStringBuilder).safelyInsertZWS(activeCursor)
       if (paraStart == paraEnd) {
         setAlignmentSpan(s, anchorAlignmentToRestore, activeCursor, activeCursor + 1)
@@ -177,7 +176,7 @@ class AlignmentStyles(
     s: Editable,
     activeCursor: Int,
   ) {
-    val (paraStart, paraEnd) = s.getParagraphBounds(activeCursor)
+    val (paraStart, paraEnd) = view.paragraphBounds(s, activeCursor)
     val spans = s.getSpans(paraStart, paraEnd, EnrichedInputAlignmentSpan::class.java)
 
     if (spans.isEmpty()) return
@@ -223,7 +222,7 @@ class AlignmentStyles(
     var cursor = start
 
     while (cursor <= shiftedEnd) {
-      val (paraStart, paraEnd) = spannable.getParagraphBounds(cursor)
+      val (paraStart, paraEnd) = view.paragraphBounds(spannable, cursor)
 
       cleanUpExistingSpans(spannable, paraStart, paraEnd)
 
@@ -255,7 +254,7 @@ class AlignmentStyles(
     val selection = view.selection ?: return "auto"
 
     val cursorPos = selection.start.coerceAtLeast(0).coerceAtMost(spannable.length)
-    val (paraStart, paraEnd) = spannable.getParagraphBounds(cursorPos)
+    val (paraStart, paraEnd) = view.paragraphBounds(spannable, cursorPos)
     val spans = spannable.getSpans(paraStart, paraEnd, EnrichedInputAlignmentSpan::class.java)
 
     return spans.firstOrNull()?.cssValue ?: "auto"
@@ -266,7 +265,7 @@ class AlignmentStyles(
     cursorPosition: Int,
   ): Int {
     if (cursorPosition > 0 && s[cursorPosition - 1] == '\n') {
-      val (currentParaStart, currentParaEnd) = s.getParagraphBounds(cursorPosition)
+      val (currentParaStart, currentParaEnd) = view.paragraphBounds(s, cursorPosition)
       s
         .getSpans(currentParaStart, currentParaEnd, EnrichedInputAlignmentSpan::class.java)
         .forEach { s.removeSpan(it) }
@@ -274,7 +273,7 @@ class AlignmentStyles(
       view.setSelection(cursorPosition - 1)
       return cursorPosition - 1
     } else if (cursorPosition == 0) {
-      val (paraStart, paraEnd) = s.getParagraphBounds(0)
+      val (paraStart, paraEnd) = view.paragraphBounds(s, 0)
       s
         .getSpans(paraStart, paraEnd, EnrichedInputAlignmentSpan::class.java)
         .forEach { s.removeSpan(it) }
@@ -287,7 +286,7 @@ class AlignmentStyles(
     s: Editable,
     cursorPosition: Int,
   ): Int {
-    val (paraStart, paraEnd) = s.getParagraphBounds(cursorPosition)
+    val (paraStart, paraEnd) = view.paragraphBounds(s, cursorPosition)
     val spans = s.getSpans(paraStart, paraEnd, EnrichedInputAlignmentSpan::class.java)
     var dominantTopSpan: EnrichedInputAlignmentSpan? = null
 
@@ -314,13 +313,13 @@ class AlignmentStyles(
     val prevCharIndex = (if (isZwsInjected) cursorPosition - 2 else cursorPosition - 1) - 1
     if (prevCharIndex < 0) return cursorPosition
 
-    val (prevParaStart, prevParaEnd) = s.getParagraphBounds(prevCharIndex)
+    val (prevParaStart, prevParaEnd) = view.paragraphBounds(s, prevCharIndex)
     val prevSpan =
       s
         .getSpans(prevParaStart, prevParaEnd, EnrichedInputAlignmentSpan::class.java)
         .firstOrNull() ?: return cursorPosition
 
-    val (newParaStart, newParaEnd) = s.getParagraphBounds(cursorPosition)
+    val (newParaStart, newParaEnd) = view.paragraphBounds(s, cursorPosition)
 
     return if (newParaStart == newParaEnd) {
       (s as SpannableStringBuilder).safelyInsertZWS(cursorPosition)
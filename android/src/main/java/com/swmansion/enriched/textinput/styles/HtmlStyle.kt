@@ -82,6 +82,12 @@ class HtmlStyle : EnrichedStyle {
   fun invalidateStyles() {
     val style = this.style ?: return
 
+    parseLayoutStyles(style)
+    parsePaintStyles(style)
+  }
+
+  // Everything that changes line breaks or leading margins
+  private fun parseLayoutStyles(style: ReadableMap) {
     val h1Style = style.getMap("h1")
     h1FontSize = parseFloat(h1Style, "fontSize").toInt()
     h1Bold = h1Style?.getBoolean("bold") == true
@@ -107,8 +113,6 @@ class HtmlStyle : EnrichedStyle {
     h6Bold = h6Style?.getBoolean("bold") == true
 
     val blockquoteStyle = style.getMap("blockquote")
-    blockquoteColor = parseOptionalColor(blockquoteStyle, "color")
-    blockquoteBorderColor = parseColor(blockquoteStyle, "borderColor")
     blockquoteGapWidth = parseFloat(blockquoteStyle, "gapWidth").toInt()
     blockquoteStripeWidth = parseFloat(blockquoteStyle, "borderWidth").toInt()
 
@@ -117,11 +121,8 @@ class HtmlStyle : EnrichedStyle {
     val calculatedMarginLeft = calculateOlMarginLeft(view, userDefinedMarginLeft)
     olMarginLeft = calculatedMarginLeft
     olGapWidth = parseFloat(olStyle, "gapWidth").toInt()
-    olMarkerColor = parseOptionalColor(olStyle, "markerColor")
-    olMarkerFontWeight = parseOptionalFontWeight(olStyle, "markerFontWeight")
 
     val ulStyle = style.getMap("ul")
-    ulBulletColor = parseColor(ulStyle, "bulletColor")
     ulGapWidth = parseFloat(ulStyle, "gapWidth").toInt()
     ulMarginLeft = parseFloat(ulStyle, "marginLeft").toInt()
     ulBulletSize = parseFloat(ulStyle, "bulletSize").toInt()
@@ -130,6 +131,21 @@ class HtmlStyle : EnrichedStyle {
     ulCheckboxBoxSize = parseFloat(ulCheckboxStyle, "boxSize").toInt()
     ulCheckboxGapWidth = parseFloat(ulCheckboxStyle, "gapWidth").toInt()
     ulCheckboxMarginLeft = parseFloat(ulCheckboxStyle, "marginLeft").toInt()
+  }
+
+  private fun parsePaintStyles(style: ReadableMap) {
+    val blockquoteStyle = style.getMap("blockquote")
+    blockquoteColor = parseOptionalColor(blockquoteStyle, "color")
+    blockquoteBorderColor = parseColor(blockquoteStyle, "borderColor")
+
+    val olStyle = style.getMap("ol")
+    olMarkerColor = parseOptionalColor(olStyle, "markerColor")
+    olMarkerFontWeight = parseOptionalFontWeight(olStyle, "markerFontWeight")
+
+    val ulStyle = style.getMap("ul")
+    ulBulletColor = parseColor(ulStyle, "bulletColor")
+
+    val ulCheckboxStyle = style.getMap("ulCheckbox")
     ulCheckboxBoxColor = parseColor(ulCheckboxStyle, "boxColor")
 
     val aStyle = style.getMap("a")
@@ -368,4 +384,16 @@ class HtmlStyle : EnrichedStyle {
 
     return result
   }
+
+  companion object {
+    // Reads the layout-only htmlStyle the Fabric measurement manager passes (see conversions.h).
+    // Paint-only fields keep their defaults, they don't change the measured size.
+    fun forMeasurement(
+      view: EnrichedTextInputView,
+      style: ReadableMap?,
+    ): HtmlStyle =
+      HtmlStyle(view, null).apply {
+        if (style != null) parseLayoutStyles(style)
+      }
+  }
 }
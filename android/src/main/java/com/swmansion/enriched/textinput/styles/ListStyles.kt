@@ -5,12 +5,12 @@ import android.text.Spannable
 import android.text.SpannableStringBuilder
 import android.text.Spanned
 import com.swmansion.enriched.common.EnrichedConstants
+import com.swmansion.enriched.common.ListNumbering
 import com.swmansion.enriched.textinput.EnrichedTextInputView
 import com.swmansion.enriched.textinput.spans.EnrichedInputCheckboxListSpan
 import com.swmansion.enriched.textinput.spans.EnrichedInputOrderedListSpan
 import com.swmansion.enriched.textinput.spans.EnrichedInputUnorderedListSpan
 import com.swmansion.enriched.textinput.spans.EnrichedSpans
-import com.swmansion.enriched.textinput.utils.getParagraphBounds
 import com.swmansion.enriched.textinput.utils.getSafeSpanBoundaries
 import com.swmansion.enriched.textinput.utils.safelyInsertZWS
 import com.swmansion.enriched.textinput.utils.safelyRemoveZWS
@@ -18,6 +18,12 @@ import com.swmansion.enriched.textinput.utils.safelyRemoveZWS
 class ListStyles(
   private val view: EnrichedTextInputView,
 ) {
+  private val numbering = ListNumbering()
+
+  fun release() {
+    numbering.release()
+  }
+
   private fun <T> getPreviousParagraphSpan(
     spannable: Spannable,
     s: Int,
@@ -25,7 +31,7 @@ class ListStyles(
   ): T? {
     if (s <= 0) return null
 
-    val (previousParagraphStart, previousParagraphEnd) = spannable.getParagraphBounds(s - 1)
+    val (previousParagraphStart, previousParagraphEnd) = view.paragraphBounds(spannable, s - 1)
     val spans = spannable.getSpans(previousParagraphStart, previousParagraphEnd, type)
 
     if (spans.isNotEmpty()) {
@@ -103,16 +109,72 @@ class ListStyles(
     return true
   }
 
+  private fun syncedNumbering(text: Spannable): ListNumbering {
+    if (numbering.length != text.length) {
+      numbering.reset(text)
+      for (span in text.getSpans(0, text.length, EnrichedInputOrderedListSpan::class.java)) {
+        numbering.setItem(numbering.paragraphAt(text.getSpanStart(span)), true)
+      }
+    }
+    return numbering
+  }
+
+  fun onTextChanged(
+    s: CharSequence,
+    start: Int,
+    before: Int,
+    count: Int,
+  ) {
+    // Out of step (e.g. before the first edit): syncedNumbering rebuilds it
+    val (first, touched) = numbering.applyEdit(start, before, s, count) ?: return
+    if (count == 0 || s !is Spanned) return
+
+    // Inserted text can bring its own items: setValue and paste set a whole spanned text inside a
+    // transaction, which reports no added spans and skips afterTextChanged. Re-read the touched
+    // paragraphs from the spans so later edits don't number from a stale state.
+    for (paragraph in first until first + touched) {
+      numbering.setItem(paragraph, false)
+    }
+    val spans =
+      s.getSpans(
+        numbering.paragraphStart(first),
+        numbering.paragraphEnd(first + touched - 1),
+        EnrichedInputOrderedListSpan::class.java,
+      )
+    for (span in spans) {
+      numbering.setItem(numbering.paragraphAt(s.getSpanStart(span)), true)
+    }
+  }
+
   fun updateOrderedListIndexes(
     text: Spannable,
     position: Int,
   ) {
-    val spans = text.getSpans(position + 1, text.length, EnrichedInputOrderedListSpan::class.java)
-    val sortedSpans = spans.sortedBy { text.getSpanStart(it) }
-    for (span in sortedSpans) {
-      val spanStart = text.getSpanStart(span)
-      val index = getOrderedListIndex(text, spanStart)
-      span.setListIndex(index)
+    val numbering = syncedNumbering(text)
+    val changed = numbering.paragraphAt(position.coerceIn(0, text.length))
+
+    // Numbers only change from the edited paragraph on, and only until an item
+    // that already has the right one or the end of the list
+    var paragraph = maxOf(0, changed - 1)
+    while (paragraph < numbering.paragraphCount) {
+      val start = numbering.paragraphStart(paragraph)
+      val end = numbering.paragraphEnd(paragraph)
+      val spans = text.getSpans(start, end, EnrichedInputOrderedListSpan::class.java)
+      numbering.setItem(paragraph, spans.isNotEmpty())
+
+      if (spans.isEmpty()) {
+        if (paragraph > changed) break
+        paragraph++
+        continue
+      }
+
+      val index = numbering.number(paragraph)
+      val isUpToDate = spans.all { it.getListIndex() == index }
+      for (span in spans) {
+        span.setListIndex(index)
+      }
+      if (isUpToDate && paragraph > changed) break
+      paragraph++
     }
   }
 
@@ -178,7 +240,7 @@ class ListStyles(
   ) {
     val config = EnrichedSpans.listSpans[name] ?: return
     val cursorPosition = endCursorPosition.coerceAtMost(s.length)
-    val (start, end) = s.getParagraphBounds(cursorPosition)
+    val (start, end) = view.paragraphBounds(s, cursorPosition)
 
     val isBackspace = previousTextLength > s.length
     val isNewLine = cursorPosition > 0 && s[cursorPosition - 1] == '\n'
@@ -244,6 +306,8 @@ class ListStyles(
     handleAfterTextChanged(s, EnrichedSpans.ORDERED_LIST, endCursorPosition, previousTextLength)
     handleAfterTextChanged(s, EnrichedSpans.UNORDERED_LIST, endCursorPosition, previousTextLength)
     handleAfterTextChanged(s, EnrichedSpans.CHECKBOX_LIST, endCursorPosition, previousTextLength)
+    // Joining or splitting paragraphs can move items without touching their spans
+    updateOrderedListIndexes(s, endCursorPosition)
   }
 
   fun getStyleRange(): Pair<Int, Int> = view.selection?.getParagraphSelection() ?: Pair(0, 0)
@@ -7,7 +7,6 @@ import android.util.Log
 import com.swmansion.enriched.textinput.EnrichedTextInputView
 import com.swmansion.enriched.textinput.spans.EnrichedSpans
 import com.swmansion.enriched.textinput.spans.interfaces.EnrichedInputSpan
-import com.swmansion.enriched.textinput.utils.getParagraphBounds
 import com.swmansion.enriched.textinput.utils.getSafeSpanBoundaries
 import com.swmansion.enriched.textinput.utils.safelyInsertZWS
 import com.swmansion.enriched.textinput.utils.safelyRemoveZWS
@@ -22,7 +21,7 @@ class ParagraphStyles(
   ): T? {
     if (paragraphStart <= 0) return null
 
-    val (previousParagraphStart, previousParagraphEnd) = spannable.getParagraphBounds(paragraphStart - 1)
+    val (previousParagraphStart, previousParagraphEnd) = view.paragraphBounds(spannable, paragraphStart - 1)
     val spans = spannable.getSpans(previousParagraphStart, previousParagraphEnd, type)
 
     // A paragraph implies a single cohesive style. having multiple spans of the
@@ -45,7 +44,7 @@ class ParagraphStyles(
   ): T? {
     if (paragraphEnd >= spannable.length - 1) return null
 
-    val (nextParagraphStart, nextParagraphEnd) = spannable.getParagraphBounds(paragraphEnd + 1)
+    val (nextParagraphStart, nextParagraphEnd) = view.paragraphBounds(spannable, paragraphEnd + 1)
 
     val spans = spannable.getSpans(nextParagraphStart, nextParagraphEnd, type)
 
@@ -213,7 +212,7 @@ class ParagraphStyles(
     endCursorPosition: Int,
     type: Class<T>,
   ) {
-    val (start, end) = s.getParagraphBounds(endCursorPosition)
+    val (start, end) = view.paragraphBounds(s, endCursorPosition)
     val currParagraphSpans = s.getSpans(start, end, type)
 
     if (currParagraphSpans.isEmpty()) {
@@ -242,22 +241,21 @@ class ParagraphStyles(
     paragraphEnd: Int,
   ): Boolean {
     val spanState = view.spanState ?: return false
-    val mergingConfig = EnrichedSpans.getMergingConfigForStyle(style, view.htmlStyle) ?: return false
     var isConflicting = false
-    val stylesToCheck = mergingConfig.blockingStyles + mergingConfig.conflictingStyles
+    val stylesToCheck = EnrichedSpans.blocks(style, view.htmlStyle) or EnrichedSpans.conflicts(style, view.htmlStyle)
 
-    for (styleToCheck in stylesToCheck) {
-      val conflictingType = EnrichedSpans.allSpans[styleToCheck]?.clazz ?: continue
+    EnrichedSpans.forEachStyle(stylesToCheck) { styleToCheck ->
+      val conflictingType = EnrichedSpans.allSpans[styleToCheck]?.clazz ?: return@forEachStyle
 
       val spans = s.getSpans(paragraphStart, paragraphEnd, conflictingType)
       if (spans.isEmpty()) {
-        continue
+        return@forEachStyle
       }
       isConflicting = true
 
       val isParagraphStyle = EnrichedSpans.paragraphSpans[styleToCheck] != null
       if (!isParagraphStyle) {
-        continue
+        return@forEachStyle
       }
 
       for (span in spans) {
@@ -281,11 +279,10 @@ class ParagraphStyles(
     paragraphStart: Int,
     paragraphEnd: Int,
   ) {
-    val mergingConfig = EnrichedSpans.getMergingConfigForStyle(style, view.htmlStyle) ?: return
-    val stylesToCheck = mergingConfig.blockingStyles + mergingConfig.conflictingStyles
+    val stylesToCheck = EnrichedSpans.blocks(style, view.htmlStyle) or EnrichedSpans.conflicts(style, view.htmlStyle)
 
-    for (styleToCheck in stylesToCheck) {
-      val conflictingType = EnrichedSpans.allSpans[styleToCheck]?.clazz ?: continue
+    EnrichedSpans.forEachStyle(stylesToCheck) { styleToCheck ->
+      val conflictingType = EnrichedSpans.allSpans[styleToCheck]?.clazz ?: return@forEachStyle
 
       val spans = s.getSpans(paragraphStart, paragraphEnd, conflictingType)
       for (span in spans) {
@@ -321,7 +318,7 @@ class ParagraphStyles(
 
       if (styleStart == null) {
         if (isBackspace) {
-          val (start, end) = s.getParagraphBounds(endCursorPosition)
+          val (start, end) = view.paragraphBounds(s, endCursorPosition)
           val spans = s.getSpans(start, end, config.clazz)
 
           for (span in spans) {
@@ -340,7 +337,7 @@ class ParagraphStyles(
       if (isNewLine) {
         // If removing text at the beginning of the line, we want to remove the span for the whole paragraph
         if (isBackspace) {
-          val currentParagraphBounds = s.getParagraphBounds(endCursorPosition)
+          val currentParagraphBounds = view.paragraphBounds(s, endCursorPosition)
           removeSpansForRange(s, currentParagraphBounds.first, currentParagraphBounds.second, config.clazz)
           spanState.setStart(style, null)
           continue
@@ -356,7 +353,7 @@ class ParagraphStyles(
         endCursorPosition += shift
       }
 
-      var (start, end) = s.getParagraphBounds(styleStart, endCursorPosition)
+      var (start, end) = view.paragraphBounds(s, styleStart, endCursorPosition)
 
       // handle conflicts when deleting newline from paragraph style (going back to previous line)
       if (isBackspace && styleStart != start) {
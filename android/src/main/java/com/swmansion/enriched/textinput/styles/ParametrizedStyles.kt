@@ -5,6 +5,8 @@ import android.text.Spannable
 import android.text.SpannableStringBuilder
 import android.text.Spanned
 import com.swmansion.enriched.common.EnrichedConstants
+import com.swmansion.enriched.common.MentionMatcher
+import com.swmansion.enriched.common.TextSegmenter
 import com.swmansion.enriched.textinput.EnrichedTextInputView
 import com.swmansion.enriched.textinput.spans.EnrichedInputImageSpan
 import com.swmansion.enriched.textinput.spans.EnrichedInputLinkSpan
@@ -19,7 +21,18 @@ class ParametrizedStyles(
   private var mentionStart: Int? = null
   private var isSettingLinkSpan = false
 
-  var mentionIndicators: Array<String> = emptyArray<String>()
+  private var mentionMatcher = MentionMatcher(emptyArray())
+
+  var mentionIndicators: Array<String>
+    get() = mentionMatcher.indicators
+    set(value) {
+      mentionMatcher.release()
+      mentionMatcher = MentionMatcher(value)
+    }
+
+  fun release() {
+    mentionMatcher.release()
+  }
 
   fun <T> removeSpansForRange(
     spannable: Spannable,
@@ -101,8 +114,8 @@ class ParametrizedStyles(
   ) {
     // Run afterTextChangedLinks on the range affected by the style toggle to re-detect links.
     // For example, toggling a code block on and off will restore automatically detected links.
-    val linkConfig = EnrichedSpans.getMergingConfigForStyle(EnrichedSpans.LINK, view.htmlStyle) ?: return
-    if (name in linkConfig.blockingStyles || name in linkConfig.conflictingStyles) {
+    val linkRules = EnrichedSpans.blocks(EnrichedSpans.LINK, view.htmlStyle) or EnrichedSpans.conflicts(EnrichedSpans.LINK, view.htmlStyle)
+    if (linkRules and EnrichedSpans.styleBit(name) != 0) {
       afterTextChangedLinks(start, end)
     }
   }
@@ -112,7 +125,9 @@ class ParametrizedStyles(
     start: Int,
     end: Int,
   ) {
-    val regex = view.linkRegex ?: return
+    val detector = view.linkDetector
+    val regex = view.linkRegex
+    if (detector == null && regex == null) return
     val textLength = spannable.length
     val safeStart = minOf(start, end).coerceIn(0, textLength)
     val safeEnd = maxOf(start, end).coerceIn(0, textLength)
@@ -126,10 +141,21 @@ class ParametrizedStyles(
       spannable.removeSpan(span)
     }
 
-    val wordsRegex = Regex("\\S+")
-    for (wordMatch in wordsRegex.findAll(contextText)) {
-      var word = wordMatch.value
-      var wordStart = wordMatch.range.first
+    if (detector != null) {
+      // The native detector splits words and skips zero-width spaces itself
+      val links = detector.detect(contextText)
+      for (i in links.indices step 2) {
+        val url = contextText.substring(links[i], links[i + 1])
+        addAutomaticLink(spannable, start + links[i], start + links[i + 1], url)
+      }
+      return
+    }
+
+    val fallbackRegex = regex ?: return
+    val words = TextSegmenter.tokensIn(contextText)
+    for (i in words.indices step 2) {
+      var word = contextText.substring(words[i], words[i + 1])
+      var wordStart = words[i]
 
       // Do not include zero-width space in link detection
       if (word.startsWith(EnrichedConstants.ZWS_STRING)) {
@@ -137,52 +163,44 @@ class ParametrizedStyles(
         wordStart += 1
       }
 
-      // Loop over words and detect links
-      val matcher = regex.matcher(word)
-      while (matcher.find()) {
-        val linkStart = matcher.start()
-        val linkEnd = matcher.end()
-
-        val spanStart = start + wordStart + linkStart
-        val spanEnd = start + wordStart + linkEnd
-
-        val (safeStart, safeEnd) = spannable.getSafeSpanBoundaries(spanStart, spanEnd)
-
-        // Do not overwrite a manual link span with an auto-detected one
-        val overlappingManual =
-          spannable
-            .getSpans(safeStart, safeEnd, EnrichedInputLinkSpan::class.java)
-            .any { it.getIsManual() }
-        if (overlappingManual) continue
-
-        val span = EnrichedInputLinkSpan(matcher.group(), view.htmlStyle)
-        spannable.setSpan(
-          span,
-          safeStart,
-          safeEnd,
-          Spanned.SPAN_EXCLUSIVE_EXCLUSIVE,
-        )
+      // Like the native detector and iOS, a matching word becomes a link as a whole
+      if (word.isNotEmpty() && fallbackRegex.matcher(word).find()) {
+        addAutomaticLink(spannable, start + wordStart, start + wordStart + word.length, word)
       }
     }
   }
 
+  private fun addAutomaticLink(
+    spannable: Spannable,
+    spanStart: Int,
+    spanEnd: Int,
+    url: String,
+  ) {
+    val (safeStart, safeEnd) = spannable.getSafeSpanBoundaries(spanStart, spanEnd)
+
+    // Do not overwrite a manual link span with an auto-detected one
+    val overlappingManual =
+      spannable
+        .getSpans(safeStart, safeEnd, EnrichedInputLinkSpan::class.java)
+        .any { it.getIsManual() }
+    if (overlappingManual) return
+
+    val span = EnrichedInputLinkSpan(url, view.htmlStyle)
+    spannable.setSpan(
+      span,
+      safeStart,
+      safeEnd,
+      Spanned.SPAN_EXCLUSIVE_EXCLUSIVE,
+    )
+  }
+
   private fun getWordAtIndex(
     s: CharSequence,
     index: Int,
   ): TextRange? {
     if (index < 0) return null
 
-    var start = index
-    var end = index
-
-    while (start > 0 && !Character.isWhitespace(s[start - 1])) {
-      start--
-    }
-
-    while (end < s.length && !Character.isWhitespace(s[end])) {
-      end++
-    }
-
+    val (start, end) = TextSegmenter.tokenAt(s, index)
     val result = s.subSequence(start, end).toString()
 
     return TextRange(result, start, end)
@@ -195,36 +213,17 @@ class ParametrizedStyles(
     start: Int,
     end: Int,
   ): IntRange {
-    var actualStart = start
-    var actualEnd = end
-
-    // Expand backward to find the start of the first affected word
-    while (actualStart > 0 && !Character.isWhitespace(s[actualStart - 1])) {
-      actualStart--
-    }
-
-    // Expand forward to find the end of the last affected word
-    while (actualEnd < s.length && !Character.isWhitespace(s[actualEnd])) {
-      actualEnd++
-    }
-
+    val actualStart = TextSegmenter.tokenAt(s, start).first
+    val actualEnd = TextSegmenter.tokenAt(s, end).second
     return actualStart..actualEnd
   }
 
   private fun canLinkBeApplied(): Boolean {
-    val mergingConfig = EnrichedSpans.getMergingConfigForStyle(EnrichedSpans.LINK, view.htmlStyle) ?: return true
-    val conflictingStyles = mergingConfig.conflictingStyles
-    val blockingStyles = mergingConfig.blockingStyles
-
-    for (style in blockingStyles) {
-      if (view.spanState?.getStart(style) != null) return false
-    }
+    val activeStyles = view.spanState?.activeStyles ?: return true
+    // A detected link replaces the one being edited
+    val conflicts = EnrichedSpans.conflicts(EnrichedSpans.LINK, view.htmlStyle) and EnrichedSpans.styleBit(EnrichedSpans.LINK).inv()
 
-    for (style in conflictingStyles) {
-      if (view.spanState?.getStart(style) != null) return false
-    }
-
-    return true
+    return (EnrichedSpans.blocks(EnrichedSpans.LINK, view.htmlStyle) or conflicts) and activeStyles == 0
   }
 
   private fun afterTextChangedLinks(
@@ -247,16 +246,12 @@ class ParametrizedStyles(
     val currentWord = getWordAtIndex(s, endCursorPosition) ?: return
     val spannable = view.text as Spannable
 
-    val indicatorsPattern = mentionIndicators.joinToString("|") { Regex.escape(it) }
-    val mentionIndicatorRegex = Regex("^($indicatorsPattern)")
-    val mentionRegex = Regex("^($indicatorsPattern)\\S*")
-
-    var indicator: String
+    var indicator = mentionMatcher.indicatorAtStart(currentWord.text)
     var finalStart: Int
     val finalEnd = currentWord.end
 
     // No mention in the current word, check previous one
-    if (!mentionRegex.matches(currentWord.text)) {
+    if (indicator == null) {
       val previousWord = getWordAtIndex(spannable, currentWord.start - 1)
 
       // No previous word -> no mention to be detected
@@ -266,18 +261,17 @@ class ParametrizedStyles(
       }
 
       // Previous word is not a mention -> end mention
-      if (!mentionRegex.matches(previousWord.text)) {
+      indicator = mentionMatcher.indicatorAtStart(previousWord.text)
+      if (indicator == null) {
         mentionHandler.endMention()
         return
       }
 
       // Previous word is a mention -> use it
       finalStart = previousWord.start
-      indicator = mentionIndicatorRegex.find(previousWord.text)?.value ?: ""
     } else {
       // Current word is a mention -> use it
       finalStart = currentWord.start
-      indicator = mentionIndicatorRegex.find(currentWord.text)?.value ?: ""
     }
 
     // Mirror iOS conflicting-styles behaviour: check the full candidate range for
@@ -0,0 +1,242 @@
+package com.swmansion.enriched.textinput.utils
+
+import android.text.Spannable
+import android.text.SpannableStringBuilder
+import android.text.Spanned
+import com.swmansion.enriched.common.BlobStore
+import com.swmansion.enriched.common.DocumentSnapshot
+import com.swmansion.enriched.common.parser.EnrichedSpanFactory
+import com.swmansion.enriched.common.spans.EnrichedAlignmentSpan
+import com.swmansion.enriched.common.spans.EnrichedCheckboxListSpan
+import com.swmansion.enriched.common.spans.EnrichedImageSpan
+import com.swmansion.enriched.common.spans.EnrichedLinkSpan
+import com.swmansion.enriched.common.spans.EnrichedMentionSpan
+import com.swmansion.enriched.textinput.spans.EnrichedSpans
+import com.swmansion.enriched.textinput.spans.interfaces.EnrichedInputSpan
+import com.swmansion.enriched.textinput.styles.HtmlStyle
+import org.json.JSONObject
+
+// Payloads are shared with iOS: the href for links, the CSS value for alignment, "checked" for
+// checked checkbox items and JSON objects for mentions and images. Like exported HTML, a snapshot
+// stands on its own, so blob store images are stored as their data: URIs.
+private const val CHECKED = "checked"
+
+/** Text and spans of the input as a snapshot. */
+fun Spanned.toDocumentSnapshot(): DocumentSnapshot {
+  val strings = mutableListOf<String>()
+  val stringIndexes = HashMap<String, Int>()
+  fun intern(value: String): Int = stringIndexes.getOrPut(value) { strings.add(value).let { strings.size - 1 } }
+
+  val spans = getSpans(0, length, EnrichedInputSpan::class.java)
+  val runs = IntArray(spans.size * 4)
+  var runCount = 0
+  for (span in spans) {
+    val start = getSpanStart(span)
+    val end = getSpanEnd(span)
+    if (start < 0 || end <= start) continue
+
+    val type = EnrichedSpans.spanStyleType(span)
+    if (type < 0) continue
+
+    val payload = spanPayload(span, exportBlobs = true)
+
+    runs[runCount * 4] = start
+    runs[runCount * 4 + 1] = end - start
+    runs[runCount * 4 + 2] = type
+    runs[runCount * 4 + 3] = payload?.let { intern(it) } ?: DocumentSnapshot.NO_STRING
+    runCount++
+  }
+
+  return DocumentSnapshot(toString(), runs.copyOf(runCount * 4), strings.toTypedArray())
+}
+
+/**
+ * The payload a span is stored with, null for spans without one. Blob store images keep their
+ * short handle unless [exportBlobs] is set.
+ */
+internal fun spanPayload(
+  span: Any,
+  exportBlobs: Boolean = false,
+): String? =
+  when (span) {
+    is EnrichedLinkSpan -> {
+      span.getUrl()
+    }
+
+    is EnrichedMentionSpan -> {
+      JSONObject()
+        .put("text", span.getText())
+        .put("indicator", span.getIndicator())
+        .put("attributes", JSONObject(span.getAttributes()))
+        .toString()
+    }
+
+    is EnrichedImageSpan -> {
+      JSONObject()
+        .put("uri", span.source?.let { if (exportBlobs) BlobStore.exportSource(it) else it } ?: "")
+        .put("width", span.getWidth())
+        .put("height", span.getHeight())
+        .toString()
+    }
+
+    is EnrichedCheckboxListSpan -> {
+      if (span.isChecked) CHECKED else null
+    }
+
+    is EnrichedAlignmentSpan -> {
+      span.cssValue
+    }
+
+    else -> {
+      null
+    }
+  }
+
+/** iOS stores one run for neighbouring paragraphs with the same style, Android one span per paragraph. */
+internal fun isPerParagraphStyle(type: Int): Boolean {
+  val name = EnrichedSpans.styleName(type)
+  return type == EnrichedSpans.ALIGNMENT_STYLE_TYPE ||
+    (name != null && (name in EnrichedSpans.listSpans || EnrichedSpans.paragraphSpans[name]?.isContinuous == false))
+}
+
+/** Rebuilds the spanned text of a snapshot, skipping runs that don't fit the text. */
+fun DocumentSnapshot.toSpannable(
+  htmlStyle: HtmlStyle,
+  factory: EnrichedSpanFactory<HtmlStyle>,
+): Spannable {
+  val builder = SpannableStringBuilder(text)
+  // Runs are sorted by start; consecutive ordered list items continue the numbering
+  var orderedListEnd = -1
+  var orderedListIndex = 0
+
+  for (i in runs.indices step 4) {
+    val start = runs[i]
+    val end = start + runs[i + 1]
+    val type = runs[i + 2]
+    val payload = strings.getOrNull(runs[i + 3])
+    if (end > builder.length) continue
+
+    val name = EnrichedSpans.styleName(type)
+    val perParagraph = isPerParagraphStyle(type)
+    var segmentStart = start
+    while (segmentStart < end) {
+      val segmentEnd =
+        if (perParagraph) {
+          builder.indexOf('\n', segmentStart).let { if (it < 0 || it >= end) end else it + 1 }
+        } else {
+          end
+        }
+
+      if (name == EnrichedSpans.ORDERED_LIST) {
+        orderedListIndex = if (segmentStart == orderedListEnd || segmentStart == orderedListEnd + 1) orderedListIndex + 1 else 1
+        orderedListEnd = segmentEnd
+      }
+      val span = createSpan(type, payload, orderedListIndex, htmlStyle, factory)
+      if (span != null) {
+        builder.setSpan(span, segmentStart, segmentEnd, Spanned.SPAN_EXCLUSIVE_EXCLUSIVE)
+      }
+      segmentStart = segmentEnd
+    }
+  }
+
+  return builder
+}
+
+/** A span of style [type] with [payload], null when the payload doesn't fit the style. */
+internal fun createSpan(
+  type: Int,
+  payload: String?,
+  orderedListIndex: Int,
+  htmlStyle: HtmlStyle,
+  factory: EnrichedSpanFactory<HtmlStyle>,
+): Any? {
+  if (type == EnrichedSpans.ALIGNMENT_STYLE_TYPE) {
+    return payload?.let { factory.createAlignmentSpan(it) }
+  }
+
+  return when (EnrichedSpans.styleName(type)) {
+    EnrichedSpans.BOLD -> {
+      factory.createBoldSpan(htmlStyle)
+    }
+
+    EnrichedSpans.ITALIC -> {
+      factory.createItalicSpan(htmlStyle)
+    }
+
+    EnrichedSpans.UNDERLINE -> {
+      factory.createUnderlineSpan(htmlStyle)
+    }
+
+    EnrichedSpans.STRIKETHROUGH -> {
+      factory.createStrikeThroughSpan(htmlStyle)
+    }
+
+    EnrichedSpans.INLINE_CODE -> {
+      factory.createInlineCodeSpan(htmlStyle)
+    }
+
+    EnrichedSpans.H1 -> {
+      factory.createH1Span(htmlStyle)
+    }
+
+    EnrichedSpans.H2 -> {
+      factory.createH2Span(htmlStyle)
+    }
+
+    EnrichedSpans.H3 -> {
+      factory.createH3Span(htmlStyle)
+    }
+
+    EnrichedSpans.H4 -> {
+      factory.createH4Span(htmlStyle)
+    }
+
+    EnrichedSpans.H5 -> {
+      factory.createH5Span(htmlStyle)
+    }
+
+    EnrichedSpans.H6 -> {
+      factory.createH6Span(htmlStyle)
+    }
+
+    EnrichedSpans.BLOCK_QUOTE -> {
+      factory.createBlockQuoteSpan(htmlStyle)
+    }
+
+    EnrichedSpans.CODE_BLOCK -> {
+      factory.createCodeBlockSpan(htmlStyle)
+    }
+
+    EnrichedSpans.UNORDERED_LIST -> {
+      factory.createUnorderedListSpan(htmlStyle)
+    }
+
+    EnrichedSpans.CHECKBOX_LIST -> {
+      factory.createCheckboxListSpan(payload == CHECKED, htmlStyle)
+    }
+
+    EnrichedSpans.ORDERED_LIST -> {
+      factory.createOrderedListSpan(orderedListIndex, htmlStyle)
+    }
+
+    EnrichedSpans.LINK -> {
+      payload?.let { factory.createLinkSpan(it, htmlStyle) }
+    }
+
+    EnrichedSpans.MENTION -> {
+      val mention = JSONObject(payload ?: return null)
+      val attributesJson = mention.optJSONObject("attributes") ?: JSONObject()
+      val attributes = attributesJson.keys().asSequence().associateWith { attributesJson.optString(it) }
+      factory.createMentionSpan(mention.optString("text"), mention.optString("indicator"), attributes, htmlStyle)
+    }
+
+    EnrichedSpans.IMAGE -> {
+      val image = JSONObject(payload ?: return null)
+      factory.createImageSpan(BlobStore.importSource(image.optString("uri")), image.optInt("width"), image.optInt("height"))
+    }
+
+    else -> {
+      null
+    }
+  }
+}
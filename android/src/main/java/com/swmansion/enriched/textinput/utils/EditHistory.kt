@@ -0,0 +1,218 @@
+package com.swmansion.enriched.textinput.utils
+
+import android.os.SystemClock
+import android.text.Editable
+import android.text.Spanned
+import com.swmansion.enriched.common.OperationLog
+import com.swmansion.enriched.common.StyleIndex
+import com.swmansion.enriched.common.parser.EnrichedSpanFactory
+import com.swmansion.enriched.textinput.EnrichedTextInputView
+import com.swmansion.enriched.textinput.spans.interfaces.EnrichedInputSpan
+import com.swmansion.enriched.textinput.styles.HtmlStyle
+
+/**
+ * Undo/redo of the input. EnrichedTextWatcher reports text replacements and EnrichedSpanWatcher
+ * restyles, both with runs read from the style index; everything recorded while handling one UI
+ * event becomes one undo step.
+ */
+class EditHistory(
+  private val view: EnrichedTextInputView,
+  private val factory: EnrichedSpanFactory<HtmlStyle>,
+) {
+  private val log = OperationLog()
+  private var isGroupOpen = false
+  private var removedText = ""
+  private var removedRuns = IntArray(0)
+
+  init {
+    // Payloads count toward the history's size while a step refers to them
+    view.styleIndex.onIntern = log::setValueSize
+  }
+
+  /** Set while undo or redo edits the text; those edits aren't recorded. */
+  var isApplying = false
+    private set
+
+  fun beforeTextChanged(
+    text: Spanned,
+    start: Int,
+    count: Int,
+  ) {
+    if (isApplying) return
+    removedText = text.substring(start, start + count)
+    removedRuns = view.styleIndex.sync(text).runs(start, start + count)
+  }
+
+  /** Called once the style index took the edit in. */
+  fun onTextChanged(
+    text: Spanned,
+    start: Int,
+    before: Int,
+    count: Int,
+  ) {
+    if (isApplying) return
+    if (removedText.length != before) {
+      // The text changed without beforeTextChanged, the recorded edits no longer fit it
+      clear()
+      return
+    }
+    openGroup()
+    val insertedText = text.substring(start, start + count)
+    log.recordReplace(start, removedText, insertedText, SystemClock.uptimeMillis(), removedRuns, view.styleIndex.runs(start, start + count))
+    view.styleIndex.collectPayloads(log::isValueReferenced)
+  }
+
+  /** The style index runs of [start, end) changed from [previousRuns] to [runs]. */
+  fun onStylesChanged(
+    start: Int,
+    end: Int,
+    previousRuns: IntArray,
+    runs: IntArray,
+  ) {
+    if (isApplying || previousRuns.contentEquals(runs)) return
+    openGroup()
+    log.recordStyles(start, end, previousRuns, runs)
+    view.styleIndex.collectPayloads(log::isValueReferenced)
+  }
+
+  fun undo() {
+    closeGroup()
+    if (log.canUndo) apply(log.undo())
+  }
+
+  fun redo() {
+    closeGroup()
+    if (log.canRedo) apply(log.redo())
+  }
+
+  /** Frees the native history once the view is dropped. */
+  fun release() {
+    isGroupOpen = false
+    log.release()
+  }
+
+  /** Forgets the history, e.g. when a new value is set. */
+  fun clear() {
+    closeGroup()
+    log.clear()
+  }
+
+  private fun openGroup() {
+    if (isGroupOpen) return
+    isGroupOpen = true
+    log.beginGroup()
+    view.post { closeGroup() }
+  }
+
+  private fun closeGroup() {
+    if (!isGroupOpen) return
+    isGroupOpen = false
+    log.endGroup()
+  }
+
+  private fun apply(operations: Array<OperationLog.Operation>) {
+    val text = view.text ?: return
+    var selectionStart = view.selectionStart
+    var selectionEnd = view.selectionEnd
+    if (!fits(operations, text.length)) {
+      // The history no longer matches the text; start over from here
+      clear()
+      return
+    }
+
+    isApplying = true
+    try {
+      view.runAsATransaction {
+        for (operation in operations) {
+          if (operation.kind == OperationLog.REPLACE_TEXT) {
+            val removedEnd = operation.start + operation.removedText.length
+            val insertedEnd = operation.start + operation.insertedText.length
+            text.replace(operation.start, removedEnd, operation.insertedText)
+            restyle(text, operation.start, insertedEnd, operation.runs)
+            selectionStart = insertedEnd
+            selectionEnd = insertedEnd
+          } else if (operation.kind == OperationLog.REPLACE_STYLES) {
+            restyle(text, operation.start, operation.end, operation.runs)
+            selectionStart = operation.start
+            selectionEnd = operation.end
+          }
+        }
+        view.setSelection(selectionStart.coerceIn(0, text.length), selectionEnd.coerceIn(0, text.length))
+      }
+    } finally {
+      isApplying = false
+    }
+    view.selection?.validateStyles()
+    view.layoutManager.invalidateLayout()
+  }
+
+  // Whether every operation of the step fits the text as the ones before it leave it.
+  private fun fits(
+    operations: Array<OperationLog.Operation>,
+    textLength: Int,
+  ): Boolean {
+    var length = textLength
+    for (operation in operations) {
+      if (operation.end > length || operation.start + operation.removedText.length > length) return false
+      if (operation.kind == OperationLog.REPLACE_TEXT) {
+        length += operation.insertedText.length - operation.removedText.length
+      }
+    }
+    return true
+  }
+
+  // Gives text[start, end) the styles of [runs]. Spans sticking out of the range keep their outer
+  // parts and merge with equal runs, so the range doesn't end up split from its neighbours.
+  private fun restyle(
+    text: Editable,
+    start: Int,
+    end: Int,
+    runs: IntArray,
+  ) {
+    if (end <= start) return
+    val index = view.styleIndex.sync(text)
+    val spans = text.getSpans(start, end, EnrichedInputSpan::class.java)
+    var extentStart = start
+    var extentEnd = end
+    for (span in spans) {
+      extentStart = minOf(extentStart, text.getSpanStart(span))
+      extentEnd = maxOf(extentEnd, text.getSpanEnd(span))
+    }
+
+    index.replace(start, end, runs)
+    val extentRuns = index.runs(extentStart, extentEnd)
+    for (span in spans) {
+      text.removeSpan(span)
+    }
+    for (i in extentRuns.indices step 4) {
+      val value = index.payload(extentRuns[i + 3]) ?: continue
+      setRun(text, extentRuns[i], extentRuns[i + 1], extentRuns[i + 2], value)
+    }
+    index.reindex(text, extentStart, extentEnd)
+  }
+
+  private fun setRun(
+    text: Editable,
+    start: Int,
+    end: Int,
+    type: Int,
+    value: StyleIndex.RunValue,
+  ) {
+    val perParagraph = isPerParagraphStyle(type)
+    var segmentStart = start
+    while (segmentStart < end) {
+      val segmentEnd =
+        if (perParagraph) {
+          text.indexOf('\n', segmentStart).let { if (it < 0 || it >= end) end else it + 1 }
+        } else {
+          end
+        }
+      // Ordered list numbers are fixed by EnrichedSpanWatcher as the spans are added
+      val span = createSpan(type, value.payload, 1, view.htmlStyle, factory)
+      if (span != null) {
+        text.setSpan(span, segmentStart, segmentEnd, value.flags)
+      }
+      segmentStart = segmentEnd
+    }
+  }
+}
@@ -81,28 +81,39 @@ class EnrichedSelection(
 
   fun validateStyles() {
     val state = view.spanState ?: return
+    val spannable = view.text as? Spannable ?: return
+
+    // Only styles with spans touching the selection are looked up in the spans
+    val (inlineStart, inlineEnd) = getInlineSelection()
+    val inlineStyles = touchingStyles(spannable, inlineStart, inlineEnd)
+    val (paragraphStart, paragraphEnd) = getParagraphSelection()
+    val paragraphStyles = touchingStyles(spannable, paragraphStart, paragraphEnd)
 
     // We don't validate inline styles when removing many characters at once
     // We don't want to remove styles on auto-correction
     // If user removes many characters at once, we want to keep the styles config
     if (!view.isRemovingMany) {
       for ((style, config) in EnrichedSpans.inlineSpans) {
-        state.setStart(style, getInlineStyleStart(config.clazz))
+        val isTouching = (inlineStyles and EnrichedSpans.styleBit(style)) != 0
+        state.setStart(style, if (isTouching) getInlineStyleStart(config.clazz) else null)
       }
     } else {
       view.isRemovingMany = false
     }
 
     for ((style, config) in EnrichedSpans.paragraphSpans) {
-      state.setStart(style, getParagraphStyleStart(config.clazz))
+      val isTouching = (paragraphStyles and EnrichedSpans.styleBit(style)) != 0
+      state.setStart(style, if (isTouching) getParagraphStyleStart(config.clazz) else null)
     }
 
     for ((style, config) in EnrichedSpans.listSpans) {
-      state.setStart(style, getListStyleStart(config.clazz))
+      val isTouching = (paragraphStyles and EnrichedSpans.styleBit(style)) != 0
+      state.setStart(style, if (isTouching) getListStyleStart(config.clazz) else null)
     }
 
     for ((style, config) in EnrichedSpans.parametrizedStyles) {
-      state.setStart(style, getParametrizedStyleStart(config.clazz))
+      val isTouching = (inlineStyles and EnrichedSpans.styleBit(style)) != 0
+      state.setStart(style, getParametrizedStyleStart(config.clazz, isTouching))
     }
 
     val currentAlignment = view.alignmentStyles?.getCurrentAlignment() ?: "auto"
@@ -140,7 +151,7 @@ class EnrichedSelection(
   fun getParagraphSelection(): Pair<Int, Int> {
     val (currentStart, currentEnd) = getInlineSelection()
     val spannable = view.text as Spannable
-    return spannable.getParagraphBounds(currentStart, currentEnd)
+    return view.paragraphBounds(spannable, currentStart, currentEnd)
   }
 
   private fun <T> getParagraphStyleStart(type: Class<T>): Int? {
@@ -191,28 +202,47 @@ class EnrichedSelection(
     return styleStart
   }
 
-  private fun <T> getParametrizedStyleStart(type: Class<T>): Int? {
+  /**
+   * Styles of spans that getSpans(start, end) could return: spans overlapping the range or touching
+   * its ends.
+   */
+  private fun touchingStyles(
+    spannable: Spannable,
+    start: Int,
+    end: Int,
+  ): Int {
+    val from = (start - 1).coerceAtLeast(0)
+    val to = (end + 1).coerceAtMost(spannable.length)
+    return view.styleIndex.sync(spannable).stylesIntersecting(from, to)
+  }
+
+  private fun <T> getParametrizedStyleStart(
+    type: Class<T>,
+    isTouching: Boolean,
+  ): Int? {
     val (start, end) = getInlineSelection()
     val spannable = view.text as Spannable
-    val spans = spannable.getSpans(start, end, type)
     val isLinkType = type == EnrichedInputLinkSpan::class.java
     val isMentionType = type == EnrichedInputMentionSpan::class.java
+    val hasSpans = isTouching && spannable.getSpans(start, end, type).isNotEmpty()
 
-    if (isLinkType && spans.isEmpty()) {
+    if (isLinkType && !hasSpans) {
       if (wasLinkPreviouslyDetected()) {
         emitLinkDetectedEvent(spannable, null, 0, 0)
       }
       return null
     }
 
-    if (isMentionType && spans.isEmpty()) {
+    if (isMentionType && !hasSpans) {
       if (wasMentionPreviouslyDetected()) {
         emitMentionDetectedEvent(spannable, null, start, end)
       }
       return null
     }
 
-    for (span in spans) {
+    if (!hasSpans) return null
+
+    for (span in spannable.getSpans(start, end, type)) {
       val spanStart = spannable.getSpanStart(span)
       val spanEnd = spannable.getSpanEnd(span)
 
@@ -241,8 +271,8 @@ class EnrichedSelection(
     val surfaceId = UIManagerHelper.getSurfaceId(context)
     val dispatcher = UIManagerHelper.getEventDispatcherForReactTag(context, view.id)
 
-    val visibleStart = start - editable.zwsCountBefore(start)
-    val visibleEnd = end - editable.zwsCountBefore(end)
+    val visibleStart = view.toVisibleIndex(start)
+    val visibleEnd = view.toVisibleIndex(end)
     val text = editable.substring(start, end).replace(EnrichedConstants.ZWS_STRING, "")
     dispatcher?.dispatchEvent(
       OnChangeSelectionEvent(
@@ -283,8 +313,8 @@ class EnrichedSelection(
     previousLinkDetectedEvent.put("text", text)
     previousLinkDetectedEvent.put("url", url)
 
-    val visibleStart = start - spannable.zwsCountBefore(start)
-    val visibleEnd = end - spannable.zwsCountBefore(end)
+    val visibleStart = view.toVisibleIndex(start)
+    val visibleEnd = view.toVisibleIndex(end)
 
     val context = view.context as ReactContext
     val surfaceId = UIManagerHelper.getSurfaceId(context)
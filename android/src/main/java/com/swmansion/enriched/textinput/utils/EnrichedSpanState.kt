@@ -55,6 +55,16 @@ class EnrichedSpanState(
   var currentAlignment: String = "auto"
     private set
 
+  /** Active styles as a StyleRules mask. */
+  val activeStyles: Int
+    get() {
+      var mask = 0
+      for (style in EnrichedSpans.allSpans.keys) {
+        if (getStart(style) != null) mask = mask or EnrichedSpans.styleBit(style)
+      }
+      return mask
+    }
+
   fun setBoldStart(start: Int?) {
     this.boldStart = start
     emitStateChangeEvent()
@@ -211,48 +221,27 @@ class EnrichedSpanState(
   }
 
   fun getStyleStatePayload(): WritableMap {
-    val activeStyles =
-      listOfNotNull(
-        if (boldStart != null) EnrichedSpans.BOLD else null,
-        if (italicStart != null) EnrichedSpans.ITALIC else null,
-        if (underlineStart != null) EnrichedSpans.UNDERLINE else null,
-        if (strikethroughStart != null) EnrichedSpans.STRIKETHROUGH else null,
-        if (inlineCodeStart != null) EnrichedSpans.INLINE_CODE else null,
-        if (h1Start != null) EnrichedSpans.H1 else null,
-        if (h2Start != null) EnrichedSpans.H2 else null,
-        if (h3Start != null) EnrichedSpans.H3 else null,
-        if (h4Start != null) EnrichedSpans.H4 else null,
-        if (h5Start != null) EnrichedSpans.H5 else null,
-        if (h6Start != null) EnrichedSpans.H6 else null,
-        if (codeBlockStart != null) EnrichedSpans.CODE_BLOCK else null,
-        if (blockQuoteStart != null) EnrichedSpans.BLOCK_QUOTE else null,
-        if (orderedListStart != null) EnrichedSpans.ORDERED_LIST else null,
-        if (unorderedListStart != null) EnrichedSpans.UNORDERED_LIST else null,
-        if (checkboxListStart != null) EnrichedSpans.CHECKBOX_LIST else null,
-        if (linkStart != null) EnrichedSpans.LINK else null,
-        if (imageStart != null) EnrichedSpans.IMAGE else null,
-        if (mentionStart != null) EnrichedSpans.MENTION else null,
-      )
+    val active = activeStyles
     val payload = Arguments.createMap()
-    payload.putMap("bold", getStyleState(activeStyles, EnrichedSpans.BOLD))
-    payload.putMap("italic", getStyleState(activeStyles, EnrichedSpans.ITALIC))
-    payload.putMap("underline", getStyleState(activeStyles, EnrichedSpans.UNDERLINE))
-    payload.putMap("strikeThrough", getStyleState(activeStyles, EnrichedSpans.STRIKETHROUGH))
-    payload.putMap("inlineCode", getStyleState(activeStyles, EnrichedSpans.INLINE_CODE))
-    payload.putMap("h1", getStyleState(activeStyles, EnrichedSpans.H1))
-    payload.putMap("h2", getStyleState(activeStyles, EnrichedSpans.H2))
-    payload.putMap("h3", getStyleState(activeStyles, EnrichedSpans.H3))
-    payload.putMap("h4", getStyleState(activeStyles, EnrichedSpans.H4))
-    payload.putMap("h5", getStyleState(activeStyles, EnrichedSpans.H5))
-    payload.putMap("h6", getStyleState(activeStyles, EnrichedSpans.H6))
-    payload.putMap("codeBlock", getStyleState(activeStyles, EnrichedSpans.CODE_BLOCK))
-    payload.putMap("blockQuote", getStyleState(activeStyles, EnrichedSpans.BLOCK_QUOTE))
-    payload.putMap("orderedList", getStyleState(activeStyles, EnrichedSpans.ORDERED_LIST))
-    payload.putMap("unorderedList", getStyleState(activeStyles, EnrichedSpans.UNORDERED_LIST))
-    payload.putMap("link", getStyleState(activeStyles, EnrichedSpans.LINK))
-    payload.putMap("image", getStyleState(activeStyles, EnrichedSpans.IMAGE))
-    payload.putMap("mention", getStyleState(activeStyles, EnrichedSpans.MENTION))
-    payload.putMap("checkboxList", getStyleState(activeStyles, EnrichedSpans.CHECKBOX_LIST))
+    payload.putMap("bold", getStyleState(active, EnrichedSpans.BOLD))
+    payload.putMap("italic", getStyleState(active, EnrichedSpans.ITALIC))
+    payload.putMap("underline", getStyleState(active, EnrichedSpans.UNDERLINE))
+    payload.putMap("strikeThrough", getStyleState(active, EnrichedSpans.STRIKETHROUGH))
+    payload.putMap("inlineCode", getStyleState(active, EnrichedSpans.INLINE_CODE))
+    payload.putMap("h1", getStyleState(active, EnrichedSpans.H1))
+    payload.putMap("h2", getStyleState(active, EnrichedSpans.H2))
+    payload.putMap("h3", getStyleState(active, EnrichedSpans.H3))
+    payload.putMap("h4", getStyleState(active, EnrichedSpans.H4))
+    payload.putMap("h5", getStyleState(active, EnrichedSpans.H5))
+    payload.putMap("h6", getStyleState(active, EnrichedSpans.H6))
+    payload.putMap("codeBlock", getStyleState(active, EnrichedSpans.CODE_BLOCK))
+    payload.putMap("blockQuote", getStyleState(active, EnrichedSpans.BLOCK_QUOTE))
+    payload.putMap("orderedList", getStyleState(active, EnrichedSpans.ORDERED_LIST))
+    payload.putMap("unorderedList", getStyleState(active, EnrichedSpans.UNORDERED_LIST))
+    payload.putMap("link", getStyleState(active, EnrichedSpans.LINK))
+    payload.putMap("image", getStyleState(active, EnrichedSpans.IMAGE))
+    payload.putMap("mention", getStyleState(active, EnrichedSpans.MENTION))
+    payload.putMap("checkboxList", getStyleState(active, EnrichedSpans.CHECKBOX_LIST))
     payload.putString("alignment", currentAlignment)
 
     return payload
@@ -292,22 +281,14 @@ class EnrichedSpanState(
   }
 
   private fun getStyleState(
-    activeStyles: List<String>,
+    activeStyles: Int,
     type: String,
   ): WritableMap {
-    val mergingConfig = EnrichedSpans.getMergingConfigForStyle(type, view.htmlStyle)
-    val blockingList = mergingConfig?.blockingStyles
-    val conflictingList = mergingConfig?.conflictingStyles
-
     val state = Arguments.createMap()
 
-    state.putBoolean("isActive", activeStyles.contains(type))
-
-    val isBlocking = blockingList?.any { activeStyles.contains(it) } ?: false
-    state.putBoolean("isBlocking", isBlocking)
-
-    val isConflicting = conflictingList?.any { activeStyles.contains(it) } ?: false
-    state.putBoolean("isConflicting", isConflicting)
+    state.putBoolean("isActive", activeStyles and EnrichedSpans.styleBit(type) != 0)
+    state.putBoolean("isBlocking", EnrichedSpans.blocks(type, view.htmlStyle) and activeStyles != 0)
+    state.putBoolean("isConflicting", EnrichedSpans.conflicts(type, view.htmlStyle) and activeStyles != 0)
 
     return state
   }
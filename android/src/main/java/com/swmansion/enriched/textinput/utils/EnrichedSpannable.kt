@@ -70,8 +70,8 @@ private fun Spannable.removeBlockedPasteStyles(
 
   for (span in pastedSpans) {
     val style = getStyleForSpan(span) ?: continue
-    val blockingStyles = EnrichedSpans.getMergingConfigForStyle(style, htmlStyle)?.blockingStyles ?: continue
-    if (blockingStyles.isEmpty()) continue
+    val blockingStyles = EnrichedSpans.blocks(style, htmlStyle)
+    if (blockingStyles == 0) continue
 
     val spanStart = pastedSpannable.getSpanStart(span)
     val spanEnd = pastedSpannable.getSpanEnd(span)
@@ -79,7 +79,11 @@ private fun Spannable.removeBlockedPasteStyles(
 
     val pastedStart = start + spanStart
     val pastedEnd = start + spanEnd
-    if (blockingStyles.any { hasStyleInRange(it, pastedStart, pastedEnd) }) {
+    var isBlocked = false
+    EnrichedSpans.forEachStyle(blockingStyles) {
+      isBlocked = isBlocked || hasStyleInRange(it, pastedStart, pastedEnd)
+    }
+    if (isBlocked) {
       removeSpan(span)
     }
   }
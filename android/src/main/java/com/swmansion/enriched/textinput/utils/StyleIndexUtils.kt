@@ -0,0 +1,57 @@
+package com.swmansion.enriched.textinput.utils
+
+import android.text.Spanned
+import com.swmansion.enriched.common.StyleIndex
+import com.swmansion.enriched.textinput.spans.EnrichedSpans
+import com.swmansion.enriched.textinput.spans.interfaces.EnrichedInputSpan
+
+/** Re-reads the runs of styles in text[start, end) from its spans. */
+fun StyleIndex.reindex(
+  text: Spanned,
+  start: Int,
+  end: Int,
+) {
+  if (end <= start) return
+  val spans = text.getSpans(start, end, EnrichedInputSpan::class.java)
+  val runs = IntArray(spans.size * 4)
+  var count = 0
+  for (span in spans) {
+    val type = EnrichedSpans.spanStyleType(span)
+    if (type < 0) continue
+    runs[count * 4] = text.getSpanStart(span)
+    runs[count * 4 + 1] = text.getSpanEnd(span)
+    runs[count * 4 + 2] = type
+    runs[count * 4 + 3] = intern(StyleIndex.RunValue(spanPayload(span), text.getSpanFlags(span)))
+    count++
+  }
+  replace(start, end, runs.copyOf(count * 4))
+}
+
+/**
+ * [removed] characters at [start] were replaced with text[start, start + count). Rebuilds the
+ * whole index when it's stale.
+ */
+fun StyleIndex.applyEdit(
+  start: Int,
+  removed: Int,
+  text: Spanned,
+  count: Int,
+) {
+  if (isStale) {
+    rebuild(text)
+    return
+  }
+  applyEdit(start, removed, count)
+  reindex(text, start, start + count)
+}
+
+/** Rebuilds the index if it's stale, e.g. for text set before the watchers were attached. */
+fun StyleIndex.sync(text: Spanned): StyleIndex {
+  if (isStale) rebuild(text)
+  return this
+}
+
+private fun StyleIndex.rebuild(text: Spanned) {
+  reset()
+  reindex(text, 0, text.length)
+}
@@ -25,11 +25,6 @@ fun resolveStyleName(name: String): String? =
     else -> null
   }
 
-fun isInlineShortcutStyle(styleName: String): Boolean {
-  val resolvedStyle = resolveStyleName(styleName) ?: return false
-  return EnrichedSpans.inlineSpans.containsKey(resolvedStyle)
-}
-
 fun isStyleBlockedOnRange(
   styleName: String,
   start: Int,
@@ -37,11 +32,8 @@ fun isStyleBlockedOnRange(
   spannable: Spannable,
   htmlStyle: HtmlStyle,
 ): Boolean {
-  val mergingConfig =
-    EnrichedSpans.getMergingConfigForStyle(styleName, htmlStyle) ?: return false
-
-  for (blockingStyleName in mergingConfig.blockingStyles) {
-    val spanClass = EnrichedSpans.allSpans[blockingStyleName]?.clazz ?: continue
+  EnrichedSpans.forEachStyle(EnrichedSpans.blocks(styleName, htmlStyle)) { blockingStyleName ->
+    val spanClass = EnrichedSpans.allSpans[blockingStyleName]?.clazz ?: return@forEachStyle
     if (spannable.getSpans(start, end, spanClass).isNotEmpty()) {
       return true
     }
@@ -14,18 +14,30 @@ import com.swmansion.enriched.textinput.events.OnChangeHtmlEvent
 import com.swmansion.enriched.textinput.spans.EnrichedInputOrderedListSpan
 import com.swmansion.enriched.textinput.spans.interfaces.EnrichedInputSpan
 import com.swmansion.enriched.textinput.utils.getSafeSpanBoundaries
+import com.swmansion.enriched.textinput.utils.reindex
+import com.swmansion.enriched.textinput.utils.sync
 
 class EnrichedSpanWatcher(
   private val view: EnrichedTextInputView,
 ) : SpanWatcher {
   private var previousHtml: String? = null
 
+  /**
+   * Set by EnrichedTextWatcher while text is being replaced. Spans moved by the replacement reach
+   * the style index as one edit instead.
+   */
+  var isTextChanging = false
+
+  /** The last emitted HTML. While onChangeHtml is set it's the input's content; null otherwise. */
+  fun emittedHtml(): String? = previousHtml
+
   override fun onSpanAdded(
     text: Spannable,
     what: Any,
     start: Int,
     end: Int,
   ) {
+    updateStyleIndex(text, what, start, end)
     updateNextLineLayout(what, text, end)
     updateUnorderedListSpans(what, text, end)
     emitEvent(text, what)
@@ -37,6 +49,7 @@ class EnrichedSpanWatcher(
     start: Int,
     end: Int,
   ) {
+    updateStyleIndex(text, what, start, end)
     updateNextLineLayout(what, text, end)
     updateUnorderedListSpans(what, text, end)
     emitEvent(text, what)
@@ -50,7 +63,22 @@ class EnrichedSpanWatcher(
     nstart: Int,
     nend: Int,
   ) {
-    // Do nothing for now
+    updateStyleIndex(text, what, ostart, oend)
+    updateStyleIndex(text, what, nstart, nend)
+  }
+
+  private fun updateStyleIndex(
+    text: Spannable,
+    what: Any,
+    start: Int,
+    end: Int,
+  ) {
+    // Undo and redo keep the index in step themselves
+    if (isTextChanging || what !is EnrichedInputSpan || view.history.isApplying) return
+    val index = view.styleIndex.sync(text)
+    val previousRuns = index.runs(start, end)
+    index.reindex(text, start, end)
+    view.history.onStylesChanged(start, end, previousRuns, index.runs(start, end))
   }
 
   private fun updateUnorderedListSpans(
@@ -85,7 +113,10 @@ class EnrichedSpanWatcher(
     what: Any?,
   ) {
     // Do not parse spannable and emit event if onChangeHtml is not provided
-    if (!view.shouldEmitHtml) return
+    if (!view.shouldEmitHtml) {
+      previousHtml = null
+      return
+    }
 
     // Emit event only if we change one of ours spans
     if (what != null && what !is EnrichedInputSpan) return
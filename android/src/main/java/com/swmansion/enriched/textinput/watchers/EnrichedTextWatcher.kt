@@ -2,6 +2,7 @@ package com.swmansion.enriched.textinput.watchers
 
 import android.text.Editable
 import android.text.Spannable
+import android.text.Spanned
 import android.text.TextWatcher
 import com.facebook.react.bridge.ReactContext
 import com.facebook.react.uimanager.UIManagerHelper
@@ -10,6 +11,7 @@ import com.swmansion.enriched.textinput.EnrichedTextInputView
 import com.swmansion.enriched.textinput.events.OnChangeTextEvent
 import com.swmansion.enriched.textinput.spans.EnrichedInputAlignmentSpan
 import com.swmansion.enriched.textinput.spans.EnrichedSpans
+import com.swmansion.enriched.textinput.utils.applyEdit
 
 class EnrichedTextWatcher(
   private val view: EnrichedTextInputView,
@@ -27,8 +29,12 @@ class EnrichedTextWatcher(
     count: Int,
     after: Int,
   ) {
+    view.spanWatcher?.isTextChanging = true
     previousTextLength = s?.length ?: 0
     deletedText = if (count > 0 && s != null) s.substring(start, start + count) else ""
+    if (s is Spanned) {
+      view.history.beforeTextChanged(s, start, count)
+    }
 
     anchorAlignmentToRestore = null
 
@@ -58,8 +64,23 @@ class EnrichedTextWatcher(
     before: Int,
     count: Int,
   ) {
+    view.spanWatcher?.isTextChanging = false
     startCursorPosition = start
     endCursorPosition = start + count
+    if (s is Spanned) {
+      view.styleIndex.applyEdit(start, before, s, count)
+      view.history.onTextChanged(s, start, before, count)
+    } else {
+      view.styleIndex.invalidate()
+    }
+    if (s != null) {
+      view.paragraphIndex.applyEdit(start, before, s, count)
+      view.visibleIndex.applyEdit(start, before, s, count)
+      view.listStyles?.onTextChanged(s, start, before, count)
+    } else {
+      view.paragraphIndex.invalidate()
+      view.visibleIndex.invalidate()
+    }
     view.layoutManager.invalidateLayout()
     view.isRemovingMany = !view.isDuringTransaction && before > count + 1
   }
@@ -0,0 +1,54 @@
+#include "BlobStore.hpp"
+#include "TextEncoding.hpp"
+#include <jni.h>
+#include <string>
+
+using enriched::Blob;
+using enriched::BlobStore;
+
+namespace {
+
+std::string toUtf8(JNIEnv *env, jstring string) {
+  jsize length = env->GetStringLength(string);
+  const jchar *chars = env->GetStringCritical(string, nullptr);
+  std::string utf8 =
+      enriched::utf16ToUtf8(reinterpret_cast<const char16_t *>(chars), length);
+  env->ReleaseStringCritical(string, chars);
+  return utf8;
+}
+
+} // namespace
+
+// Blobs are never evicted, so the buffer can point straight at the stored
+// bytes; the Kotlin side hands it out read-only.
+extern "C" JNIEXPORT jobject JNICALL
+Java_com_swmansion_enriched_common_BlobStore_nativeBuffer(JNIEnv *env,
+                                                          jclass /*cls*/,
+                                                          jstring handle) {
+  const Blob *blob = BlobStore::shared().get(toUtf8(env, handle));
+  if (!blob)
+    return nullptr;
+  return env->NewDirectByteBuffer(const_cast<char *>(blob->bytes.data()),
+                                  static_cast<jlong>(blob->bytes.size()));
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_swmansion_enriched_common_BlobStore_nativeDataUri(JNIEnv *env,
+                                                           jclass /*cls*/,
+                                                           jstring handle) {
+  std::string uri = BlobStore::shared().dataUri(toUtf8(env, handle));
+  if (uri.empty())
+    return nullptr;
+  // Base64 is ASCII, so modified UTF-8 is plain UTF-8 here.
+  return env->NewStringUTF(uri.c_str());
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_swmansion_enriched_common_BlobStore_nativePut(JNIEnv *env,
+                                                       jclass /*cls*/,
+                                                       jstring dataUri) {
+  std::string handle = BlobStore::shared().put(toUtf8(env, dataUri));
+  if (handle.empty())
+    return nullptr;
+  return env->NewStringUTF(handle.c_str());
+}
@@ -0,0 +1,105 @@
+#include "DocumentSnapshot.hpp"
+#include "TextEncoding.hpp"
+#include <jni.h>
+#include <string>
+#include <vector>
+
+using enriched::DocumentSnapshot;
+using enriched::StyleType;
+
+namespace {
+
+std::u16string toU16String(JNIEnv *env, jstring string) {
+  jsize length = env->GetStringLength(string);
+  std::u16string result(length, u'\0');
+  env->GetStringRegion(string, 0, length,
+                       reinterpret_cast<jchar *>(result.data()));
+  return result;
+}
+
+jstring toJString(JNIEnv *env, const std::u16string &string) {
+  return env->NewString(reinterpret_cast<const jchar *>(string.data()),
+                        static_cast<jsize>(string.size()));
+}
+
+} // namespace
+
+extern "C" JNIEXPORT jbyteArray JNICALL
+Java_com_swmansion_enriched_common_DocumentSnapshot_nativeSerialize(
+    JNIEnv *env, jclass /*cls*/, jstring textJString, jintArray runsJArray,
+    jobjectArray stringsJArray) {
+  DocumentSnapshot snapshot;
+  snapshot.text = toU16String(env, textJString);
+
+  jsize stringCount = env->GetArrayLength(stringsJArray);
+  snapshot.strings.reserve(stringCount);
+  for (jsize i = 0; i < stringCount; i++) {
+    auto string =
+        static_cast<jstring>(env->GetObjectArrayElement(stringsJArray, i));
+    snapshot.strings.push_back(
+        enriched::utf16ToUtf8(toU16String(env, string)));
+    env->DeleteLocalRef(string);
+  }
+
+  jsize runValues = env->GetArrayLength(runsJArray);
+  jint *runs = env->GetIntArrayElements(runsJArray, nullptr);
+  snapshot.runs.reserve(runValues / 4);
+  for (jsize i = 0; i + 3 < runValues; i += 4) {
+    jint value = runs[i + 3];
+    snapshot.runs.push_back(
+        {{static_cast<size_t>(runs[i]), static_cast<size_t>(runs[i + 1])},
+         static_cast<StyleType>(runs[i + 2]),
+         value < 0 ? DocumentSnapshot::kNoString
+                   : static_cast<uint32_t>(value)});
+  }
+  env->ReleaseIntArrayElements(runsJArray, runs, JNI_ABORT);
+
+  std::string bytes = snapshot.serialize();
+  jbyteArray result = env->NewByteArray(static_cast<jsize>(bytes.size()));
+  env->SetByteArrayRegion(result, 0, static_cast<jsize>(bytes.size()),
+                          reinterpret_cast<const jbyte *>(bytes.data()));
+  return result;
+}
+
+extern "C" JNIEXPORT jobject JNICALL
+Java_com_swmansion_enriched_common_DocumentSnapshot_nativeDeserialize(
+    JNIEnv *env, jclass cls, jbyteArray bytesJArray) {
+  jsize size = env->GetArrayLength(bytesJArray);
+  jbyte *bytes = env->GetByteArrayElements(bytesJArray, nullptr);
+  DocumentSnapshot snapshot;
+  bool parsed = DocumentSnapshot::deserialize(reinterpret_cast<char *>(bytes),
+                                              size, snapshot);
+  env->ReleaseByteArrayElements(bytesJArray, bytes, JNI_ABORT);
+  if (!parsed) {
+    return nullptr;
+  }
+
+  jstring text = toJString(env, snapshot.text);
+
+  std::vector<jint> runs;
+  runs.reserve(snapshot.runs.size() * 4);
+  for (const auto &run : snapshot.runs) {
+    runs.push_back(static_cast<jint>(run.range.start));
+    runs.push_back(static_cast<jint>(run.range.length));
+    runs.push_back(static_cast<jint>(run.type));
+    runs.push_back(run.value == DocumentSnapshot::kNoString
+                       ? -1
+                       : static_cast<jint>(run.value));
+  }
+  jintArray runsJArray = env->NewIntArray(static_cast<jsize>(runs.size()));
+  env->SetIntArrayRegion(runsJArray, 0, static_cast<jsize>(runs.size()),
+                         runs.data());
+
+  jclass stringClass = env->FindClass("java/lang/String");
+  jobjectArray strings = env->NewObjectArray(
+      static_cast<jsize>(snapshot.strings.size()), stringClass, nullptr);
+  for (size_t i = 0; i < snapshot.strings.size(); i++) {
+    jstring string = toJString(env, enriched::utf8ToUtf16(snapshot.strings[i]));
+    env->SetObjectArrayElement(strings, static_cast<jsize>(i), string);
+    env->DeleteLocalRef(string);
+  }
+
+  jmethodID constructor = env->GetMethodID(
+      cls, "<init>", "(Ljava/lang/String;[I[Ljava/lang/String;)V");
+  return env->NewObject(cls, constructor, text, runsJArray, strings);
+}
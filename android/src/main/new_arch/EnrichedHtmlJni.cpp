@@ -0,0 +1,10 @@
+#include "EnrichedHtmlHostObject.hpp"
+#include <jni.h>
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_EnrichedHtmlModule_nativeInstall(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong runtimePointer) {
+  // Called from the JS thread through the blocking `install` method.
+  auto *runtime = reinterpret_cast<facebook::jsi::Runtime *>(runtimePointer);
+  enriched::EnrichedHtmlHostObject::install(*runtime);
+}
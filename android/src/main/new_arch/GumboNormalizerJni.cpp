@@ -1,14 +1,154 @@
 #include "GumboParser.hpp"
+#include "NormalizationWorker.hpp"
+#include "TextEncoding.hpp"
 #include <jni.h>
+#include <memory>
 #include <string>
 
+// Java strings are UTF-16; GetStringUTFChars would hand Gumbo modified UTF-8,
+// where emoji arrive as CESU-8 surrogate pairs. Transcode the UTF-16 buffer
+// directly instead, once in each direction, through per-thread buffers that
+// keep their capacity between calls.
 extern "C" JNIEXPORT jstring JNICALL
 Java_com_swmansion_enriched_common_GumboNormalizer_normalizeHtml(
     JNIEnv *env, jclass /*cls*/, jstring htmlJString) {
-  const char *htmlChars = env->GetStringUTFChars(htmlJString, nullptr);
-  std::string result = GumboParser::normalizeHtml(htmlChars);
-  env->ReleaseStringUTFChars(htmlJString, htmlChars);
-  if (result.empty())
+  thread_local std::string utf8;
+  thread_local std::u16string utf16;
+
+  jsize length = env->GetStringLength(htmlJString);
+  const jchar *chars = env->GetStringCritical(htmlJString, nullptr);
+  enriched::utf16ToUtf8(reinterpret_cast<const char16_t *>(chars), length,
+                        utf8);
+  env->ReleaseStringCritical(htmlJString, chars);
+
+  bool normalized = GumboParser::normalizeHtmlForView(
+      utf8.data(), utf8.size(), [](const char *data, size_t size) {
+        enriched::utf8ToUtf16(data, size, utf16);
+      });
+  if (!normalized || utf16.empty())
     return nullptr;
-  return env->NewStringUTF(result.c_str());
+  return env->NewString(reinterpret_cast<const jchar *>(utf16.data()),
+                        static_cast<jsize>(utf16.size()));
+}
+
+// Hashes the UTF-8 the normalizer produced, so the result doesn't depend on
+// which side of the bridge computed it.
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_swmansion_enriched_common_GumboNormalizer_hashNormalized(
+    JNIEnv *env, jclass /*cls*/, jstring normalizedJString) {
+  thread_local std::string utf8;
+
+  jsize length = env->GetStringLength(normalizedJString);
+  const jchar *chars = env->GetStringCritical(normalizedJString, nullptr);
+  enriched::utf16ToUtf8(reinterpret_cast<const char16_t *>(chars), length,
+                        utf8);
+  env->ReleaseStringCritical(normalizedJString, chars);
+
+  return static_cast<jlong>(
+      GumboParser::hashNormalized(utf8.data(), utf8.size()));
+}
+
+/* --- Background normalization --- */
+
+namespace {
+
+JavaVM *javaVm = nullptr;
+
+/**
+ * JNIEnv of the current thread. The worker thread is attached on first use
+ * and detached when it exits; Java threads already have one.
+ */
+JNIEnv *currentEnv() {
+  JNIEnv *env = nullptr;
+  if (javaVm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6) ==
+      JNI_OK)
+    return env;
+
+  struct Attachment {
+    JNIEnv *env = nullptr;
+    ~Attachment() {
+      if (env)
+        javaVm->DetachCurrentThread();
+    }
+  };
+  thread_local Attachment attachment;
+  javaVm->AttachCurrentThread(&attachment.env, nullptr);
+  return attachment.env;
+}
+
+/**
+ * Global ref to the Kotlin NormalizationTask, released with the job whether
+ * it completes or is skipped.
+ */
+class TaskRef {
+public:
+  TaskRef(JNIEnv *env, jobject task) : task_(env->NewGlobalRef(task)) {
+    jclass cls = env->GetObjectClass(task);
+    onNormalized_ =
+        env->GetMethodID(cls, "onNormalized", "(Ljava/lang/String;)V");
+    env->DeleteLocalRef(cls);
+  }
+  ~TaskRef() { currentEnv()->DeleteGlobalRef(task_); }
+
+  TaskRef(const TaskRef &) = delete;
+  TaskRef &operator=(const TaskRef &) = delete;
+
+  void deliver(JNIEnv *env, jstring html) const {
+    env->CallVoidMethod(task_, onNormalized_, html);
+    if (env->ExceptionCheck())
+      env->ExceptionClear();
+  }
+
+private:
+  jobject task_;
+  jmethodID onNormalized_;
+};
+
+using TokenHandle = std::shared_ptr<enriched::CancellationToken>;
+
+} // namespace
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_swmansion_enriched_common_NormalizationTask_nativeSubmit(
+    JNIEnv *env, jclass /*cls*/, jstring htmlJString, jobject task) {
+  if (javaVm == nullptr)
+    env->GetJavaVM(&javaVm);
+
+  // The job owns its copy; only the transcoding happens on this thread.
+  std::string utf8;
+  jsize length = env->GetStringLength(htmlJString);
+  const jchar *chars = env->GetStringCritical(htmlJString, nullptr);
+  enriched::utf16ToUtf8(reinterpret_cast<const char16_t *>(chars), length,
+                        utf8);
+  env->ReleaseStringCritical(htmlJString, chars);
+
+  auto ref = std::make_shared<TaskRef>(env, task);
+  TokenHandle token = enriched::NormalizationWorker::shared().submit(
+      std::move(utf8), [ref](const char *html, size_t size) {
+        thread_local std::u16string utf16;
+        JNIEnv *workerJni = currentEnv();
+        jstring result = nullptr;
+        if (html != nullptr && size > 0) {
+          enriched::utf8ToUtf16(html, size, utf16);
+          result = workerJni->NewString(
+              reinterpret_cast<const jchar *>(utf16.data()),
+              static_cast<jsize>(utf16.size()));
+        }
+        ref->deliver(workerJni, result);
+        if (result != nullptr)
+          workerJni->DeleteLocalRef(result);
+      });
+  return reinterpret_cast<jlong>(new TokenHandle(std::move(token)));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_NormalizationTask_nativeCancel(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle) {
+  (*reinterpret_cast<TokenHandle *>(handle))->cancel();
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_NormalizationTask_nativeDestroy(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle) {
+  delete reinterpret_cast<TokenHandle *>(handle);
 }
@@ -0,0 +1,57 @@
+#include "LinkDetector.hpp"
+#include <jni.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using enriched::LinkDetector;
+using enriched::LinkRegexConfig;
+using enriched::TextRange;
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_swmansion_enriched_common_LinkDetector_nativeCreate(
+    JNIEnv *env, jclass /*cls*/, jstring patternJString,
+    jboolean caseInsensitive, jboolean dotAll) {
+  LinkRegexConfig config;
+  if (patternJString != nullptr) {
+    const jchar *chars = env->GetStringChars(patternJString, nullptr);
+    config.pattern.assign(reinterpret_cast<const char16_t *>(chars),
+                          env->GetStringLength(patternJString));
+    env->ReleaseStringChars(patternJString, chars);
+    config.isDefault = false;
+    config.caseInsensitive = caseInsensitive;
+    config.dotAll = dotAll;
+  }
+  std::unique_ptr<LinkDetector> detector = LinkDetector::fromConfig(config);
+  return reinterpret_cast<jlong>(detector.release());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_LinkDetector_nativeDestroy(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle) {
+  delete reinterpret_cast<LinkDetector *>(handle);
+}
+
+extern "C" JNIEXPORT jintArray JNICALL
+Java_com_swmansion_enriched_common_LinkDetector_nativeDetect(
+    JNIEnv *env, jclass /*cls*/, jlong handle, jstring textJString) {
+  auto *detector = reinterpret_cast<LinkDetector *>(handle);
+  jsize length = env->GetStringLength(textJString);
+  const jchar *chars = env->GetStringCritical(textJString, nullptr);
+  std::vector<TextRange> links =
+      detector->detect(reinterpret_cast<const char16_t *>(chars), length,
+                       {0, static_cast<size_t>(length)});
+  env->ReleaseStringCritical(textJString, chars);
+
+  std::vector<jint> flat;
+  flat.reserve(links.size() * 2);
+  for (const TextRange &link : links) {
+    flat.push_back(static_cast<jint>(link.start));
+    flat.push_back(static_cast<jint>(link.end()));
+  }
+  jintArray result = env->NewIntArray(static_cast<jsize>(flat.size()));
+  if (result != nullptr && !flat.empty())
+    env->SetIntArrayRegion(result, 0, static_cast<jsize>(flat.size()),
+                           flat.data());
+  return result;
+}
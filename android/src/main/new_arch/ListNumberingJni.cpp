@@ -0,0 +1,86 @@
+#include "ListNumbering.hpp"
+#include <jni.h>
+#include <string>
+
+using enriched::ListNumbering;
+using enriched::TextRange;
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_swmansion_enriched_common_ListNumbering_nativeCreate(
+    JNIEnv * /*env*/, jclass /*cls*/) {
+  return reinterpret_cast<jlong>(new ListNumbering());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_ListNumbering_nativeDestroy(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle) {
+  delete reinterpret_cast<ListNumbering *>(handle);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_ListNumbering_nativeReset(
+    JNIEnv *env, jclass /*cls*/, jlong handle, jstring textJString) {
+  auto *numbering = reinterpret_cast<ListNumbering *>(handle);
+  jsize length = env->GetStringLength(textJString);
+  const jchar *chars = env->GetStringCritical(textJString, nullptr);
+  std::u16string text(reinterpret_cast<const char16_t *>(chars), length);
+  env->ReleaseStringCritical(textJString, chars);
+  numbering->reset(text);
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_swmansion_enriched_common_ListNumbering_nativeApplyEdit(
+    JNIEnv *env, jclass /*cls*/, jlong handle, jint start, jint removed,
+    jstring replacementJString) {
+  auto *numbering = reinterpret_cast<ListNumbering *>(handle);
+  jsize length = env->GetStringLength(replacementJString);
+  const jchar *chars = env->GetStringCritical(replacementJString, nullptr);
+  TextRange touched = numbering->applyEdit(
+      TextRange{static_cast<size_t>(start), static_cast<size_t>(removed)},
+      reinterpret_cast<const char16_t *>(chars), length);
+  env->ReleaseStringCritical(replacementJString, chars);
+  return (static_cast<jlong>(touched.start) << 32) |
+         static_cast<jlong>(touched.length);
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_swmansion_enriched_common_ListNumbering_nativeLength(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle) {
+  return static_cast<jint>(
+      reinterpret_cast<ListNumbering *>(handle)->length());
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_swmansion_enriched_common_ListNumbering_nativeParagraphCount(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle) {
+  return static_cast<jint>(
+      reinterpret_cast<ListNumbering *>(handle)->paragraphCount());
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_swmansion_enriched_common_ListNumbering_nativeParagraphAt(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle, jint offset) {
+  auto *numbering = reinterpret_cast<ListNumbering *>(handle);
+  return static_cast<jint>(numbering->paragraphs().paragraphAt(offset));
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_swmansion_enriched_common_ListNumbering_nativeParagraphStart(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle, jint paragraph) {
+  auto *numbering = reinterpret_cast<ListNumbering *>(handle);
+  return static_cast<jint>(numbering->paragraphs().paragraphStart(paragraph));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_ListNumbering_nativeSetItem(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle, jint paragraph,
+    jboolean isItem) {
+  reinterpret_cast<ListNumbering *>(handle)->setItem(paragraph, isItem);
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_swmansion_enriched_common_ListNumbering_nativeNumber(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle, jint paragraph) {
+  return static_cast<jint>(
+      reinterpret_cast<ListNumbering *>(handle)->number(paragraph));
+}
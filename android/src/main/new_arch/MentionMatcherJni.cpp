@@ -0,0 +1,42 @@
+#include "MentionMatcher.hpp"
+#include <jni.h>
+#include <string>
+#include <vector>
+
+using enriched::MentionMatcher;
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_swmansion_enriched_common_MentionMatcher_nativeCreate(
+    JNIEnv *env, jclass /*cls*/, jobjectArray indicatorsArray) {
+  jsize count = env->GetArrayLength(indicatorsArray);
+  std::vector<std::u16string> indicators;
+  indicators.reserve(count);
+  for (jsize i = 0; i < count; i++) {
+    auto indicator =
+        static_cast<jstring>(env->GetObjectArrayElement(indicatorsArray, i));
+    const jchar *chars = env->GetStringChars(indicator, nullptr);
+    indicators.emplace_back(reinterpret_cast<const char16_t *>(chars),
+                            env->GetStringLength(indicator));
+    env->ReleaseStringChars(indicator, chars);
+    env->DeleteLocalRef(indicator);
+  }
+  return reinterpret_cast<jlong>(new MentionMatcher(indicators));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_MentionMatcher_nativeDestroy(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle) {
+  delete reinterpret_cast<MentionMatcher *>(handle);
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_swmansion_enriched_common_MentionMatcher_nativeIndicatorAtStart(
+    JNIEnv *env, jclass /*cls*/, jlong handle, jstring wordJString) {
+  auto *matcher = reinterpret_cast<MentionMatcher *>(handle);
+  jsize length = env->GetStringLength(wordJString);
+  const jchar *chars = env->GetStringCritical(wordJString, nullptr);
+  int index = matcher->indicatorAtStart(
+      reinterpret_cast<const char16_t *>(chars), length);
+  env->ReleaseStringCritical(wordJString, chars);
+  return index;
+}
@@ -0,0 +1,192 @@
+#include "OperationLog.hpp"
+#include <jni.h>
+#include <string>
+#include <vector>
+
+using enriched::EditOperation;
+using enriched::kStyleTypeCount;
+using enriched::OperationLog;
+using enriched::OperationLogConfig;
+using enriched::StyleInterval;
+using enriched::StyleType;
+
+namespace {
+
+OperationLog *history(jlong handle) {
+  return reinterpret_cast<OperationLog *>(handle);
+}
+
+std::u16string toU16String(JNIEnv *env, jstring string) {
+  jsize length = env->GetStringLength(string);
+  std::u16string result(length, u'\0');
+  env->GetStringRegion(string, 0, length,
+                       reinterpret_cast<jchar *>(result.data()));
+  return result;
+}
+
+jstring toJString(JNIEnv *env, const std::u16string &string) {
+  return env->NewString(reinterpret_cast<const jchar *>(string.data()),
+                        static_cast<jsize>(string.size()));
+}
+
+// Flattened (start, end, type, value) quadruples, as StyleIndex uses them.
+std::vector<StyleInterval> toRuns(JNIEnv *env, jintArray runsArray) {
+  std::vector<StyleInterval> result;
+  jsize size = env->GetArrayLength(runsArray);
+  jint *runs = env->GetIntArrayElements(runsArray, nullptr);
+  result.reserve(size / 4);
+  for (jsize i = 0; i + 3 < size; i += 4) {
+    if (runs[i + 2] < 0 ||
+        static_cast<size_t>(runs[i + 2]) >= kStyleTypeCount ||
+        runs[i] < 0 || runs[i + 1] <= runs[i])
+      continue;
+    result.push_back({{static_cast<size_t>(runs[i]),
+                       static_cast<size_t>(runs[i + 1] - runs[i])},
+                      static_cast<StyleType>(runs[i + 2]),
+                      static_cast<uint32_t>(runs[i + 3])});
+  }
+  env->ReleaseIntArrayElements(runsArray, runs, JNI_ABORT);
+  return result;
+}
+
+jintArray toJRuns(JNIEnv *env, const std::vector<StyleInterval> &runs) {
+  std::vector<jint> values;
+  values.reserve(runs.size() * 4);
+  for (const StyleInterval &run : runs) {
+    values.insert(values.end(), {static_cast<jint>(run.range.start),
+                                 static_cast<jint>(run.range.end()),
+                                 static_cast<jint>(run.type),
+                                 static_cast<jint>(run.value)});
+  }
+  jintArray result = env->NewIntArray(static_cast<jsize>(values.size()));
+  env->SetIntArrayRegion(result, 0, static_cast<jsize>(values.size()),
+                         values.data());
+  return result;
+}
+
+jobjectArray toJOperations(JNIEnv *env,
+                           const std::vector<EditOperation> &operations) {
+  jclass cls =
+      env->FindClass("com/swmansion/enriched/common/OperationLog$Operation");
+  jmethodID constructor = env->GetMethodID(
+      cls, "<init>", "(IIILjava/lang/String;Ljava/lang/String;[I)V");
+  jobjectArray result =
+      env->NewObjectArray(static_cast<jsize>(operations.size()), cls, nullptr);
+  for (size_t i = 0; i < operations.size(); i++) {
+    const EditOperation &operation = operations[i];
+    jstring removedText = toJString(env, operation.removedText);
+    jstring insertedText = toJString(env, operation.insertedText);
+    jintArray runs = toJRuns(env, operation.spans);
+    jobject object = env->NewObject(
+        cls, constructor, static_cast<jint>(operation.kind),
+        static_cast<jint>(operation.range.start),
+        static_cast<jint>(operation.range.end()), removedText, insertedText,
+        runs);
+    env->SetObjectArrayElement(result, static_cast<jsize>(i), object);
+    env->DeleteLocalRef(object);
+    env->DeleteLocalRef(runs);
+    env->DeleteLocalRef(insertedText);
+    env->DeleteLocalRef(removedText);
+  }
+  return result;
+}
+
+} // namespace
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_swmansion_enriched_common_OperationLog_nativeCreate(JNIEnv * /*env*/,
+                                                             jclass /*cls*/,
+                                                             jint maxSteps,
+                                                             jint maxBytes) {
+  OperationLogConfig config;
+  config.maxGroups = static_cast<size_t>(maxSteps);
+  config.maxBytes = static_cast<size_t>(maxBytes);
+  return reinterpret_cast<jlong>(new OperationLog(config));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_OperationLog_nativeDestroy(JNIEnv * /*env*/,
+                                                              jclass /*cls*/,
+                                                              jlong handle) {
+  delete history(handle);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_OperationLog_nativeBeginGroup(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle) {
+  history(handle)->beginGroup();
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_OperationLog_nativeEndGroup(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle) {
+  history(handle)->endGroup();
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_OperationLog_nativeRecordReplace(
+    JNIEnv *env, jclass /*cls*/, jlong handle, jint start,
+    jstring removedText, jstring insertedText, jlong timestampMs,
+    jintArray removedRuns, jintArray insertedRuns) {
+  history(handle)->recordReplace(
+      static_cast<size_t>(start), toU16String(env, removedText),
+      toU16String(env, insertedText), static_cast<uint64_t>(timestampMs),
+      toRuns(env, removedRuns), toRuns(env, insertedRuns));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_OperationLog_nativeRecordStyles(
+    JNIEnv *env, jclass /*cls*/, jlong handle, jint start, jint end,
+    jintArray previousRuns, jintArray runs) {
+  if (end <= start)
+    return;
+  history(handle)->recordStyles(
+      {static_cast<size_t>(start), static_cast<size_t>(end - start)},
+      toRuns(env, previousRuns), toRuns(env, runs));
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_swmansion_enriched_common_OperationLog_nativeCanUndo(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle) {
+  return history(handle)->canUndo();
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_swmansion_enriched_common_OperationLog_nativeCanRedo(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle) {
+  return history(handle)->canRedo();
+}
+
+extern "C" JNIEXPORT jobjectArray JNICALL
+Java_com_swmansion_enriched_common_OperationLog_nativeUndo(JNIEnv *env,
+                                                           jclass /*cls*/,
+                                                           jlong handle) {
+  return toJOperations(env, history(handle)->undo());
+}
+
+extern "C" JNIEXPORT jobjectArray JNICALL
+Java_com_swmansion_enriched_common_OperationLog_nativeRedo(JNIEnv *env,
+                                                           jclass /*cls*/,
+                                                           jlong handle) {
+  return toJOperations(env, history(handle)->redo());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_OperationLog_nativeClear(JNIEnv * /*env*/,
+                                                            jclass /*cls*/,
+                                                            jlong handle) {
+  history(handle)->clear();
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_OperationLog_nativeSetValueSize(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle, jint value, jint bytes) {
+  history(handle)->setValueSize(static_cast<uint32_t>(value),
+                                static_cast<size_t>(bytes));
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_swmansion_enriched_common_OperationLog_nativeIsValueReferenced(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle, jint value) {
+  return history(handle)->isValueReferenced(static_cast<uint32_t>(value));
+}
@@ -0,0 +1,67 @@
+#include "ParagraphIndex.hpp"
+#include <algorithm>
+#include <jni.h>
+#include <string>
+
+using enriched::ParagraphIndex;
+using enriched::TextRange;
+
+namespace {
+
+std::u16string toU16String(JNIEnv *env, jstring string) {
+  jsize length = env->GetStringLength(string);
+  const jchar *chars = env->GetStringCritical(string, nullptr);
+  std::u16string result(reinterpret_cast<const char16_t *>(chars), length);
+  env->ReleaseStringCritical(string, chars);
+  return result;
+}
+
+} // namespace
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_swmansion_enriched_common_ParagraphIndex_nativeCreate(
+    JNIEnv * /*env*/, jclass /*cls*/) {
+  return reinterpret_cast<jlong>(new ParagraphIndex());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_ParagraphIndex_nativeDestroy(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle) {
+  delete reinterpret_cast<ParagraphIndex *>(handle);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_ParagraphIndex_nativeReset(
+    JNIEnv *env, jclass /*cls*/, jlong handle, jstring textJString) {
+  reinterpret_cast<ParagraphIndex *>(handle)->reset(
+      toU16String(env, textJString));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_ParagraphIndex_nativeApplyEdit(
+    JNIEnv *env, jclass /*cls*/, jlong handle, jint start, jint removed,
+    jstring replacementJString) {
+  reinterpret_cast<ParagraphIndex *>(handle)->applyEdit(
+      TextRange{static_cast<size_t>(start), static_cast<size_t>(removed)},
+      toU16String(env, replacementJString));
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_swmansion_enriched_common_ParagraphIndex_nativeBounds(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle, jint start, jint end) {
+  auto *index = reinterpret_cast<ParagraphIndex *>(handle);
+  size_t length = index->length();
+  size_t from = std::min(static_cast<size_t>(std::max(start, 0)), length);
+  size_t to = std::min(static_cast<size_t>(std::max(end, 0)), length);
+  size_t first = index->paragraphAt(from);
+  size_t last = index->paragraphAt(to);
+  size_t boundsStart = index->paragraphStart(first);
+  // The end stops before the last paragraph's '\n'
+  size_t boundsEnd = index->paragraphStart(last) + index->paragraphLength(last);
+  if (last + 1 < index->paragraphCount()) {
+    boundsEnd--;
+  }
+  boundsStart = std::min(boundsStart, boundsEnd);
+  return (static_cast<jlong>(boundsStart) << 32) |
+         static_cast<jlong>(boundsEnd);
+}
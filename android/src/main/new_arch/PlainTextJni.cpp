@@ -0,0 +1,26 @@
+#include "PlainText.hpp"
+#include <jni.h>
+#include <string>
+
+using enriched::PlainTextOptions;
+using enriched::stripPlainText;
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_swmansion_enriched_common_PlainText_nativeVisibleText(
+    JNIEnv *env, jclass /*cls*/, jstring textJString,
+    jchar attachmentReplacement) {
+  // Reused across calls; onChangeText fires on every keystroke.
+  thread_local std::u16string buffer;
+  jsize length = env->GetStringLength(textJString);
+  buffer.resize(length);
+
+  PlainTextOptions options;
+  options.attachmentReplacement = attachmentReplacement;
+  const jchar *chars = env->GetStringCritical(textJString, nullptr);
+  size_t written = stripPlainText(reinterpret_cast<const char16_t *>(chars),
+                                  length, &buffer[0], options);
+  env->ReleaseStringCritical(textJString, chars);
+
+  return env->NewString(reinterpret_cast<const jchar *>(buffer.data()),
+                        static_cast<jsize>(written));
+}
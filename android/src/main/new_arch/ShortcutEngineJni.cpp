@@ -0,0 +1,99 @@
+#include "ShortcutEngine.hpp"
+#include <jni.h>
+#include <string>
+#include <vector>
+
+using enriched::ShortcutEngine;
+using enriched::ShortcutMatch;
+using enriched::TextShortcut;
+
+namespace {
+
+std::u16string toU16String(JNIEnv *env, jstring string) {
+  const jchar *chars = env->GetStringChars(string, nullptr);
+  std::u16string result(reinterpret_cast<const char16_t *>(chars),
+                        env->GetStringLength(string));
+  env->ReleaseStringChars(string, chars);
+  return result;
+}
+
+std::string toUtf8String(JNIEnv *env, jstring string) {
+  const char *chars = env->GetStringUTFChars(string, nullptr);
+  std::string result(chars);
+  env->ReleaseStringUTFChars(string, chars);
+  return result;
+}
+
+// Per match: shortcut, then start and length of openDelete, closeDelete,
+// content and finalContent.
+constexpr size_t kMatchStride = 9;
+
+jintArray toJIntArray(JNIEnv *env, const std::vector<ShortcutMatch> &matches) {
+  std::vector<jint> flat;
+  flat.reserve(matches.size() * kMatchStride);
+  for (const ShortcutMatch &match : matches) {
+    flat.push_back(static_cast<jint>(match.shortcut));
+    for (const auto &range : {match.openDelete, match.closeDelete,
+                              match.content, match.finalContent}) {
+      flat.push_back(static_cast<jint>(range.start));
+      flat.push_back(static_cast<jint>(range.length));
+    }
+  }
+  jintArray result = env->NewIntArray(static_cast<jsize>(flat.size()));
+  env->SetIntArrayRegion(result, 0, static_cast<jsize>(flat.size()),
+                         flat.data());
+  return result;
+}
+
+} // namespace
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_swmansion_enriched_common_ShortcutEngine_nativeCreate(
+    JNIEnv *env, jclass /*cls*/, jobjectArray triggersArray,
+    jobjectArray stylesArray) {
+  jsize count = env->GetArrayLength(triggersArray);
+  std::vector<TextShortcut> shortcuts;
+  shortcuts.reserve(count);
+  for (jsize i = 0; i < count; i++) {
+    auto trigger =
+        static_cast<jstring>(env->GetObjectArrayElement(triggersArray, i));
+    auto style =
+        static_cast<jstring>(env->GetObjectArrayElement(stylesArray, i));
+    shortcuts.push_back({toU16String(env, trigger), toUtf8String(env, style)});
+    env->DeleteLocalRef(trigger);
+    env->DeleteLocalRef(style);
+  }
+  return reinterpret_cast<jlong>(new ShortcutEngine(shortcuts));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_ShortcutEngine_nativeDestroy(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle) {
+  delete reinterpret_cast<ShortcutEngine *>(handle);
+}
+
+extern "C" JNIEXPORT jintArray JNICALL
+Java_com_swmansion_enriched_common_ShortcutEngine_nativeParagraphMatches(
+    JNIEnv *env, jclass /*cls*/, jlong handle, jstring textJString,
+    jint triggerStart) {
+  auto *engine = reinterpret_cast<ShortcutEngine *>(handle);
+  jsize length = env->GetStringLength(textJString);
+  const jchar *chars = env->GetStringCritical(textJString, nullptr);
+  auto matches = engine->paragraphMatches(
+      reinterpret_cast<const char16_t *>(chars), length, triggerStart);
+  env->ReleaseStringCritical(textJString, chars);
+  return toJIntArray(env, matches);
+}
+
+extern "C" JNIEXPORT jintArray JNICALL
+Java_com_swmansion_enriched_common_ShortcutEngine_nativeInlineMatches(
+    JNIEnv *env, jclass /*cls*/, jlong handle, jstring textJString,
+    jint paragraphStart) {
+  auto *engine = reinterpret_cast<ShortcutEngine *>(handle);
+  jsize length = env->GetStringLength(textJString);
+  const jchar *chars = env->GetStringCritical(textJString, nullptr);
+  auto matches = engine->inlineMatches(
+      reinterpret_cast<const char16_t *>(chars), length, paragraphStart);
+  env->ReleaseStringCritical(textJString, chars);
+  return toJIntArray(env, matches);
+}
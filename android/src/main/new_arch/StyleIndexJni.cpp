@@ -0,0 +1,109 @@
+#include "StyleIntervalTree.hpp"
+#include <algorithm>
+#include <jni.h>
+#include <vector>
+
+using enriched::kStyleTypeCount;
+using enriched::StyleInterval;
+using enriched::StyleIntervalTree;
+using enriched::StyleType;
+using enriched::TextRange;
+
+static StyleIntervalTree *tree(jlong handle) {
+  return reinterpret_cast<StyleIntervalTree *>(handle);
+}
+
+static TextRange toRange(jint start, jint end) {
+  return {static_cast<size_t>(start), static_cast<size_t>(end - start)};
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_swmansion_enriched_common_StyleIndex_nativeCreate(JNIEnv * /*env*/,
+                                                           jclass /*cls*/) {
+  return reinterpret_cast<jlong>(new StyleIntervalTree());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_StyleIndex_nativeDestroy(JNIEnv * /*env*/,
+                                                            jclass /*cls*/,
+                                                            jlong handle) {
+  delete tree(handle);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_StyleIndex_nativeApplyEdit(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle, jint start, jint removed,
+    jint count) {
+  StyleIntervalTree *index = tree(handle);
+  index->applyDeletion(
+      {static_cast<size_t>(start), static_cast<size_t>(removed)});
+  index->applyInsertion(static_cast<size_t>(start),
+                        static_cast<size_t>(count));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_StyleIndex_nativeReplace(
+    JNIEnv *env, jclass /*cls*/, jlong handle, jint start, jint end,
+    jintArray runsArray) {
+  StyleIntervalTree *index = tree(handle);
+  TextRange range = toRange(start, end);
+  for (size_t i = 0; i < kStyleTypeCount; i++)
+    index->remove(range, static_cast<StyleType>(i));
+
+  jsize size = env->GetArrayLength(runsArray);
+  jint *runs = env->GetIntArrayElements(runsArray, nullptr);
+  for (jsize i = 0; i + 3 < size; i += 4) {
+    if (runs[i + 2] < 0 ||
+        static_cast<size_t>(runs[i + 2]) >= kStyleTypeCount ||
+        runs[i + 1] <= runs[i])
+      continue;
+    index->add({toRange(runs[i], runs[i + 1]),
+                static_cast<StyleType>(runs[i + 2]),
+                static_cast<uint32_t>(runs[i + 3])});
+  }
+  env->ReleaseIntArrayElements(runsArray, runs, JNI_ABORT);
+}
+
+extern "C" JNIEXPORT jintArray JNICALL
+Java_com_swmansion_enriched_common_StyleIndex_nativeRuns(JNIEnv *env,
+                                                         jclass /*cls*/,
+                                                         jlong handle,
+                                                         jint start,
+                                                         jint end) {
+  std::vector<jint> runs;
+  if (end > start) {
+    for (const StyleInterval &run :
+         tree(handle)->intervalsIntersecting(toRange(start, end))) {
+      jint runStart = std::max(static_cast<jint>(run.range.start), start);
+      jint runEnd = std::min(static_cast<jint>(run.range.end()), end);
+      if (runEnd <= runStart)
+        continue;
+      runs.insert(runs.end(), {runStart, runEnd, static_cast<jint>(run.type),
+                               static_cast<jint>(run.value)});
+    }
+  }
+  jintArray result = env->NewIntArray(static_cast<jsize>(runs.size()));
+  env->SetIntArrayRegion(result, 0, static_cast<jsize>(runs.size()),
+                         runs.data());
+  return result;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_StyleIndex_nativeClear(JNIEnv * /*env*/,
+                                                          jclass /*cls*/,
+                                                          jlong handle) {
+  tree(handle)->clear();
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_swmansion_enriched_common_StyleIndex_nativeStylesIntersecting(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle, jint start, jint end) {
+  return static_cast<jint>(
+      tree(handle)->stylesIntersecting(toRange(start, end)));
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_swmansion_enriched_common_StyleIndex_nativeStylesCovering(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle, jint start, jint end) {
+  return static_cast<jint>(tree(handle)->stylesCovering(toRange(start, end)));
+}
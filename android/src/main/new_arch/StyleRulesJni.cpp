@@ -0,0 +1,28 @@
+#include "StyleRules.hpp"
+#include <jni.h>
+
+using enriched::kStyleTypeCount;
+using enriched::StyleRules;
+using enriched::StyleType;
+
+extern "C" JNIEXPORT jintArray JNICALL
+Java_com_swmansion_enriched_common_StyleRules_nativeRules(
+    JNIEnv *env, jclass /*cls*/, jint boldHeadings) {
+  StyleRules rules;
+  for (int i = 0; i < 6; i++) {
+    auto heading = static_cast<StyleType>(static_cast<int>(StyleType::H1) + i);
+    rules.setHeadingBold(heading, (boldHeadings >> i) & 1);
+  }
+
+  // conflicts of every style, then blocks of every style
+  jint masks[2 * kStyleTypeCount];
+  for (size_t i = 0; i < kStyleTypeCount; i++) {
+    auto type = static_cast<StyleType>(i);
+    masks[i] = static_cast<jint>(rules.conflicts(type));
+    masks[kStyleTypeCount + i] = static_cast<jint>(rules.blocks(type));
+  }
+
+  jintArray result = env->NewIntArray(2 * kStyleTypeCount);
+  env->SetIntArrayRegion(result, 0, 2 * kStyleTypeCount, masks);
+  return result;
+}
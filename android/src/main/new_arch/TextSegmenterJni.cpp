@@ -0,0 +1,78 @@
+#include "TextSegmenter.hpp"
+#include <jni.h>
+#include <vector>
+
+using enriched::TextRange;
+using enriched::TextWindow;
+
+namespace {
+
+/** Pins `chars` for the duration of a segmenter call. */
+class CriticalWindow {
+public:
+  CriticalWindow(JNIEnv *env, jcharArray chars, jint windowStart,
+                 jint textLength)
+      : env_(env), chars_(chars),
+        data_(env->GetPrimitiveArrayCritical(chars, nullptr)) {
+    window_ = TextWindow(static_cast<const char16_t *>(data_), windowStart,
+                         env->GetArrayLength(chars), textLength);
+  }
+  ~CriticalWindow() {
+    env_->ReleasePrimitiveArrayCritical(chars_, data_, JNI_ABORT);
+  }
+
+  const TextWindow &window() const { return window_; }
+
+private:
+  JNIEnv *env_;
+  jcharArray chars_;
+  void *data_;
+  TextWindow window_;
+};
+
+} // namespace
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_swmansion_enriched_common_TextSegmenter_nativeTokenAt(
+    JNIEnv *env, jclass /*cls*/, jcharArray chars, jint windowStart,
+    jint textLength, jint position) {
+  TextRange token;
+  bool found;
+  {
+    CriticalWindow window(env, chars, windowStart, textLength);
+    found = enriched::tokenAt(window.window(), position, token);
+  }
+  if (!found)
+    return -1;
+  return (static_cast<jlong>(token.start) << 32) |
+         static_cast<jlong>(token.end());
+}
+
+extern "C" JNIEXPORT jintArray JNICALL
+Java_com_swmansion_enriched_common_TextSegmenter_nativeTokensIn(
+    JNIEnv *env, jclass /*cls*/, jcharArray chars, jint windowStart,
+    jint textLength, jint start, jint end) {
+  std::vector<TextRange> tokens;
+  bool found;
+  {
+    CriticalWindow window(env, chars, windowStart, textLength);
+    found = enriched::tokensIn(window.window(),
+                               {static_cast<size_t>(start),
+                                static_cast<size_t>(end - start)},
+                               tokens);
+  }
+  if (!found)
+    return nullptr;
+
+  std::vector<jint> flat;
+  flat.reserve(tokens.size() * 2);
+  for (const TextRange &token : tokens) {
+    flat.push_back(static_cast<jint>(token.start));
+    flat.push_back(static_cast<jint>(token.end()));
+  }
+  jintArray result = env->NewIntArray(static_cast<jsize>(flat.size()));
+  if (result != nullptr && !flat.empty())
+    env->SetIntArrayRegion(result, 0, static_cast<jsize>(flat.size()),
+                           flat.data());
+  return result;
+}
@@ -0,0 +1,54 @@
+#include "VisibleIndex.hpp"
+#include <jni.h>
+
+using enriched::TextRange;
+using enriched::VisibleIndex;
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_swmansion_enriched_common_VisibleIndex_nativeCreate(
+    JNIEnv * /*env*/, jclass /*cls*/) {
+  return reinterpret_cast<jlong>(new VisibleIndex());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_VisibleIndex_nativeDestroy(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle) {
+  delete reinterpret_cast<VisibleIndex *>(handle);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_VisibleIndex_nativeReset(
+    JNIEnv *env, jclass /*cls*/, jlong handle, jstring textJString) {
+  auto *index = reinterpret_cast<VisibleIndex *>(handle);
+  jsize length = env->GetStringLength(textJString);
+  const jchar *chars = env->GetStringCritical(textJString, nullptr);
+  index->reset(reinterpret_cast<const char16_t *>(chars), length);
+  env->ReleaseStringCritical(textJString, chars);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_swmansion_enriched_common_VisibleIndex_nativeApplyEdit(
+    JNIEnv *env, jclass /*cls*/, jlong handle, jint start, jint removed,
+    jstring replacementJString) {
+  auto *index = reinterpret_cast<VisibleIndex *>(handle);
+  jsize length = env->GetStringLength(replacementJString);
+  const jchar *chars = env->GetStringCritical(replacementJString, nullptr);
+  index->applyEdit(
+      TextRange{static_cast<size_t>(start), static_cast<size_t>(removed)},
+      reinterpret_cast<const char16_t *>(chars), length);
+  env->ReleaseStringCritical(replacementJString, chars);
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_swmansion_enriched_common_VisibleIndex_nativeVisibleIndex(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle, jint storageIndex) {
+  auto *index = reinterpret_cast<VisibleIndex *>(handle);
+  return static_cast<jint>(index->visibleIndex(storageIndex));
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_swmansion_enriched_common_VisibleIndex_nativeStorageIndex(
+    JNIEnv * /*env*/, jclass /*cls*/, jlong handle, jint visibleIndex) {
+  auto *index = reinterpret_cast<VisibleIndex *>(handle);
+  return static_cast<jint>(index->storageIndex(visibleIndex));
+}
@@ -1,5 +1,4 @@
 #include "EnrichedTextInputMeasurementManager.h"
-#include "conversions.h"
 
 #include <fbjni/fbjni.h>
 #include <react/jni/ReadableNativeMap.h>
@@ -10,8 +9,15 @@ using namespace facebook::jni;
 namespace facebook::react {
 
 Size EnrichedTextInputMeasurementManager::measure(
-    SurfaceId surfaceId, int viewTag, const EnrichedTextInputViewProps &props,
-    LayoutConstraints layoutConstraints) const {
+    SurfaceId surfaceId, int viewTag, const LayoutKey &layoutKey,
+    int stateCounter, LayoutConstraints layoutConstraints) const {
+  MeasurementKey key{layoutKey.hash, layoutKey.props, viewTag, stateCounter,
+                     layoutConstraints.minimumSize,
+                     layoutConstraints.maximumSize};
+  if (auto cached = cache_.find(key)) {
+    return *cached;
+  }
+
   const jni::global_ref<jobject> &fabricUIManager =
       contextContainer_->at<jni::global_ref<jobject>>("FabricUIManager");
 
@@ -35,10 +41,9 @@ Size EnrichedTextInputMeasurementManager::measure(
   local_ref<ReadableMap::javaobject> extraDataRM =
       make_local(reinterpret_cast<ReadableMap::javaobject>(extraDataRNM.get()));
 
-  // Prepare layout metrics affecting props
-  auto serializedProps = toDynamic(props);
+  // Pass layout metrics affecting props
   local_ref<ReadableNativeMap::javaobject> propsRNM =
-      ReadableNativeMap::newObjectCxxArgs(serializedProps);
+      ReadableNativeMap::newObjectCxxArgs(*layoutKey.props);
   local_ref<ReadableMap::javaobject> propsRM =
       make_local(reinterpret_cast<ReadableMap::javaobject>(propsRNM.get()));
 
@@ -47,6 +52,7 @@ Size EnrichedTextInputMeasurementManager::measure(
               extraDataRM.get(), propsRM.get(), nullptr, minimumSize.width,
               maximumSize.width, minimumSize.height, maximumSize.height));
 
+  cache_.insert(key, measurement);
   return measurement;
 }
 
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "ComponentDescriptors.h"
+#include "MeasurementCache.h"
+#include "conversions.h"
 
 #include <react/renderer/components/ReactNativeEnrichedSpec/Props.h>
 #include <react/renderer/core/LayoutConstraints.h>
@@ -14,12 +16,15 @@ public:
       const std::shared_ptr<const ContextContainer> &contextContainer)
       : contextContainer_(contextContainer) {}
 
-  Size measure(SurfaceId surfaceId, int viewTag,
-               const EnrichedTextInputViewProps &props,
-               LayoutConstraints layoutConstraints) const;
+  // `layoutKey` is built once per shadow node from its props. The size also
+  // depends on the text in the native view, which bumps `stateCounter`
+  // whenever it would measure differently.
+  Size measure(SurfaceId surfaceId, int viewTag, const LayoutKey &layoutKey,
+               int stateCounter, LayoutConstraints layoutConstraints) const;
 
 private:
   const std::shared_ptr<const ContextContainer> contextContainer_;
+  mutable MeasurementCache cache_;
 };
 
 } // namespace facebook::react
@@ -28,8 +28,15 @@ void EnrichedTextInputShadowNode::dirtyLayoutIfNeeded() {
 Size EnrichedTextInputShadowNode::measureContent(
     const LayoutContext &layoutContext,
     const LayoutConstraints &layoutConstraints) const {
-  return measurementsManager_->measure(getSurfaceId(), getTag(),
-                                       getConcreteProps(), layoutConstraints);
+  return measurementsManager_->measure(
+      getSurfaceId(), getTag(), layoutKey(),
+      getStateData().getForceHeightRecalculationCounter(), layoutConstraints);
+}
+
+const LayoutKey &EnrichedTextInputShadowNode::layoutKey() const {
+  std::call_once(layoutKeyOnce_,
+                 [this] { layoutKey_ = makeLayoutKey(getConcreteProps()); });
+  return layoutKey_;
 }
 
 } // namespace facebook::react
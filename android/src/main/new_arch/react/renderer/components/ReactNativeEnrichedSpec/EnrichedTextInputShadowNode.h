@@ -7,6 +7,8 @@
 #include <react/renderer/components/ReactNativeEnrichedSpec/Props.h>
 #include <react/renderer/components/view/ConcreteViewShadowNode.h>
 
+#include <mutex>
+
 namespace facebook::react {
 
 JSI_EXPORT extern const char EnrichedTextInputComponentName[];
@@ -46,7 +48,14 @@ public:
   measureContent(const LayoutContext &layoutContext,
                  const LayoutConstraints &layoutConstraints) const override;
 
+  const LayoutKey &layoutKey() const;
+
 private:
+  // The props that affect measurement, built on the first measure. Props
+  // never change for a node, so every later measure reuses them.
+  mutable std::once_flag layoutKeyOnce_;
+  mutable LayoutKey layoutKey_;
+
   int forceHeightRecalculationCounter_;
   std::shared_ptr<EnrichedTextInputMeasurementManager> measurementsManager_;
 };
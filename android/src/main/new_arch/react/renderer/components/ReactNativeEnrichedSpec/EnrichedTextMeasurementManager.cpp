@@ -1,5 +1,4 @@
 #include "EnrichedTextMeasurementManager.h"
-#include "conversions.h"
 
 #include <fbjni/fbjni.h>
 #include <react/jni/ReadableNativeMap.h>
@@ -10,8 +9,17 @@ using namespace facebook::jni;
 namespace facebook::react {
 
 Size EnrichedTextMeasurementManager::measure(
-    SurfaceId surfaceId, int viewTag, const EnrichedTextViewProps &props,
+    SurfaceId surfaceId, int viewTag, const LayoutKey &layoutKey,
     LayoutConstraints layoutConstraints) const {
+  // The size only depends on props, so equal props share entries across
+  // views.
+  MeasurementKey key{layoutKey.hash, layoutKey.props, 0, 0,
+                     layoutConstraints.minimumSize,
+                     layoutConstraints.maximumSize};
+  if (auto cached = cache_.find(key)) {
+    return *cached;
+  }
+
   const jni::global_ref<jobject> &fabricUIManager =
       contextContainer_->at<jni::global_ref<jobject>>("FabricUIManager");
 
@@ -27,10 +35,9 @@ Size EnrichedTextMeasurementManager::measure(
 
   local_ref<JString> componentName = make_jstring("EnrichedTextView");
 
-  // Prepare layout metrics affecting props
-  auto serializedProps = toDynamic(props);
+  // Pass layout metrics affecting props
   local_ref<ReadableNativeMap::javaobject> propsRNM =
-      ReadableNativeMap::newObjectCxxArgs(serializedProps);
+      ReadableNativeMap::newObjectCxxArgs(*layoutKey.props);
   local_ref<ReadableMap::javaobject> propsRM =
       make_local(reinterpret_cast<ReadableMap::javaobject>(propsRNM.get()));
 
@@ -39,6 +46,7 @@ Size EnrichedTextMeasurementManager::measure(
               propsRM.get(), nullptr, minimumSize.width, maximumSize.width,
               minimumSize.height, maximumSize.height));
 
+  cache_.insert(key, measurement);
   return measurement;
 }
 
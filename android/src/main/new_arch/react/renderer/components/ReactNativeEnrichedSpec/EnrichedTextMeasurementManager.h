@@ -1,6 +1,8 @@
 #pragma once
 
 #include "ComponentDescriptors.h"
+#include "MeasurementCache.h"
+#include "conversions.h"
 
 #include <react/renderer/components/ReactNativeEnrichedSpec/Props.h>
 #include <react/renderer/core/LayoutConstraints.h>
@@ -14,12 +16,13 @@ public:
       const std::shared_ptr<const ContextContainer> &contextContainer)
       : contextContainer_(contextContainer) {}
 
-  Size measure(SurfaceId surfaceId, int viewTag,
-               const EnrichedTextViewProps &props,
+  // `layoutKey` is built once per shadow node from its props.
+  Size measure(SurfaceId surfaceId, int viewTag, const LayoutKey &layoutKey,
                LayoutConstraints layoutConstraints) const;
 
 private:
   const std::shared_ptr<const ContextContainer> contextContainer_;
+  mutable MeasurementCache cache_;
 };
 
 } // namespace facebook::react
@@ -14,8 +14,14 @@ void EnrichedTextShadowNode::setMeasurementsManager(
 Size EnrichedTextShadowNode::measureContent(
     const LayoutContext &layoutContext,
     const LayoutConstraints &layoutConstraints) const {
-  return measurementsManager_->measure(getSurfaceId(), getTag(),
-                                       getConcreteProps(), layoutConstraints);
+  return measurementsManager_->measure(getSurfaceId(), getTag(), layoutKey(),
+                                       layoutConstraints);
+}
+
+const LayoutKey &EnrichedTextShadowNode::layoutKey() const {
+  std::call_once(layoutKeyOnce_,
+                 [this] { layoutKey_ = makeLayoutKey(getConcreteProps()); });
+  return layoutKey_;
 }
 
 } // namespace facebook::react
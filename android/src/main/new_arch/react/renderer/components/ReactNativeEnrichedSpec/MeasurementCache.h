@@ -0,0 +1,96 @@
+#pragma once
+
+#include <folly/dynamic.h>
+#include <react/renderer/core/LayoutConstraints.h>
+#include <react/utils/hash_combine.h>
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace facebook::react {
+
+/**
+ * Everything a measurement depends on: the props that affect layout, the
+ * Yoga constraints and, for views measured from native state, the view and
+ * its state counter. The props hash only picks the bucket; equal hashes
+ * still compare the props, so a collision can't return another text's size.
+ */
+struct MeasurementKey {
+  size_t propsHash = 0;
+  std::shared_ptr<const folly::dynamic> props;
+  int viewTag = 0;
+  int stateCounter = 0;
+  Size minimumSize;
+  Size maximumSize;
+
+  bool operator==(const MeasurementKey &other) const {
+    return propsHash == other.propsHash && viewTag == other.viewTag &&
+           stateCounter == other.stateCounter &&
+           minimumSize == other.minimumSize &&
+           maximumSize == other.maximumSize &&
+           (props == other.props ||
+            (props && other.props && *props == *other.props));
+  }
+};
+
+/**
+ * Recent measurements of one component type, least recently used evicted
+ * first. Yoga measures a node several times per pass with the same
+ * constraints; a hit skips the props conversion, the JNI call and the text
+ * layout in Kotlin. Layout runs on more than one thread, hence the lock.
+ */
+class MeasurementCache {
+public:
+  explicit MeasurementCache(size_t capacity = 64) : capacity_(capacity) {}
+
+  std::optional<Size> find(const MeasurementKey &key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end())
+      return std::nullopt;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->second;
+  }
+
+  void insert(const MeasurementKey &key, Size size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      it->second->second = size;
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return;
+    }
+    entries_.emplace_front(key, size);
+    index_.emplace(key, entries_.begin());
+    if (entries_.size() > capacity_) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+  }
+
+private:
+  struct KeyHash {
+    size_t operator()(const MeasurementKey &key) const {
+      size_t seed = key.propsHash;
+      hash_combine(seed, key.viewTag, key.stateCounter,
+                   key.minimumSize.width, key.minimumSize.height,
+                   key.maximumSize.width, key.maximumSize.height);
+      return seed;
+    }
+  };
+
+  using Entry = std::pair<MeasurementKey, Size>;
+
+  std::mutex mutex_;
+  std::list<Entry> entries_; // most recently used first
+  std::unordered_map<MeasurementKey, std::list<Entry>::iterator, KeyHash>
+      index_;
+  const size_t capacity_;
+};
+
+} // namespace facebook::react
@@ -5,10 +5,62 @@
 #include <react/renderer/components/ReactNativeEnrichedSpec/Props.h>
 #include <react/renderer/core/propsConversions.h>
 
+#include <cstddef>
+#include <memory>
+
 namespace facebook::react {
 
-#ifdef RN_SERIALIZABLE_STATE
-inline folly::dynamic toDynamic(const EnrichedTextInputViewProps &props) {
+/**
+ * The props a measurement depends on, in the shape the Kotlin
+ * MeasurementStore reads them. Built once per shadow node: `props` is the map
+ * passed to FabricUIManager.measure and, with its `hash`, the props part of
+ * the MeasurementCache key, so both always cover the same fields. Cache
+ * entries share `props` instead of copying it.
+ */
+struct LayoutKey {
+  std::shared_ptr<const folly::dynamic> props;
+  size_t hash = 0;
+};
+
+inline LayoutKey layoutKeyFromDynamic(folly::dynamic props) {
+  LayoutKey key;
+  key.hash = props.hash();
+  key.props = std::make_shared<const folly::dynamic>(std::move(props));
+  return key;
+}
+
+// Only the htmlStyle fields that change line breaks or leading margins;
+// colors, decorations and mention styles only affect drawing. Both
+// components' generated style structs share these member names.
+template <typename HtmlStyle>
+folly::dynamic toLayoutDynamic(const HtmlStyle &style) {
+  auto heading = [](const auto &h) {
+    return folly::dynamic::object("fontSize", h.fontSize)("bold", h.bold);
+  };
+
+  folly::dynamic serialized = folly::dynamic::object();
+  serialized["h1"] = heading(style.h1);
+  serialized["h2"] = heading(style.h2);
+  serialized["h3"] = heading(style.h3);
+  serialized["h4"] = heading(style.h4);
+  serialized["h5"] = heading(style.h5);
+  serialized["h6"] = heading(style.h6);
+  serialized["blockquote"] =
+      folly::dynamic::object("borderWidth", style.blockquote.borderWidth)(
+          "gapWidth", style.blockquote.gapWidth);
+  serialized["ol"] = folly::dynamic::object("gapWidth", style.ol.gapWidth)(
+      "marginLeft", style.ol.marginLeft);
+  serialized["ul"] = folly::dynamic::object("bulletSize", style.ul.bulletSize)(
+      "marginLeft", style.ul.marginLeft)("gapWidth", style.ul.gapWidth);
+  serialized["ulCheckbox"] =
+      folly::dynamic::object("boxSize", style.ulCheckbox.boxSize)(
+          "marginLeft", style.ulCheckbox.marginLeft)(
+          "gapWidth", style.ulCheckbox.gapWidth);
+
+  return serialized;
+}
+
+inline LayoutKey makeLayoutKey(const EnrichedTextInputViewProps &props) {
   // Serialize only metrics affecting props
   folly::dynamic serializedProps = folly::dynamic::object();
   serializedProps["defaultValue"] = props.defaultValue;
@@ -19,13 +71,12 @@ inline folly::dynamic toDynamic(const EnrichedTextInputViewProps &props) {
   serializedProps["fontFamily"] = props.fontFamily;
   serializedProps["lineHeight"] = props.lineHeight;
   serializedProps["allowFontScaling"] = props.allowFontScaling;
-  serializedProps["htmlStyle"] = toDynamic(props.htmlStyle);
+  serializedProps["htmlStyle"] = toLayoutDynamic(props.htmlStyle);
 
-  return serializedProps;
+  return layoutKeyFromDynamic(std::move(serializedProps));
 }
-#endif
 
-inline folly::dynamic toDynamic(const EnrichedTextViewProps &props) {
+inline LayoutKey makeLayoutKey(const EnrichedTextViewProps &props) {
   // Serialize only metrics affecting props
   folly::dynamic serializedProps = folly::dynamic::object();
   serializedProps["text"] = props.text;
@@ -36,9 +87,9 @@ inline folly::dynamic toDynamic(const EnrichedTextViewProps &props) {
   serializedProps["numberOfLines"] = props.numberOfLines;
   serializedProps["ellipsizeMode"] = props.ellipsizeMode;
   serializedProps["allowFontScaling"] = props.allowFontScaling;
-  serializedProps["htmlStyle"] = toDynamic(props.htmlStyle);
+  serializedProps["htmlStyle"] = toLayoutDynamic(props.htmlStyle);
 
-  return serializedProps;
+  return layoutKeyFromDynamic(std::move(serializedProps));
 }
 
 } // namespace facebook::react
@@ -25821,6 +25821,8 @@ static GumboNode *new_document_node(GumboParser *parser) {
   document->name = NULL;
   document->public_identifier = NULL;
   document->system_identifier = NULL;
+  // Fragment parses never see the initial insertion mode that sets this.
+  document->doc_type_quirks_mode = GUMBO_DOCTYPE_NO_QUIRKS;
   return document_node;
 }
 
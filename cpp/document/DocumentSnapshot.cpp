@@ -0,0 +1,168 @@
+#include "DocumentSnapshot.hpp"
+#include "TextEncoding.hpp"
+
+#include <algorithm>
+
+namespace enriched {
+
+namespace {
+
+constexpr char kMagic[4] = {'E', 'N', 'R', 'S'};
+
+void writeVarint(std::string &out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+void writeUint16(std::string &out, uint16_t value) {
+  out.push_back(static_cast<char>(value & 0xFF));
+  out.push_back(static_cast<char>(value >> 8));
+}
+
+struct Reader {
+  const unsigned char *data;
+  size_t size;
+  size_t offset = 0;
+
+  bool readVarint(uint64_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (offset >= size)
+        return false;
+      unsigned char byte = data[offset++];
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  bool readUint16(uint16_t &value) {
+    if (size - offset < 2)
+      return false;
+    value = static_cast<uint16_t>(data[offset] | (data[offset + 1] << 8));
+    offset += 2;
+    return true;
+  }
+
+  bool readBytes(size_t length, const char *&bytes) {
+    if (size - offset < length)
+      return false;
+    bytes = reinterpret_cast<const char *>(data + offset);
+    offset += length;
+    return true;
+  }
+};
+
+} // namespace
+
+uint32_t DocumentSnapshot::internString(const std::string &value) {
+  auto it = stringIndex_.find(value);
+  if (it != stringIndex_.end() && it->second < strings.size() &&
+      strings[it->second] == value)
+    return it->second;
+  uint32_t index = static_cast<uint32_t>(strings.size());
+  strings.push_back(value);
+  stringIndex_[value] = index;
+  return index;
+}
+
+std::string DocumentSnapshot::serialize() const {
+  std::string utf8 = utf16ToUtf8(text);
+  size_t estimate = 16 + utf8.size() + runs.size() * 6;
+  for (const std::string &s : strings)
+    estimate += s.size() + 2;
+
+  std::string out;
+  out.reserve(estimate);
+  out.append(kMagic, sizeof(kMagic));
+  writeUint16(out, kVersion);
+  writeUint16(out, 0);
+
+  writeVarint(out, utf8.size());
+  out.append(utf8);
+
+  writeVarint(out, strings.size());
+  for (const std::string &s : strings) {
+    writeVarint(out, s.size());
+    out.append(s);
+  }
+
+  std::vector<StyleInterval> sorted(runs);
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](const StyleInterval &a, const StyleInterval &b) {
+                     return a.range.start < b.range.start;
+                   });
+  writeVarint(out, sorted.size());
+  size_t previousStart = 0;
+  for (const StyleInterval &run : sorted) {
+    writeVarint(out, run.range.start - previousStart);
+    writeVarint(out, run.range.length);
+    out.push_back(static_cast<char>(run.type));
+    // kNoString wraps around to 0, so runs without payload take one byte.
+    writeVarint(out, static_cast<uint32_t>(run.value + 1));
+    previousStart = run.range.start;
+  }
+  return out;
+}
+
+bool DocumentSnapshot::deserialize(const char *data, size_t size,
+                                   DocumentSnapshot &out) {
+  if (!data || size < 8 || !std::equal(kMagic, kMagic + 4, data))
+    return false;
+  Reader reader{reinterpret_cast<const unsigned char *>(data), size, 4};
+
+  uint16_t version, flags;
+  if (!reader.readUint16(version) || !reader.readUint16(flags) ||
+      version != kVersion)
+    return false;
+
+  uint64_t length;
+  const char *bytes;
+  if (!reader.readVarint(length) || !reader.readBytes(length, bytes))
+    return false;
+  out.text = utf8ToUtf16(bytes, length);
+
+  uint64_t count;
+  if (!reader.readVarint(count) || count > size)
+    return false;
+  out.strings.clear();
+  out.stringIndex_.clear();
+  out.strings.reserve(count);
+  for (uint64_t i = 0; i < count; i++) {
+    if (!reader.readVarint(length) || !reader.readBytes(length, bytes))
+      return false;
+    out.strings.emplace_back(bytes, length);
+    out.stringIndex_.emplace(out.strings.back(), static_cast<uint32_t>(i));
+  }
+
+  if (!reader.readVarint(count) || count > size)
+    return false;
+  out.runs.clear();
+  out.runs.reserve(count);
+  size_t start = 0;
+  for (uint64_t i = 0; i < count; i++) {
+    uint64_t delta, runLength, value;
+    const char *type;
+    if (!reader.readVarint(delta) || !reader.readVarint(runLength) ||
+        !reader.readBytes(1, type) || !reader.readVarint(value))
+      return false;
+    // start never passes the end of the text, so these can't wrap around.
+    if (delta > out.text.size() - start)
+      return false;
+    start += delta;
+    auto styleType = static_cast<StyleType>(static_cast<uint8_t>(*type));
+    if (styleType >= StyleType::None || runLength > out.text.size() - start ||
+        value > out.strings.size())
+      return false;
+    out.runs.push_back({{start, static_cast<size_t>(runLength)},
+                        styleType,
+                        static_cast<uint32_t>(value - 1)});
+  }
+  return reader.offset == size;
+}
+
+} // namespace enriched
@@ -0,0 +1,59 @@
+/**
+ * Compact binary document format for saving and restoring drafts without
+ * going through HTML.
+ */
+
+#pragma once
+
+#include "StyleIntervalTree.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace enriched {
+
+/**
+ * Text, style runs and a string pool holding run payloads (hrefs, mention
+ * attributes, image URIs, ...). A run's `value` is an index into `strings`,
+ * or kNoString for runs without a payload.
+ *
+ * Layout (version 1, integers are unsigned LEB128 unless noted):
+ *
+ *   "ENRS"                magic, 4 bytes
+ *   version               2 bytes, little endian
+ *   flags                 2 bytes, little endian, currently 0
+ *   textLength  bytes     UTF-8 text
+ *   stringCount { length bytes }
+ *   runCount    { startDelta length type(1 byte) value+1 }
+ *
+ * Run offsets are UTF-16 code units of the text and runs are stored sorted
+ * by start, each start relative to the previous one.
+ */
+struct DocumentSnapshot {
+  static constexpr uint16_t kVersion = 1;
+  static constexpr uint32_t kNoString = UINT32_MAX;
+
+  std::u16string text;
+  std::vector<StyleInterval> runs;
+  std::vector<std::string> strings;
+
+  /** Adds a string to the pool, reusing an equal one. */
+  uint32_t internString(const std::string &value);
+
+  std::string serialize() const;
+  /**
+   * Parses serialized bytes. Returns false for unknown versions and
+   * malformed or truncated input, leaving `out` unspecified.
+   */
+  static bool deserialize(const char *data, size_t size,
+                          DocumentSnapshot &out);
+  static bool deserialize(const std::string &bytes, DocumentSnapshot &out) {
+    return deserialize(bytes.data(), bytes.size(), out);
+  }
+
+private:
+  std::unordered_map<std::string, uint32_t> stringIndex_;
+};
+
+} // namespace enriched
@@ -0,0 +1,227 @@
+#include "ListNumbering.hpp"
+
+#include <algorithm>
+
+namespace enriched {
+
+ListNumbering::ListNumbering() { root_ = build(1); }
+
+ListNumbering::ListNumbering(const std::u16string &text) { reset(text); }
+
+void ListNumbering::reset(const std::u16string &text) {
+  paragraphs_.reset(text);
+  nodes_.clear();
+  freeNodes_.clear();
+  root_ = build(paragraphs_.paragraphCount());
+}
+
+/* ------------------------------------------------------------------ */
+/*  Treap plumbing                                                     */
+/* ------------------------------------------------------------------ */
+
+int ListNumbering::newNode() {
+  seed_ ^= seed_ << 13;
+  seed_ ^= seed_ >> 17;
+  seed_ ^= seed_ << 5;
+
+  Node node;
+  node.priority = seed_;
+
+  int index;
+  if (!freeNodes_.empty()) {
+    index = freeNodes_.back();
+    freeNodes_.pop_back();
+    nodes_[index] = node;
+  } else {
+    index = static_cast<int>(nodes_.size());
+    nodes_.push_back(node);
+  }
+  return index;
+}
+
+void ListNumbering::pull(int t) {
+  Node &n = nodes_[t];
+  size_t leftCount = count(n.left);
+  size_t rightCount = count(n.right);
+  size_t leftLeading = n.left == kNil ? 0 : nodes_[n.left].leadingItems;
+  size_t leftTrailing = n.left == kNil ? 0 : nodes_[n.left].trailingItems;
+  size_t rightLeading = n.right == kNil ? 0 : nodes_[n.right].leadingItems;
+  size_t rightTrailing = n.right == kNil ? 0 : nodes_[n.right].trailingItems;
+
+  n.count = leftCount + 1 + rightCount;
+  n.leadingItems = leftLeading;
+  if (leftLeading == leftCount && n.isItem)
+    n.leadingItems += 1 + rightLeading;
+  n.trailingItems = rightTrailing;
+  if (rightTrailing == rightCount && n.isItem)
+    n.trailingItems += 1 + leftTrailing;
+}
+
+void ListNumbering::split(int t, size_t count, int &left, int &right) {
+  // left: the first `count` paragraphs, right: the rest
+  if (t == kNil) {
+    left = right = kNil;
+    return;
+  }
+  size_t leftCount = this->count(nodes_[t].left);
+  if (count <= leftCount) {
+    int l, r;
+    split(nodes_[t].left, count, l, r);
+    nodes_[t].left = r;
+    pull(t);
+    left = l;
+    right = t;
+  } else {
+    int l, r;
+    split(nodes_[t].right, count - leftCount - 1, l, r);
+    nodes_[t].right = l;
+    pull(t);
+    left = t;
+    right = r;
+  }
+}
+
+int ListNumbering::merge(int left, int right) {
+  if (left == kNil)
+    return right;
+  if (right == kNil)
+    return left;
+  if (nodes_[left].priority > nodes_[right].priority) {
+    int merged = merge(nodes_[left].right, right);
+    nodes_[left].right = merged;
+    pull(left);
+    return left;
+  }
+  int merged = merge(left, nodes_[right].left);
+  nodes_[right].left = merged;
+  pull(right);
+  return right;
+}
+
+int ListNumbering::build(size_t count) {
+  // Linear-time construction: the stack holds the right spine, and a new
+  // node adopts the spine nodes of lower priority as its left subtree.
+  std::vector<int> spine;
+  for (size_t i = 0; i < count; i++) {
+    int node = newNode();
+    int adopted = kNil;
+    while (!spine.empty() &&
+           nodes_[spine.back()].priority < nodes_[node].priority) {
+      adopted = spine.back();
+      spine.pop_back();
+      pull(adopted);
+    }
+    nodes_[node].left = adopted;
+    if (!spine.empty())
+      nodes_[spine.back()].right = node;
+    spine.push_back(node);
+  }
+  for (size_t i = spine.size(); i-- > 0;)
+    pull(spine[i]);
+  return spine.empty() ? kNil : spine.front();
+}
+
+void ListNumbering::release(int t) {
+  std::vector<int> pending;
+  if (t != kNil)
+    pending.push_back(t);
+  while (!pending.empty()) {
+    int node = pending.back();
+    pending.pop_back();
+    for (int child : {nodes_[node].left, nodes_[node].right})
+      if (child != kNil)
+        pending.push_back(child);
+    freeNodes_.push_back(node);
+  }
+}
+
+int ListNumbering::find(size_t paragraph) const {
+  int t = root_;
+  while (t != kNil) {
+    size_t leftCount = count(nodes_[t].left);
+    if (paragraph < leftCount) {
+      t = nodes_[t].left;
+    } else if (paragraph == leftCount) {
+      return t;
+    } else {
+      paragraph -= leftCount + 1;
+      t = nodes_[t].right;
+    }
+  }
+  return kNil;
+}
+
+void ListNumbering::update(int t, size_t paragraph, bool isItem) {
+  size_t leftCount = count(nodes_[t].left);
+  if (paragraph < leftCount)
+    update(nodes_[t].left, paragraph, isItem);
+  else if (paragraph == leftCount)
+    nodes_[t].isItem = isItem;
+  else
+    update(nodes_[t].right, paragraph - leftCount - 1, isItem);
+  pull(t);
+}
+
+size_t ListNumbering::itemsEndingAt(int t, size_t count) const {
+  // Run of items at the end of the first `count` paragraphs of the subtree.
+  if (t == kNil || count == 0)
+    return 0;
+  const Node &n = nodes_[t];
+  size_t leftCount = this->count(n.left);
+  if (count <= leftCount)
+    return itemsEndingAt(n.left, count);
+  size_t rightPart = count - leftCount - 1;
+  size_t run = itemsEndingAt(n.right, rightPart);
+  if (run < rightPart || !n.isItem)
+    return run;
+  return run + 1 + (n.left == kNil ? 0 : nodes_[n.left].trailingItems);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Public API                                                         */
+/* ------------------------------------------------------------------ */
+
+TextRange ListNumbering::applyEdit(TextRange range,
+                                   const char16_t *replacement,
+                                   size_t replacementLength) {
+  size_t length = paragraphs_.length();
+  size_t from = std::min(range.start, length);
+  size_t to = std::min(range.end(), length);
+  size_t first = paragraphs_.paragraphAt(from);
+  size_t last = paragraphs_.paragraphAt(to);
+  size_t before = paragraphs_.paragraphCount();
+
+  paragraphs_.applyEdit({from, to - from},
+                        std::u16string(replacement, replacementLength));
+
+  // Paragraphs first + 1..last are gone; the new ones follow `first`.
+  size_t removed = last - first;
+  size_t added = paragraphs_.paragraphCount() + removed - before;
+  if (removed > 0 || added > 0) {
+    int left, middle, right;
+    split(root_, first + 1, left, right);
+    split(right, removed, middle, right);
+    release(middle);
+    root_ = merge(merge(left, build(added)), right);
+  }
+  return {first, added + 1};
+}
+
+void ListNumbering::setItem(size_t paragraph, bool isItem) {
+  if (paragraph >= paragraphCount() || this->isItem(paragraph) == isItem)
+    return;
+  update(root_, paragraph, isItem);
+}
+
+bool ListNumbering::isItem(size_t paragraph) const {
+  int t = find(paragraph);
+  return t != kNil && nodes_[t].isItem;
+}
+
+size_t ListNumbering::number(size_t paragraph) const {
+  if (!isItem(paragraph))
+    return 0;
+  return itemsEndingAt(root_, paragraph) + 1;
+}
+
+} // namespace enriched
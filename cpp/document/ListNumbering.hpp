@@ -0,0 +1,89 @@
+/**
+ * Ordered-list item numbers by paragraph.
+ * Replaces walking back through the preceding paragraphs every time a list
+ * marker is drawn, which made drawing an n-item list O(n²).
+ */
+
+#pragma once
+
+#include "ParagraphIndex.hpp"
+
+#include <string>
+#include <vector>
+
+namespace enriched {
+
+/**
+ * Which paragraphs are ordered-list items, kept in step with text edits.
+ * Consecutive items form one list, numbered from 1, so an item's number is
+ * one more than the length of the run of items right before it.
+ *
+ * Paragraphs are the nodes of an implicit treap (ordered by position, not by
+ * a key) that keeps, per subtree, the length of its leading and trailing
+ * runs of items. Setting a paragraph's state and asking for an item's
+ * number are O(log n); an edit that adds or removes k paragraphs is
+ * O(k log n) on top of ParagraphIndex's own update.
+ */
+class ListNumbering {
+public:
+  ListNumbering();
+  explicit ListNumbering(const std::u16string &text);
+
+  /** Paragraphs of the text, none of them items. */
+  void reset(const std::u16string &text);
+
+  const ParagraphIndex &paragraphs() const { return paragraphs_; }
+  size_t paragraphCount() const { return paragraphs_.paragraphCount(); }
+  size_t length() const { return paragraphs_.length(); }
+
+  /**
+   * Text in the range was replaced with `replacement`. The paragraph the
+   * edit starts in keeps its state; paragraphs the edit creates aren't
+   * items. Returns the paragraphs the edit touched as {first, count}, for
+   * the caller to re-read their list style.
+   */
+  TextRange applyEdit(TextRange range, const char16_t *replacement,
+                      size_t replacementLength);
+
+  void setItem(size_t paragraph, bool isItem);
+  bool isItem(size_t paragraph) const;
+
+  /** 1-based number of the item in its list, 0 when it isn't an item. */
+  size_t number(size_t paragraph) const;
+  size_t numberAt(size_t offset) const {
+    return number(paragraphs_.paragraphAt(offset));
+  }
+
+private:
+  static constexpr int kNil = -1;
+
+  struct Node {
+    bool isItem = false;
+    uint32_t priority = 0;
+    int left = kNil;
+    int right = kNil;
+    size_t count = 1;
+    // Items at the start and at the end of the subtree's paragraphs.
+    size_t leadingItems = 0;
+    size_t trailingItems = 0;
+  };
+
+  int newNode();
+  void pull(int t);
+  size_t count(int t) const { return t == kNil ? 0 : nodes_[t].count; }
+  void split(int t, size_t count, int &left, int &right);
+  int merge(int left, int right);
+  int build(size_t count);
+  void release(int t);
+  int find(size_t paragraph) const;
+  void update(int t, size_t paragraph, bool isItem);
+  size_t itemsEndingAt(int t, size_t count) const;
+
+  ParagraphIndex paragraphs_;
+  std::vector<Node> nodes_;
+  std::vector<int> freeNodes_;
+  int root_ = kNil;
+  uint32_t seed_ = 0x2545f491u;
+};
+
+} // namespace enriched
@@ -0,0 +1,542 @@
+#include "OperationLog.hpp"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+namespace enriched {
+
+OperationLog::OperationLog(OperationLogConfig config) : config_(config) {}
+
+void OperationLog::setConfig(OperationLogConfig config) {
+  config_ = config;
+  enforceLimits();
+}
+
+size_t OperationLog::sizeOf(const EditOperation &operation) {
+  return sizeof(EditOperation) +
+         (operation.removedText.capacity() +
+          operation.insertedText.capacity()) *
+             sizeof(char16_t) +
+         (operation.spans.capacity() + operation.removedSpans.capacity()) *
+             sizeof(StyleInterval);
+}
+
+namespace {
+// Appends spans shifted by `offset`, extending the last span instead when
+// the next one continues it, so a styled typing burst stays one span.
+void appendSpans(std::vector<StyleInterval> &spans,
+                 const std::vector<StyleInterval> &added, size_t offset) {
+  for (StyleInterval span : added) {
+    span.range.start += offset;
+    if (!spans.empty()) {
+      StyleInterval &last = spans.back();
+      if (last.type == span.type && last.value == span.value &&
+          last.range.start + last.range.length == span.range.start) {
+        last.range.length += span.range.length;
+        continue;
+      }
+    }
+    spans.push_back(span);
+  }
+}
+
+// Replaces the parts of `spans` inside `range` with `replacement`, keeping
+// the spans sorted by start and touching equal spans merged.
+void overlay(std::vector<StyleInterval> &spans, TextRange range,
+             const std::vector<StyleInterval> &replacement) {
+  std::vector<StyleInterval> result;
+  result.reserve(spans.size() + replacement.size() + 1);
+  for (const StyleInterval &span : spans) {
+    if (span.range.end() <= range.start || span.range.start >= range.end()) {
+      result.push_back(span);
+      continue;
+    }
+    if (span.range.start < range.start)
+      result.push_back({{span.range.start, range.start - span.range.start},
+                        span.type,
+                        span.value});
+    if (span.range.end() > range.end())
+      result.push_back({{range.end(), span.range.end() - range.end()},
+                        span.type,
+                        span.value});
+  }
+  result.insert(result.end(), replacement.begin(), replacement.end());
+
+  std::sort(result.begin(), result.end(),
+            [](const StyleInterval &a, const StyleInterval &b) {
+              if (a.type != b.type)
+                return a.type < b.type;
+              if (a.value != b.value)
+                return a.value < b.value;
+              return a.range.start < b.range.start;
+            });
+  spans.clear();
+  for (const StyleInterval &span : result) {
+    if (!spans.empty()) {
+      StyleInterval &last = spans.back();
+      if (last.type == span.type && last.value == span.value &&
+          last.range.end() >= span.range.start) {
+        last.range.length =
+            std::max(last.range.end(), span.range.end()) - last.range.start;
+        continue;
+      }
+    }
+    spans.push_back(span);
+  }
+  std::stable_sort(spans.begin(), spans.end(),
+                   [](const StyleInterval &a, const StyleInterval &b) {
+                     return a.range.start < b.range.start;
+                   });
+}
+
+// The smallest part of `range` where `before` and `after` cover positions
+// with different styles; empty when they style the range the same way,
+// however the runs are split.
+TextRange changedRange(TextRange range,
+                       const std::vector<StyleInterval> &before,
+                       const std::vector<StyleInterval> &after) {
+  struct Boundary {
+    size_t position;
+    StyleType type;
+    uint32_t value;
+    int delta;
+  };
+  std::vector<Boundary> boundaries;
+  boundaries.reserve((before.size() + after.size()) * 2);
+  auto collect = [&](const std::vector<StyleInterval> &spans, int sign) {
+    for (const StyleInterval &span : spans) {
+      size_t start = std::max(span.range.start, range.start);
+      size_t end = std::min(span.range.end(), range.end());
+      if (start >= end)
+        continue;
+      boundaries.push_back({start, span.type, span.value, sign});
+      boundaries.push_back({end, span.type, span.value, -sign});
+    }
+  };
+  collect(before, 1);
+  collect(after, -1);
+  std::sort(boundaries.begin(), boundaries.end(),
+            [](const Boundary &a, const Boundary &b) {
+              if (a.position != b.position)
+                return a.position < b.position;
+              if (a.type != b.type)
+                return a.type < b.type;
+              return a.value < b.value;
+            });
+
+  // Per style and value: how many `before` spans minus `after` spans cover
+  // the current position. The styles differ where any of them is non-zero.
+  std::map<std::pair<StyleType, uint32_t>, int> balances;
+  size_t unbalanced = 0;
+  size_t first = range.end();
+  size_t last = range.start;
+  for (size_t i = 0; i < boundaries.size();) {
+    size_t position = boundaries[i].position;
+    if (unbalanced > 0)
+      last = position;
+    for (; i < boundaries.size() && boundaries[i].position == position; i++) {
+      int &balance = balances[{boundaries[i].type, boundaries[i].value}];
+      bool wasBalanced = balance == 0;
+      balance += boundaries[i].delta;
+      if (wasBalanced != (balance == 0))
+        wasBalanced ? unbalanced++ : unbalanced--;
+    }
+    if (unbalanced > 0)
+      first = std::min(first, position);
+  }
+  if (first >= last)
+    return {range.start, 0};
+  return {first, last - first};
+}
+
+// The parts of `spans` inside `range`.
+std::vector<StyleInterval> clip(const std::vector<StyleInterval> &spans,
+                                TextRange range) {
+  std::vector<StyleInterval> result;
+  for (const StyleInterval &span : spans) {
+    size_t start = std::max(span.range.start, range.start);
+    size_t end = std::min(span.range.end(), range.end());
+    if (start < end)
+      result.push_back({{start, end - start}, span.type, span.value});
+  }
+  return result;
+}
+} // namespace
+
+EditOperation OperationLog::inverse(const EditOperation &operation) {
+  EditOperation result;
+  result.style = operation.style;
+  result.value = operation.value;
+  switch (operation.kind) {
+  case EditOperation::Kind::ReplaceText:
+    result.kind = EditOperation::Kind::ReplaceText;
+    result.range = {operation.range.start, operation.insertedText.size()};
+    result.removedText = operation.insertedText;
+    result.insertedText = operation.removedText;
+    result.spans = operation.removedSpans;
+    result.removedSpans = operation.spans;
+    break;
+  case EditOperation::Kind::AddStyle:
+  case EditOperation::Kind::RemoveStyle:
+  case EditOperation::Kind::RestoreStyle:
+    result.kind = EditOperation::Kind::RestoreStyle;
+    result.range = operation.range;
+    result.spans = operation.spans;
+    break;
+  case EditOperation::Kind::ReplaceStyles:
+    result.kind = EditOperation::Kind::ReplaceStyles;
+    result.range = operation.range;
+    result.spans = operation.removedSpans;
+    result.removedSpans = operation.spans;
+    break;
+  }
+  return result;
+}
+
+bool OperationLog::foldStyles(EditOperation &last, TextRange range,
+                              std::vector<StyleInterval> &previousSpans,
+                              std::vector<StyleInterval> &spans) {
+  if (last.kind == EditOperation::Kind::ReplaceText) {
+    // Styling the inserted text only changes what the insertion brings.
+    size_t insertedEnd = last.range.start + last.insertedText.size();
+    if (range.start < last.range.start || range.end() > insertedEnd)
+      return false;
+    overlay(last.spans, range, spans);
+    return true;
+  }
+
+  if (last.kind != EditOperation::Kind::ReplaceStyles ||
+      range.end() < last.range.start || range.start > last.range.end())
+    return false;
+  // Before: the last operation's snapshot where it reaches, ours elsewhere.
+  // After: ours where it reaches, the last operation's elsewhere.
+  overlay(previousSpans, last.range, last.removedSpans);
+  last.removedSpans = std::move(previousSpans);
+  overlay(last.spans, range, spans);
+  size_t start = std::min(range.start, last.range.start);
+  size_t end = std::max(range.end(), last.range.end());
+  last.range = {start, end - start};
+  return true;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Recording                                                          */
+/* ------------------------------------------------------------------ */
+
+void OperationLog::beginGroup() {
+  if (depth_++ == 0)
+    staging_ = Group();
+}
+
+void OperationLog::endGroup() {
+  if (depth_ == 0 || --depth_ > 0)
+    return;
+  Group group = std::move(staging_);
+  staging_ = Group();
+  if (group.operations.empty())
+    return;
+
+  if (group.operations.size() == 1 &&
+      group.operations[0].kind == EditOperation::Kind::ReplaceText) {
+    EditOperation &operation = group.operations[0];
+    recordReplace(operation.range.start, std::move(operation.removedText),
+                  std::move(operation.insertedText), stagedTimestampMs_,
+                  std::move(operation.removedSpans),
+                  std::move(operation.spans));
+    // Released only now, so values the replacement kept never drop to zero
+    release(group);
+    return;
+  }
+
+  bytes_ += group.bytes;
+  undo_.push_back(std::move(group));
+  coalescing_ = false;
+  enforceLimits();
+}
+
+bool OperationLog::tryCoalesce(size_t position,
+                               const std::u16string &removedText,
+                               const std::u16string &insertedText,
+                               uint64_t timestampMs,
+                               std::vector<StyleInterval> &removedSpans,
+                               std::vector<StyleInterval> &insertedSpans) {
+  if (!coalescing_ || depth_ > 0 || undo_.empty() ||
+      timestampMs - lastTimestampMs_ > config_.coalesceWindowMs)
+    return false;
+  Group &group = undo_.back();
+  if (group.operations.size() != 1)
+    return false;
+  EditOperation &last = group.operations.back();
+  if (last.kind != EditOperation::Kind::ReplaceText)
+    return false;
+
+  size_t before = sizeOf(last);
+  bool typing = removedText.empty() && last.removedText.empty();
+  bool deleting = insertedText.empty() && last.insertedText.empty();
+
+  if (typing && !insertedText.empty() && !last.insertedText.empty() &&
+      last.insertedText.back() != u'\n' &&
+      position == last.range.start + last.insertedText.size()) {
+    last.insertedText += insertedText;
+    appendSpans(last.spans, insertedSpans, 0);
+  } else if (deleting && !removedText.empty() &&
+             position + removedText.size() == last.range.start) {
+    // backspace
+    last.removedText.insert(0, removedText);
+    last.range = {position, last.removedText.size()};
+    appendSpans(removedSpans, last.removedSpans, 0);
+    last.removedSpans = std::move(removedSpans);
+  } else if (deleting && !removedText.empty() &&
+             position == last.range.start) {
+    // forward delete; the new spans were shifted left by the earlier ones
+    appendSpans(last.removedSpans, removedSpans, last.removedText.size());
+    last.removedText += removedText;
+    last.range.length = last.removedText.size();
+  } else {
+    return false;
+  }
+
+  size_t after = sizeOf(last);
+  group.bytes += after - before;
+  bytes_ += after - before;
+  retain(group, last);
+  lastTimestampMs_ = timestampMs;
+  return true;
+}
+
+void OperationLog::append(EditOperation operation) {
+  releaseRedo();
+
+  size_t size = sizeOf(operation);
+  if (depth_ > 0) {
+    retain(staging_, operation);
+    staging_.operations.push_back(std::move(operation));
+    staging_.bytes += size;
+    return;
+  }
+
+  undo_.emplace_back();
+  Group &group = undo_.back();
+  retain(group, operation);
+  group.operations.push_back(std::move(operation));
+  group.bytes = size;
+  bytes_ += size;
+  enforceLimits();
+}
+
+void OperationLog::recordReplace(size_t position, std::u16string removedText,
+                                 std::u16string insertedText,
+                                 uint64_t timestampMs,
+                                 std::vector<StyleInterval> removedSpans,
+                                 std::vector<StyleInterval> insertedSpans) {
+  if (removedText.empty() && insertedText.empty())
+    return;
+  if (depth_ > 0) {
+    // Coalescing waits for endGroup(), once the whole step is known.
+    stagedTimestampMs_ = timestampMs;
+    EditOperation operation;
+    operation.kind = EditOperation::Kind::ReplaceText;
+    operation.range = {position, removedText.size()};
+    operation.removedText = std::move(removedText);
+    operation.insertedText = std::move(insertedText);
+    operation.removedSpans = std::move(removedSpans);
+    operation.spans = std::move(insertedSpans);
+    append(std::move(operation));
+    return;
+  }
+  if (tryCoalesce(position, removedText, insertedText, timestampMs,
+                  removedSpans, insertedSpans)) {
+    releaseRedo();
+    return;
+  }
+
+  EditOperation operation;
+  operation.kind = EditOperation::Kind::ReplaceText;
+  operation.range = {position, removedText.size()};
+  operation.removedText = std::move(removedText);
+  operation.insertedText = std::move(insertedText);
+  operation.removedSpans = std::move(removedSpans);
+  operation.spans = std::move(insertedSpans);
+  // Only single-step typing or deleting starts a burst.
+  coalescing_ =
+      operation.removedText.empty() || operation.insertedText.empty();
+  lastTimestampMs_ = timestampMs;
+  append(std::move(operation));
+}
+
+void OperationLog::recordStyle(TextRange range, StyleType style,
+                               uint32_t value, bool added,
+                               std::vector<StyleInterval> previousSpans) {
+  EditOperation operation;
+  operation.kind =
+      added ? EditOperation::Kind::AddStyle : EditOperation::Kind::RemoveStyle;
+  operation.range = range;
+  operation.style = style;
+  operation.value = value;
+  operation.spans = std::move(previousSpans);
+  coalescing_ = false;
+  append(std::move(operation));
+}
+
+void OperationLog::recordStyles(TextRange range,
+                                std::vector<StyleInterval> previousSpans,
+                                std::vector<StyleInterval> spans) {
+  range = changedRange(range, previousSpans, spans);
+  if (range.length == 0)
+    return;
+  previousSpans = clip(previousSpans, range);
+  spans = clip(spans, range);
+  if (depth_ > 0 && !staging_.operations.empty()) {
+    EditOperation &last = staging_.operations.back();
+    size_t before = sizeOf(last);
+    if (foldStyles(last, range, previousSpans, spans)) {
+      staging_.bytes = staging_.bytes + sizeOf(last) - before;
+      retain(staging_, last);
+      return;
+    }
+  }
+
+  EditOperation operation;
+  operation.kind = EditOperation::Kind::ReplaceStyles;
+  operation.range = range;
+  operation.removedSpans = std::move(previousSpans);
+  operation.spans = std::move(spans);
+  coalescing_ = false;
+  append(std::move(operation));
+}
+
+void OperationLog::enforceLimits() {
+  if (depth_ > 0)
+    return;
+  while (!redo_.empty() && bytes_ > config_.maxBytes) {
+    bytes_ -= redo_.front().bytes;
+    release(redo_.front());
+    redo_.pop_front();
+  }
+  // The newest step is always kept, even if it alone exceeds maxBytes.
+  while (undo_.size() > config_.maxGroups ||
+         (undo_.size() > 1 && bytes_ > config_.maxBytes)) {
+    bytes_ -= undo_.front().bytes;
+    release(undo_.front());
+    undo_.pop_front();
+  }
+}
+
+/* ------------------------------------------------------------------ */
+/*  Span values                                                        */
+/* ------------------------------------------------------------------ */
+
+void OperationLog::retain(Group &group, const EditOperation &operation) {
+  if (operation.kind == EditOperation::Kind::AddStyle)
+    retain(group, operation.value);
+  retain(group, operation.spans);
+  retain(group, operation.removedSpans);
+}
+
+void OperationLog::retain(Group &group,
+                          const std::vector<StyleInterval> &spans) {
+  for (const StyleInterval &span : spans)
+    retain(group, span.value);
+}
+
+void OperationLog::retain(Group &group, uint32_t value) {
+  auto it = std::lower_bound(group.values.begin(), group.values.end(), value);
+  if (it != group.values.end() && *it == value)
+    return;
+  group.values.insert(it, value);
+  if (valueReferences_[value]++ == 0)
+    bytes_ += valueSize(value);
+}
+
+void OperationLog::release(Group &group) {
+  for (uint32_t value : group.values) {
+    auto it = valueReferences_.find(value);
+    if (--it->second > 0)
+      continue;
+    valueReferences_.erase(it);
+    bytes_ -= valueSize(value);
+    releasedValues_.push_back(value);
+  }
+  group.values.clear();
+}
+
+void OperationLog::releaseRedo() {
+  for (Group &group : redo_) {
+    bytes_ -= group.bytes;
+    release(group);
+  }
+  redo_.clear();
+}
+
+size_t OperationLog::valueSize(uint32_t value) const {
+  auto it = valueSizes_.find(value);
+  return it == valueSizes_.end() ? 0 : it->second;
+}
+
+void OperationLog::setValueSize(uint32_t value, size_t bytes) {
+  size_t &size = valueSizes_[value];
+  if (isValueReferenced(value))
+    bytes_ = bytes_ - size + bytes;
+  size = bytes;
+}
+
+std::vector<uint32_t> OperationLog::takeReleasedValues() {
+  std::vector<uint32_t> released;
+  released.swap(releasedValues_);
+  std::sort(released.begin(), released.end());
+  released.erase(std::unique(released.begin(), released.end()),
+                 released.end());
+  // A value can be released and referenced again within one call
+  released.erase(std::remove_if(released.begin(), released.end(),
+                                [this](uint32_t value) {
+                                  return isValueReferenced(value);
+                                }),
+                 released.end());
+  return released;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Undo / redo                                                        */
+/* ------------------------------------------------------------------ */
+
+std::vector<EditOperation> OperationLog::undo() {
+  std::vector<EditOperation> result;
+  if (!canUndo())
+    return result;
+  Group group = std::move(undo_.back());
+  undo_.pop_back();
+  result.reserve(group.operations.size());
+  for (auto it = group.operations.rbegin(); it != group.operations.rend();
+       ++it)
+    result.push_back(inverse(*it));
+  redo_.push_back(std::move(group));
+  coalescing_ = false;
+  return result;
+}
+
+std::vector<EditOperation> OperationLog::redo() {
+  std::vector<EditOperation> result;
+  if (!canRedo())
+    return result;
+  Group group = std::move(redo_.back());
+  redo_.pop_back();
+  result = group.operations;
+  undo_.push_back(std::move(group));
+  coalescing_ = false;
+  return result;
+}
+
+void OperationLog::clear() {
+  for (Group &group : undo_)
+    release(group);
+  releaseRedo();
+  release(staging_);
+  undo_.clear();
+  staging_ = Group();
+  bytes_ = 0;
+  depth_ = 0;
+  coalescing_ = false;
+}
+
+} // namespace enriched
@@ -0,0 +1,187 @@
+/**
+ * Operation-log undo/redo engine.
+ * Records text edits and style changes as compact operations so that undo
+ * replays exactly what changed instead of going through the platform text
+ * system's attribute-level undo.
+ */
+
+#pragma once
+
+#include "StyleIntervalTree.hpp"
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace enriched {
+
+struct EditOperation {
+  enum class Kind : uint8_t {
+    /**
+     * Replace `removedText` at `range.start` with `insertedText`, then apply
+     * `spans` to the inserted text.
+     */
+    ReplaceText,
+    /** Apply `style` (with payload `value`) to `range`. */
+    AddStyle,
+    /** Remove `style` from `range`. */
+    RemoveStyle,
+    /** Remove `style` from `range`, then apply `spans`. */
+    RestoreStyle,
+    /**
+     * Replace every style in `range` with `spans`; `removedSpans` are the
+     * ones they replaced.
+     */
+    ReplaceStyles,
+  };
+
+  Kind kind = Kind::ReplaceText;
+  TextRange range;
+  std::u16string removedText;
+  std::u16string insertedText;
+  StyleType style = StyleType::None;
+  uint32_t value = 0;
+  /**
+   * Style operations: spans of `style` inside `range` before the change (for
+   * undo). ReplaceText: spans of `insertedText` in document offsets.
+   * ReplaceStyles: spans of `range` after the change.
+   */
+  std::vector<StyleInterval> spans;
+  /**
+   * ReplaceText: spans `removedText` had, restored when it is undone.
+   * ReplaceStyles: spans of `range` before the change.
+   */
+  std::vector<StyleInterval> removedSpans;
+};
+
+struct OperationLogConfig {
+  /** Maximum number of undo steps kept. */
+  size_t maxGroups = 100;
+  /** Approximate upper bound of memory held by the history. */
+  size_t maxBytes = 1 << 20;
+  /** Typing bursts closer than this (in ms) become a single undo step. */
+  uint64_t coalesceWindowMs = 1000;
+};
+
+/**
+ * Undo/redo history of grouped operations. Undo and redo cost is linear in
+ * the size of the undone step; the history is trimmed from the oldest end
+ * whenever it exceeds the configured limits.
+ *
+ * The log does not own the document: undo() and redo() return operations
+ * that the caller applies in order.
+ */
+class OperationLog {
+public:
+  explicit OperationLog(OperationLogConfig config = {});
+
+  void setConfig(OperationLogConfig config);
+  const OperationLogConfig &config() const { return config_; }
+
+  /**
+   * Operations recorded between begin/end form one undo step. Nestable. A
+   * step that ends up as a single typing or deleting replacement still
+   * continues the typing burst.
+   */
+  void beginGroup();
+  void endGroup();
+
+  /**
+   * Text at `position` was replaced. Single-character typing and deletions
+   * next to the previous ones are coalesced into the current burst.
+   * `removedSpans` and `insertedSpans` are the styles of the two texts in
+   * document offsets, so undo and redo bring the text back styled.
+   */
+  void recordReplace(size_t position, std::u16string removedText,
+                     std::u16string insertedText, uint64_t timestampMs = 0,
+                     std::vector<StyleInterval> removedSpans = {},
+                     std::vector<StyleInterval> insertedSpans = {});
+  /**
+   * A style was added to or removed from `range`. `previousSpans` are the
+   * spans of that style inside the range before the change.
+   */
+  void recordStyle(TextRange range, StyleType style, uint32_t value,
+                   bool added, std::vector<StyleInterval> previousSpans);
+  /**
+   * The styles of `range` changed from `previousSpans` to `spans`, both
+   * covering every style in the range in document offsets. Only the part of
+   * the range where they differ is recorded. Inside a group,
+   * restyling text the group just inserted, or text next to the previous
+   * restyle, extends that operation instead of adding one.
+   */
+  void recordStyles(TextRange range, std::vector<StyleInterval> previousSpans,
+                    std::vector<StyleInterval> spans);
+  /** Ends the current typing burst, e.g. after the selection moved. */
+  void breakCoalescing() { coalescing_ = false; }
+
+  bool canUndo() const { return !undo_.empty() && depth_ == 0; }
+  bool canRedo() const { return !redo_.empty() && depth_ == 0; }
+  /** Operations reverting the last step, in application order. */
+  std::vector<EditOperation> undo();
+  /** Operations re-applying the last undone step, in application order. */
+  std::vector<EditOperation> redo();
+  void clear();
+
+  size_t undoDepth() const { return undo_.size(); }
+  size_t redoDepth() const { return redo_.size(); }
+  size_t memoryUsage() const { return bytes_; }
+
+  /**
+   * Span values are opaque to the log; callers that map them to payloads
+   * report each payload's size here. It counts toward maxBytes for as long
+   * as a kept step refers to the value.
+   */
+  void setValueSize(uint32_t value, size_t bytes);
+  bool isValueReferenced(uint32_t value) const {
+    return valueReferences_.count(value) != 0;
+  }
+  /**
+   * Values no kept step refers to any more, since the last call. Their
+   * payloads can be dropped and the values reused.
+   */
+  std::vector<uint32_t> takeReleasedValues();
+
+private:
+  struct Group {
+    std::vector<EditOperation> operations;
+    size_t bytes = 0;
+    // Sorted span values the operations refer to, each counted once in
+    // valueReferences_.
+    std::vector<uint32_t> values;
+  };
+
+  static size_t sizeOf(const EditOperation &operation);
+  static EditOperation inverse(const EditOperation &operation);
+  static bool foldStyles(EditOperation &last, TextRange range,
+                         std::vector<StyleInterval> &previousSpans,
+                         std::vector<StyleInterval> &spans);
+  bool tryCoalesce(size_t position, const std::u16string &removedText,
+                   const std::u16string &insertedText, uint64_t timestampMs,
+                   std::vector<StyleInterval> &removedSpans,
+                   std::vector<StyleInterval> &insertedSpans);
+  void append(EditOperation operation);
+  void enforceLimits();
+  void retain(Group &group, const EditOperation &operation);
+  void retain(Group &group, const std::vector<StyleInterval> &spans);
+  void retain(Group &group, uint32_t value);
+  void release(Group &group);
+  void releaseRedo();
+  size_t valueSize(uint32_t value) const;
+
+  OperationLogConfig config_;
+  std::deque<Group> undo_;
+  std::deque<Group> redo_;
+  // The open group, committed by the outermost endGroup().
+  Group staging_;
+  uint64_t stagedTimestampMs_ = 0;
+  size_t bytes_ = 0;
+  int depth_ = 0;
+  bool coalescing_ = false;
+  uint64_t lastTimestampMs_ = 0;
+  std::unordered_map<uint32_t, size_t> valueReferences_;
+  std::unordered_map<uint32_t, size_t> valueSizes_;
+  std::vector<uint32_t> releasedValues_;
+};
+
+} // namespace enriched
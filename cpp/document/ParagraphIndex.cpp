@@ -0,0 +1,126 @@
+#include "ParagraphIndex.hpp"
+
+#include <algorithm>
+
+namespace enriched {
+
+ParagraphIndex::ParagraphIndex() : lengths_(1, 0) { rebuild(); }
+
+ParagraphIndex::ParagraphIndex(const std::u16string &text) { reset(text); }
+
+void ParagraphIndex::reset(const std::u16string &text) {
+  lengths_.clear();
+  size_t start = 0;
+  for (size_t i = 0; i < text.size(); i++) {
+    if (text[i] == u'\n') {
+      lengths_.push_back(i + 1 - start);
+      start = i + 1;
+    }
+  }
+  lengths_.push_back(text.size() - start);
+  rebuild();
+}
+
+void ParagraphIndex::rebuild() {
+  // Linear-time construction: each node hands its sum to its parent.
+  size_t n = lengths_.size();
+  tree_.assign(n + 1, 0);
+  length_ = 0;
+  for (size_t i = 1; i <= n; i++) {
+    tree_[i] += lengths_[i - 1];
+    length_ += lengths_[i - 1];
+    size_t parent = i + (i & (~i + 1));
+    if (parent <= n)
+      tree_[parent] += tree_[i];
+  }
+  highBit_ = 1;
+  while (highBit_ * 2 <= n)
+    highBit_ *= 2;
+}
+
+void ParagraphIndex::add(size_t index, std::ptrdiff_t delta) {
+  lengths_[index] += delta;
+  length_ += delta;
+  for (size_t i = index + 1; i < tree_.size(); i += i & (~i + 1))
+    tree_[i] += delta;
+}
+
+size_t ParagraphIndex::prefix(size_t count) const {
+  size_t sum = 0;
+  for (size_t i = count; i > 0; i -= i & (~i + 1))
+    sum += tree_[i];
+  return sum;
+}
+
+size_t ParagraphIndex::paragraphAt(size_t offset) const {
+  if (offset >= length_)
+    return lengths_.size() - 1;
+  // Binary lifting: the largest count whose prefix sum is <= offset.
+  size_t position = 0;
+  for (size_t step = highBit_; step > 0; step >>= 1) {
+    size_t next = position + step;
+    if (next < tree_.size() && tree_[next] <= offset) {
+      position = next;
+      offset -= tree_[next];
+    }
+  }
+  return position;
+}
+
+size_t ParagraphIndex::paragraphStart(size_t index) const {
+  return prefix(std::min(index, lengths_.size()));
+}
+
+TextRange ParagraphIndex::paragraphRange(size_t index) const {
+  if (index >= lengths_.size())
+    return {length_, 0};
+  return {paragraphStart(index), lengths_[index]};
+}
+
+TextRange ParagraphIndex::paragraphRangeForRange(TextRange range) const {
+  size_t first = paragraphAt(range.start);
+  size_t last = range.length == 0 ? first : paragraphAt(range.end() - 1);
+  size_t start = paragraphStart(first);
+  size_t end = paragraphStart(last) + lengths_[last];
+  return {start, end - start};
+}
+
+void ParagraphIndex::applyEdit(TextRange range,
+                               const std::u16string &replacement) {
+  size_t from = std::min(range.start, length_);
+  size_t to = std::min(range.end(), length_);
+  size_t first = paragraphAt(from);
+  size_t last = paragraphAt(to);
+  size_t firstStart = paragraphStart(first);
+
+  size_t newlineAt = replacement.find(u'\n');
+  if (first == last && newlineAt == std::u16string::npos) {
+    add(first, static_cast<std::ptrdiff_t>(replacement.size()) -
+                   static_cast<std::ptrdiff_t>(to - from));
+    return;
+  }
+
+  // Paragraphs first..last collapse into prefix + replacement + suffix and
+  // are split again at the replacement's newlines.
+  size_t lastStart = first == last ? firstStart : paragraphStart(last);
+  size_t prefixLength = from - firstStart;
+  size_t suffixLength = lastStart + lengths_[last] - to;
+
+  std::vector<size_t> segments;
+  size_t segmentStart = 0;
+  for (size_t i = 0; i < replacement.size(); i++) {
+    if (replacement[i] == u'\n') {
+      segments.push_back(i + 1 - segmentStart);
+      segmentStart = i + 1;
+    }
+  }
+  segments.push_back(replacement.size() - segmentStart);
+  segments.front() += prefixLength;
+  segments.back() += suffixLength;
+
+  lengths_.erase(lengths_.begin() + first, lengths_.begin() + last + 1);
+  lengths_.insert(lengths_.begin() + first, segments.begin(), segments.end());
+  rebuild();
+}
+
+} // namespace enriched
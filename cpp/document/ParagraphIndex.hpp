@@ -0,0 +1,61 @@
+/**
+ * Offset <-> paragraph index.
+ * Lets paragraph styles (headings, lists, blockquote, codeblock, alignment)
+ * find paragraph ranges without scanning the text for newlines.
+ */
+
+#pragma once
+
+#include "StyleType.hpp"
+
+#include <string>
+#include <vector>
+
+namespace enriched {
+
+/**
+ * Fenwick tree over paragraph lengths. A paragraph's length includes its
+ * trailing '\n'; the text after the last newline is the final paragraph, so
+ * there is always at least one.
+ *
+ * Offset -> paragraph and paragraph -> offset are O(log n). Edits that stay
+ * inside one paragraph only shift the prefix sums, which is O(log n) as
+ * well. Edits that add or remove newlines splice the paragraph list and
+ * rebuild the tree in linear time, without touching the text.
+ *
+ * All offsets are UTF-16 code units.
+ */
+class ParagraphIndex {
+public:
+  ParagraphIndex();
+  explicit ParagraphIndex(const std::u16string &text);
+
+  void reset(const std::u16string &text);
+
+  size_t paragraphCount() const { return lengths_.size(); }
+  size_t length() const { return length_; }
+
+  /** Paragraph containing the offset; the end of the text maps to the last. */
+  size_t paragraphAt(size_t offset) const;
+  size_t paragraphStart(size_t index) const;
+  size_t paragraphLength(size_t index) const { return lengths_[index]; }
+  /** Range of a paragraph, including its trailing '\n' if present. */
+  TextRange paragraphRange(size_t index) const;
+  /** Union of the ranges of all paragraphs touched by the range. */
+  TextRange paragraphRangeForRange(TextRange range) const;
+
+  /** Text in the range was replaced with `replacement`. */
+  void applyEdit(TextRange range, const std::u16string &replacement);
+
+private:
+  void rebuild();
+  void add(size_t index, std::ptrdiff_t delta);
+  size_t prefix(size_t count) const;
+
+  std::vector<size_t> lengths_;
+  std::vector<size_t> tree_; // 1-based Fenwick tree over lengths_
+  size_t length_ = 0;
+  size_t highBit_ = 1;
+};
+
+} // namespace enriched
@@ -0,0 +1,452 @@
+#include "StyleIntervalTree.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace enriched {
+
+/* ------------------------------------------------------------------ */
+/*  Treap plumbing                                                     */
+/* ------------------------------------------------------------------ */
+
+int StyleIntervalTree::newNode(size_t start, size_t end, StyleType type,
+                               uint32_t value) {
+  seed_ ^= seed_ << 13;
+  seed_ ^= seed_ >> 17;
+  seed_ ^= seed_ << 5;
+
+  Node node;
+  node.start = start;
+  node.end = end;
+  node.type = type;
+  node.value = value;
+  node.priority = seed_;
+
+  int index;
+  if (!freeNodes_.empty()) {
+    index = freeNodes_.back();
+    freeNodes_.pop_back();
+    nodes_[index] = node;
+  } else {
+    index = static_cast<int>(nodes_.size());
+    nodes_.push_back(node);
+  }
+  pull(index);
+  return index;
+}
+
+void StyleIntervalTree::releaseNode(int t) { freeNodes_.push_back(t); }
+
+void StyleIntervalTree::pull(int t) {
+  Node &n = nodes_[t];
+  n.maxEnd = n.end;
+  n.count = 1;
+  for (int child : {n.left, n.right}) {
+    if (child == kNil)
+      continue;
+    n.maxEnd = std::max(n.maxEnd, nodes_[child].maxEnd);
+    n.count += nodes_[child].count;
+  }
+}
+
+void StyleIntervalTree::applyShift(int t, std::ptrdiff_t shift) {
+  if (t == kNil || shift == 0)
+    return;
+  Node &n = nodes_[t];
+  n.start += shift;
+  n.end += shift;
+  n.maxEnd += shift;
+  n.shift += shift;
+}
+
+void StyleIntervalTree::push(int t) {
+  Node &n = nodes_[t];
+  if (n.shift == 0)
+    return;
+  applyShift(n.left, n.shift);
+  applyShift(n.right, n.shift);
+  n.shift = 0;
+}
+
+bool StyleIntervalTree::keyLess(int a, int b) const {
+  // Node indices break ties so that every node has a unique key.
+  const Node &x = nodes_[a];
+  const Node &y = nodes_[b];
+  return x.start < y.start || (x.start == y.start && a < b);
+}
+
+void StyleIntervalTree::split(int t, size_t start, int &left, int &right) {
+  // left: spans starting before `start`, right: the rest
+  if (t == kNil) {
+    left = right = kNil;
+    return;
+  }
+  push(t);
+  if (nodes_[t].start < start) {
+    int l, r;
+    split(nodes_[t].right, start, l, r);
+    nodes_[t].right = l;
+    pull(t);
+    left = t;
+    right = r;
+  } else {
+    int l, r;
+    split(nodes_[t].left, start, l, r);
+    nodes_[t].left = r;
+    pull(t);
+    left = l;
+    right = t;
+  }
+}
+
+int StyleIntervalTree::merge(int left, int right) {
+  if (left == kNil)
+    return right;
+  if (right == kNil)
+    return left;
+  if (nodes_[left].priority > nodes_[right].priority) {
+    push(left);
+    int merged = merge(nodes_[left].right, right);
+    nodes_[left].right = merged;
+    pull(left);
+    return left;
+  }
+  push(right);
+  int merged = merge(left, nodes_[right].left);
+  nodes_[right].left = merged;
+  pull(right);
+  return right;
+}
+
+void StyleIntervalTree::splitByKey(int t, int node, int &left, int &right) {
+  // left: keys ordered before `node`, right: the rest
+  if (t == kNil) {
+    left = right = kNil;
+    return;
+  }
+  push(t);
+  if (keyLess(t, node)) {
+    int l, r;
+    splitByKey(nodes_[t].right, node, l, r);
+    nodes_[t].right = l;
+    pull(t);
+    left = t;
+    right = r;
+  } else {
+    int l, r;
+    splitByKey(nodes_[t].left, node, l, r);
+    nodes_[t].left = r;
+    pull(t);
+    left = l;
+    right = t;
+  }
+}
+
+int StyleIntervalTree::insertNode(int t, int node) {
+  int left, right;
+  splitByKey(t, node, left, right);
+  return merge(merge(left, node), right);
+}
+
+int StyleIntervalTree::eraseNode(int t, int node) {
+  if (t == kNil)
+    return kNil;
+  push(t);
+  if (t == node) {
+    int merged = merge(nodes_[t].left, nodes_[t].right);
+    releaseNode(t);
+    return merged;
+  }
+  if (keyLess(node, t))
+    nodes_[t].left = eraseNode(nodes_[t].left, node);
+  else
+    nodes_[t].right = eraseNode(nodes_[t].right, node);
+  pull(t);
+  return t;
+}
+
+void StyleIntervalTree::collect(int t, size_t from, size_t to, bool touching,
+                                std::vector<int> &out) {
+  if (t == kNil)
+    return;
+  Node &n = nodes_[t];
+  if (touching ? n.maxEnd < from : n.maxEnd <= from)
+    return;
+  push(t);
+  collect(nodes_[t].left, from, to, touching, out);
+  const Node &m = nodes_[t];
+  bool startsInside = touching ? m.start <= to : m.start < to;
+  if (startsInside && (touching ? m.end >= from : m.end > from))
+    out.push_back(t);
+  if (startsInside)
+    collect(m.right, from, to, touching, out);
+}
+
+void StyleIntervalTree::collectAll(int t, std::vector<int> &out) {
+  if (t == kNil)
+    return;
+  push(t);
+  collectAll(nodes_[t].left, out);
+  out.push_back(t);
+  collectAll(nodes_[t].right, out);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Editing spans                                                      */
+/* ------------------------------------------------------------------ */
+
+void StyleIntervalTree::add(StyleInterval interval) {
+  if (interval.range.length == 0 || interval.type == StyleType::None)
+    return;
+  size_t start = interval.range.start;
+  size_t end = interval.range.end();
+
+  std::vector<int> touching;
+  collect(root_, start, end, true, touching);
+  for (int t : touching) {
+    const Node &n = nodes_[t];
+    if (n.type != interval.type)
+      continue;
+    if (n.value != interval.value) {
+      // A different payload of the same style is overwritten.
+      if (n.end > start && n.start < end) {
+        size_t s = n.start, e = n.end;
+        uint32_t v = n.value;
+        root_ = eraseNode(root_, t);
+        if (s < start)
+          root_ = insertNode(root_, newNode(s, start, interval.type, v));
+        if (e > end)
+          root_ = insertNode(root_, newNode(end, e, interval.type, v));
+      }
+      continue;
+    }
+    start = std::min(start, n.start);
+    end = std::max(end, n.end);
+    root_ = eraseNode(root_, t);
+  }
+  root_ = insertNode(root_, newNode(start, end, interval.type, interval.value));
+}
+
+void StyleIntervalTree::remove(TextRange range, StyleType type) {
+  if (range.length == 0)
+    return;
+  size_t from = range.start;
+  size_t to = range.end();
+
+  std::vector<int> hits;
+  collect(root_, from, to, false, hits);
+  for (int t : hits) {
+    const Node &n = nodes_[t];
+    if (n.type != type)
+      continue;
+    size_t s = n.start, e = n.end;
+    uint32_t v = n.value;
+    root_ = eraseNode(root_, t);
+    if (s < from)
+      root_ = insertNode(root_, newNode(s, from, type, v));
+    if (e > to)
+      root_ = insertNode(root_, newNode(to, e, type, v));
+  }
+}
+
+void StyleIntervalTree::clear() {
+  nodes_.clear();
+  freeNodes_.clear();
+  root_ = kNil;
+}
+
+void StyleIntervalTree::growSpanning(int t, size_t position, size_t length) {
+  if (t == kNil || nodes_[t].maxEnd <= position)
+    return;
+  push(t);
+  growSpanning(nodes_[t].left, position, length);
+  Node &n = nodes_[t];
+  if (n.start < position) {
+    if (n.end > position)
+      n.end += length;
+    growSpanning(n.right, position, length);
+  }
+  pull(t);
+}
+
+void StyleIntervalTree::clipSpanning(int t, size_t from, size_t to) {
+  // Only called on spans starting before `from`.
+  if (t == kNil || nodes_[t].maxEnd <= from)
+    return;
+  push(t);
+  clipSpanning(nodes_[t].left, from, to);
+  Node &n = nodes_[t];
+  if (n.end > from)
+    n.end = n.end <= to ? from : n.end - (to - from);
+  clipSpanning(n.right, from, to);
+  pull(t);
+}
+
+void StyleIntervalTree::applyInsertion(size_t position, size_t length) {
+  if (length == 0 || root_ == kNil)
+    return;
+  growSpanning(root_, position, length);
+  int left, right;
+  split(root_, position, left, right);
+  applyShift(right, static_cast<std::ptrdiff_t>(length));
+  root_ = merge(left, right);
+}
+
+void StyleIntervalTree::applyDeletion(TextRange range) {
+  if (range.length == 0 || root_ == kNil)
+    return;
+  size_t from = range.start;
+  size_t to = range.end();
+
+  int left, middle, right;
+  split(root_, from, left, middle);
+  split(middle, to, middle, right);
+
+  clipSpanning(left, from, to);
+  applyShift(right, -static_cast<std::ptrdiff_t>(range.length));
+  root_ = merge(left, right);
+
+  // Spans starting inside the deleted range now start at its beginning.
+  std::vector<int> moved;
+  collectAll(middle, moved);
+  for (int t : moved) {
+    Node &n = nodes_[t];
+    size_t end = n.end <= to ? from : n.end - range.length;
+    if (end == from) {
+      releaseNode(t);
+      continue;
+    }
+    n.start = from;
+    n.end = end;
+    n.left = n.right = kNil;
+    n.shift = 0;
+    pull(t);
+    root_ = insertNode(root_, t);
+  }
+
+  // Spans of the same kind that now touch at the cut are joined, as they
+  // would be by add().
+  std::vector<int> around, ending, starting;
+  collect(root_, from, from, true, around);
+  for (int t : around) {
+    if (nodes_[t].end == from)
+      ending.push_back(t);
+    else if (nodes_[t].start == from)
+      starting.push_back(t);
+  }
+  for (int a : ending) {
+    for (int &b : starting) {
+      if (b == kNil || nodes_[b].type != nodes_[a].type ||
+          nodes_[b].value != nodes_[a].value)
+        continue;
+      size_t start = nodes_[a].start, end = nodes_[b].end;
+      StyleType type = nodes_[a].type;
+      uint32_t value = nodes_[a].value;
+      root_ = eraseNode(root_, a);
+      root_ = eraseNode(root_, b);
+      b = kNil;
+      root_ = insertNode(root_, newNode(start, end, type, value));
+      break;
+    }
+  }
+}
+
+/* ------------------------------------------------------------------ */
+/*  Queries                                                            */
+/* ------------------------------------------------------------------ */
+
+template <typename Visit>
+void StyleIntervalTree::visitIntersecting(int t, size_t from, size_t to,
+                                          std::ptrdiff_t pending,
+                                          Visit &&visit) const {
+  if (t == kNil)
+    return;
+  const Node &n = nodes_[t];
+  if (n.maxEnd + pending <= from)
+    return;
+  visitIntersecting(n.left, from, to, pending + n.shift, visit);
+  size_t start = n.start + pending;
+  if (start >= to)
+    return;
+  if (n.end + pending > from)
+    visit(n, pending);
+  visitIntersecting(n.right, from, to, pending + n.shift, visit);
+}
+
+StyleInterval StyleIntervalTree::toInterval(const Node &node,
+                                            std::ptrdiff_t pending) const {
+  size_t start = node.start + pending;
+  size_t end = node.end + pending;
+  return {{start, end - start}, node.type, node.value};
+}
+
+StyleMask StyleIntervalTree::stylesAt(size_t position) const {
+  return stylesIntersecting({position, 1});
+}
+
+StyleMask StyleIntervalTree::stylesIntersecting(TextRange range) const {
+  StyleMask mask = 0;
+  if (range.length == 0)
+    return mask;
+  visitIntersecting(root_, range.start, range.end(), 0,
+                    [&](const Node &n, std::ptrdiff_t) {
+                      mask |= styleBit(n.type);
+                    });
+  return mask;
+}
+
+StyleMask StyleIntervalTree::stylesCovering(TextRange range) const {
+  StyleMask mask = 0;
+  if (range.length == 0)
+    return mask;
+  // Spans are visited by start, so a style covers the range as long as each
+  // of its spans starts before the previous ones end.
+  std::array<size_t, kStyleTypeCount> reached;
+  reached.fill(range.start);
+  StyleMask gaps = 0;
+  visitIntersecting(root_, range.start, range.end(), 0,
+                    [&](const Node &n, std::ptrdiff_t pending) {
+                      size_t i = static_cast<size_t>(n.type);
+                      if (i >= kStyleTypeCount)
+                        return;
+                      if (n.start + pending > reached[i])
+                        gaps |= styleBit(n.type);
+                      else
+                        reached[i] = std::max(reached[i], n.end + pending);
+                    });
+  for (size_t i = 0; i < kStyleTypeCount; i++) {
+    StyleMask bit = styleBit(static_cast<StyleType>(i));
+    if (reached[i] >= range.end() && (gaps & bit) == 0)
+      mask |= bit;
+  }
+  return mask;
+}
+
+std::vector<StyleInterval> StyleIntervalTree::intervalsAt(
+    size_t position) const {
+  return intervalsIntersecting({position, 1});
+}
+
+std::vector<StyleInterval>
+StyleIntervalTree::intervalsIntersecting(TextRange range) const {
+  std::vector<StyleInterval> result;
+  if (range.length == 0)
+    return result;
+  visitIntersecting(root_, range.start, range.end(), 0,
+                    [&](const Node &n, std::ptrdiff_t pending) {
+                      result.push_back(toInterval(n, pending));
+                    });
+  return result;
+}
+
+std::vector<StyleInterval> StyleIntervalTree::intervals() const {
+  std::vector<StyleInterval> result;
+  result.reserve(size());
+  visitIntersecting(root_, 0, SIZE_MAX, 0,
+                    [&](const Node &n, std::ptrdiff_t pending) {
+                      result.push_back(toInterval(n, pending));
+                    });
+  return result;
+}
+
+} // namespace enriched
@@ -0,0 +1,107 @@
+/**
+ * Interval index of style spans.
+ * Answers "which styles cover this position" and "which styles intersect
+ * this range" without enumerating every attribute of the text storage.
+ */
+
+#pragma once
+
+#include "StyleType.hpp"
+
+#include <vector>
+
+namespace enriched {
+
+/** A single style span; `value` identifies parametrized style payloads. */
+struct StyleInterval {
+  TextRange range;
+  StyleType type = StyleType::None;
+  uint32_t value = 0;
+
+  bool operator==(const StyleInterval &other) const {
+    return range == other.range && type == other.type && value == other.value;
+  }
+};
+
+/**
+ * Augmented treap of intervals ordered by start, where every node also keeps
+ * the maximum end in its subtree. Point and range queries run in
+ * O(log n + k) for k reported intervals; position shifts caused by text
+ * edits are applied lazily to whole subtrees.
+ *
+ * Spans of the same type and value that overlap or touch are coalesced on
+ * insertion, mirroring how attributed strings merge equal attributes.
+ */
+class StyleIntervalTree {
+public:
+  /** Adds a span, coalescing it with touching spans of the same kind. */
+  void add(StyleInterval interval);
+  /** Removes a style from a range, trimming spans that stick out of it. */
+  void remove(TextRange range, StyleType type);
+  void clear();
+
+  size_t size() const { return root_ == kNil ? 0 : nodes_[root_].count; }
+  bool empty() const { return root_ == kNil; }
+
+  StyleMask stylesAt(size_t position) const;
+  StyleMask stylesIntersecting(TextRange range) const;
+  /** Styles present at every position of a non-empty range. */
+  StyleMask stylesCovering(TextRange range) const;
+  std::vector<StyleInterval> intervalsAt(size_t position) const;
+  std::vector<StyleInterval> intervalsIntersecting(TextRange range) const;
+  /** All spans ordered by start. */
+  std::vector<StyleInterval> intervals() const;
+
+  /**
+   * Text was inserted at the position. Spans strictly containing it grow,
+   * spans starting at or after it move right.
+   */
+  void applyInsertion(size_t position, size_t length);
+  /** Text in the range was deleted; spans shrink or disappear. */
+  void applyDeletion(TextRange range);
+
+private:
+  static constexpr int kNil = -1;
+
+  struct Node {
+    size_t start = 0;
+    size_t end = 0;
+    StyleType type = StyleType::None;
+    uint32_t value = 0;
+    uint32_t priority = 0;
+    int left = kNil;
+    int right = kNil;
+    size_t maxEnd = 0;
+    size_t count = 0;
+    // Pending shift for the children (already applied to this node).
+    std::ptrdiff_t shift = 0;
+  };
+
+  int newNode(size_t start, size_t end, StyleType type, uint32_t value);
+  void releaseNode(int t);
+  void pull(int t);
+  void applyShift(int t, std::ptrdiff_t shift);
+  void push(int t);
+  bool keyLess(int a, int b) const;
+  void split(int t, size_t start, int &left, int &right);
+  void splitByKey(int t, int node, int &left, int &right);
+  int merge(int left, int right);
+  int insertNode(int t, int node);
+  int eraseNode(int t, int node);
+  void collect(int t, size_t from, size_t to, bool touching,
+               std::vector<int> &out);
+  void collectAll(int t, std::vector<int> &out);
+  void growSpanning(int t, size_t position, size_t length);
+  void clipSpanning(int t, size_t from, size_t to);
+  template <typename Visit>
+  void visitIntersecting(int t, size_t from, size_t to, std::ptrdiff_t pending,
+                         Visit &&visit) const;
+  StyleInterval toInterval(const Node &node, std::ptrdiff_t pending) const;
+
+  std::vector<Node> nodes_;
+  std::vector<int> freeNodes_;
+  int root_ = kNil;
+  uint32_t seed_ = 0x2545f491u;
+};
+
+} // namespace enriched
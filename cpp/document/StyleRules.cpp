@@ -0,0 +1,27 @@
+#include "StyleRules.hpp"
+
+namespace enriched {
+
+void StyleRules::setHeadingBold(StyleType heading, bool bold) {
+  if ((styleBit(heading) & kHeadingStyles) == 0)
+    return;
+  StyleRule &headingRule = rules_[static_cast<size_t>(heading)];
+  StyleRule &boldRule = rules_[static_cast<size_t>(StyleType::Bold)];
+  if (bold) {
+    headingRule.conflicts |= styleBit(StyleType::Bold);
+    boldRule.blocks |= styleBit(heading);
+  } else {
+    headingRule.conflicts &= ~styleBit(StyleType::Bold);
+    boldRule.blocks &= ~styleBit(heading);
+  }
+}
+
+StyleMask StyleRules::blockedBy(StyleMask active) const {
+  StyleMask blocked = 0;
+  for (size_t i = 0; i < kStyleTypeCount; i++)
+    if (rules_[i].blocks & active)
+      blocked |= styleBit(static_cast<StyleType>(i));
+  return blocked;
+}
+
+} // namespace enriched
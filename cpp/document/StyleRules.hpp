@@ -0,0 +1,119 @@
+/**
+ * Which styles conflict with or block each other, for both platforms.
+ * Replaces a dictionary of arrays on iOS and string arrays on Android that
+ * were scanned on every toggle and had drifted apart.
+ */
+
+#pragma once
+
+#include "StyleType.hpp"
+
+#include <array>
+#include <initializer_list>
+
+namespace enriched {
+
+constexpr StyleMask styleMask(std::initializer_list<StyleType> types) {
+  StyleMask mask = 0;
+  for (StyleType type : types)
+    mask |= styleBit(type);
+  return mask;
+}
+
+/** Lowest style in the mask; iterate with `mask &= mask - 1`. */
+inline StyleType firstStyle(StyleMask mask) {
+  return mask == 0 ? StyleType::None
+                   : static_cast<StyleType>(__builtin_ctz(mask));
+}
+
+struct StyleRule {
+  // styles that are removed when the style is applied
+  StyleMask conflicts = 0;
+  // styles that prevent the style from being applied
+  StyleMask blocks = 0;
+};
+
+constexpr StyleMask kHeadingStyles =
+    styleMask({StyleType::H1, StyleType::H2, StyleType::H3, StyleType::H4,
+               StyleType::H5, StyleType::H6});
+constexpr StyleMask kListStyles =
+    styleMask({StyleType::UnorderedList, StyleType::OrderedList,
+               StyleType::CheckboxList});
+
+/** Rules with no heading styled bold. */
+constexpr std::array<StyleRule, kStyleTypeCount> kDefaultStyleRules = [] {
+  std::array<StyleRule, kStyleTypeCount> rules{};
+  auto rule = [&rules](StyleType type) -> StyleRule & {
+    return rules[static_cast<size_t>(type)];
+  };
+  const StyleMask codeBlock = styleBit(StyleType::CodeBlock);
+  const StyleMask blockQuote = styleBit(StyleType::BlockQuote);
+
+  for (StyleType type : {StyleType::Bold, StyleType::Italic,
+                         StyleType::Underline, StyleType::Strikethrough})
+    rule(type).blocks = codeBlock;
+  rule(StyleType::InlineCode) = {
+      styleMask({StyleType::Link, StyleType::Mention}),
+      codeBlock | styleBit(StyleType::Image)};
+  rule(StyleType::Link) = {
+      styleMask({StyleType::Link, StyleType::Mention}),
+      codeBlock | styleMask({StyleType::Image, StyleType::InlineCode})};
+  rule(StyleType::Mention) = {
+      styleBit(StyleType::Link),
+      codeBlock | styleMask({StyleType::Image, StyleType::InlineCode})};
+  rule(StyleType::Image) = {styleMask({StyleType::Link, StyleType::Mention}),
+                            styleBit(StyleType::InlineCode)};
+
+  // Block styles replace each other
+  for (StyleType type : {StyleType::H1, StyleType::H2, StyleType::H3,
+                         StyleType::H4, StyleType::H5, StyleType::H6,
+                         StyleType::UnorderedList, StyleType::OrderedList,
+                         StyleType::CheckboxList})
+    rule(type).conflicts = ((kHeadingStyles | kListStyles) & ~styleBit(type)) |
+                           blockQuote | codeBlock;
+  rule(StyleType::BlockQuote).conflicts =
+      kHeadingStyles | kListStyles | codeBlock;
+  rule(StyleType::CodeBlock).conflicts =
+      kHeadingStyles | kListStyles | blockQuote |
+      styleMask({StyleType::Bold, StyleType::Italic, StyleType::Underline,
+                 StyleType::Strikethrough, StyleType::InlineCode,
+                 StyleType::Link, StyleType::Mention});
+  return rules;
+}();
+
+/** Outcome of applying a style where other styles are active. */
+struct StyleResolution {
+  bool blocked = false;
+  // active styles to remove first
+  StyleMask removed = 0;
+};
+
+/**
+ * Per-view style rules: the defaults plus bold headings, where applying a
+ * heading removes bold and bold is blocked inside the heading.
+ */
+class StyleRules {
+public:
+  StyleMask conflicts(StyleType type) const { return rule(type).conflicts; }
+  StyleMask blocks(StyleType type) const { return rule(type).blocks; }
+
+  void setHeadingBold(StyleType heading, bool bold);
+
+  StyleResolution resolve(StyleType type, StyleMask active) const {
+    return {(blocks(type) & active) != 0, conflicts(type) & active};
+  }
+
+  /** Styles that can't be applied while the `active` ones are. */
+  StyleMask blockedBy(StyleMask active) const;
+
+private:
+  const StyleRule &rule(StyleType type) const {
+    static const StyleRule kNone;
+    return type == StyleType::None ? kNone
+                                   : rules_[static_cast<size_t>(type)];
+  }
+
+  std::array<StyleRule, kStyleTypeCount> rules_ = kDefaultStyleRules;
+};
+
+} // namespace enriched
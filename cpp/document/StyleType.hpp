@@ -0,0 +1,61 @@
+/**
+ * Style identifiers shared by the C++ document engines.
+ * Mirrors `StyleType` from ios/interfaces/StyleTypeEnum.h so that values can
+ * be passed across the platform boundary as plain integers.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace enriched {
+
+// the order is aligned with the order of tags in parser (and with iOS)
+enum class StyleType : uint8_t {
+  BlockQuote,
+  CodeBlock,
+  UnorderedList,
+  OrderedList,
+  CheckboxList,
+  Alignment,
+  H1,
+  H2,
+  H3,
+  H4,
+  H5,
+  H6,
+  Link,
+  Mention,
+  Image,
+  InlineCode,
+  Bold,
+  Italic,
+  Underline,
+  Strikethrough,
+  None,
+};
+
+constexpr size_t kStyleTypeCount = static_cast<size_t>(StyleType::None);
+
+/** One bit per StyleType (None has no bit). */
+using StyleMask = uint32_t;
+
+constexpr StyleMask styleBit(StyleType type) {
+  return type == StyleType::None
+             ? 0u
+             : (1u << static_cast<uint8_t>(type));
+}
+
+/** Half-open UTF-16 range [start, start + length). */
+struct TextRange {
+  size_t start = 0;
+  size_t length = 0;
+
+  size_t end() const { return start + length; }
+  bool operator==(const TextRange &other) const {
+    return start == other.start && length == other.length;
+  }
+};
+
+} // namespace enriched
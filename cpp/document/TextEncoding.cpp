@@ -0,0 +1,185 @@
+#include "TextEncoding.hpp"
+
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace enriched {
+
+namespace {
+
+/* --- ASCII fast paths --- */
+
+// Markup is mostly ASCII; these copy 8 (16) code units per step while they
+// last and return how many were handled, leaving the rest to the scalar
+// loops.
+
+size_t asciiToUtf8(const char16_t *in, size_t length, char *out) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128i high = _mm_set1_epi16(static_cast<short>(0xFF80));
+  for (; i + 8 <= length; i += 8) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+    if (_mm_movemask_epi8(_mm_and_si128(chunk, high)) != 0)
+      break;
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(out + i),
+                     _mm_packus_epi16(chunk, chunk));
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  for (; i + 8 <= length; i += 8) {
+    uint16x8_t chunk = vld1q_u16(reinterpret_cast<const uint16_t *>(in + i));
+    if (vmaxvq_u16(chunk) >= 0x80)
+      break;
+    vst1_u8(reinterpret_cast<uint8_t *>(out + i), vmovn_u16(chunk));
+  }
+#endif
+  for (; i < length && in[i] < 0x80; i++)
+    out[i] = static_cast<char>(in[i]);
+  return i;
+}
+
+size_t asciiToUtf16(const unsigned char *in, size_t length, char16_t *out) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= length; i += 16) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+    if (_mm_movemask_epi8(chunk) != 0)
+      break;
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i),
+                     _mm_unpacklo_epi8(chunk, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i + 8),
+                     _mm_unpackhi_epi8(chunk, zero));
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  for (; i + 16 <= length; i += 16) {
+    uint8x16_t chunk = vld1q_u8(in + i);
+    if (vmaxvq_u8(chunk) >= 0x80)
+      break;
+    vst1q_u16(reinterpret_cast<uint16_t *>(out + i),
+              vmovl_u8(vget_low_u8(chunk)));
+    vst1q_u16(reinterpret_cast<uint16_t *>(out + i + 8),
+              vmovl_u8(vget_high_u8(chunk)));
+  }
+#endif
+  for (; i < length && in[i] < 0x80; i++)
+    out[i] = in[i];
+  return i;
+}
+
+} // namespace
+
+/* --- UTF-16 -> UTF-8 --- */
+
+void utf16ToUtf8(const char16_t *data, size_t length, std::string &out) {
+  // A code unit never needs more than 3 bytes; a surrogate pair takes 4.
+  out.resize(length * 3);
+  char *o = &out[0];
+  size_t written = 0;
+  size_t i = 0;
+  while (i < length) {
+    size_t ascii = asciiToUtf8(data + i, length - i, o + written);
+    i += ascii;
+    written += ascii;
+    if (i == length)
+      break;
+
+    uint32_t c = data[i];
+    if (c < 0x800) {
+      o[written++] = static_cast<char>(0xC0 | (c >> 6));
+      o[written++] = static_cast<char>(0x80 | (c & 0x3F));
+    } else if (c >= 0xD800 && c <= 0xDBFF && i + 1 < length &&
+               data[i + 1] >= 0xDC00 && data[i + 1] <= 0xDFFF) {
+      c = 0x10000 + ((c - 0xD800) << 10) + (data[i + 1] - 0xDC00);
+      i++;
+      o[written++] = static_cast<char>(0xF0 | (c >> 18));
+      o[written++] = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+      o[written++] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+      o[written++] = static_cast<char>(0x80 | (c & 0x3F));
+    } else {
+      o[written++] = static_cast<char>(0xE0 | (c >> 12));
+      o[written++] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+      o[written++] = static_cast<char>(0x80 | (c & 0x3F));
+    }
+    i++;
+  }
+  out.resize(written);
+}
+
+std::string utf16ToUtf8(const char16_t *data, size_t length) {
+  std::string out;
+  utf16ToUtf8(data, length, out);
+  return out;
+}
+
+/* --- UTF-8 -> UTF-16 --- */
+
+void utf8ToUtf16(const char *data, size_t length, std::u16string &out) {
+  // Every byte yields at most one code unit.
+  out.resize(length);
+  char16_t *o = &out[0];
+  size_t written = 0;
+  const unsigned char *s = reinterpret_cast<const unsigned char *>(data);
+  size_t i = 0;
+  while (i < length) {
+    size_t ascii = asciiToUtf16(s + i, length - i, o + written);
+    i += ascii;
+    written += ascii;
+    if (i == length)
+      break;
+
+    uint32_t c = s[i];
+    size_t extra;
+    uint32_t min;
+    if ((c & 0xE0) == 0xC0) {
+      extra = 1;
+      min = 0x80;
+      c &= 0x1F;
+    } else if ((c & 0xF0) == 0xE0) {
+      extra = 2;
+      min = 0x800;
+      c &= 0x0F;
+    } else if ((c & 0xF8) == 0xF0) {
+      extra = 3;
+      min = 0x10000;
+      c &= 0x07;
+    } else {
+      o[written++] = u'\uFFFD';
+      i++;
+      continue;
+    }
+
+    size_t j = 1;
+    for (; j <= extra && i + j < length && (s[i + j] & 0xC0) == 0x80; j++)
+      c = (c << 6) | (s[i + j] & 0x3F);
+    if (j <= extra || c < min || c > 0x10FFFF) {
+      o[written++] = u'\uFFFD';
+      i += j;
+      continue;
+    }
+    i += j;
+
+    if (c >= 0x10000) {
+      c -= 0x10000;
+      o[written++] = static_cast<char16_t>(0xD800 + (c >> 10));
+      o[written++] = static_cast<char16_t>(0xDC00 + (c & 0x3FF));
+    } else {
+      o[written++] = static_cast<char16_t>(c);
+    }
+  }
+  out.resize(written);
+}
+
+std::u16string utf8ToUtf16(const char *data, size_t length) {
+  std::u16string out;
+  utf8ToUtf16(data, length, out);
+  return out;
+}
+
+} // namespace enriched
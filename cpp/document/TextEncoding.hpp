@@ -0,0 +1,30 @@
+/**
+ * UTF-8 <-> UTF-16 transcoding used at the platform boundary.
+ * Runs of ASCII, i.e. most markup, are converted a vector at a time.
+ */
+
+#pragma once
+
+#include <string>
+
+namespace enriched {
+
+/**
+ * Unpaired surrogates are encoded as 3-byte sequences (WTF-8), so that any
+ * platform string survives a round trip.
+ */
+std::string utf16ToUtf8(const char16_t *data, size_t length);
+/** Same, into `out`, whose capacity is reused across calls. */
+void utf16ToUtf8(const char16_t *data, size_t length, std::string &out);
+inline std::string utf16ToUtf8(const std::u16string &text) {
+  return utf16ToUtf8(text.data(), text.size());
+}
+
+/** Malformed sequences decode to U+FFFD. */
+std::u16string utf8ToUtf16(const char *data, size_t length);
+void utf8ToUtf16(const char *data, size_t length, std::u16string &out);
+inline std::u16string utf8ToUtf16(const std::string &text) {
+  return utf8ToUtf16(text.data(), text.size());
+}
+
+} // namespace enriched
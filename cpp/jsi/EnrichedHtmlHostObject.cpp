@@ -0,0 +1,90 @@
+#include "EnrichedHtmlHostObject.hpp"
+#include "GumboParser.hpp"
+
+#include <memory>
+#include <string>
+
+namespace enriched {
+
+namespace jsi = facebook::jsi;
+
+namespace {
+
+constexpr const char *kMethods[] = {"normalizeHtml", "isCanonicalHtml",
+                                    "toPlainText", "getStats"};
+
+std::string htmlArgument(jsi::Runtime &runtime, const jsi::Value *args,
+                         size_t count, const char *method) {
+  if (count < 1 || !args[0].isString())
+    throw jsi::JSError(runtime, std::string("EnrichedHtml.") + method +
+                                    ": expected an HTML string");
+  return args[0].getString(runtime).utf8(runtime);
+}
+
+jsi::Value statsObject(jsi::Runtime &runtime, const HtmlStats &stats) {
+  jsi::Object object(runtime);
+  object.setProperty(runtime, "characters",
+                     static_cast<double>(stats.characters));
+  object.setProperty(runtime, "paragraphs",
+                     static_cast<double>(stats.paragraphs));
+  object.setProperty(runtime, "links", static_cast<double>(stats.links));
+  object.setProperty(runtime, "mentions", static_cast<double>(stats.mentions));
+  object.setProperty(runtime, "images", static_cast<double>(stats.images));
+  return object;
+}
+
+jsi::Value call(jsi::Runtime &runtime, const std::string &method,
+                const std::string &html) {
+  if (method == "normalizeHtml") {
+    jsi::Value result = jsi::String::createFromAscii(runtime, "");
+    // Straight from the normalizer's buffer into the JS string.
+    GumboParser::normalizeHtml(
+        html.data(), html.size(), [&](const char *data, size_t length) {
+          result = jsi::String::createFromUtf8(
+              runtime, reinterpret_cast<const uint8_t *>(data), length);
+        });
+    return result;
+  }
+  if (method == "isCanonicalHtml")
+    return jsi::Value(GumboParser::isCanonicalHtml(html));
+  if (method == "toPlainText")
+    return jsi::String::createFromUtf8(runtime,
+                                       GumboParser::toPlainText(html));
+  return statsObject(runtime, GumboParser::stats(html));
+}
+
+} // namespace
+
+void EnrichedHtmlHostObject::install(jsi::Runtime &runtime) {
+  static auto instance = std::make_shared<EnrichedHtmlHostObject>();
+  runtime.global().setProperty(
+      runtime, kGlobalName,
+      jsi::Object::createFromHostObject(runtime, instance));
+}
+
+jsi::Value EnrichedHtmlHostObject::get(jsi::Runtime &runtime,
+                                       const jsi::PropNameID &name) {
+  std::string method = name.utf8(runtime);
+  for (const char *known : kMethods) {
+    if (method != known)
+      continue;
+    return jsi::Function::createFromHostFunction(
+        runtime, name, 1,
+        [method](jsi::Runtime &rt, const jsi::Value &, const jsi::Value *args,
+                 size_t count) -> jsi::Value {
+          return call(rt, method,
+                      htmlArgument(rt, args, count, method.c_str()));
+        });
+  }
+  return jsi::Value::undefined();
+}
+
+std::vector<jsi::PropNameID>
+EnrichedHtmlHostObject::getPropertyNames(jsi::Runtime &runtime) {
+  std::vector<jsi::PropNameID> names;
+  for (const char *method : kMethods)
+    names.push_back(jsi::PropNameID::forAscii(runtime, method));
+  return names;
+}
+
+} // namespace enriched
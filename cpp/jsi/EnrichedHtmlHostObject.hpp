@@ -0,0 +1,38 @@
+/**
+ * JSI binding for the HTML engine the views use, so JS can normalize,
+ * validate and inspect HTML synchronously.
+ */
+
+#pragma once
+
+#include <jsi/jsi.h>
+
+#include <vector>
+
+namespace enriched {
+
+/**
+ * Host object installed as `global.__enrichedHtml`. Every method takes a
+ * UTF-8 HTML string and runs on the JS thread:
+ *
+ *   normalizeHtml(html): string     canonical HTML, '' on failure
+ *   isCanonicalHtml(html): boolean  normalizing would be a no-op
+ *   toPlainText(html): string       text as the views show it
+ *   getStats(html): HtmlStats       counts over the canonical form
+ *
+ * Stateless, so one instance can serve every runtime.
+ */
+class EnrichedHtmlHostObject : public facebook::jsi::HostObject {
+public:
+  static constexpr const char *kGlobalName = "__enrichedHtml";
+
+  /** Installs the host object on the runtime's global object. */
+  static void install(facebook::jsi::Runtime &runtime);
+
+  facebook::jsi::Value get(facebook::jsi::Runtime &runtime,
+                           const facebook::jsi::PropNameID &name) override;
+  std::vector<facebook::jsi::PropNameID>
+  getPropertyNames(facebook::jsi::Runtime &runtime) override;
+};
+
+} // namespace enriched
@@ -0,0 +1,283 @@
+#include "BlobStore.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace enriched {
+
+namespace {
+
+/* --- Base64 --- */
+
+constexpr unsigned char kInvalid = 0xFF;
+constexpr unsigned char kSpace = 0xFE;
+constexpr unsigned char kPad = 0xFD;
+
+constexpr char kAlphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+struct DecodeTable {
+  unsigned char values[256];
+
+  constexpr DecodeTable() : values() {
+    for (int i = 0; i < 256; i++)
+      values[i] = kInvalid;
+    for (int i = 0; i < 64; i++)
+      values[static_cast<unsigned char>(kAlphabet[i])] =
+          static_cast<unsigned char>(i);
+    values[' '] = values['\t'] = values['\n'] = values['\r'] = kSpace;
+    values['\f'] = kSpace;
+    values['='] = kPad;
+  }
+};
+
+constexpr DecodeTable kDecode;
+
+/* --- Handles --- */
+
+uint64_t fnv1a(const std::string &bytes) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : bytes) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+std::string handleFor(uint64_t key) {
+  static constexpr char kHex[] = "0123456789abcdef";
+  std::string handle(BlobStore::kScheme);
+  for (int shift = 60; shift >= 0; shift -= 4)
+    handle.push_back(kHex[(key >> shift) & 0xF]);
+  return handle;
+}
+
+bool keyFor(std::string_view handle, uint64_t &key) {
+  if (!BlobStore::isHandle(handle) ||
+      handle.size() != BlobStore::kScheme.size() + 16)
+    return false;
+  key = 0;
+  for (char c : handle.substr(BlobStore::kScheme.size())) {
+    int digit;
+    if (c >= '0' && c <= '9')
+      digit = c - '0';
+    else if (c >= 'a' && c <= 'f')
+      digit = c - 'a' + 10;
+    else
+      return false;
+    key = (key << 4) | static_cast<uint64_t>(digit);
+  }
+  return true;
+}
+
+bool startsWithIgnoringCase(std::string_view s, std::string_view prefix) {
+  if (s.size() < prefix.size())
+    return false;
+  for (size_t i = 0; i < prefix.size(); i++) {
+    char c = s[i];
+    if (c >= 'A' && c <= 'Z')
+      c = static_cast<char>(c - 'A' + 'a');
+    if (c != prefix[i])
+      return false;
+  }
+  return true;
+}
+
+} // namespace
+
+bool decodeBase64(const char *data, size_t length, std::string &out) {
+  const unsigned char *s = reinterpret_cast<const unsigned char *>(data);
+  size_t written = out.size();
+  out.resize(written + length / 4 * 3 + 3);
+  char *o = &out[0];
+
+  uint32_t acc = 0;
+  int pending = 0;
+  size_t i = 0;
+  while (i < length) {
+    // Whole quads of alphabet characters, the common case for anything but
+    // the tail and line breaks.
+    if (pending == 0) {
+      for (; i + 4 <= length; i += 4) {
+        uint32_t a = kDecode.values[s[i]], b = kDecode.values[s[i + 1]],
+                 c = kDecode.values[s[i + 2]], d = kDecode.values[s[i + 3]];
+        if ((a | b | c | d) & 0x80)
+          break;
+        uint32_t quad = (a << 18) | (b << 12) | (c << 6) | d;
+        o[written++] = static_cast<char>(quad >> 16);
+        o[written++] = static_cast<char>(quad >> 8);
+        o[written++] = static_cast<char>(quad);
+      }
+      if (i == length)
+        break;
+    }
+
+    unsigned char value = kDecode.values[s[i++]];
+    if (value == kSpace)
+      continue;
+    if (value == kPad) {
+      for (; i < length; i++) {
+        unsigned char rest = kDecode.values[s[i]];
+        if (rest != kPad && rest != kSpace)
+          return false;
+      }
+      break;
+    }
+    if (value == kInvalid)
+      return false;
+
+    acc = (acc << 6) | value;
+    if (++pending == 4) {
+      o[written++] = static_cast<char>(acc >> 16);
+      o[written++] = static_cast<char>(acc >> 8);
+      o[written++] = static_cast<char>(acc);
+      acc = 0;
+      pending = 0;
+    }
+  }
+
+  if (pending == 1)
+    return false;
+  if (pending == 2) {
+    o[written++] = static_cast<char>(acc >> 4);
+  } else if (pending == 3) {
+    o[written++] = static_cast<char>(acc >> 10);
+    o[written++] = static_cast<char>(acc >> 2);
+  }
+  out.resize(written);
+  return true;
+}
+
+void encodeBase64(const char *data, size_t length, std::string &out) {
+  const unsigned char *s = reinterpret_cast<const unsigned char *>(data);
+  size_t written = out.size();
+  out.resize(written + (length + 2) / 3 * 4);
+  char *o = &out[0];
+
+  size_t i = 0;
+  for (; i + 3 <= length; i += 3) {
+    uint32_t triple = (s[i] << 16) | (s[i + 1] << 8) | s[i + 2];
+    o[written++] = kAlphabet[(triple >> 18) & 0x3F];
+    o[written++] = kAlphabet[(triple >> 12) & 0x3F];
+    o[written++] = kAlphabet[(triple >> 6) & 0x3F];
+    o[written++] = kAlphabet[triple & 0x3F];
+  }
+  if (i < length) {
+    uint32_t triple = s[i] << 16;
+    if (i + 1 < length)
+      triple |= s[i + 1] << 8;
+    o[written++] = kAlphabet[(triple >> 18) & 0x3F];
+    o[written++] = kAlphabet[(triple >> 12) & 0x3F];
+    o[written++] = i + 1 < length ? kAlphabet[(triple >> 6) & 0x3F] : '=';
+    o[written++] = '=';
+  }
+}
+
+/* --- BlobStore --- */
+
+BlobStore &BlobStore::shared() {
+  static BlobStore *store = new BlobStore();
+  return *store;
+}
+
+std::string BlobStore::put(std::string_view dataUri) {
+  if (!startsWithIgnoringCase(dataUri, "data:"))
+    return {};
+  size_t comma = dataUri.find(',');
+  if (comma == std::string_view::npos ||
+      dataUri.size() - comma - 1 < kMinInlineLength)
+    return {};
+
+  // data:[<mime>][;param=value]*;base64,<payload>
+  std::string_view header = dataUri.substr(5, comma - 5);
+  constexpr std::string_view kBase64 = ";base64";
+  if (header.size() < kBase64.size() ||
+      !startsWithIgnoringCase(header.substr(header.size() - kBase64.size()),
+                              kBase64))
+    return {};
+  std::string_view mimeType = header.substr(0, header.find(';'));
+  if (!startsWithIgnoringCase(mimeType, "image/"))
+    return {};
+
+  auto blob = std::make_unique<Blob>();
+  blob->mimeType = std::string(mimeType);
+  std::string_view payload = dataUri.substr(comma + 1);
+  if (!decodeBase64(payload.data(), payload.size(), blob->bytes) ||
+      blob->bytes.empty())
+    return {};
+
+  uint64_t key = fnv1a(blob->bytes);
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Probe past the (vanishingly rare) hash collision so a handle always
+  // names exactly one payload.
+  for (auto it = blobs_.find(key); it != blobs_.end(); it = blobs_.find(++key))
+    if (it->second->bytes == blob->bytes &&
+        it->second->mimeType == blob->mimeType)
+      return handleFor(key);
+
+  if (blob->bytes.size() > budget_ - size_)
+    return {};
+  size_ += blob->bytes.size();
+  blobs_.emplace(key, std::move(blob));
+  return handleFor(key);
+}
+
+const Blob *BlobStore::get(std::string_view handle) const {
+  uint64_t key;
+  if (!keyFor(handle, key))
+    return nullptr;
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = blobs_.find(key);
+  return it == blobs_.end() ? nullptr : it->second.get();
+}
+
+std::string BlobStore::dataUri(std::string_view handle) const {
+  const Blob *blob = get(handle);
+  if (!blob)
+    return {};
+  std::string uri = "data:" + blob->mimeType + ";base64,";
+  encodeBase64(blob->bytes.data(), blob->bytes.size(), uri);
+  return uri;
+}
+
+bool BlobStore::extractDataUris(std::string_view html, std::string &out) {
+  static constexpr std::string_view kImg = "<img ";
+  static constexpr std::string_view kSrc = " src=\"";
+  bool moved = false;
+  size_t copied = 0;
+  size_t tag = html.find(kImg);
+  while (tag != std::string_view::npos) {
+    size_t end = html.find('>', tag);
+    if (end == std::string_view::npos)
+      break;
+    size_t src = html.substr(tag, end - tag).find(kSrc);
+    if (src != std::string_view::npos) {
+      size_t valueStart = tag + src + kSrc.size();
+      size_t valueEnd = html.find('"', valueStart);
+      std::string handle =
+          valueEnd < end ? put(html.substr(valueStart, valueEnd - valueStart))
+                         : std::string();
+      if (!handle.empty()) {
+        if (!moved) {
+          out.clear();
+          out.reserve(html.size());
+          moved = true;
+        }
+        out.append(html.substr(copied, valueStart - copied));
+        out += handle;
+        copied = valueEnd;
+      }
+    }
+    tag = html.find(kImg, end);
+  }
+  if (moved)
+    out.append(html.substr(copied));
+  return moved;
+}
+
+size_t BlobStore::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return size_;
+}
+
+} // namespace enriched
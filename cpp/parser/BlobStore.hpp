@@ -0,0 +1,94 @@
+/**
+ * Side-channel storage for images pasted as base64 data: URIs.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace enriched {
+
+/** Decoded payload of a data: URI. */
+struct Blob {
+  std::string mimeType;
+  std::string bytes;
+};
+
+/**
+ * Content-addressed store that HTML loaded into a view moves large data: URI
+ * images into (GumboParser::normalizeHtmlForView), so the HTML that travels
+ * through parsing, the span builders and the platform bridges carries a
+ * short `enriched-blob:` handle instead of megabytes of base64. Image
+ * attachments resolve the handle to the decoded bytes in place and
+ * exporters turn it back into a data: URI.
+ *
+ * Blobs are never evicted: a handle may sit in undo history or on the
+ * clipboard for the lifetime of the process, and resolved pointers stay
+ * valid without reference counting. A byte budget bounds the total; past
+ * it, payloads stay inline in the HTML as before.
+ */
+class BlobStore {
+public:
+  static constexpr std::string_view kScheme = "enriched-blob:";
+  /** Payloads shorter than this (in base64 characters) stay inline. */
+  static constexpr size_t kMinInlineLength = 1024;
+  static constexpr size_t kDefaultBudget = 64 * 1024 * 1024;
+
+  explicit BlobStore(size_t budget = kDefaultBudget) : budget_(budget) {}
+
+  BlobStore(const BlobStore &) = delete;
+  BlobStore &operator=(const BlobStore &) = delete;
+
+  /** Store shared by the normalizer and every view; never destroyed. */
+  static BlobStore &shared();
+
+  static bool isHandle(std::string_view src) {
+    return src.substr(0, kScheme.size()) == kScheme;
+  }
+
+  /**
+   * Decodes a base64 data: URI and returns its handle, or an empty string
+   * when the URI should stay as it is: not base64, malformed, too small to
+   * be worth it, or over budget. Identical payloads share one handle.
+   */
+  std::string put(std::string_view dataUri);
+
+  /**
+   * Copies normalized HTML to `out` with the src of every <img> that put()
+   * accepts replaced by its handle. Returns false, leaving `out` untouched,
+   * when no image moved.
+   */
+  bool extractDataUris(std::string_view html, std::string &out);
+
+  /** The blob behind a handle, or null if this store never issued it. */
+  const Blob *get(std::string_view handle) const;
+
+  /** The handle's blob re-encoded as a data: URI, or empty if unknown. */
+  std::string dataUri(std::string_view handle) const;
+
+  /** Decoded bytes held, across all blobs. */
+  size_t size() const;
+
+private:
+  const size_t budget_;
+  mutable std::mutex mutex_;
+  std::unordered_map<uint64_t, std::unique_ptr<Blob>> blobs_;
+  size_t size_ = 0;
+};
+
+/**
+ * Appends the decoded form of `length` base64 characters to `out`. ASCII
+ * whitespace is skipped (mail clients wrap long URIs) and padding is
+ * optional; any other stray character fails the decode.
+ */
+bool decodeBase64(const char *data, size_t length, std::string &out);
+
+void encodeBase64(const char *data, size_t length, std::string &out);
+
+} // namespace enriched
@@ -26,8 +26,11 @@
 #endif
 
 #include <ctype.h>
+#include <pthread.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 /* ------------------------------------------------------------------ */
 /*  Dynamic string buffer                                              */
@@ -91,46 +94,498 @@ typedef enum {
   TAG_CLASS_PASS,         /* pass-through (e.g. <html>, <body>) */
 } tag_class_t;
 
-static const char *canonical_name(const char *name) {
-  if (strcmp(name, "strong") == 0)
-    return "b";
-  if (strcmp(name, "em") == 0)
-    return "i";
-  if (strcmp(name, "del") == 0 || strcmp(name, "strike") == 0)
-    return "s";
-  if (strcmp(name, "ins") == 0)
-    return "u";
-  if (strcmp(name, "pre") == 0)
-    return "codeblock";
+/* ------------------------------------------------------------------ */
+/*  Normalizer schema                                                  */
+/* ------------------------------------------------------------------ */
+
+/*
+ * Which tags survive normalization, under what name, and which of their
+ * attributes are kept. The canonical subset below is the default; callers
+ * can start from it (or from nothing) and add, remap or strip tags, e.g. to
+ * keep <sup>/<sub> or data-* attributes on mentions.
+ *
+ * The walker classifies every node several times over, so a compiled
+ * schema looks tags up through a perfect hash (hash and displace): one pass
+ * over the name gives a bucket, the bucket's displacement the only slot the
+ * tag can be in, and the stored hash and length rule out a miss before any
+ * compare.
+ */
+
+#define SCHEMA_MAX_NAME 63 /* fits get_tag_name's buffer */
+#define SCHEMA_SEEDS_PER_SIZE 16
+#define SCHEMA_MAX_SLOTS (1u << 17)
+
+typedef struct {
+  char *name;
+  char *value; /* NULL: any non-empty value; "": boolean; else only this */
+  bool prefix; /* name was "data-*": every attribute starting with it */
+} schema_attr_t;
+
+typedef struct {
+  char *name;
+  size_t len;
+  uint64_t hash;
+  tag_class_t cls;
+  char *canonical; /* emitted as, when not under its own name */
+  /* Attributes kept when this is the emitted tag, in emission order */
+  schema_attr_t *attrs;
+  size_t attr_count;
+  size_t attr_cap;
+} schema_tag_t;
+
+typedef struct normalizer_schema {
+  schema_tag_t *tags;
+  size_t tag_count;
+  size_t tag_cap;
+  bool rejected; /* a rule was invalid; compiling fails */
+  bool compiled;
+  bool streamable;
+  uint64_t seed;
+  uint32_t bucket_mask;
+  uint32_t slot_mask;
+  uint32_t *displacements; /* per bucket */
+  int *slots;              /* index into tags, -1 if empty */
+} normalizer_schema_t;
+
+static const struct {
+  const char *name;
+  tag_class_t cls;
+  const char *canonical;
+} kDefaultTags[] = {
+    {"b", TAG_CLASS_INLINE, NULL},
+    {"i", TAG_CLASS_INLINE, NULL},
+    {"u", TAG_CLASS_INLINE, NULL},
+    {"s", TAG_CLASS_INLINE, NULL},
+    {"code", TAG_CLASS_INLINE, NULL},
+    {"a", TAG_CLASS_INLINE, NULL},
+    {"strong", TAG_CLASS_INLINE, "b"},
+    {"em", TAG_CLASS_INLINE, "i"},
+    {"del", TAG_CLASS_INLINE, "s"},
+    {"strike", TAG_CLASS_INLINE, "s"},
+    {"ins", TAG_CLASS_INLINE, "u"},
+    {"mention", TAG_CLASS_INLINE, NULL},
+    {"p", TAG_CLASS_BLOCK, NULL},
+    {"h1", TAG_CLASS_BLOCK, NULL},
+    {"h2", TAG_CLASS_BLOCK, NULL},
+    {"h3", TAG_CLASS_BLOCK, NULL},
+    {"h4", TAG_CLASS_BLOCK, NULL},
+    {"h5", TAG_CLASS_BLOCK, NULL},
+    {"h6", TAG_CLASS_BLOCK, NULL},
+    {"ul", TAG_CLASS_BLOCK, NULL},
+    {"ol", TAG_CLASS_BLOCK, NULL},
+    {"li", TAG_CLASS_BLOCK, NULL},
+    {"blockquote", TAG_CLASS_BLOCK, NULL},
+    {"codeblock", TAG_CLASS_BLOCK, NULL},
+    {"pre", TAG_CLASS_BLOCK, "codeblock"},
+    {"br", TAG_CLASS_SELF_CLOSING, NULL},
+    {"img", TAG_CLASS_SELF_CLOSING, NULL},
+    {"html", TAG_CLASS_PASS, NULL},
+    {"head", TAG_CLASS_PASS, NULL},
+    {"body", TAG_CLASS_PASS, NULL},
+};
+
+static const struct {
+  const char *tag;
+  const char *name;
+  const char *value;
+} kDefaultAttributes[] = {
+    {"a", "href", NULL},
+    {"img", "src", NULL},
+    {"img", "alt", NULL},
+    {"img", "width", NULL},
+    {"img", "height", NULL},
+    {"ul", "data-type", "checkbox"},
+    {"li", "checked", ""},
+    {"mention", "id", NULL},
+    {"mention", "text", NULL},
+    {"mention", "indicator", NULL},
+};
+
+#define COUNT_OF(a) (sizeof(a) / sizeof((a)[0]))
+
+/* FNV-1a over a NUL-terminated name, also returning its length */
+static uint64_t schema_hash(uint64_t seed, const char *name, size_t *len) {
+  uint64_t h = 14695981039346656037ull ^ seed;
+  const char *p = name;
+  for (; *p; p++) {
+    h ^= (unsigned char)*p;
+    h *= 1099511628211ull;
+  }
+  *len = (size_t)(p - name);
+  /* Buckets and slots come from bit ranges FNV alone mixes poorly */
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  return h ^ (h >> 33);
+}
+
+static uint32_t hash_bucket(uint64_t h, uint32_t bucket_mask) {
+  return (uint32_t)(h >> 32) & bucket_mask;
+}
+
+/* Displacement d steps an odd stride from the hash's home slot, so the
+   first slot_mask + 1 values of d visit every slot */
+static uint32_t hash_slot(uint64_t h, uint32_t d, uint32_t slot_mask) {
+  uint32_t stride = (uint32_t)(h >> 48) | 1;
+  return ((uint32_t)h + d * stride) & slot_mask;
+}
+
+static const schema_tag_t *schema_lookup(const normalizer_schema_t *schema,
+                                         const char *name) {
+  size_t len;
+  uint64_t h = schema_hash(schema->seed, name, &len);
+  uint32_t d = schema->displacements[hash_bucket(h, schema->bucket_mask)];
+  int index = schema->slots[hash_slot(h, d, schema->slot_mask)];
+  if (index < 0)
+    return NULL;
+  const schema_tag_t *tag = &schema->tags[index];
+  if (tag->hash != h || tag->len != len || memcmp(tag->name, name, len) != 0)
+    return NULL;
+  return tag;
+}
+
+static tag_class_t classify_tag(const normalizer_schema_t *schema,
+                                const char *name) {
+  const schema_tag_t *tag = schema_lookup(schema, name);
+  return tag ? tag->cls : TAG_CLASS_SKIP;
+}
+
+/* --- Building --- */
+
+/*
+ * Lowercased copy of a tag or attribute name, or NULL if it isn't one we
+ * could match: empty, too long, or with characters the tokenizer ends names
+ * on.
+ */
+static char *copy_name(const char *name) {
+  size_t len = name ? strlen(name) : 0;
+  if (len == 0 || len > SCHEMA_MAX_NAME)
+    return NULL;
+  char *copy = (char *)malloc(len + 1);
+  for (size_t i = 0; i < len; i++) {
+    unsigned char c = (unsigned char)name[i];
+    if (c <= ' ' || c == '/' || c == '>' || c == '=' || c == '"' ||
+        c == '\'' || c == '<') {
+      free(copy);
+      return NULL;
+    }
+    copy[i] = (char)tolower(c);
+  }
+  copy[len] = '\0';
+  return copy;
+}
+
+static char *copy_value(const char *value) {
+  if (!value)
+    return NULL;
+  size_t len = strlen(value);
+  char *copy = (char *)malloc(len + 1);
+  memcpy(copy, value, len + 1);
+  return copy;
+}
+
+static schema_tag_t *find_schema_tag(normalizer_schema_t *schema,
+                                     const char *name) {
+  for (size_t i = 0; i < schema->tag_count; i++)
+    if (strcmp(schema->tags[i].name, name) == 0)
+      return &schema->tags[i];
   return NULL;
 }
 
-static tag_class_t classify_tag(const char *name) {
-  if (strcmp(name, "b") == 0 || strcmp(name, "i") == 0 ||
-      strcmp(name, "u") == 0 || strcmp(name, "s") == 0 ||
-      strcmp(name, "code") == 0 || strcmp(name, "a") == 0 ||
-      strcmp(name, "strong") == 0 || strcmp(name, "em") == 0 ||
-      strcmp(name, "del") == 0 || strcmp(name, "strike") == 0 ||
-      strcmp(name, "ins") == 0 || strcmp(name, "mention") == 0)
-    return TAG_CLASS_INLINE;
+/* The rule for `name` (lowercased), added as stripped if there's none yet */
+static schema_tag_t *schema_tag(normalizer_schema_t *schema,
+                                const char *name) {
+  char *key = copy_name(name);
+  if (!key)
+    return NULL;
+  schema_tag_t *tag = find_schema_tag(schema, key);
+  if (tag) {
+    free(key);
+    return tag;
+  }
+  if (schema->tag_count == schema->tag_cap) {
+    schema->tag_cap = schema->tag_cap ? schema->tag_cap * 2 : 32;
+    schema->tags = (schema_tag_t *)realloc(
+        schema->tags, schema->tag_cap * sizeof(*schema->tags));
+  }
+  tag = &schema->tags[schema->tag_count++];
+  memset(tag, 0, sizeof(*tag));
+  tag->name = key;
+  tag->len = strlen(key);
+  tag->cls = TAG_CLASS_SKIP;
+  return tag;
+}
+
+static bool reject_rule(normalizer_schema_t *schema) {
+  schema->rejected = true;
+  return false;
+}
+
+/**
+ * Keeps (or, with TAG_CLASS_SKIP, strips) the tag `name`, emitted as
+ * `canonical` when that's given. Later rules for a tag replace earlier ones.
+ * Returns false, and makes compiling fail, if the rule is invalid.
+ */
+bool normalizer_schema_allow_tag(normalizer_schema_t *schema,
+                                 const char *name, int cls,
+                                 const char *canonical) {
+  if (!schema || schema->compiled)
+    return false;
+  if (cls < TAG_CLASS_SKIP || cls > TAG_CLASS_PASS)
+    return reject_rule(schema);
+  char *out = NULL;
+  if (canonical && canonical[0] && !(out = copy_name(canonical)))
+    return reject_rule(schema);
+  schema_tag_t *tag = schema_tag(schema, name);
+  if (!tag) {
+    free(out);
+    return reject_rule(schema);
+  }
+  if (out && strcmp(out, tag->name) == 0) {
+    free(out);
+    out = NULL;
+  }
+  free(tag->canonical);
+  tag->canonical = out;
+  tag->cls = (tag_class_t)cls;
+  return true;
+}
 
-  if (strcmp(name, "p") == 0 || strcmp(name, "h1") == 0 ||
-      strcmp(name, "h2") == 0 || strcmp(name, "h3") == 0 ||
-      strcmp(name, "h4") == 0 || strcmp(name, "h5") == 0 ||
-      strcmp(name, "h6") == 0 || strcmp(name, "ul") == 0 ||
-      strcmp(name, "ol") == 0 || strcmp(name, "li") == 0 ||
-      strcmp(name, "blockquote") == 0 || strcmp(name, "codeblock") == 0 ||
-      strcmp(name, "pre") == 0)
-    return TAG_CLASS_BLOCK;
+/**
+ * Keeps attribute `name` on the emitted tag `tag`: with any non-empty
+ * value if `value` is NULL, as a bare boolean attribute if it's "", and
+ * only with exactly that value otherwise. A name ending in '*' keeps every
+ * attribute starting with the rest that has no rule of its own.
+ */
+bool normalizer_schema_allow_attribute(normalizer_schema_t *schema,
+                                       const char *tag_name, const char *name,
+                                       const char *value) {
+  if (!schema || schema->compiled)
+    return false;
+  char *key = copy_name(name);
+  schema_tag_t *tag = key ? schema_tag(schema, tag_name) : NULL;
+  if (!tag) {
+    free(key);
+    return reject_rule(schema);
+  }
+  size_t len = strlen(key);
+  bool prefix = key[len - 1] == '*';
+  if (prefix)
+    key[len - 1] = '\0';
+  for (size_t i = 0; i < tag->attr_count; i++) {
+    schema_attr_t *attr = &tag->attrs[i];
+    if (attr->prefix == prefix && strcmp(attr->name, key) == 0) {
+      free(key);
+      free(attr->value);
+      attr->value = copy_value(value);
+      return true;
+    }
+  }
+  if (tag->attr_count == tag->attr_cap) {
+    tag->attr_cap = tag->attr_cap ? tag->attr_cap * 2 : 4;
+    tag->attrs = (schema_attr_t *)realloc(
+        tag->attrs, tag->attr_cap * sizeof(*tag->attrs));
+  }
+  schema_attr_t *attr = &tag->attrs[tag->attr_count++];
+  attr->name = key;
+  attr->value = copy_value(value);
+  attr->prefix = prefix;
+  return true;
+}
 
-  if (strcmp(name, "br") == 0 || strcmp(name, "img") == 0)
-    return TAG_CLASS_SELF_CLOSING;
+/** An empty schema, or one holding the canonical subset. */
+normalizer_schema_t *normalizer_schema_create(bool with_defaults) {
+  normalizer_schema_t *schema =
+      (normalizer_schema_t *)calloc(1, sizeof(normalizer_schema_t));
+  if (!with_defaults)
+    return schema;
+  for (size_t i = 0; i < COUNT_OF(kDefaultTags); i++)
+    normalizer_schema_allow_tag(schema, kDefaultTags[i].name,
+                                kDefaultTags[i].cls,
+                                kDefaultTags[i].canonical);
+  for (size_t i = 0; i < COUNT_OF(kDefaultAttributes); i++)
+    normalizer_schema_allow_attribute(schema, kDefaultAttributes[i].tag,
+                                      kDefaultAttributes[i].name,
+                                      kDefaultAttributes[i].value);
+  return schema;
+}
 
-  if (strcmp(name, "html") == 0 || strcmp(name, "head") == 0 ||
-      strcmp(name, "body") == 0)
-    return TAG_CLASS_PASS;
+void normalizer_schema_free(normalizer_schema_t *schema) {
+  if (!schema)
+    return;
+  for (size_t i = 0; i < schema->tag_count; i++) {
+    schema_tag_t *tag = &schema->tags[i];
+    for (size_t j = 0; j < tag->attr_count; j++) {
+      free(tag->attrs[j].name);
+      free(tag->attrs[j].value);
+    }
+    free(tag->attrs);
+    free(tag->name);
+    free(tag->canonical);
+  }
+  free(schema->tags);
+  free(schema->displacements);
+  free(schema->slots);
+  free(schema);
+}
+
+/* --- Compiling --- */
+
+/* Puts a bucket's tags at displacement d if all their slots are free */
+static bool displace_bucket(normalizer_schema_t *schema, const size_t *tags,
+                            size_t count, uint32_t d, uint32_t slot_mask,
+                            int *slots) {
+  for (size_t i = 0; i < count; i++) {
+    uint32_t slot = hash_slot(schema->tags[tags[i]].hash, d, slot_mask);
+    if (slots[slot] >= 0) {
+      while (i-- > 0)
+        slots[hash_slot(schema->tags[tags[i]].hash, d, slot_mask)] = -1;
+      return false;
+    }
+    slots[slot] = (int)tags[i];
+  }
+  return true;
+}
+
+/*
+ * Gives every bucket the first displacement that puts all its tags in free
+ * slots, fullest buckets first while there are still plenty of free slots.
+ * False if some bucket has no such displacement (tags whose hashes can't be
+ * told apart), in which case the caller tries another seed.
+ */
+static bool place_tags(normalizer_schema_t *schema, uint64_t seed,
+                       uint32_t bucket_mask, uint32_t slot_mask,
+                       uint32_t *displacements, int *slots) {
+  size_t n = schema->tag_count;
+  uint32_t buckets = bucket_mask + 1;
+  /* Tag indices grouped by bucket: bucket b holds members[first[b]..] */
+  size_t *first = (size_t *)calloc(buckets + 1, sizeof(size_t));
+  size_t *members = (size_t *)malloc((n ? n : 1) * sizeof(size_t));
+  size_t largest = 0;
+  for (size_t i = 0; i < n; i++) {
+    schema_tag_t *tag = &schema->tags[i];
+    size_t len;
+    tag->hash = schema_hash(seed, tag->name, &len);
+    first[hash_bucket(tag->hash, bucket_mask) + 1]++;
+  }
+  for (uint32_t b = 0; b < buckets; b++) {
+    if (first[b + 1] > largest)
+      largest = first[b + 1];
+    first[b + 1] += first[b];
+  }
+  size_t *fill = (size_t *)malloc(buckets * sizeof(size_t));
+  memcpy(fill, first, buckets * sizeof(size_t));
+  for (size_t i = 0; i < n; i++)
+    members[fill[hash_bucket(schema->tags[i].hash, bucket_mask)]++] = i;
+  free(fill);
+
+  for (uint32_t i = 0; i <= slot_mask; i++)
+    slots[i] = -1;
+  memset(displacements, 0, buckets * sizeof(uint32_t));
+
+  bool placed = true;
+  for (size_t size = largest; placed && size > 0; size--) {
+    for (uint32_t b = 0; placed && b < buckets; b++) {
+      if (first[b + 1] - first[b] != size)
+        continue;
+      placed = false;
+      for (uint32_t d = 0; !placed && d <= slot_mask; d++) {
+        placed = displace_bucket(schema, members + first[b], size, d,
+                                 slot_mask, slots);
+        displacements[b] = d;
+      }
+    }
+  }
+  free(first);
+  free(members);
+  return placed;
+}
+
+static bool same_name(const char *a, const char *b) {
+  return a == b || (a && b && strcmp(a, b) == 0);
+}
+
+/*
+ * The streaming path decides structure (blocks, lists, void elements)
+ * itself and only asks the schema about inline tags and attributes. It can
+ * run as long as the schema leaves everything else as the defaults have it.
+ */
+static bool is_streamable(normalizer_schema_t *schema) {
+  for (size_t i = 0; i < COUNT_OF(kDefaultTags); i++) {
+    if (kDefaultTags[i].cls == TAG_CLASS_INLINE)
+      continue;
+    schema_tag_t *tag = find_schema_tag(schema, kDefaultTags[i].name);
+    if (!tag || tag->cls != kDefaultTags[i].cls ||
+        !same_name(tag->canonical, kDefaultTags[i].canonical))
+      return false;
+  }
+  for (size_t i = 0; i < schema->tag_count; i++) {
+    schema_tag_t *tag = &schema->tags[i];
+    if (tag->cls == TAG_CLASS_SKIP)
+      continue;
+    const char *out = tag->canonical ? tag->canonical : tag->name;
+    bool structural = false;
+    for (size_t j = 0; j < COUNT_OF(kDefaultTags); j++) {
+      if (kDefaultTags[j].cls != TAG_CLASS_INLINE &&
+          (strcmp(kDefaultTags[j].name, tag->name) == 0 ||
+           strcmp(kDefaultTags[j].name, out) == 0))
+        structural = true;
+    }
+    /* New blocks and void tags, or inline tags emitted as one */
+    if (structural != (tag->cls != TAG_CLASS_INLINE))
+      return false;
+  }
+  return true;
+}
+
+/**
+ * Builds the lookup table. The schema can't change afterwards, and can be
+ * shared by any number of threads. Returns false if a rule was rejected.
+ */
+bool normalizer_schema_compile(normalizer_schema_t *schema) {
+  if (!schema || schema->rejected)
+    return false;
+  if (schema->compiled)
+    return true;
+
+  /* Slots at most half full, two tags per bucket on average */
+  uint32_t slots = 8;
+  while (slots < schema->tag_count * 2)
+    slots *= 2;
+  for (; slots <= SCHEMA_MAX_SLOTS; slots *= 2) {
+    uint32_t buckets = slots / 4;
+    schema->slots = (int *)malloc(slots * sizeof(int));
+    schema->displacements = (uint32_t *)malloc(buckets * sizeof(uint32_t));
+    for (uint64_t seed = 0; seed < SCHEMA_SEEDS_PER_SIZE; seed++) {
+      if (place_tags(schema, seed, buckets - 1, slots - 1,
+                     schema->displacements, schema->slots)) {
+        schema->seed = seed;
+        schema->bucket_mask = buckets - 1;
+        schema->slot_mask = slots - 1;
+        schema->streamable = is_streamable(schema);
+        schema->compiled = true;
+        return true;
+      }
+    }
+    free(schema->slots);
+    free(schema->displacements);
+    schema->slots = NULL;
+    schema->displacements = NULL;
+  }
+  return false;
+}
+
+static normalizer_schema_t *default_schema;
+static pthread_once_t default_schema_once = PTHREAD_ONCE_INIT;
+
+static void create_default_schema(void) {
+  default_schema = normalizer_schema_create(true);
+  normalizer_schema_compile(default_schema);
+}
 
-  return TAG_CLASS_SKIP;
+/** The canonical subset, compiled; shared and never freed. */
+const normalizer_schema_t *normalizer_schema_default(void) {
+  pthread_once(&default_schema_once, create_default_schema);
+  return default_schema;
 }
 
 /* ------------------------------------------------------------------ */
@@ -196,37 +651,40 @@ static bool is_br_node(GumboNode *node) {
   return n && strcmp(n, "br") == 0;
 }
 
-static bool is_block_producing(GumboNode *node) {
+static bool is_block_producing(const normalizer_schema_t *schema,
+                               GumboNode *node) {
   char buf[64];
   const char *n = get_tag_name(node, buf, sizeof(buf));
   if (!n)
     return false;
-  if (classify_tag(n) == TAG_CLASS_BLOCK)
+  if (classify_tag(schema, n) == TAG_CLASS_BLOCK)
     return true;
   return strcmp(n, "div") == 0 || strcmp(n, "table") == 0 ||
          strcmp(n, "tr") == 0;
 }
 
 /** True if all children are inline/text (no block-producing elements). */
-static bool is_purely_inline(GumboNode *node) {
+static bool is_purely_inline(const normalizer_schema_t *schema,
+                             GumboNode *node) {
   if (!is_element(node))
     return true;
   GumboVector *children = &node->v.element.children;
   for (unsigned int i = 0; i < children->length; i++) {
-    if (is_block_producing(children->data[i]))
+    if (is_block_producing(schema, children->data[i]))
       return false;
   }
   return true;
 }
 
 /** True if any direct child is block-producing or a blockquote. */
-static bool has_block_or_bq_child(GumboNode *node) {
+static bool has_block_or_bq_child(const normalizer_schema_t *schema,
+                                  GumboNode *node) {
   if (!is_element(node))
     return false;
   GumboVector *children = &node->v.element.children;
   for (unsigned int i = 0; i < children->length; i++) {
     GumboNode *c = children->data[i];
-    if (is_block_producing(c) || is_blockquote_node(c))
+    if (is_block_producing(schema, c) || is_blockquote_node(c))
       return true;
   }
   return false;
@@ -399,38 +857,62 @@ static const char *get_attr(GumboElement *el, const char *name) {
   return NULL;
 }
 
+static void append_attr(buffer_t *out, const char *name, const char *val) {
+  buffer_append_str(out, " ");
+  buffer_append_str(out, name);
+  buffer_append_str(out, "=\"");
+  buffer_append_str(out, val);
+  buffer_append_str(out, "\"");
+}
+
 static void emit_one_attr(buffer_t *out, GumboElement *el,
                           const char *attr_name) {
   const char *val = get_attr(el, attr_name);
-  if (val && val[0]) {
-    buffer_append_str(out, " ");
-    buffer_append_str(out, attr_name);
-    buffer_append_str(out, "=\"");
-    buffer_append_str(out, val);
-    buffer_append_str(out, "\"");
-  }
-}
-
-static void emit_attributes(GumboElement *el, const char *tag_name,
-                            buffer_t *out) {
-  if (strcmp(tag_name, "a") == 0) {
-    emit_one_attr(out, el, "href");
-  } else if (strcmp(tag_name, "img") == 0) {
-    emit_one_attr(out, el, "src");
-    emit_one_attr(out, el, "alt");
-    emit_one_attr(out, el, "width");
-    emit_one_attr(out, el, "height");
-  } else if (strcmp(tag_name, "ul") == 0) {
-    const char *val = get_attr(el, "data-type");
-    if (val && strcmp(val, "checkbox") == 0)
-      buffer_append_str(out, " data-type=\"checkbox\"");
-  } else if (strcmp(tag_name, "li") == 0) {
-    if (gumbo_get_attribute(&el->attributes, "checked") != NULL)
-      buffer_append_str(out, " checked");
-  } else if (strcmp(tag_name, "mention") == 0) {
-    emit_one_attr(out, el, "id");
-    emit_one_attr(out, el, "text");
-    emit_one_attr(out, el, "indicator");
+  if (val && val[0])
+    append_attr(out, attr_name, val);
+}
+
+static bool has_attr_rule(const schema_tag_t *tag, const char *name) {
+  for (size_t i = 0; i < tag->attr_count; i++)
+    if (!tag->attrs[i].prefix && strcmp(tag->attrs[i].name, name) == 0)
+      return true;
+  return false;
+}
+
+/* Every attribute starting with the rule's prefix, in source order */
+static void emit_prefixed_attrs(buffer_t *out, GumboElement *el,
+                                const schema_tag_t *tag,
+                                const schema_attr_t *rule) {
+  size_t prefix_len = strlen(rule->name);
+  for (unsigned int i = 0; i < el->attributes.length; i++) {
+    GumboAttribute *attr = el->attributes.data[i];
+    if (strncmp(attr->name, rule->name, prefix_len) == 0 && attr->value[0] &&
+        !has_attr_rule(tag, attr->name))
+      append_attr(out, attr->name, attr->value);
+  }
+}
+
+static void emit_attributes(const normalizer_schema_t *schema, GumboElement *el,
+                            const char *tag_name, buffer_t *out) {
+  const schema_tag_t *tag = schema_lookup(schema, tag_name);
+  if (!tag)
+    return;
+  for (size_t i = 0; i < tag->attr_count; i++) {
+    const schema_attr_t *rule = &tag->attrs[i];
+    if (rule->prefix) {
+      emit_prefixed_attrs(out, el, tag, rule);
+    } else if (!rule->value) {
+      emit_one_attr(out, el, rule->name);
+    } else if (!rule->value[0]) {
+      if (gumbo_get_attribute(&el->attributes, rule->name) != NULL) {
+        buffer_append_str(out, " ");
+        buffer_append_str(out, rule->name);
+      }
+    } else {
+      const char *val = get_attr(el, rule->name);
+      if (val && strcmp(val, rule->value) == 0)
+        append_attr(out, rule->name, val);
+    }
   }
 }
 
@@ -452,13 +934,17 @@ static bool is_google_docs_wrapper(GumboElement *el, const char *tag_name) {
 /*  Recursive DOM tree walker                                          */
 /* ------------------------------------------------------------------ */
 
-static void walk_node(GumboNode *node, buffer_t *out);
+static void walk_node(const normalizer_schema_t *schema, GumboNode *node,
+                      buffer_t *out);
+static void walk_children(const normalizer_schema_t *schema, GumboNode *node,
+                          buffer_t *out);
 
 /* ------------------------------------------------------------------ */
 /*  Blockquote content flattening                                      */
 /* ------------------------------------------------------------------ */
 
-static void flatten_bq_node(GumboNode *node, buffer_t *ib, buffer_t *out);
+static void flatten_bq_node(const normalizer_schema_t *schema, GumboNode *node,
+                            buffer_t *ib, buffer_t *out);
 
 static void flush_inline_p(buffer_t *ib, buffer_t *out) {
   if (ib->len > 0) {
@@ -469,20 +955,22 @@ static void flush_inline_p(buffer_t *ib, buffer_t *out) {
   }
 }
 
-static void flatten_bq_children(GumboNode *node, buffer_t *ib, buffer_t *out) {
+static void flatten_bq_children(const normalizer_schema_t *schema,
+                                GumboNode *node, buffer_t *ib, buffer_t *out) {
   if (!is_element(node))
     return;
   GumboVector *children = &node->v.element.children;
   for (unsigned int i = 0; i < children->length; i++) {
-    flatten_bq_node(children->data[i], ib, out);
+    flatten_bq_node(schema, children->data[i], ib, out);
   }
 }
 
-static void flatten_bq_node(GumboNode *node, buffer_t *ib, buffer_t *out) {
+static void flatten_bq_node(const normalizer_schema_t *schema, GumboNode *node,
+                            buffer_t *ib, buffer_t *out) {
   if (!node)
     return;
   if (is_text(node)) {
-    walk_node(node, ib);
+    walk_node(schema, node, ib);
     return;
   }
   if (!is_element(node)) {
@@ -492,13 +980,13 @@ static void flatten_bq_node(GumboNode *node, buffer_t *ib, buffer_t *out) {
     flush_inline_p(ib, out);
     return;
   }
-  if (is_block_producing(node) || is_blockquote_node(node)) {
+  if (is_block_producing(schema, node) || is_blockquote_node(node)) {
     flush_inline_p(ib, out);
-    flatten_bq_children(node, ib, out);
+    flatten_bq_children(schema, node, ib, out);
     flush_inline_p(ib, out);
     return;
   }
-  walk_node(node, ib);
+  walk_node(schema, node, ib);
 }
 
 /* ------------------------------------------------------------------ */
@@ -513,14 +1001,15 @@ typedef struct {
   int max_nested;
 } li_ctx_t;
 
-static void flatten_li_node(GumboNode *node, buffer_t *ib, buffer_t *out,
-                            li_ctx_t *ctx);
+static void flatten_li_node(const normalizer_schema_t *schema, GumboNode *node,
+                            buffer_t *ib, buffer_t *out, li_ctx_t *ctx);
 
-static void flush_li_buffer(buffer_t *ib, buffer_t *out, li_ctx_t *ctx) {
+static void flush_li_buffer(const normalizer_schema_t *schema, buffer_t *ib,
+                            buffer_t *out, li_ctx_t *ctx) {
   if (ib->len == 0)
     return;
   buffer_append_str(out, "<li");
-  emit_attributes(ctx->el, "li", out);
+  emit_attributes(schema, ctx->el, "li", out);
   buffer_append_str(out, ">");
   emit_styles_open(out, ctx->styles);
   buffer_append(out, ib->data, ib->len);
@@ -529,26 +1018,27 @@ static void flush_li_buffer(buffer_t *ib, buffer_t *out, li_ctx_t *ctx) {
   buffer_clear(ib);
 }
 
-static void flatten_li_children(GumboNode *node, buffer_t *ib, buffer_t *out,
+static void flatten_li_children(const normalizer_schema_t *schema,
+                                GumboNode *node, buffer_t *ib, buffer_t *out,
                                 li_ctx_t *ctx) {
   if (!is_element(node))
     return;
   GumboVector *children = &node->v.element.children;
   for (unsigned int i = 0; i < children->length; i++) {
-    flatten_li_node(children->data[i], ib, out, ctx);
+    flatten_li_node(schema, children->data[i], ib, out, ctx);
   }
 }
 
-static void flatten_li_node(GumboNode *node, buffer_t *ib, buffer_t *out,
-                            li_ctx_t *ctx) {
+static void flatten_li_node(const normalizer_schema_t *schema, GumboNode *node,
+                            buffer_t *ib, buffer_t *out, li_ctx_t *ctx) {
   if (!node)
     return;
   if (is_text(node)) {
-    walk_node(node, ib);
+    walk_node(schema, node, ib);
     return;
   }
   if (!is_element(node)) {
-    flatten_li_children(node, ib, out, ctx);
+    flatten_li_children(schema, node, ib, out, ctx);
     return;
   }
   if (is_list_node(node)) {
@@ -559,45 +1049,50 @@ static void flatten_li_node(GumboNode *node, buffer_t *ib, buffer_t *out,
     return;
   }
   if (is_br_node(node)) {
-    flush_li_buffer(ib, out, ctx);
+    flush_li_buffer(schema, ib, out, ctx);
     return;
   }
-  if (is_block_producing(node) || is_blockquote_node(node)) {
-    flush_li_buffer(ib, out, ctx);
-    flatten_li_children(node, ib, out, ctx);
-    flush_li_buffer(ib, out, ctx);
+  if (is_block_producing(schema, node) || is_blockquote_node(node)) {
+    flush_li_buffer(schema, ib, out, ctx);
+    flatten_li_children(schema, node, ib, out, ctx);
+    flush_li_buffer(schema, ib, out, ctx);
     return;
   }
-  walk_node(node, ib);
+  walk_node(schema, node, ib);
 }
 
 /* ------------------------------------------------------------------ */
 /*  walk_children — the main child-iteration driver                    */
 /* ------------------------------------------------------------------ */
 
-static void walk_children(GumboNode *node, buffer_t *out) {
-  if (!is_element(node))
-    return;
+/* Detect mixed content: does the parent have any block-producing child? */
+static bool has_block_child_from(const normalizer_schema_t *schema,
+                                 GumboNode *node, unsigned int first) {
+  GumboVector *children = &node->v.element.children;
+  for (unsigned int j = first; j < children->length; j++) {
+    if (is_block_producing(schema, children->data[j]))
+      return true;
+  }
+  return false;
+}
 
+/*
+ * Walks children [first, end) of node. has_block is computed once over all
+ * the children being walked, so a range comes out as it would in the whole.
+ */
+static void walk_child_range(const normalizer_schema_t *schema, GumboNode *node,
+                             unsigned int first, unsigned int end,
+                             bool has_block, buffer_t *out) {
   GumboVector *children = &node->v.element.children;
   bool parent_is_list = is_list_node(node);
 
-  /* Detect mixed content: does the parent have any block-producing child? */
-  bool has_block = false;
-  for (unsigned int j = 0; j < children->length; j++) {
-    if (is_block_producing(children->data[j])) {
-      has_block = true;
-      break;
-    }
-  }
-
-  unsigned int i = 0;
-  while (i < children->length) {
+  unsigned int i = first;
+  while (i < end) {
     GumboNode *child = children->data[i];
 
     /* Flatten list-inside-list */
     if (parent_is_list && is_list_node(child)) {
-      walk_children(child, out);
+      walk_children(schema, child, out);
       i++;
       continue;
     }
@@ -606,8 +1101,8 @@ static void walk_children(GumboNode *node, buffer_t *out) {
     if (is_blockquote_node(child)) {
       buffer_append_str(out, "<blockquote>");
       buffer_t bq_ib = buffer_create(64);
-      while (i < children->length && is_blockquote_node(children->data[i])) {
-        flatten_bq_children(children->data[i], &bq_ib, out);
+      while (i < end && is_blockquote_node(children->data[i])) {
+        flatten_bq_children(schema, children->data[i], &bq_ib, out);
         i++;
       }
       flush_inline_p(&bq_ib, out);
@@ -617,10 +1112,10 @@ static void walk_children(GumboNode *node, buffer_t *out) {
     }
 
     /* Auto-paragraph: group inline runs into <p> when mixed with blocks */
-    if (has_block && !parent_is_list && !is_block_producing(child) &&
+    if (has_block && !parent_is_list && !is_block_producing(schema, child) &&
         !is_blockquote_node(child)) {
       buffer_t ib = buffer_create(64);
-      while (i < children->length && !is_block_producing(children->data[i]) &&
+      while (i < end && !is_block_producing(schema, children->data[i]) &&
              !is_blockquote_node(children->data[i])) {
         child = children->data[i];
         if (is_br_node(child)) {
@@ -632,13 +1127,13 @@ static void walk_children(GumboNode *node, buffer_t *out) {
           continue;
         }
         /* Transparent inline wrapper for block/bq children */
-        if (is_element(child) && has_block_or_bq_child(child)) {
+        if (is_element(child) && has_block_or_bq_child(schema, child)) {
           flush_inline_p(&ib, out);
-          walk_children(child, out);
+          walk_children(schema, child, out);
           i++;
           continue;
         }
-        walk_node(child, &ib);
+        walk_node(schema, child, &ib);
         i++;
       }
       flush_inline_p(&ib, out);
@@ -646,16 +1141,31 @@ static void walk_children(GumboNode *node, buffer_t *out) {
       continue;
     }
 
-    walk_node(child, out);
+    walk_node(schema, child, out);
     i++;
   }
 }
 
+static void walk_children_from(const normalizer_schema_t *schema,
+                               GumboNode *node, unsigned int first,
+                               buffer_t *out) {
+  if (!is_element(node))
+    return;
+  walk_child_range(schema, node, first, node->v.element.children.length,
+                   has_block_child_from(schema, node, first), out);
+}
+
+static void walk_children(const normalizer_schema_t *schema, GumboNode *node,
+                          buffer_t *out) {
+  walk_children_from(schema, node, 0, out);
+}
+
 /* ------------------------------------------------------------------ */
 /*  walk_node — process a single DOM node                              */
 /* ------------------------------------------------------------------ */
 
-static void walk_node(GumboNode *node, buffer_t *out) {
+static void walk_node(const normalizer_schema_t *schema, GumboNode *node,
+                      buffer_t *out) {
   if (!node)
     return;
 
@@ -686,14 +1196,14 @@ static void walk_node(GumboNode *node, buffer_t *out) {
   }
 
   if (!is_element(node)) {
-    walk_children(node, out);
+    walk_children(schema, node, out);
     return;
   }
 
   GumboElement *el = &node->v.element;
   char name_buf[64];
   if (!get_tag_name(node, name_buf, sizeof(name_buf))) {
-    walk_children(node, out);
+    walk_children(schema, node, out);
     return;
   }
 
@@ -705,15 +1215,13 @@ static void walk_node(GumboNode *node, buffer_t *out) {
 
   /* Google Docs wrapper */
   if (is_google_docs_wrapper(el, name_buf)) {
-    walk_children(node, out);
+    walk_children(schema, node, out);
     return;
   }
 
-  const char *out_name = canonical_name(name_buf);
-  if (!out_name)
-    out_name = name_buf;
-
-  tag_class_t cls = classify_tag(name_buf);
+  const schema_tag_t *rule = schema_lookup(schema, name_buf);
+  const char *out_name = rule && rule->canonical ? rule->canonical : name_buf;
+  tag_class_t cls = rule ? rule->cls : TAG_CLASS_SKIP;
 
   /* --- <span>: CSS style → inline tags --- */
   if (strcmp(name_buf, "span") == 0) {
@@ -721,7 +1229,7 @@ static void walk_node(GumboNode *node, buffer_t *out) {
     size_t slen = sval ? strlen(sval) : 0;
     css_styles_t s = parse_css_style(sval, slen);
     emit_styles_open(out, s);
-    walk_children(node, out);
+    walk_children(schema, node, out);
     emit_styles_close(out, s);
     return;
   }
@@ -732,7 +1240,7 @@ static void walk_node(GumboNode *node, buffer_t *out) {
     size_t slen = sval ? strlen(sval) : 0;
     css_styles_t s = parse_css_style(sval, slen);
 
-    if (is_purely_inline(node)) {
+    if (is_purely_inline(schema, node)) {
       /* Split on <br> into separate <p>s */
       buffer_t pb = buffer_create(64);
       GumboVector *div_children = &el->children;
@@ -751,7 +1259,7 @@ static void walk_node(GumboNode *node, buffer_t *out) {
           buffer_clear(&pb);
           continue;
         }
-        walk_node(dc, &pb);
+        walk_node(schema, dc, &pb);
       }
       if (pb.len > 0) {
         buffer_append_str(out, "<p>");
@@ -763,7 +1271,7 @@ static void walk_node(GumboNode *node, buffer_t *out) {
       free(pb.data);
     } else {
       emit_styles_open(out, s);
-      walk_children(node, out);
+      walk_children(schema, node, out);
       emit_styles_close(out, s);
     }
     return;
@@ -776,7 +1284,7 @@ static void walk_node(GumboNode *node, buffer_t *out) {
       strcmp(name_buf, "th") == 0 || strcmp(name_buf, "caption") == 0 ||
       strcmp(name_buf, "colgroup") == 0 || strcmp(name_buf, "col") == 0) {
     if (strcmp(name_buf, "td") == 0 || strcmp(name_buf, "th") == 0) {
-      walk_children(node, out);
+      walk_children(schema, node, out);
       /* Check if there's a next sibling element */
       GumboNode *parent = node->parent;
       if (parent && is_element(parent)) {
@@ -796,7 +1304,7 @@ static void walk_node(GumboNode *node, buffer_t *out) {
       }
     } else if (strcmp(name_buf, "tr") == 0) {
       buffer_t row = buffer_create(64);
-      walk_children(node, &row);
+      walk_children(schema, node, &row);
       if (row.len > 0) {
         buffer_append_str(out, "<p>");
         buffer_append(out, row.data, row.len);
@@ -804,7 +1312,7 @@ static void walk_node(GumboNode *node, buffer_t *out) {
       }
       free(row.data);
     } else {
-      walk_children(node, out);
+      walk_children(schema, node, out);
     }
     return;
   }
@@ -813,13 +1321,13 @@ static void walk_node(GumboNode *node, buffer_t *out) {
   switch (cls) {
   case TAG_CLASS_PASS:
   case TAG_CLASS_SKIP:
-    walk_children(node, out);
+    walk_children(schema, node, out);
     break;
 
   case TAG_CLASS_SELF_CLOSING:
     buffer_append_str(out, "<");
     buffer_append_str(out, out_name);
-    emit_attributes(el, out_name, out);
+    emit_attributes(schema, el, out_name, out);
     buffer_append_str(out, strcmp(out_name, "img") == 0 ? " />" : ">");
     break;
 
@@ -835,21 +1343,21 @@ static void walk_node(GumboNode *node, buffer_t *out) {
       int nested_count = 0;
       buffer_t li_ib = buffer_create(64);
       li_ctx_t ctx = {el, es, nested_lists, &nested_count, 16};
-      flatten_li_children(node, &li_ib, out, &ctx);
-      flush_li_buffer(&li_ib, out, &ctx);
+      flatten_li_children(schema, node, &li_ib, out, &ctx);
+      flush_li_buffer(schema, &li_ib, out, &ctx);
       free(li_ib.data);
       for (int k = 0; k < nested_count; k++)
-        walk_children(nested_lists[k], out);
+        walk_children(schema, nested_lists[k], out);
       break;
     }
 
     /* <codeblock>: wrap inline content in <p> */
     if (strcmp(out_name, "codeblock") == 0) {
-      bool wrap = is_purely_inline(node);
+      bool wrap = is_purely_inline(schema, node);
       buffer_append_str(out, "<codeblock>");
       if (wrap)
         buffer_append_str(out, "<p>");
-      walk_children(node, out);
+      walk_children(schema, node, out);
       if (wrap)
         buffer_append_str(out, "</p>");
       buffer_append_str(out, "</codeblock>");
@@ -859,10 +1367,10 @@ static void walk_node(GumboNode *node, buffer_t *out) {
     /* Generic block/inline tag */
     buffer_append_str(out, "<");
     buffer_append_str(out, out_name);
-    emit_attributes(el, out_name, out);
+    emit_attributes(schema, el, out_name, out);
     buffer_append_str(out, ">");
     emit_styles_open(out, es);
-    walk_children(node, out);
+    walk_children(schema, node, out);
     emit_styles_close(out, es);
     buffer_append_str(out, "</");
     buffer_append_str(out, out_name);
@@ -873,43 +1381,1656 @@ static void walk_node(GumboNode *node, buffer_t *out) {
 }
 
 /* ------------------------------------------------------------------ */
-/*  Find <body> element from parse output                              */
+/*  Inline run coalescing                                              */
 /* ------------------------------------------------------------------ */
 
-static GumboNode *find_body(GumboNode *root) {
-  if (!root || !is_element(root))
-    return root;
-  GumboVector *children = &root->v.element.children;
-  for (unsigned int i = 0; i < children->length; i++) {
-    GumboNode *child = children->data[i];
-    if (is_element(child) && child->v.element.tag == GUMBO_TAG_BODY)
-      return child;
+/*
+ * The walker wraps every styled <span> on its own, so Google Docs pastes come
+ * out as <b>a</b><b>b</b> or <b><i><b>x</b></i></b>, and every fragment
+ * becomes a separate attribute run / span on the platforms. This pass
+ * re-emits the walker's output tracking the active set of marks as a
+ * bitmask: marks open lazily right before content and close only when the
+ * set changes, a block boundary is reached or an inline element they would
+ * overlap ends.
+ *
+ * Tags are classified by the schema's rule for the emitted name. Marks are
+ * inline tags that keep no attributes (<b>, <i>, or a schema's <sup>),
+ * so any two of the same name are interchangeable; inline tags with
+ * attributes (<a>, <mention>) stay exactly where they are.
+ */
+
+#define MAX_MARKS 32
+
+typedef enum {
+  TOKEN_TEXT,
+  TOKEN_VOID,   /* <br>, <img />: content, like text */
+  TOKEN_MARK,   /* <b>, <i>, <u>, <s>, ... */
+  TOKEN_INLINE, /* <a>, <mention>: kept exactly where they are */
+  TOKEN_BLOCK,  /* everything else */
+} token_kind_t;
+
+typedef struct {
+  token_kind_t kind;
+  bool closing;
+  unsigned int mark;
+  const char *data;
+  size_t len;
+} token_t;
+
+/* Stack of open elements; `mark` is 0 for anything but a mark */
+typedef struct {
+  unsigned int *marks;
+  size_t len;
+  size_t cap;
+} mark_stack_t;
+
+static void mark_stack_push(mark_stack_t *s, unsigned int mark) {
+  if (s->len == s->cap) {
+    s->cap = s->cap ? s->cap * 2 : 16;
+    s->marks = (unsigned int *)realloc(s->marks, s->cap * sizeof(*s->marks));
+  }
+  s->marks[s->len++] = mark;
+}
+
+static bool name_is(const char *name, size_t len, const char *expected) {
+  return strlen(expected) == len && strncmp(name, expected, len) == 0;
+}
+
+/*
+ * The rule a tag is emitted under: its own, or the first rule renaming
+ * another tag to it (a schema may keep <strong> only as <b>).
+ */
+static const schema_tag_t *emitted_rule(const normalizer_schema_t *schema,
+                                        const char *name) {
+  const schema_tag_t *tag = schema_lookup(schema, name);
+  if (tag && tag->cls != TAG_CLASS_SKIP && !tag->canonical)
+    return tag;
+  for (size_t i = 0; i < schema->tag_count; i++) {
+    const schema_tag_t *alias = &schema->tags[i];
+    if (alias->cls != TAG_CLASS_SKIP && alias->canonical &&
+        strcmp(alias->canonical, name) == 0)
+      return alias;
+  }
+  return NULL;
+}
+
+typedef struct {
+  const normalizer_schema_t *schema;
+  buffer_t *out;
+  mark_stack_t open;    /* input elements currently open */
+  mark_stack_t emitted; /* marks currently open in the output */
+  size_t segment;       /* emitted[segment..] may still be closed */
+  unsigned int emitted_marks;
+  /* Per mark, the open input elements setting it */
+  unsigned int wanted[MAX_MARKS];
+  /* Names of the marks seen so far; bit i of a mark set is names[i] */
+  const char *mark_names[MAX_MARKS];
+  size_t mark_lens[MAX_MARKS];
+  size_t mark_count;
+} coalescer_t;
+
+/* The mark bit of a tag, assigned on first sight; 0 once all are taken */
+static unsigned int mark_bit(coalescer_t *c, const char *name, size_t len) {
+  for (size_t i = 0; i < c->mark_count; i++)
+    if (c->mark_lens[i] == len && memcmp(c->mark_names[i], name, len) == 0)
+      return 1u << i;
+  if (c->mark_count == MAX_MARKS)
+    return 0;
+  c->mark_names[c->mark_count] = name;
+  c->mark_lens[c->mark_count] = len;
+  return 1u << c->mark_count++;
+}
+
+static size_t mark_index(unsigned int mark) {
+  size_t index = 0;
+  while (!(mark & 1u)) {
+    mark >>= 1;
+    index++;
+  }
+  return index;
+}
+
+static token_kind_t classify_token(coalescer_t *c, const char *name,
+                                   size_t len, unsigned int *mark) {
+  char key[SCHEMA_MAX_NAME + 1];
+  if (len == 0 || len > SCHEMA_MAX_NAME)
+    return TOKEN_BLOCK;
+  memcpy(key, name, len);
+  key[len] = '\0';
+
+  const schema_tag_t *rule = emitted_rule(c->schema, key);
+  if (!rule) {
+    /* The walker emits <br> for line breaks whatever the schema says */
+    return name_is(name, len, "br") ? TOKEN_VOID : TOKEN_BLOCK;
+  }
+  switch (rule->cls) {
+  case TAG_CLASS_SELF_CLOSING:
+    return TOKEN_VOID;
+  case TAG_CLASS_INLINE: {
+    /* Attributes are kept by emitted name */
+    const schema_tag_t *emitted = schema_lookup(c->schema, key);
+    if ((!emitted || emitted->attr_count == 0) &&
+        (*mark = mark_bit(c, name, len)) != 0)
+      return TOKEN_MARK;
+    return TOKEN_INLINE;
+  }
+  default:
+    return TOKEN_BLOCK;
+  }
+}
+
+/* Reads the token at html[pos]; the walker's output is well formed */
+static token_t next_token(coalescer_t *c, const char *html, size_t len,
+                          size_t pos) {
+  token_t t = {TOKEN_TEXT, false, 0, html + pos, 0};
+  if (html[pos] != '<') {
+    const char *lt = memchr(html + pos, '<', len - pos);
+    t.len = (lt ? (size_t)(lt - html) : len) - pos;
+    return t;
+  }
+
+  size_t end = pos + 1;
+  char quote = 0;
+  while (end < len && (quote || html[end] != '>')) {
+    if (quote) {
+      if (html[end] == quote)
+        quote = 0;
+    } else if (html[end] == '"' || html[end] == '\'') {
+      quote = html[end];
+    }
+    end++;
+  }
+  t.len = (end < len ? end + 1 : len) - pos;
+
+  size_t name_start = pos + 1;
+  if (name_start < len && html[name_start] == '/') {
+    t.closing = true;
+    name_start++;
+  }
+  size_t name_end = name_start;
+  while (name_end < len && html[name_end] != '>' && html[name_end] != '/' &&
+         !isspace((unsigned char)html[name_end]))
+    name_end++;
+  t.kind = classify_token(c, html + name_start, name_end - name_start,
+                          &t.mark);
+  return t;
+}
+
+static unsigned int wanted_marks(const coalescer_t *c) {
+  unsigned int marks = 0;
+  for (size_t i = 0; i < c->mark_count; i++)
+    if (c->wanted[i] > 0)
+      marks |= 1u << i;
+  return marks;
+}
+
+static void append_mark(coalescer_t *c, const char *prefix,
+                        unsigned int mark) {
+  size_t index = mark_index(mark);
+  buffer_append_str(c->out, prefix);
+  buffer_append(c->out, c->mark_names[index], c->mark_lens[index]);
+  buffer_append_str(c->out, ">");
+}
+
+static void close_marks_from(coalescer_t *c, size_t index) {
+  while (c->emitted.len > index) {
+    unsigned int mark = c->emitted.marks[--c->emitted.len];
+    c->emitted_marks &= ~mark;
+    append_mark(c, "</", mark);
   }
-  return root;
+}
+
+/* Closes the emitted marks the input no longer wants */
+static void drop_unwanted_marks(coalescer_t *c, unsigned int wanted) {
+  for (size_t i = c->segment; i < c->emitted.len; i++) {
+    if (!(c->emitted.marks[i] & wanted)) {
+      close_marks_from(c, i);
+      return;
+    }
+  }
+}
+
+/* Brings the emitted marks in line with the input before content */
+static void sync_marks(coalescer_t *c) {
+  unsigned int wanted = wanted_marks(c);
+  drop_unwanted_marks(c, wanted);
+  unsigned int missing = wanted & ~c->emitted_marks;
+  /* Open in input order so untouched nesting comes out as it went in */
+  for (size_t i = 0; missing && i < c->open.len; i++) {
+    unsigned int mark = c->open.marks[i];
+    if (mark & missing) {
+      missing &= ~mark;
+      c->emitted_marks |= mark;
+      mark_stack_push(&c->emitted, mark);
+      append_mark(c, "<", mark);
+    }
+  }
+}
+
+static void coalesce_inline_runs(const normalizer_schema_t *schema,
+                                 const char *html, size_t len,
+                                 buffer_t *out) {
+  coalescer_t c;
+  memset(&c, 0, sizeof(c));
+  c.schema = schema;
+  c.out = out;
+  /* Where each open inline element started its mark segment */
+  mark_stack_t segments = {NULL, 0, 0};
+
+  size_t pos = 0;
+  while (pos < len) {
+    token_t t = next_token(&c, html, len, pos);
+    pos += t.len;
+
+    switch (t.kind) {
+    case TOKEN_TEXT:
+    case TOKEN_VOID:
+      sync_marks(&c);
+      buffer_append(out, t.data, t.len);
+      break;
+
+    case TOKEN_MARK:
+      if (t.closing) {
+        if (c.open.len > 0)
+          c.open.len--;
+        if (c.wanted[mark_index(t.mark)] > 0)
+          c.wanted[mark_index(t.mark)]--;
+      } else {
+        mark_stack_push(&c.open, t.mark);
+        c.wanted[mark_index(t.mark)]++;
+      }
+      break;
+
+    case TOKEN_INLINE:
+      if (t.closing) {
+        close_marks_from(&c, c.segment);
+        if (segments.len > 0)
+          c.segment = segments.marks[--segments.len];
+        if (c.open.len > 0)
+          c.open.len--;
+      } else {
+        drop_unwanted_marks(&c, wanted_marks(&c));
+        mark_stack_push(&segments, (unsigned int)c.segment);
+        c.segment = c.emitted.len;
+        mark_stack_push(&c.open, 0);
+      }
+      buffer_append(out, t.data, t.len);
+      break;
+
+    case TOKEN_BLOCK:
+      close_marks_from(&c, c.segment);
+      if (t.closing) {
+        if (c.open.len > 0)
+          c.open.len--;
+      } else {
+        mark_stack_push(&c.open, 0);
+      }
+      buffer_append(out, t.data, t.len);
+      break;
+    }
+  }
+  close_marks_from(&c, 0);
+
+  free(c.open.marks);
+  free(c.emitted.marks);
+  free(segments.marks);
 }
 
 /* ------------------------------------------------------------------ */
-/*  Public API                                                         */
+/*  Streaming fast path                                                */
 /* ------------------------------------------------------------------ */
 
-char *normalize_html(const char *html, size_t len) {
-  if (!html || len == 0)
-    return NULL;
+/*
+ * Most pastes are shallow and well formed: paragraphs, spans, links and
+ * simple lists, every element closed where it was opened. For those, HTML5
+ * tree construction comes down to pushing and popping a stack of open
+ * elements, so this scanner tokenizes the input itself and produces the
+ * walker's output as it goes, without a Gumbo parse or tree.
+ *
+ * It gives up, and the caller falls back to the tree path, as soon as tree
+ * construction would do more than that: misnested formatting elements (the
+ * adoption agency), tables (foster parenting), raw text elements, tags it
+ * doesn't know, character references outside a small table and input the
+ * tokenizer would have to repair (NUL, control characters, bad UTF-8).
+ *
+ * The walker's context-dependent rules are mirrored per frame. Containers
+ * that auto-paragraph (root, <div>, the Google Docs wrapper, <codeblock>)
+ * collect their children's output along with where their <br>s and blocks
+ * are, and assemble it once they close and it's known whether they had any
+ * block children. <li> and <blockquote> flatten their content into item and
+ * paragraph buffers the same way flatten_li_node and flatten_bq_node do.
+ */
 
-  GumboOutput *output =
-      gumbo_parse_with_options(&kGumboDefaultOptions, html, len);
-  if (!output)
-    return NULL;
+#define STREAM_MAX_DEPTH 64
+#define STREAM_MAX_ATTRS 32
+#define STREAM_MAX_NESTED_LISTS 16
 
-  GumboNode *body = find_body(output->root);
-  if (!body)
-    body = output->root;
+typedef enum {
+  FRAME_ROOT,
+  FRAME_DIV,
+  FRAME_WRAPPER, /* Google Docs <b id="docs-internal-guid-..."> */
+  FRAME_CODEBLOCK,
+  FRAME_LIST,
+  FRAME_ITEM,
+  FRAME_QUOTE,
+  FRAME_FLAT,   /* block inside a flattened <li> or <blockquote> */
+  FRAME_BLOCK,  /* <p>, <h1>..<h6> */
+  FRAME_INLINE, /* everything else that can be open */
+} frame_kind_t;
 
-  buffer_t buf = buffer_create(len * 2);
-  walk_children(body, &buf);
+typedef enum {
+  BREAK_BR,
+  BREAK_BLOCK,
+  BREAK_WRAPPER, /* Google Docs wrapper with block children */
+} break_kind_t;
+
+/* A container child that ends an auto-paragraph run: buf[start, end) */
+typedef struct {
+  break_kind_t kind;
+  size_t start;
+  size_t end;
+} run_break_t;
+
+typedef struct {
+  frame_kind_t kind;
+  char tag[16];
+  const char *out_name; /* tag emitted around the content, if any */
+  css_styles_t styles;
+  buffer_t *sink;  /* where the content goes */
+  buffer_t *out;   /* where the frame's own output goes */
+  size_t start;    /* parent container's buf.len when this opened */
+  int owner;       /* FRAME_FLAT: the ITEM or QUOTE frame it flattens into */
+  /* Containers */
+  buffer_t buf;
+  run_break_t *breaks;
+  size_t break_count;
+  size_t break_cap;
+  bool has_block;
+  /* Containers and lists: consecutive <blockquote> children merge */
+  bool quote_open;
+  size_t quote_start;
+  buffer_t quote_ib;
+  /* FRAME_ITEM */
+  buffer_t item_open;
+  buffer_t ib;
+  buffer_t deferred; /* nested lists, emitted after the item */
+  int nested_lists;
+} frame_t;
+
+typedef struct {
+  const normalizer_schema_t *schema;
+  const char *p;
+  const char *end;
+  frame_t frames[STREAM_MAX_DEPTH];
+  int depth;
+  bool leading;     /* nothing but document preamble at the root so far */
+  buffer_t pending; /* the root's leading text node, dropped if blank */
+  /* Current tag */
+  char name[16];
+  bool end_tag;
+  bool self_closing;
+  buffer_t attr_data;
+  size_t attr_name[STREAM_MAX_ATTRS];
+  size_t attr_value[STREAM_MAX_ATTRS];
+  int attr_count;
+} streamer_t;
+
+static const char *const kFormattingTags[] = {
+    "a", "b", "big", "code", "em", "font", "i", "s", "small", "strike",
+    "strong", "u", NULL};
+
+static const char *const kInlineTags[] = {
+    "a", "b", "big", "code", "del", "em", "font", "i", "ins", "mark",
+    "mention", "s", "small", "span", "strike", "strong", "sub", "sup", "u",
+    NULL};
+
+/* Block tags tree construction treats specially (closing an open <p>) */
+static const char *const kBlockTags[] = {
+    "blockquote", "div", "h1", "h2", "h3", "h4", "h5", "h6", "li", "ol", "p",
+    "ul", NULL};
+
+static bool name_in(const char *name, const char *const *names) {
+  for (; *names; names++)
+    if (strcmp(name, *names) == 0)
+      return true;
+  return false;
+}
+
+static bool is_heading_tag(const char *name) {
+  return name[0] == 'h' && name[1] >= '1' && name[1] <= '6' && name[2] == '\0';
+}
+
+static bool is_html_space(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\f' || c == '\r';
+}
+
+/* --- Character data --- */
+
+/* Bytes that stand for themselves in text and attribute values */
+static bool is_plain_byte(unsigned char c) {
+  return (c >= 0x20 && c < 0x7F && c != '&' && c != '<' && c != '>') ||
+         c == '\t' || c == '\n' || c == '\f';
+}
+
+/* Code points the tokenizer passes through without a parse error */
+static bool is_clean_code_point(unsigned int cp) {
+  if (cp < 0x20)
+    return cp == '\t' || cp == '\n' || cp == '\f';
+  if (cp >= 0x7F && cp <= 0x9F)
+    return false;
+  if ((cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF)
+    return false;
+  if ((cp >= 0xFDD0 && cp <= 0xFDEF) || (cp & 0xFFFE) == 0xFFFE)
+    return false;
+  return true;
+}
+
+static void append_code_point(buffer_t *out, unsigned int cp, bool escape) {
+  char bytes[4];
+  size_t n;
+  if (escape && (cp == '&' || cp == '<' || cp == '>')) {
+    buffer_append_str(out, cp == '&' ? "&amp;" : cp == '<' ? "&lt;" : "&gt;");
+    return;
+  }
+  if (cp < 0x80) {
+    bytes[0] = (char)cp;
+    n = 1;
+  } else if (cp < 0x800) {
+    bytes[0] = (char)(0xC0 | (cp >> 6));
+    bytes[1] = (char)(0x80 | (cp & 0x3F));
+    n = 2;
+  } else if (cp < 0x10000) {
+    bytes[0] = (char)(0xE0 | (cp >> 12));
+    bytes[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    bytes[2] = (char)(0x80 | (cp & 0x3F));
+    n = 3;
+  } else {
+    bytes[0] = (char)(0xF0 | (cp >> 18));
+    bytes[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    bytes[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    bytes[3] = (char)(0x80 | (cp & 0x3F));
+    n = 4;
+  }
+  buffer_append(out, bytes, n);
+}
 
-  gumbo_destroy_output(&kGumboDefaultOptions, output);
-  return buffer_finish(&buf);
+/* Length of the valid UTF-8 sequence at p, or 0 */
+static size_t utf8_sequence(const unsigned char *p, const unsigned char *end,
+                            unsigned int *cp) {
+  unsigned char c = p[0];
+  size_t n;
+  unsigned char lo = 0x80, hi = 0xBF;
+  if (c >= 0xC2 && c <= 0xDF) {
+    n = 2;
+    *cp = c & 0x1F;
+  } else if (c >= 0xE0 && c <= 0xEF) {
+    n = 3;
+    *cp = c & 0x0F;
+    if (c == 0xE0)
+      lo = 0xA0;
+    else if (c == 0xED)
+      hi = 0x9F;
+  } else if (c >= 0xF0 && c <= 0xF4) {
+    n = 4;
+    *cp = c & 0x07;
+    if (c == 0xF0)
+      lo = 0x90;
+    else if (c == 0xF4)
+      hi = 0x8F;
+  } else {
+    return 0;
+  }
+  if ((size_t)(end - p) < n || p[1] < lo || p[1] > hi)
+    return 0;
+  for (size_t i = 1; i < n; i++) {
+    if ((p[i] & 0xC0) != 0x80)
+      return 0;
+    *cp = (*cp << 6) | (p[i] & 0x3F);
+  }
+  return n;
+}
+
+/* Named references we decode; anything else goes to the tree path */
+static const struct {
+  const char *name;
+  unsigned int cp;
+} kNamedRefs[] = {
+    {"amp", '&'},      {"lt", '<'},       {"gt", '>'},
+    {"quot", '"'},     {"apos", '\''},    {"nbsp", 0xA0},
+    {"shy", 0xAD},     {"copy", 0xA9},    {"reg", 0xAE},
+    {"middot", 0xB7},  {"ndash", 0x2013}, {"mdash", 0x2014},
+    {"lsquo", 0x2018}, {"rsquo", 0x2019}, {"ldquo", 0x201C},
+    {"rdquo", 0x201D}, {"bull", 0x2022},  {"hellip", 0x2026},
+    {"euro", 0x20AC},  {"trade", 0x2122}, {NULL, 0},
+};
+
+/*
+ * Decodes the character reference at *pp ('&'). Only references closed by
+ * ';' are handled: without one, the tokenizer's legacy matching applies.
+ */
+static bool read_char_ref(streamer_t *s, const char **pp, buffer_t *out,
+                          bool escape) {
+  const char *p = *pp + 1;
+  if (p >= s->end || !(isalnum((unsigned char)*p) || *p == '#')) {
+    /* Not a reference: a literal ampersand */
+    append_code_point(out, '&', escape);
+    *pp = p;
+    return true;
+  }
+
+  unsigned int cp = 0;
+  if (*p == '#') {
+    p++;
+    bool hex = p < s->end && (*p == 'x' || *p == 'X');
+    if (hex)
+      p++;
+    const char *digits = p;
+    while (p < s->end && p - digits < 8 &&
+           (hex ? isxdigit((unsigned char)*p) : isdigit((unsigned char)*p))) {
+      char c = (char)tolower((unsigned char)*p);
+      cp = cp * (hex ? 16 : 10) +
+           (unsigned int)(c <= '9' ? c - '0' : c - 'a' + 10);
+      p++;
+    }
+    if (p == digits || p >= s->end || *p != ';' || !is_clean_code_point(cp))
+      return false;
+  } else {
+    const char *name = p;
+    while (p < s->end && p - name < 8 && isalnum((unsigned char)*p))
+      p++;
+    if (p >= s->end || *p != ';')
+      return false;
+    size_t len = (size_t)(p - name);
+    int i = 0;
+    while (kNamedRefs[i].name && !(strlen(kNamedRefs[i].name) == len &&
+                                   strncmp(kNamedRefs[i].name, name, len) == 0))
+      i++;
+    if (!kNamedRefs[i].name)
+      return false;
+    cp = kNamedRefs[i].cp;
+  }
+  append_code_point(out, cp, escape);
+  *pp = p + 1;
+  return true;
+}
+
+/* Appends the (non-plain) character at *pp and steps past it */
+static bool read_special_char(streamer_t *s, const char **pp, buffer_t *out,
+                              bool escape) {
+  const char *p = *pp;
+  unsigned char c = (unsigned char)*p;
+  if (c == '&')
+    return read_char_ref(s, pp, out, escape);
+  if (c == '<' || c == '>') {
+    append_code_point(out, c, escape);
+    *pp = p + 1;
+    return true;
+  }
+  if (c == '\r') {
+    buffer_append(out, "\n", 1);
+    *pp = p + 1 < s->end && p[1] == '\n' ? p + 2 : p + 1;
+    return true;
+  }
+  if (c >= 0x80) {
+    unsigned int cp;
+    size_t n = utf8_sequence((const unsigned char *)p,
+                             (const unsigned char *)s->end, &cp);
+    if (n == 0 || !is_clean_code_point(cp))
+      return false;
+    buffer_append(out, p, n);
+    *pp = p + n;
+    return true;
+  }
+  return false;
+}
+
+/* Whether '<' at p opens markup rather than standing for itself */
+static bool starts_markup(streamer_t *s, const char *p) {
+  if (p + 1 >= s->end)
+    return false;
+  char c = p[1];
+  return isalpha((unsigned char)c) || c == '/' || c == '!' || c == '?';
+}
+
+/* --- Frames --- */
+
+static bool frame_is_container(const frame_t *f) {
+  return f->kind == FRAME_ROOT || f->kind == FRAME_DIV ||
+         f->kind == FRAME_WRAPPER || f->kind == FRAME_CODEBLOCK;
+}
+
+static bool frame_is_flat(const frame_t *f) {
+  return f->kind == FRAME_ITEM || f->kind == FRAME_QUOTE ||
+         f->kind == FRAME_FLAT;
+}
+
+static frame_t *top_frame(streamer_t *s) { return &s->frames[s->depth - 1]; }
+
+static void free_frame(frame_t *f) {
+  free(f->buf.data);
+  free(f->breaks);
+  free(f->quote_ib.data);
+  free(f->item_open.data);
+  free(f->ib.data);
+  free(f->deferred.data);
+}
+
+static void add_break(frame_t *f, break_kind_t kind, size_t start,
+                      size_t end) {
+  if (f->break_count == f->break_cap) {
+    f->break_cap = f->break_cap ? f->break_cap * 2 : 16;
+    f->breaks = (run_break_t *)realloc(f->breaks,
+                                       f->break_cap * sizeof(*f->breaks));
+  }
+  run_break_t b = {kind, start, end};
+  f->breaks[f->break_count++] = b;
+}
+
+/* flush_li_buffer for an open <li> */
+static void flush_item(frame_t *f) {
+  if (f->ib.len == 0)
+    return;
+  buffer_append(f->out, f->item_open.data, f->item_open.len);
+  emit_styles_open(f->out, f->styles);
+  buffer_append(f->out, f->ib.data, f->ib.len);
+  emit_styles_close(f->out, f->styles);
+  buffer_append_str(f->out, "</li>");
+  buffer_clear(&f->ib);
+}
+
+static void flush_flat(streamer_t *s, int owner) {
+  frame_t *f = &s->frames[owner];
+  if (f->kind == FRAME_ITEM)
+    flush_item(f);
+  else
+    flush_inline_p(f->sink, f->out);
+}
+
+/* Ends a run of merged <blockquote> children */
+static void close_quote(frame_t *f) {
+  if (!f->quote_open)
+    return;
+  flush_inline_p(&f->quote_ib, f->sink);
+  buffer_append_str(f->sink, "</blockquote>");
+  f->quote_open = false;
+  if (frame_is_container(f))
+    add_break(f, BREAK_BLOCK, f->quote_start, f->buf.len);
+}
+
+/* walk_children_from's auto-paragraphing, once block children were seen */
+static void assemble_blocks(const frame_t *f, buffer_t *out) {
+  buffer_t ib = buffer_create(64);
+  size_t pos = 0;
+  for (size_t i = 0; i < f->break_count; i++) {
+    const run_break_t *b = &f->breaks[i];
+    buffer_append(&ib, f->buf.data + pos, b->start - pos);
+    if (b->kind == BREAK_BR) {
+      if (ib.len > 0)
+        flush_inline_p(&ib, out);
+      else
+        buffer_append_str(out, "<br>");
+    } else {
+      flush_inline_p(&ib, out);
+      buffer_append(out, f->buf.data + b->start, b->end - b->start);
+    }
+    pos = b->end;
+  }
+  buffer_append(&ib, f->buf.data + pos, f->buf.len - pos);
+  flush_inline_p(&ib, out);
+  free(ib.data);
+}
+
+static void assemble_container(const frame_t *f, buffer_t *out) {
+  if (f->has_block)
+    assemble_blocks(f, out);
+  else
+    buffer_append(out, f->buf.data, f->buf.len);
+}
+
+static void emit_div_paragraph(buffer_t *out, buffer_t *pb, css_styles_t s) {
+  buffer_append_str(out, "<p>");
+  emit_styles_open(out, s);
+  buffer_append(out, pb->data, pb->len);
+  emit_styles_close(out, s);
+  buffer_append_str(out, "</p>");
+}
+
+/* A <div> without block children: one <p> per <br>-separated run */
+static void assemble_inline_div(const frame_t *f, buffer_t *out) {
+  buffer_t pb = buffer_create(64);
+  size_t pos = 0;
+  for (size_t i = 0; i < f->break_count; i++) {
+    const run_break_t *b = &f->breaks[i];
+    buffer_append(&pb, f->buf.data + pos, b->start - pos);
+    if (b->kind == BREAK_BR) {
+      if (pb.len > 0)
+        emit_div_paragraph(out, &pb, f->styles);
+      else
+        buffer_append_str(out, "<br>");
+      buffer_clear(&pb);
+    } else {
+      buffer_append(&pb, f->buf.data + b->start, b->end - b->start);
+    }
+    pos = b->end;
+  }
+  buffer_append(&pb, f->buf.data + pos, f->buf.len - pos);
+  if (pb.len > 0)
+    emit_div_paragraph(out, &pb, f->styles);
+  free(pb.data);
+}
+
+static frame_t *push_frame(streamer_t *s, frame_kind_t kind) {
+  frame_t *parent = top_frame(s);
+  frame_t *f = &s->frames[s->depth++];
+  memset(f, 0, sizeof(*f));
+  f->kind = kind;
+  memcpy(f->tag, s->name, sizeof(f->tag));
+  f->sink = parent->sink;
+  f->out = parent->sink;
+  f->start = frame_is_container(parent) ? parent->buf.len : 0;
+  if (frame_is_container(f)) {
+    f->buf = buffer_create(256);
+    f->sink = &f->buf;
+  }
+  return f;
+}
+
+static void pop_frame(streamer_t *s) {
+  frame_t *f = top_frame(s);
+  frame_t *parent = f - 1;
+
+  switch (f->kind) {
+  case FRAME_ROOT:
+    return;
+  case FRAME_DIV:
+    close_quote(f);
+    if (f->has_block) {
+      emit_styles_open(f->out, f->styles);
+      assemble_blocks(f, f->out);
+      emit_styles_close(f->out, f->styles);
+    } else {
+      assemble_inline_div(f, f->out);
+    }
+    break;
+  case FRAME_WRAPPER:
+    close_quote(f);
+    assemble_container(f, f->out);
+    break;
+  case FRAME_CODEBLOCK:
+    close_quote(f);
+    buffer_append_str(f->out, "<codeblock>");
+    if (!f->has_block)
+      buffer_append_str(f->out, "<p>");
+    assemble_container(f, f->out);
+    if (!f->has_block)
+      buffer_append_str(f->out, "</p>");
+    buffer_append_str(f->out, "</codeblock>");
+    break;
+  case FRAME_LIST:
+    close_quote(f);
+    /* fall through */
+  case FRAME_BLOCK:
+  case FRAME_INLINE:
+    emit_styles_close(f->out, f->styles);
+    if (f->out_name) {
+      buffer_append_str(f->out, "</");
+      buffer_append_str(f->out, f->out_name);
+      buffer_append_str(f->out, ">");
+    }
+    break;
+  case FRAME_ITEM:
+    flush_item(f);
+    buffer_append(f->out, f->deferred.data, f->deferred.len);
+    break;
+  case FRAME_QUOTE:
+    /* Stays open in the parent until a sibling other than a blockquote */
+    break;
+  case FRAME_FLAT:
+    flush_flat(s, f->owner);
+    break;
+  }
+
+  if (frame_is_container(parent)) {
+    if (f->kind == FRAME_WRAPPER) {
+      if (f->has_block)
+        add_break(parent, BREAK_WRAPPER, f->start, parent->buf.len);
+    } else if (f->kind != FRAME_INLINE && f->kind != FRAME_QUOTE) {
+      add_break(parent, BREAK_BLOCK, f->start, parent->buf.len);
+    }
+  }
+  free_frame(f);
+  s->depth--;
+}
+
+/* --- Tree construction --- */
+
+/* Fake element over the current tag's attributes, for emit_attributes */
+typedef struct {
+  GumboElement el;
+  GumboAttribute attrs[STREAM_MAX_ATTRS];
+  void *ptrs[STREAM_MAX_ATTRS];
+} stream_element_t;
+
+static void make_element(streamer_t *s, stream_element_t *e) {
+  memset(e, 0, sizeof(*e));
+  for (int i = 0; i < s->attr_count; i++) {
+    e->attrs[i].name = s->attr_data.data + s->attr_name[i];
+    e->attrs[i].value = s->attr_data.data + s->attr_value[i];
+    e->ptrs[i] = &e->attrs[i];
+  }
+  e->el.attributes.data = e->ptrs;
+  e->el.attributes.length = (unsigned int)s->attr_count;
+  e->el.attributes.capacity = (unsigned int)s->attr_count;
+}
+
+static css_styles_t element_styles(GumboElement *el) {
+  const char *sval = get_attr(el, "style");
+  return parse_css_style(sval, sval ? strlen(sval) : 0);
+}
+
+/* A text, comment or element child is about to start in the current node */
+static void begin_child(streamer_t *s, bool head_content) {
+  close_quote(top_frame(s));
+  if (!head_content)
+    s->leading = false;
+}
+
+/* Gumbo ends a text node at every element and comment */
+static void end_text_node(streamer_t *s) {
+  if (s->pending.len == 0)
+    return;
+  for (size_t i = 0; i < s->pending.len; i++) {
+    if (!is_html_space(s->pending.data[i])) {
+      buffer_append(top_frame(s)->sink, s->pending.data, s->pending.len);
+      s->leading = false;
+      break;
+    }
+  }
+  buffer_clear(&s->pending);
+}
+
+static int find_frame(streamer_t *s, const char *tag) {
+  for (int i = s->depth - 1; i > 0; i--)
+    if (strcmp(s->frames[i].tag, tag) == 0)
+      return i;
+  return -1;
+}
+
+static void pop_to(streamer_t *s, int index) {
+  while (s->depth > index)
+    pop_frame(s);
+}
+
+/* "Close a p element" for block start tags, when it's just a pop */
+static bool close_open_p(streamer_t *s) {
+  int p = find_frame(s, "p");
+  if (p < 0)
+    return true;
+  if (p != s->depth - 1)
+    return false;
+  pop_frame(s);
+  return true;
+}
+
+/* <li> closes an open <li> unless a list or another block is in between */
+static bool close_open_li(streamer_t *s) {
+  for (int i = s->depth - 1; i > 0; i--) {
+    const char *tag = s->frames[i].tag;
+    if (strcmp(tag, "li") == 0) {
+      /* Popping a formatting element would leave it to be reconstructed */
+      for (int j = i + 1; j < s->depth; j++)
+        if (name_in(s->frames[j].tag, kFormattingTags))
+          return false;
+      pop_to(s, i);
+      return true;
+    }
+    if (name_in(tag, kBlockTags) && strcmp(tag, "div") != 0 &&
+        strcmp(tag, "p") != 0)
+      return true;
+  }
+  return true;
+}
+
+static bool stream_void(streamer_t *s, stream_element_t *e) {
+  const char *name = s->name;
+  if (strcmp(name, "meta") == 0 || strcmp(name, "link") == 0 ||
+      strcmp(name, "base") == 0) {
+    begin_child(s, true);
+    return true;
+  }
+
+  begin_child(s, false);
+  frame_t *f = top_frame(s);
+  if (strcmp(name, "img") == 0) {
+    buffer_append_str(f->sink, "<img");
+    emit_attributes(s->schema, &e->el, "img", f->sink);
+    buffer_append_str(f->sink, " />");
+  } else if (frame_is_flat(f)) {
+    flush_flat(s, f->kind == FRAME_FLAT ? f->owner : s->depth - 1);
+  } else {
+    size_t start = f->sink->len;
+    buffer_append_str(f->sink, "<br>");
+    if (frame_is_container(f))
+      add_break(f, BREAK_BR, start, f->buf.len);
+  }
+  return true;
+}
+
+static bool stream_start_tag(streamer_t *s) {
+  const char *name = s->name;
+  /* Ignored in body, and not even the end of a text node */
+  if (strcmp(name, "html") == 0 || strcmp(name, "head") == 0 ||
+      strcmp(name, "body") == 0)
+    return true;
+
+  end_text_node(s);
+  stream_element_t e;
+  make_element(s, &e);
+
+  bool is_void = strcmp(name, "br") == 0 || strcmp(name, "img") == 0 ||
+                 strcmp(name, "meta") == 0 || strcmp(name, "link") == 0 ||
+                 strcmp(name, "base") == 0;
+  if (is_void)
+    return stream_void(s, &e);
+
+  bool is_block = name_in(name, kBlockTags) || strcmp(name, "codeblock") == 0;
+  if (s->self_closing || (!is_block && !name_in(name, kInlineTags)))
+    return false;
+  if (s->depth == STREAM_MAX_DEPTH)
+    return false;
+
+  /* Implied end tags, where they amount to popping the current node */
+  if (strcmp(name, "li") == 0 && !close_open_li(s))
+    return false;
+  if (name_in(name, kBlockTags) && !close_open_p(s))
+    return false;
+  if (is_heading_tag(name) && is_heading_tag(top_frame(s)->tag))
+    pop_frame(s);
+  if (strcmp(name, "a") == 0 && find_frame(s, "a") >= 0)
+    return false;
+
+  /* A blockquote continues a run of blockquote siblings */
+  if (strcmp(name, "blockquote") == 0)
+    s->leading = false;
+  else
+    begin_child(s, false);
+  frame_t *parent = top_frame(s);
+  int index = s->depth - 1;
+  int owner = parent->kind == FRAME_FLAT ? parent->owner : index;
+  bool is_list = strcmp(name, "ul") == 0 || strcmp(name, "ol") == 0;
+  frame_t *f;
+
+  if (is_block && frame_is_flat(parent)) {
+    frame_t *o = &s->frames[owner];
+    if (is_list && o->kind == FRAME_ITEM) {
+      /* Walked after the item, without its own tags */
+      if (++o->nested_lists > STREAM_MAX_NESTED_LISTS)
+        return false;
+      f = push_frame(s, FRAME_LIST);
+      f->sink = &o->deferred;
+      f->out = &o->deferred;
+    } else {
+      flush_flat(s, owner);
+      f = push_frame(s, FRAME_FLAT);
+      f->owner = owner;
+    }
+    return true;
+  }
+
+  if (is_block) {
+    bool in_list = parent->kind == FRAME_LIST;
+    if (!frame_is_container(parent) && !in_list)
+      return false;
+    if (frame_is_container(parent))
+      parent->has_block = true;
+
+    if (strcmp(name, "blockquote") == 0) {
+      if (!parent->quote_open) {
+        parent->quote_open = true;
+        parent->quote_start = parent->sink->len;
+        if (!parent->quote_ib.data)
+          parent->quote_ib = buffer_create(64);
+        buffer_append_str(parent->sink, "<blockquote>");
+      }
+      f = push_frame(s, FRAME_QUOTE);
+      f->sink = &parent->quote_ib;
+    } else if (is_list) {
+      f = push_frame(s, FRAME_LIST);
+      if (!in_list) {
+        f->out_name = strcmp(name, "ul") == 0 ? "ul" : "ol";
+        f->styles = element_styles(&e.el);
+        buffer_append_str(f->out, "<");
+        buffer_append_str(f->out, f->out_name);
+        emit_attributes(s->schema, &e.el, f->out_name, f->out);
+        buffer_append_str(f->out, ">");
+        emit_styles_open(f->out, f->styles);
+      }
+    } else if (strcmp(name, "li") == 0) {
+      f = push_frame(s, FRAME_ITEM);
+      f->styles = element_styles(&e.el);
+      f->item_open = buffer_create(64);
+      buffer_append_str(&f->item_open, "<li");
+      emit_attributes(s->schema, &e.el, "li", &f->item_open);
+      buffer_append_str(&f->item_open, ">");
+      f->ib = buffer_create(64);
+      f->deferred = buffer_create(64);
+      f->sink = &f->ib;
+    } else if (strcmp(name, "div") == 0) {
+      f = push_frame(s, FRAME_DIV);
+      f->styles = element_styles(&e.el);
+    } else if (strcmp(name, "codeblock") == 0) {
+      f = push_frame(s, FRAME_CODEBLOCK);
+    } else {
+      f = push_frame(s, FRAME_BLOCK);
+      f->out_name = f->tag;
+    }
+    if (f->kind != FRAME_BLOCK)
+      return true;
+  } else if (is_google_docs_wrapper(&e.el, name)) {
+    push_frame(s, FRAME_WRAPPER);
+    return true;
+  } else {
+    f = push_frame(s, FRAME_INLINE);
+    if (strcmp(name, "span") == 0) {
+      f->styles = element_styles(&e.el);
+      emit_styles_open(f->out, f->styles);
+      return true;
+    }
+    const schema_tag_t *rule = schema_lookup(s->schema, name);
+    if (!rule || rule->cls != TAG_CLASS_INLINE)
+      return true;
+    f->out_name = rule->canonical ? rule->canonical : f->tag;
+  }
+
+  /* Generic block/inline tag, as in walk_node */
+  f->styles = extra_styles(element_styles(&e.el), f->out_name);
+  buffer_append_str(f->out, "<");
+  buffer_append_str(f->out, f->out_name);
+  emit_attributes(s->schema, &e.el, f->out_name, f->out);
+  buffer_append_str(f->out, ">");
+  emit_styles_open(f->out, f->styles);
+  return true;
+}
+
+static bool is_unknown_tag(const char *name) {
+  return gumbo_tag_enum(name) == GUMBO_TAG_UNKNOWN;
+}
+
+static bool stream_end_tag(streamer_t *s) {
+  const char *name = s->name;
+  bool heading = is_heading_tag(name);
+  /* Gumbo matches end tags by GumboTag, so any unknown end tag closes the
+     nearest unknown element (<codeblock>, <mention>) */
+  bool unknown = is_unknown_tag(name);
+  int target = -1;
+  for (int i = s->depth - 1; i > 0 && target < 0; i--) {
+    const char *tag = s->frames[i].tag;
+    if (heading ? is_heading_tag(tag)
+        : unknown ? is_unknown_tag(tag)
+                  : strcmp(tag, name) == 0)
+      target = i;
+  }
+
+  if (target < 0) {
+    /* </p> would insert an empty paragraph, </br> a line break */
+    if (strcmp(name, "p") == 0 || strcmp(name, "br") == 0)
+      return false;
+    return true;
+  }
+  if (!unknown && strcmp(s->frames[target].tag, name) != 0)
+    return false;
+
+  /* Elements above the target that the end tag implicitly closes */
+  bool closes_items = strcmp(name, "ul") == 0 || strcmp(name, "ol") == 0 ||
+                      strcmp(name, "div") == 0 ||
+                      strcmp(name, "blockquote") == 0;
+  bool closes_paragraphs = closes_items || strcmp(name, "li") == 0;
+  for (int i = target + 1; i < s->depth; i++) {
+    const char *tag = s->frames[i].tag;
+    if (!(closes_paragraphs && strcmp(tag, "p") == 0) &&
+        !(closes_items && strcmp(tag, "li") == 0))
+      return false;
+  }
+
+  end_text_node(s);
+  pop_to(s, target);
+  return true;
+}
+
+/* --- Tokenizer --- */
+
+static bool read_attr_value(streamer_t *s, const char **pp) {
+  const char *p = *pp;
+  char quote = 0;
+  if (*p == '"' || *p == '\'')
+    quote = *p++;
+  for (;;) {
+    const char *run = p;
+    while (p < s->end && is_plain_byte((unsigned char)*p) && *p != quote &&
+           (quote || !is_html_space(*p)))
+      p++;
+    buffer_append(&s->attr_data, run, (size_t)(p - run));
+    if (p >= s->end)
+      return false;
+    if (quote ? *p == quote : is_html_space(*p) || *p == '>')
+      break;
+    if (!read_special_char(s, &p, &s->attr_data, false))
+      return false;
+  }
+  if (quote)
+    p++;
+  *pp = p;
+  return true;
+}
+
+/* Reads the tag at s->p, just past '<' */
+static bool read_tag(streamer_t *s) {
+  const char *p = s->p;
+  s->end_tag = *p == '/';
+  if (s->end_tag)
+    p++;
+  s->self_closing = false;
+  s->attr_count = 0;
+  buffer_clear(&s->attr_data);
+
+  size_t n = 0;
+  bool known = true;
+  for (; p < s->end && !is_html_space(*p) && *p != '/' && *p != '>'; p++) {
+    unsigned char c = (unsigned char)*p;
+    if (c < 0x20 || c >= 0x7F)
+      return false;
+    if (n < sizeof(s->name) - 1)
+      s->name[n++] = (char)tolower(c);
+    else
+      known = false;
+  }
+  s->name[n] = '\0';
+  /* gumbo_tag_from_original_text keeps a trailing CR in unknown tag names */
+  if (p < s->end && *p == '\r')
+    return false;
+  if (!known)
+    strcpy(s->name, "-"); /* no tag we know; never matches */
+
+  /* Gumbo leaves the name of a duplicate attribute without a value in its
+     buffer, to be prepended to the next attribute's name */
+  bool dangling_duplicate = false;
+  for (;;) {
+    while (p < s->end && is_html_space(*p))
+      p++;
+    if (p >= s->end)
+      return false;
+    if (*p == '>') {
+      p++;
+      break;
+    }
+    if (*p == '/') {
+      p++;
+      if (p < s->end && *p == '>') {
+        s->self_closing = true;
+        p++;
+        break;
+      }
+      continue;
+    }
+
+    /* Attribute name; a leading '=' is part of it */
+    if (dangling_duplicate)
+      return false;
+    size_t name_at = s->attr_data.len;
+    do {
+      unsigned char c = (unsigned char)*p;
+      if (c < 0x20 || c >= 0x7F)
+        return false;
+      char lower = (char)tolower(c);
+      buffer_append(&s->attr_data, &lower, 1);
+      p++;
+    } while (p < s->end && !is_html_space(*p) && *p != '/' && *p != '>' &&
+             *p != '=');
+    buffer_append(&s->attr_data, "", 1);
+
+    while (p < s->end && is_html_space(*p))
+      p++;
+    size_t value_at = s->attr_data.len;
+    bool has_value = p < s->end && *p == '=';
+    if (has_value) {
+      p++;
+      while (p < s->end && is_html_space(*p))
+        p++;
+      if (p >= s->end)
+        return false;
+      if (*p != '>' && !read_attr_value(s, &p))
+        return false;
+    }
+    buffer_append(&s->attr_data, "", 1);
+
+    /* The first of duplicate attributes wins */
+    bool duplicate = false;
+    for (int i = 0; i < s->attr_count && !duplicate; i++)
+      duplicate = strcmp(s->attr_data.data + s->attr_name[i],
+                         s->attr_data.data + name_at) == 0;
+    dangling_duplicate = duplicate && !has_value;
+    if (!duplicate) {
+      if (s->attr_count == STREAM_MAX_ATTRS)
+        return false;
+      s->attr_name[s->attr_count] = name_at;
+      s->attr_value[s->attr_count] = value_at;
+      s->attr_count++;
+    }
+  }
+  s->p = p;
+  return true;
+}
+
+static bool starts_with_doctype(const char *p) {
+  static const char kDoctype[] = "doctype";
+  for (int i = 0; kDoctype[i]; i++)
+    if (tolower((unsigned char)p[i]) != kDoctype[i])
+      return false;
+  return true;
+}
+
+/* <!-- ... -->, or a doctype, which is ignored in body */
+static bool read_markup_declaration(streamer_t *s) {
+  const char *p = s->p + 1; /* past "<!" */
+  size_t left = (size_t)(s->end - p);
+  if (left >= 2 && p[0] == '-' && p[1] == '-') {
+    p += 2;
+    const char *close = NULL;
+    if (p < s->end && *p == '>')
+      close = p + 1;
+    else if (s->end - p >= 2 && p[0] == '-' && p[1] == '>')
+      close = p + 2;
+    for (const char *q = p; !close && q + 2 < s->end; q++) {
+      if (q[0] == '-' && q[1] == '-') {
+        if (q[2] == '>')
+          close = q + 3;
+        else if (q[2] == '!' && q + 3 < s->end && q[3] == '>')
+          close = q + 4;
+      }
+    }
+    if (!close)
+      return false;
+    end_text_node(s);
+    begin_child(s, true);
+    s->p = close;
+    return true;
+  }
+  if (left >= 7 && starts_with_doctype(p)) {
+    const char *gt = memchr(p, '>', left);
+    if (!gt)
+      return false;
+    s->p = gt + 1;
+    return true;
+  }
+  return false;
+}
+
+static bool read_text(streamer_t *s) {
+  begin_child(s, s->leading && s->depth == 1);
+  buffer_t *out = s->leading && s->depth == 1 ? &s->pending
+                                              : top_frame(s)->sink;
+  const char *p = s->p;
+  while (p < s->end) {
+    const char *run = p;
+    while (p < s->end && is_plain_byte((unsigned char)*p))
+      p++;
+    buffer_append(out, run, (size_t)(p - run));
+    if (p >= s->end || (*p == '<' && starts_markup(s, p)))
+      break;
+    if (!read_special_char(s, &p, out, true))
+      return false;
+  }
+  s->p = p;
+  return true;
+}
+
+static bool stream_run(streamer_t *s) {
+  while (s->p < s->end) {
+    if (*s->p != '<' || !starts_markup(s, s->p)) {
+      if (!read_text(s))
+        return false;
+      continue;
+    }
+    char next = s->p[1];
+    s->p++;
+    if (next == '!') {
+      if (!read_markup_declaration(s))
+        return false;
+    } else if (next == '?' ||
+               (next == '/' && (s->p + 1 >= s->end ||
+                                !isalpha((unsigned char)s->p[1])))) {
+      return false;
+    } else {
+      if (!read_tag(s))
+        return false;
+      if (!(s->end_tag ? stream_end_tag(s) : stream_start_tag(s)))
+        return false;
+    }
+  }
+  end_text_node(s);
+  pop_to(s, 1);
+  close_quote(&s->frames[0]);
+  return true;
+}
+
+/*
+ * Normalizes html without building a tree, appending to out. Returns false,
+ * leaving out untouched, when the input needs full tree construction.
+ */
+static bool stream_normalize(const normalizer_schema_t *schema,
+                             const char *html, size_t len, buffer_t *out) {
+  streamer_t *s = (streamer_t *)malloc(sizeof(streamer_t));
+  if (!s)
+    return false;
+  s->schema = schema;
+  s->p = html;
+  s->end = html + len;
+  s->depth = 1;
+  s->leading = true;
+  s->pending = buffer_create(64);
+  s->attr_data = buffer_create(256);
+
+  frame_t *root = &s->frames[0];
+  memset(root, 0, sizeof(*root));
+  root->kind = FRAME_ROOT;
+  root->buf = buffer_create(len + len / 4);
+  root->sink = &root->buf;
+
+  bool ok = stream_run(s);
+  if (ok)
+    assemble_container(root, out);
+
+  for (int i = 0; i < s->depth; i++)
+    free_frame(&s->frames[i]);
+  free(s->pending.data);
+  free(s->attr_data.data);
+  free(s);
+  return ok;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Parallel top-level walk                                            */
+/* ------------------------------------------------------------------ */
+
+/*
+ * Multi-MB documents spend most of the tree path walking the root's
+ * children, which are independent apart from two things: a run of inline
+ * children is grouped into one <p>, and consecutive blockquotes merge. The
+ * walk is split into contiguous chunks at boundaries neither can cross, so
+ * each chunk walks on its own thread into its own buffer and the buffers
+ * concatenate to exactly the serial output.
+ */
+
+#define PARALLEL_WALK_MIN_BYTES (1024 * 1024)
+#define PARALLEL_WALK_MAX_CHUNKS 8
+#define PARALLEL_WALK_STACK_SIZE (8 * 1024 * 1024)
+
+typedef struct {
+  const normalizer_schema_t *schema;
+  GumboNode *root;
+  unsigned int first;
+  unsigned int end;
+  bool has_block;
+  buffer_t out;
+} walk_chunk_t;
+
+static void *walk_chunk(void *arg) {
+  walk_chunk_t *chunk = (walk_chunk_t *)arg;
+  walk_child_range(chunk->schema, chunk->root, chunk->first, chunk->end,
+                   chunk->has_block, &chunk->out);
+  return NULL;
+}
+
+static size_t node_offset(GumboNode *node) {
+  if (is_element(node))
+    return node->v.element.start_pos.offset;
+  return node->v.text.start_pos.offset;
+}
+
+/* Whether a chunk may start at child i without changing the output */
+static bool is_chunk_boundary(const normalizer_schema_t *schema,
+                              GumboVector *children, unsigned int i,
+                              bool has_block) {
+  if (!has_block)
+    return true;
+  GumboNode *child = children->data[i];
+  if (!is_block_producing(schema, child))
+    return false;
+  return !is_blockquote_node(child) ||
+         !is_blockquote_node(children->data[i - 1]);
+}
+
+/* Number of chunks worth using for an input of len bytes */
+static unsigned int walk_chunk_count(size_t len) {
+  if (len < PARALLEL_WALK_MIN_BYTES)
+    return 1;
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  if (cpus < 1)
+    return 1;
+  return cpus < PARALLEL_WALK_MAX_CHUNKS ? (unsigned int)cpus
+                                         : PARALLEL_WALK_MAX_CHUNKS;
+}
+
+/*
+ * walk_children_from(schema, root, first, out), split into up to max_chunks
+ * chunks of about equal source length that are walked in parallel.
+ */
+static void walk_children_parallel(const normalizer_schema_t *schema,
+                                   GumboNode *root, unsigned int first,
+                                   unsigned int max_chunks, buffer_t *out) {
+  GumboVector *children = &root->v.element.children;
+  unsigned int count = children->length;
+  if (max_chunks > PARALLEL_WALK_MAX_CHUNKS)
+    max_chunks = PARALLEL_WALK_MAX_CHUNKS;
+  if (max_chunks < 2 || count - first < 2) {
+    walk_children_from(schema, root, first, out);
+    return;
+  }
+
+  bool has_block = has_block_child_from(schema, root, first);
+  /* Offsets only steer the split; reconstructed elements can reuse older
+     positions, so they needn't be monotonic */
+  size_t start = node_offset(children->data[first]);
+  size_t last = node_offset(children->data[count - 1]);
+  size_t span = last > start ? last - start : 0;
+
+  walk_chunk_t chunks[PARALLEL_WALK_MAX_CHUNKS];
+  unsigned int n = 0;
+  unsigned int i = first;
+  while (i < count) {
+    walk_chunk_t *chunk = &chunks[n++];
+    chunk->schema = schema;
+    chunk->root = root;
+    chunk->first = i;
+    chunk->has_block = has_block;
+    /* The next chunk starts at the first boundary past its share */
+    size_t target = start + span / max_chunks * n;
+    i++;
+    if (n < max_chunks)
+      while (i < count && (node_offset(children->data[i]) < target ||
+                           !is_chunk_boundary(schema, children, i, has_block)))
+        i++;
+    else
+      i = count;
+    chunk->end = i;
+    chunk->out = buffer_create(span / max_chunks * 2);
+  }
+
+  /* The walk recurses once per nesting level; don't leave deep documents to
+     the platform's (512 KB on iOS) default thread stack */
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setstacksize(&attr, PARALLEL_WALK_STACK_SIZE);
+
+  /* Chunk 0 runs here; any thread that fails to start runs here too */
+  pthread_t threads[PARALLEL_WALK_MAX_CHUNKS];
+  bool started[PARALLEL_WALK_MAX_CHUNKS] = {false};
+  for (unsigned int k = 1; k < n; k++)
+    started[k] =
+        pthread_create(&threads[k], &attr, walk_chunk, &chunks[k]) == 0;
+  pthread_attr_destroy(&attr);
+  walk_chunk(&chunks[0]);
+  for (unsigned int k = 1; k < n; k++) {
+    if (started[k])
+      pthread_join(threads[k], NULL);
+    else
+      walk_chunk(&chunks[k]);
+  }
+
+  for (unsigned int k = 0; k < n; k++) {
+    buffer_append(out, chunks[k].out.data, chunks[k].out.len);
+    free(chunks[k].out.data);
+  }
+}
+
+/* ------------------------------------------------------------------ */
+/*  Parse options                                                      */
+/* ------------------------------------------------------------------ */
+
+/*
+ * Input is parsed as the content of a <body>: Gumbo doesn't synthesize the
+ * html/head/body scaffolding we'd only walk past, and head-only elements
+ * that still show up (<style>, <meta>, ...) are dropped by walk_node.
+ * max_errors = 0 keeps Gumbo from allocating a GumboError per parse error;
+ * Word and Google Docs markup produces thousands and we never read them.
+ */
+static GumboOptions lean_options(void) {
+  GumboOptions options = kGumboDefaultOptions;
+  options.max_errors = 0;
+  options.fragment_context = GUMBO_TAG_BODY;
+  options.fragment_namespace = GUMBO_NAMESPACE_HTML;
+  return options;
+}
+
+/*
+ * Whether a node would have ended up in <head> (or before it) in a full
+ * document parse: whitespace, comments and head-only elements. A leading run
+ * of these is document preamble, not content.
+ */
+static bool is_head_content(GumboNode *node) {
+  if (node->type == GUMBO_NODE_WHITESPACE ||
+      node->type == GUMBO_NODE_COMMENT || node->type == GUMBO_NODE_TEMPLATE)
+    return true;
+  if (node->type != GUMBO_NODE_ELEMENT)
+    return false;
+  switch (node->v.element.tag) {
+  case GUMBO_TAG_BASE:
+  case GUMBO_TAG_LINK:
+  case GUMBO_TAG_META:
+  case GUMBO_TAG_SCRIPT:
+  case GUMBO_TAG_STYLE:
+  case GUMBO_TAG_TITLE:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/* ------------------------------------------------------------------ */
+/*  Public API                                                         */
+/* ------------------------------------------------------------------ */
+
+/* Runs the inline run coalescer over out and returns the result */
+static char *finish_output(const normalizer_schema_t *schema, buffer_t *out) {
+  buffer_t coalesced = buffer_create(out->len);
+  coalesce_inline_runs(schema, out->data, out->len, &coalesced);
+  free(out->data);
+  return buffer_finish(&coalesced);
+}
+
+static char *normalize_streaming(const normalizer_schema_t *schema,
+                                 const char *html, size_t len) {
+  if (!html || len == 0 || !schema->streamable)
+    return NULL;
+  buffer_t buf = buffer_create(len * 2);
+  if (!stream_normalize(schema, html, len, &buf)) {
+    free(buf.data);
+    return NULL;
+  }
+  return finish_output(schema, &buf);
+}
+
+/**
+ * Normalizes html with the streaming fast path only. Returns NULL when the
+ * input needs full tree construction.
+ */
+char *normalize_html_streaming(const char *html, size_t len) {
+  return normalize_streaming(normalizer_schema_default(), html, len);
+}
+
+static char *normalize_tree(const normalizer_schema_t *schema,
+                            const char *html, size_t len, unsigned int chunks,
+                            int (*is_cancelled)(void *), void *ctx) {
+  if (!html || len == 0)
+    return NULL;
+
+  GumboOptions options = lean_options();
+  GumboOutput *output = gumbo_parse_with_options(&options, html, len);
+  if (!output)
+    return NULL;
+
+  if (is_cancelled && is_cancelled(ctx)) {
+    gumbo_destroy_output(&options, output);
+    return NULL;
+  }
+
+  /* In fragment mode the root <html> holds the fragment's nodes directly */
+  GumboVector *nodes = &output->root->v.element.children;
+  unsigned int first = 0;
+  while (first < nodes->length && is_head_content(nodes->data[first]))
+    first++;
+
+  buffer_t buf = buffer_create(len * 2);
+  walk_children_parallel(schema, output->root, first, chunks, &buf);
+  gumbo_destroy_output(&options, output);
+  return finish_output(schema, &buf);
+}
+
+/** Normalizes html with Gumbo and the tree walker, never streaming. */
+char *normalize_html_tree(const char *html, size_t len) {
+  return normalize_tree(normalizer_schema_default(), html, len,
+                        walk_chunk_count(len), NULL, NULL);
+}
+
+/**
+ * normalize_html_tree with the top-level walk split into (at most) the given
+ * number of parallel chunks, regardless of input size; 1 walks serially.
+ */
+char *normalize_html_tree_chunked(const char *html, size_t len,
+                                  unsigned int chunks) {
+  return normalize_tree(normalizer_schema_default(), html, len, chunks, NULL,
+                        NULL);
+}
+
+/**
+ * Same as normalize_html_with_schema, but gives up (returning NULL) when
+ * is_cancelled reports true between parsing and walking the tree.
+ */
+char *normalize_html_cancellable(const char *html, size_t len,
+                                 const normalizer_schema_t *schema,
+                                 int (*is_cancelled)(void *), void *ctx) {
+  if (!schema)
+    schema = normalizer_schema_default();
+  else if (!schema->compiled)
+    return NULL;
+  char *result = normalize_streaming(schema, html, len);
+  if (result)
+    return result;
+  return normalize_tree(schema, html, len, walk_chunk_count(len),
+                        is_cancelled, ctx);
+}
+
+/**
+ * Normalizes html into the subset a compiled schema describes; NULL means
+ * the canonical subset. Returns NULL for an uncompiled schema.
+ */
+char *normalize_html_with_schema(const char *html, size_t len,
+                                 const normalizer_schema_t *schema) {
+  return normalize_html_cancellable(html, len, schema, NULL, NULL);
+}
+
+char *normalize_html(const char *html, size_t len) {
+  return normalize_html_with_schema(html, len, NULL);
 }
 
 void free_normalized_html(char *result) { free(result); }
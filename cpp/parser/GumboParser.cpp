@@ -1,16 +1,271 @@
 #include "GumboParser.hpp"
 
+#include "BlobStore.hpp"
+#include "GumboParser.h"
+
+#include <cstring>
+#include <string_view>
+
 // C functions defined in GumboNormalizer.c (compiled as C)
 extern "C" {
-char *normalize_html(const char *html, size_t len);
+char *normalize_html_with_schema(const char *html, size_t len,
+                                 const normalizer_schema *schema);
 void free_normalized_html(char *result);
 }
 
-std::string GumboParser::normalizeHtml(const std::string &html) {
-  char *raw = normalize_html(html.c_str(), html.size());
+std::string
+GumboParser::normalizeHtml(const std::string &html,
+                           const enriched::NormalizerSchema &schema) {
+  char *raw = normalize_html_with_schema(html.c_str(), html.size(),
+                                         schema.get());
   if (!raw)
     return {};
   std::string result(raw);
   free_normalized_html(raw);
   return result;
 }
+
+bool GumboParser::normalizeHtml(
+    const char *html, size_t length,
+    const std::function<void(const char *, size_t)> &consume,
+    const enriched::NormalizerSchema &schema) {
+  char *raw = normalize_html_with_schema(html, length, schema.get());
+  if (!raw)
+    return false;
+  consume(raw, std::strlen(raw));
+  free_normalized_html(raw);
+  return true;
+}
+
+bool GumboParser::normalizeHtmlForView(
+    const char *html, size_t length,
+    const std::function<void(const char *, size_t)> &consume,
+    const enriched::NormalizerSchema &schema) {
+  return normalizeHtml(
+      html, length,
+      [&](const char *data, size_t size) {
+        std::string extracted;
+        if (enriched::BlobStore::shared().extractDataUris({data, size},
+                                                          extracted))
+          consume(extracted.data(), extracted.size());
+        else
+          consume(data, size);
+      },
+      schema);
+}
+
+/* --- Inspection --- */
+
+namespace {
+
+bool isElement(const GumboNode *node) {
+  return node->type == GUMBO_NODE_ELEMENT || node->type == GUMBO_NODE_TEMPLATE;
+}
+
+std::string_view unknownTagName(const GumboElement &element) {
+  GumboStringPiece piece = element.original_tag;
+  gumbo_tag_from_original_text(&piece);
+  return {piece.data, piece.length};
+}
+
+/**
+ * Walks the parse of canonical HTML. Text outside of a block (canonical
+ * output allows bare inline runs) opens an implicit paragraph that lasts
+ * until the next block.
+ */
+class PlainTextWalker {
+public:
+  PlainTextWalker(std::string &text, HtmlStats &stats)
+      : text_(text), stats_(stats) {}
+
+  void walkChildren(const GumboNode *node, bool container) {
+    const GumboVector &children = node->v.element.children;
+    for (unsigned int i = 0; i < children.length; i++) {
+      const GumboNode *child = static_cast<GumboNode *>(children.data[i]);
+      // Formatting whitespace between blocks isn't content.
+      if (container && child->type == GUMBO_NODE_WHITESPACE)
+        continue;
+      walk(child);
+    }
+  }
+
+private:
+  void startParagraph() {
+    if (stats_.paragraphs++ > 0)
+      text_ += '\n';
+  }
+
+  void ensureParagraph() {
+    if (!open_) {
+      startParagraph();
+      open_ = true;
+    }
+  }
+
+  void walk(const GumboNode *node) {
+    if (node->type == GUMBO_NODE_TEXT || node->type == GUMBO_NODE_WHITESPACE ||
+        node->type == GUMBO_NODE_CDATA) {
+      ensureParagraph();
+      text_.append(node->v.text.text);
+      return;
+    }
+    if (!isElement(node))
+      return;
+
+    const GumboElement &element = node->v.element;
+    switch (element.tag) {
+    case GUMBO_TAG_P:
+    case GUMBO_TAG_H1:
+    case GUMBO_TAG_H2:
+    case GUMBO_TAG_H3:
+    case GUMBO_TAG_H4:
+    case GUMBO_TAG_H5:
+    case GUMBO_TAG_H6:
+    case GUMBO_TAG_LI:
+      startParagraph();
+      open_ = true;
+      walkChildren(node, false);
+      open_ = false;
+      return;
+    case GUMBO_TAG_HTML:
+    case GUMBO_TAG_BODY:
+    case GUMBO_TAG_UL:
+    case GUMBO_TAG_OL:
+    case GUMBO_TAG_BLOCKQUOTE:
+      open_ = false;
+      walkChildren(node, true);
+      open_ = false;
+      return;
+    case GUMBO_TAG_BR:
+      // Inside a paragraph a break starts the next one; between blocks it
+      // is an empty paragraph of its own.
+      startParagraph();
+      return;
+    case GUMBO_TAG_IMG:
+      ensureParagraph();
+      text_ += "\xEF\xBF\xBC"; // U+FFFC
+      stats_.images++;
+      return;
+    case GUMBO_TAG_A:
+      stats_.links++;
+      break;
+    case GUMBO_TAG_UNKNOWN: {
+      std::string_view name = unknownTagName(element);
+      if (name == "codeblock") {
+        open_ = false;
+        walkChildren(node, true);
+        open_ = false;
+        return;
+      }
+      if (name == "mention")
+        stats_.mentions++;
+      break;
+    }
+    default:
+      break;
+    }
+    walkChildren(node, false);
+  }
+
+  std::string &text_;
+  HtmlStats &stats_;
+  bool open_ = false;
+};
+
+size_t utf16Length(const std::string &utf8) {
+  size_t length = 0;
+  for (unsigned char c : utf8) {
+    if ((c & 0xC0) != 0x80)
+      length++;
+    if (c >= 0xF0)
+      length++; // surrogate pair
+  }
+  return length;
+}
+
+} // namespace
+
+namespace {
+
+uint64_t mix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+/**
+ * Eight bytes per multiply, so hashing adds little to the normalization it
+ * follows. Words are read in native order: both platforms are
+ * little-endian, and hashes never leave the process.
+ */
+uint64_t hashBytes(const char *data, size_t size) {
+  constexpr uint64_t kMultiplier = 0x9e3779b97f4a7c15ULL;
+  uint64_t h = size * kMultiplier;
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, data + i, 8);
+    h = (h ^ mix(word)) * kMultiplier;
+  }
+  uint64_t tail = 0;
+  std::memcpy(&tail, data + i, size - i);
+  h = mix(h ^ mix(tail));
+  // 0 means "no hash" to callers
+  return h != 0 ? h : 1;
+}
+
+} // namespace
+
+bool GumboParser::isCanonicalHtml(const std::string &html) {
+  bool canonical = html.empty();
+  normalizeHtml(html.data(), html.size(), [&](const char *data, size_t size) {
+    canonical = std::string_view(data, size) == html;
+  });
+  return canonical;
+}
+
+uint64_t GumboParser::canonicalHash(const char *html, size_t length) {
+  uint64_t hash = 0;
+  normalizeHtml(html, length, [&](const char *data, size_t size) {
+    hash = hashBytes(data, size);
+  });
+  return hash;
+}
+
+uint64_t GumboParser::hashNormalized(const char *data, size_t size) {
+  return hashBytes(data, size);
+}
+
+uint64_t GumboParser::canonicalHash(const std::string &html) {
+  return canonicalHash(html.data(), html.size());
+}
+
+std::string GumboParser::toPlainText(const std::string &html,
+                                     HtmlStats *stats) {
+  std::string text;
+  HtmlStats counts;
+  normalizeHtml(html.data(), html.size(), [&](const char *data, size_t size) {
+    // Canonical HTML is body content, parsed the same lean way as pastes
+    GumboOptions options = kGumboDefaultOptions;
+    options.max_errors = 0;
+    options.fragment_context = GUMBO_TAG_BODY;
+    GumboOutput *output = gumbo_parse_with_options(&options, data, size);
+    if (!output)
+      return;
+    PlainTextWalker(text, counts).walkChildren(output->root, true);
+    gumbo_destroy_output(&options, output);
+  });
+  counts.characters = utf16Length(text);
+  if (stats)
+    *stats = counts;
+  return text;
+}
+
+HtmlStats GumboParser::stats(const std::string &html) {
+  HtmlStats counts;
+  toPlainText(html, &counts);
+  return counts;
+}
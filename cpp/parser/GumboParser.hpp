@@ -6,8 +6,24 @@
 
 #pragma once
 
+#include "NormalizerSchema.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <string>
 
+/**
+ * Counts over the canonical form of a document, as the views would load it.
+ */
+struct HtmlStats {
+  size_t characters = 0; // UTF-16 code units of the plain text
+  size_t paragraphs = 0;
+  size_t links = 0;
+  size_t mentions = 0;
+  size_t images = 0;
+};
+
 /**
  * C++ wrapper around the Gumbo-based HTML normalizer.
  */
@@ -16,8 +32,72 @@ public:
   /**
    * Normalize an HTML string into the canonical subset.
    *
-   * @param html  UTF-8 encoded HTML fragment or full document.
-   * @return      Canonical HTML string, or empty string on failure.
+   * @param html    UTF-8 encoded HTML fragment or full document.
+   * @param schema  Subset to produce instead; must be compiled.
+   * @return        Canonical HTML string, or empty string on failure.
    */
-  static std::string normalizeHtml(const std::string &html);
+  static std::string normalizeHtml(const std::string &html,
+                                   const enriched::NormalizerSchema &schema =
+                                       enriched::NormalizerSchema::canonical());
+
+  /**
+   * Same, without copying the result: `consume` sees the canonical UTF-8
+   * only for the duration of the call, so platform bridges can transcode it
+   * straight into their own buffers.
+   *
+   * @return false on failure, in which case `consume` isn't called.
+   */
+  static bool
+  normalizeHtml(const char *html, size_t length,
+                const std::function<void(const char *, size_t)> &consume,
+                const enriched::NormalizerSchema &schema =
+                    enriched::NormalizerSchema::canonical());
+
+  /**
+   * normalizeHtml for HTML a view is about to load (setValue, paste, the
+   * text view's content): base64 images of 1 KB or more also move into
+   * enriched::BlobStore::shared(), and the output carries their
+   * `enriched-blob:` handles. Handles only resolve inside this process, so
+   * HTML that goes back to JS or is only inspected doesn't come through
+   * here.
+   */
+  static bool
+  normalizeHtmlForView(const char *html, size_t length,
+                       const std::function<void(const char *, size_t)> &consume,
+                       const enriched::NormalizerSchema &schema =
+                           enriched::NormalizerSchema::canonical());
+
+  /**
+   * Whether the HTML is already in the canonical subset, i.e. normalizing
+   * it is a no-op.
+   */
+  static bool isCanonicalHtml(const std::string &html);
+
+  /**
+   * 64-bit hash of the canonical form, computed over the normalizer's output
+   * as it's produced. Inputs that normalize to the same HTML hash the same,
+   * so a view can skip re-parsing a value equivalent to what it shows (say
+   * `onChangeHtml` output coming back as `value`). 0 if normalization fails.
+   * Not stable across releases; don't persist it.
+   */
+  static uint64_t canonicalHash(const char *html, size_t length);
+  static uint64_t canonicalHash(const std::string &html);
+
+  /**
+   * The hash canonicalHash takes of the normalizer's output, for bytes a
+   * caller already normalized (say with normalizeHtmlForView, right before
+   * parsing them), so equivalence checks don't normalize a second time.
+   * Never 0.
+   */
+  static uint64_t hashNormalized(const char *data, size_t size);
+
+  /**
+   * Plain text of the normalized HTML, matching what the views show:
+   * paragraphs and line breaks become '\n' and images U+FFFC. `stats`, when
+   * given, receives the counts from the same pass.
+   */
+  static std::string toPlainText(const std::string &html,
+                                 HtmlStats *stats = nullptr);
+
+  static HtmlStats stats(const std::string &html);
 };
@@ -0,0 +1,100 @@
+#include "NormalizationWorker.hpp"
+
+#include "BlobStore.hpp"
+
+#include <cstring>
+
+// C functions defined in GumboNormalizer.c (compiled as C)
+extern "C" {
+char *normalize_html_cancellable(const char *html, size_t len,
+                                 const normalizer_schema *schema,
+                                 int (*is_cancelled)(void *), void *ctx);
+void free_normalized_html(char *result);
+}
+
+namespace enriched {
+
+namespace {
+
+int isCancelled(void *token) {
+  return static_cast<CancellationToken *>(token)->isCancelled();
+}
+
+} // namespace
+
+NormalizationWorker::NormalizationWorker() : thread_([this] { run(); }) {}
+
+NormalizationWorker::~NormalizationWorker() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    for (Job &job : jobs_)
+      job.token->cancel();
+  }
+  wake_.notify_one();
+  thread_.join();
+}
+
+NormalizationWorker &NormalizationWorker::shared() {
+  // Leaked on purpose: a static destructor would join the thread during
+  // process exit, possibly mid-job.
+  static NormalizationWorker *worker = new NormalizationWorker();
+  return *worker;
+}
+
+std::shared_ptr<CancellationToken>
+NormalizationWorker::submit(std::string html, Completion completion,
+                            std::shared_ptr<const NormalizerSchema> schema) {
+  auto token = std::make_shared<CancellationToken>();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(
+        {std::move(html), token, std::move(completion), std::move(schema)});
+  }
+  wake_.notify_one();
+  return token;
+}
+
+void NormalizationWorker::waitUntilIdle() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_.wait(lock, [this] { return jobs_.empty() && !busy_; });
+}
+
+void NormalizationWorker::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    wake_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+    if (jobs_.empty())
+      return; // stopping
+
+    Job job = std::move(jobs_.front());
+    jobs_.pop_front();
+    busy_ = true;
+    lock.unlock();
+
+    if (!job.token->isCancelled()) {
+      char *raw = normalize_html_cancellable(
+          job.html.data(), job.html.size(),
+          job.schema ? job.schema->get() : nullptr, isCancelled,
+          job.token.get());
+      if (!job.token->isCancelled()) {
+        std::string extracted;
+        if (raw && BlobStore::shared().extractDataUris(raw, extracted))
+          job.completion(extracted.data(), extracted.size());
+        else
+          job.completion(raw, raw ? std::strlen(raw) : 0);
+      }
+      if (raw)
+        free_normalized_html(raw);
+    }
+    // Release the captures here, off the lock.
+    job = Job();
+
+    lock.lock();
+    busy_ = false;
+    if (jobs_.empty())
+      idle_.notify_all();
+  }
+}
+
+} // namespace enriched
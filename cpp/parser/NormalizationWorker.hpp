@@ -0,0 +1,86 @@
+/**
+ * Background HTML normalization for large pastes.
+ */
+
+#pragma once
+
+#include "NormalizerSchema.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace enriched {
+
+/** Flag shared by a background job and the view that may supersede it. */
+class CancellationToken {
+public:
+  void cancel() { cancelled_.store(true, std::memory_order_release); }
+  bool isCancelled() const {
+    return cancelled_.load(std::memory_order_acquire);
+  }
+
+private:
+  std::atomic<bool> cancelled_{false};
+};
+
+/**
+ * Runs GumboParser::normalizeHtmlForView on a dedicated thread, one job at a
+ * time in submission order, so external HTML never blocks input handling.
+ *
+ * A cancelled job is skipped if it hasn't started and abandoned between
+ * parsing and tree walking if it has; either way its completion doesn't
+ * run. A completion that does run can still race a later cancel, so
+ * platforms re-check the token once they're back on the main thread.
+ */
+class NormalizationWorker {
+public:
+  /**
+   * Runs on the worker thread with the canonical UTF-8, valid only for the
+   * duration of the call; `html` is null when normalization failed.
+   */
+  using Completion = std::function<void(const char *html, size_t length)>;
+
+  NormalizationWorker();
+  ~NormalizationWorker();
+
+  NormalizationWorker(const NormalizationWorker &) = delete;
+  NormalizationWorker &operator=(const NormalizationWorker &) = delete;
+
+  /** Worker shared by every view; never destroyed. */
+  static NormalizationWorker &shared();
+
+  /** `schema`, when given, must be compiled; the job keeps it alive. */
+  std::shared_ptr<CancellationToken>
+  submit(std::string html, Completion completion,
+         std::shared_ptr<const NormalizerSchema> schema = nullptr);
+
+  /** Blocks until every job submitted so far has finished or been skipped. */
+  void waitUntilIdle();
+
+private:
+  struct Job {
+    std::string html;
+    std::shared_ptr<CancellationToken> token;
+    Completion completion;
+    std::shared_ptr<const NormalizerSchema> schema;
+  };
+
+  void run();
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable idle_;
+  std::deque<Job> jobs_;
+  bool busy_ = false;
+  bool stopping_ = false;
+  std::thread thread_;
+};
+
+} // namespace enriched
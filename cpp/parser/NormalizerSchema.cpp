@@ -0,0 +1,72 @@
+#include "NormalizerSchema.hpp"
+
+// C functions defined in GumboNormalizer.c (compiled as C)
+extern "C" {
+normalizer_schema *normalizer_schema_create(bool with_defaults);
+bool normalizer_schema_allow_tag(normalizer_schema *schema, const char *name,
+                                 int cls, const char *canonical);
+bool normalizer_schema_allow_attribute(normalizer_schema *schema,
+                                       const char *tag_name, const char *name,
+                                       const char *value);
+bool normalizer_schema_compile(normalizer_schema *schema);
+void normalizer_schema_free(normalizer_schema *schema);
+const normalizer_schema *normalizer_schema_default(void);
+}
+
+namespace enriched {
+
+NormalizerSchema::NormalizerSchema(bool canonical)
+    : schema_(normalizer_schema_create(canonical)) {}
+
+NormalizerSchema::NormalizerSchema(normalizer_schema *compiled)
+    : schema_(compiled), owned_(false), compiled_(true) {}
+
+NormalizerSchema::~NormalizerSchema() {
+  if (owned_)
+    normalizer_schema_free(schema_);
+}
+
+const NormalizerSchema &NormalizerSchema::canonical() {
+  // Leaked on purpose, like the C default it wraps.
+  static NormalizerSchema *schema = new NormalizerSchema(
+      const_cast<normalizer_schema *>(normalizer_schema_default()));
+  return *schema;
+}
+
+NormalizerSchema &NormalizerSchema::allowTag(const std::string &name,
+                                             TagKind kind,
+                                             const std::string &outputName) {
+  normalizer_schema_allow_tag(schema_, name.c_str(), static_cast<int>(kind),
+                              outputName.c_str());
+  return *this;
+}
+
+NormalizerSchema &NormalizerSchema::allowAttribute(const std::string &tag,
+                                                   const std::string &name) {
+  normalizer_schema_allow_attribute(schema_, tag.c_str(), name.c_str(),
+                                    nullptr);
+  return *this;
+}
+
+NormalizerSchema &
+NormalizerSchema::allowAttributeValue(const std::string &tag,
+                                      const std::string &name,
+                                      const std::string &value) {
+  normalizer_schema_allow_attribute(schema_, tag.c_str(), name.c_str(),
+                                    value.c_str());
+  return *this;
+}
+
+NormalizerSchema &
+NormalizerSchema::allowBooleanAttribute(const std::string &tag,
+                                        const std::string &name) {
+  normalizer_schema_allow_attribute(schema_, tag.c_str(), name.c_str(), "");
+  return *this;
+}
+
+bool NormalizerSchema::compile() {
+  compiled_ = normalizer_schema_compile(schema_);
+  return compiled_;
+}
+
+} // namespace enriched
@@ -0,0 +1,91 @@
+/**
+ * Tag and attribute allow-list for the HTML normalizer.
+ */
+
+#pragma once
+
+#include <string>
+
+// Defined in GumboNormalizer.c
+struct normalizer_schema;
+
+namespace enriched {
+
+/**
+ * The subset of HTML that normalization produces: which tags are kept and
+ * under what name, and which of their attributes survive. The canonical
+ * subset the views understand is the default; apps that keep more (say
+ * <sup>/<sub>, or data-* attributes on mentions) build their own once,
+ * compile it and pass it to GumboParser::normalizeHtml.
+ *
+ * Compiling turns the rules into a perfect-hash table, so a custom schema
+ * costs the walker no more per node than the canonical one. A compiled
+ * schema is immutable and can be shared across threads.
+ */
+class NormalizerSchema {
+public:
+  /** Values match tag_class_t in GumboNormalizer.c. */
+  enum class TagKind {
+    Strip = 0, // the tag goes, its content stays
+    Inline = 1,
+    Block = 2,
+    Void = 3, // no content, like <br> and <img>
+  };
+
+  /** Starts from the canonical subset, or with no tags at all. */
+  explicit NormalizerSchema(bool canonical = true);
+  ~NormalizerSchema();
+
+  NormalizerSchema(const NormalizerSchema &) = delete;
+  NormalizerSchema &operator=(const NormalizerSchema &) = delete;
+
+  /** The canonical subset, compiled; never destroyed. */
+  static const NormalizerSchema &canonical();
+
+  /**
+   * Keeps `name` as `kind`, emitted as `outputName` when that's given (the
+   * canonical subset maps <strong> to <b> this way). Replaces any earlier
+   * rule for the tag.
+   */
+  NormalizerSchema &allowTag(const std::string &name, TagKind kind,
+                             const std::string &outputName = "");
+
+  /**
+   * Keeps attribute `name`, when non-empty, on the emitted tag `tag`. A name
+   * ending in '*' ("data-*") keeps every attribute with that prefix.
+   */
+  NormalizerSchema &allowAttribute(const std::string &tag,
+                                   const std::string &name);
+
+  /**
+   * Keeps attribute `name` on `tag` only when its value is `value`. An
+   * empty `value` makes it a boolean attribute.
+   */
+  NormalizerSchema &allowAttributeValue(const std::string &tag,
+                                        const std::string &name,
+                                        const std::string &value);
+
+  /** Keeps attribute `name` on `tag` as a bare boolean, like `checked`. */
+  NormalizerSchema &allowBooleanAttribute(const std::string &tag,
+                                          const std::string &name);
+
+  /**
+   * Builds the lookup table. Rules can't be added afterwards; returns false
+   * if any rule was invalid (an empty or malformed name), in which case
+   * normalizing with the schema fails.
+   */
+  bool compile();
+
+  bool isCompiled() const { return compiled_; }
+
+  const normalizer_schema *get() const { return schema_; }
+
+private:
+  explicit NormalizerSchema(normalizer_schema *compiled);
+
+  normalizer_schema *schema_;
+  bool owned_ = true;
+  bool compiled_ = false;
+};
+
+} // namespace enriched
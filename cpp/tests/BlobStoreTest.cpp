@@ -0,0 +1,122 @@
+#include "BlobStore.hpp"
+#include "GumboParser.hpp"
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace enriched;
+
+namespace {
+
+std::string pngBytes(size_t length, char seed) {
+  std::string bytes = "\x89PNG\r\n\x1a\n";
+  for (size_t i = 0; bytes.size() < length; i++)
+    bytes.push_back(static_cast<char>(seed + i * 31));
+  return bytes;
+}
+
+std::string dataUri(const std::string &bytes,
+                    const std::string &mimeType = "image/png") {
+  std::string uri = "data:" + mimeType + ";base64,";
+  encodeBase64(bytes.data(), bytes.size(), uri);
+  return uri;
+}
+
+} // namespace
+
+TEST(BlobStoreTest, Base64RoundTrip) {
+  for (size_t length = 0; length < 8; length++) {
+    std::string bytes = pngBytes(length, 'a').substr(0, length);
+    std::string encoded;
+    encodeBase64(bytes.data(), bytes.size(), encoded);
+    std::string decoded;
+    ASSERT_TRUE(decodeBase64(encoded.data(), encoded.size(), decoded));
+    EXPECT_EQ(decoded, bytes);
+  }
+
+  std::string decoded;
+  EXPECT_TRUE(decodeBase64("aGVs\r\nbG8", 9, decoded));
+  EXPECT_EQ(decoded, "hello");
+  EXPECT_FALSE(decodeBase64("aGVs*G8=", 8, decoded));
+  EXPECT_FALSE(decodeBase64("aGVsb", 5, decoded));
+  EXPECT_FALSE(decodeBase64("aGU=bG8=", 8, decoded));
+}
+
+TEST(BlobStoreTest, StoresAndResolves) {
+  BlobStore store;
+  std::string bytes = pngBytes(4096, 1);
+  std::string handle = store.put(dataUri(bytes));
+
+  ASSERT_TRUE(BlobStore::isHandle(handle));
+  const Blob *blob = store.get(handle);
+  ASSERT_NE(blob, nullptr);
+  EXPECT_EQ(blob->mimeType, "image/png");
+  EXPECT_EQ(blob->bytes, bytes);
+  EXPECT_EQ(store.dataUri(handle), dataUri(bytes));
+  EXPECT_EQ(store.get("enriched-blob:0000000000000000"), nullptr);
+}
+
+TEST(BlobStoreTest, DeduplicatesPayloads) {
+  BlobStore store;
+  std::string bytes = pngBytes(4096, 2);
+  std::string first = store.put(dataUri(bytes));
+  EXPECT_EQ(store.put(dataUri(bytes)), first);
+  EXPECT_EQ(store.size(), bytes.size());
+  EXPECT_NE(store.put(dataUri(pngBytes(4096, 3))), first);
+}
+
+TEST(BlobStoreTest, LeavesOtherUrisInline) {
+  BlobStore store(8192);
+  EXPECT_EQ(store.put(dataUri(pngBytes(64, 4))), "");
+  EXPECT_EQ(store.put("https://example.com/a.png"), "");
+  EXPECT_EQ(store.put(dataUri(pngBytes(4096, 5), "text/html")), "");
+  EXPECT_EQ(store.put("data:image/svg+xml," + std::string(2048, 'x')), "");
+
+  EXPECT_NE(store.put(dataUri(pngBytes(6000, 6))), "");
+  EXPECT_EQ(store.put(dataUri(pngBytes(6000, 7))), "");
+}
+
+TEST(BlobStoreTest, ViewNormalizationEmitsHandles) {
+  std::string bytes = pngBytes(4096, 8);
+  std::string input =
+      "<img src=\"" + dataUri(bytes) + "\" width=\"10\" height=\"10\">";
+  std::string html;
+  ASSERT_TRUE(GumboParser::normalizeHtmlForView(
+      input.data(), input.size(),
+      [&](const char *data, size_t size) { html.assign(data, size); }));
+
+  std::string prefix = "<img src=\"";
+  ASSERT_EQ(html.compare(0, prefix.size(), prefix), 0);
+  std::string handle =
+      html.substr(prefix.size(), html.find('"', prefix.size()) - prefix.size());
+  ASSERT_TRUE(BlobStore::isHandle(handle));
+  EXPECT_EQ(BlobStore::shared().get(handle)->bytes, bytes);
+  EXPECT_EQ(html, "<img src=\"" + handle + "\" width=\"10\" height=\"10\" />");
+}
+
+TEST(BlobStoreTest, OtherNormalizationKeepsDataUris) {
+  std::string uri = dataUri(pngBytes(4096, 9));
+  std::string canonical = "<img src=\"" + uri + "\" />";
+  size_t storeSize = BlobStore::shared().size();
+
+  EXPECT_EQ(GumboParser::normalizeHtml(canonical), canonical);
+  EXPECT_TRUE(GumboParser::isCanonicalHtml(canonical));
+  EXPECT_NE(GumboParser::canonicalHash(canonical), 0u);
+  EXPECT_EQ(BlobStore::shared().size(), storeSize);
+}
+
+TEST(BlobStoreTest, ExtractDataUris) {
+  BlobStore store;
+  std::string uri = dataUri(pngBytes(2048, 10));
+  std::string out = "untouched";
+  EXPECT_FALSE(store.extractDataUris("<p>no images</p>", out));
+  EXPECT_FALSE(store.extractDataUris("<img src=\"data:,x\" />", out));
+  EXPECT_EQ(out, "untouched");
+
+  std::string html = "<p>a</p><img src=\"" + uri + "\" /><p>b</p><img src=\"" +
+                     uri + "\" width=\"4\" />";
+  ASSERT_TRUE(store.extractDataUris(html, out));
+  std::string handle = store.put(uri);
+  EXPECT_EQ(out, "<p>a</p><img src=\"" + handle + "\" /><p>b</p><img src=\"" +
+                 handle + "\" width=\"4\" />");
+}
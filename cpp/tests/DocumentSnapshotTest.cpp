@@ -0,0 +1,150 @@
+#include "BlobStore.hpp"
+#include "DocumentSnapshot.hpp"
+#include "TextEncoding.hpp"
+#include <gtest/gtest.h>
+
+using namespace enriched;
+
+namespace {
+DocumentSnapshot sampleSnapshot() {
+  DocumentSnapshot snapshot;
+  snapshot.text = u"Hello 👋 world\nSecond line";
+  uint32_t href = snapshot.internString("https://swmansion.com");
+  snapshot.runs.push_back(
+      {{0, 5}, StyleType::Bold, DocumentSnapshot::kNoString});
+  snapshot.runs.push_back({{9, 5}, StyleType::Link, href});
+  snapshot.runs.push_back(
+      {{15, 11}, StyleType::H1, DocumentSnapshot::kNoString});
+  return snapshot;
+}
+} // namespace
+
+TEST(DocumentSnapshotTest, RoundTrip) {
+  DocumentSnapshot snapshot = sampleSnapshot();
+  std::string bytes = snapshot.serialize();
+
+  DocumentSnapshot restored;
+  ASSERT_TRUE(DocumentSnapshot::deserialize(bytes, restored));
+  EXPECT_EQ(restored.text, snapshot.text);
+  ASSERT_EQ(restored.strings.size(), 1u);
+  EXPECT_EQ(restored.strings[0], "https://swmansion.com");
+  ASSERT_EQ(restored.runs.size(), 3u);
+  EXPECT_EQ(restored.runs[0].type, StyleType::Bold);
+  EXPECT_EQ(restored.runs[0].value, DocumentSnapshot::kNoString);
+  EXPECT_EQ(restored.runs[1].range, (TextRange{9, 5}));
+  EXPECT_EQ(restored.runs[1].value, 0u);
+  EXPECT_EQ(restored.runs[2].range, (TextRange{15, 11}));
+
+  // Interning keeps working after a restore.
+  EXPECT_EQ(restored.internString("https://swmansion.com"), 0u);
+  EXPECT_EQ(restored.internString("other"), 1u);
+}
+
+TEST(DocumentSnapshotTest, StringPoolDeduplicates) {
+  DocumentSnapshot snapshot;
+  EXPECT_EQ(snapshot.internString("a"), 0u);
+  EXPECT_EQ(snapshot.internString("b"), 1u);
+  EXPECT_EQ(snapshot.internString("a"), 0u);
+  EXPECT_EQ(snapshot.strings.size(), 2u);
+}
+
+TEST(DocumentSnapshotTest, RejectsMalformedInput) {
+  std::string bytes = sampleSnapshot().serialize();
+  DocumentSnapshot out;
+
+  EXPECT_FALSE(DocumentSnapshot::deserialize(nullptr, 0, out));
+  EXPECT_FALSE(DocumentSnapshot::deserialize("<p>x</p>", out));
+  for (size_t cut = 0; cut < bytes.size(); cut++) {
+    EXPECT_FALSE(DocumentSnapshot::deserialize(bytes.data(), cut, out));
+  }
+
+  std::string future = bytes;
+  future[4] = 2;
+  EXPECT_FALSE(DocumentSnapshot::deserialize(future, out));
+
+  std::string trailing = bytes + "x";
+  EXPECT_FALSE(DocumentSnapshot::deserialize(trailing, out));
+}
+
+TEST(DocumentSnapshotTest, RejectsRunsOutsideText) {
+  DocumentSnapshot snapshot;
+  snapshot.text = u"abc";
+  snapshot.runs.push_back(
+      {{1, 5}, StyleType::Bold, DocumentSnapshot::kNoString});
+  DocumentSnapshot out;
+  EXPECT_FALSE(DocumentSnapshot::deserialize(snapshot.serialize(), out));
+}
+
+TEST(DocumentSnapshotTest, RejectsOffsetsThatWrapAround) {
+  DocumentSnapshot snapshot;
+  snapshot.text = u"abc";
+  snapshot.runs.push_back(
+      {{1, SIZE_MAX}, StyleType::Bold, DocumentSnapshot::kNoString});
+  DocumentSnapshot out;
+  EXPECT_FALSE(DocumentSnapshot::deserialize(snapshot.serialize(), out));
+
+  snapshot.runs = {
+      {{SIZE_MAX, 1}, StyleType::Bold, DocumentSnapshot::kNoString}};
+  EXPECT_FALSE(DocumentSnapshot::deserialize(snapshot.serialize(), out));
+}
+
+// What both inputs do with images: a blob handle is stored as its data: URI
+// and put back into the store on restore, which may be another process.
+TEST(DocumentSnapshotTest, BlobImageRoundTrip) {
+  std::string bytes = "\x89PNG\r\n\x1a\n" + std::string(4096, '\x7f');
+  std::string dataUri = "data:image/png;base64,";
+  encodeBase64(bytes.data(), bytes.size(), dataUri);
+  BlobStore store;
+  std::string handle = store.put(dataUri);
+  ASSERT_TRUE(BlobStore::isHandle(handle));
+
+  DocumentSnapshot snapshot;
+  snapshot.text = u"\uFFFC";
+  snapshot.runs.push_back({{0, 1},
+                           StyleType::Image,
+                           snapshot.internString(store.dataUri(handle))});
+
+  DocumentSnapshot restored;
+  ASSERT_TRUE(DocumentSnapshot::deserialize(snapshot.serialize(), restored));
+  ASSERT_EQ(restored.runs.size(), 1u);
+  const std::string &source = restored.strings[restored.runs[0].value];
+  EXPECT_EQ(source, dataUri);
+
+  BlobStore other;
+  std::string restoredHandle = other.put(source);
+  EXPECT_EQ(restoredHandle, handle);
+  ASSERT_NE(other.get(restoredHandle), nullptr);
+  EXPECT_EQ(other.get(restoredHandle)->bytes, bytes);
+}
+
+TEST(DocumentSnapshotTest, TextEncoding) {
+  std::u16string text = u"zażółć 👋 ​";
+  EXPECT_EQ(utf8ToUtf16(utf16ToUtf8(text)), text);
+
+  // Lone surrogates survive a round trip.
+  std::u16string lone = u"a";
+  lone.push_back(0xD83D);
+  lone += u"b";
+  EXPECT_EQ(utf8ToUtf16(utf16ToUtf8(lone)), lone);
+
+  EXPECT_EQ(utf8ToUtf16(std::string("\xC3\x28")), u"�(");
+  EXPECT_EQ(utf16ToUtf8(u"👋"), "\xF0\x9F\x91\x8B");
+}
+
+TEST(DocumentSnapshotTest, TextEncodingAcrossAsciiBlocks) {
+  // Non-ASCII at every offset relative to the vector width, through reused
+  // buffers.
+  std::string utf8;
+  std::u16string utf16;
+  for (size_t run = 0; run < 40; run++) {
+    std::u16string text = std::u16string(run, u'a') + u"\u00E9\U0001F44B" +
+                          std::u16string(run, u'b');
+    std::string expected = std::string(run, 'a') +
+                           "\xC3\xA9\xF0\x9F\x91\x8B" +
+                           std::string(run, 'b');
+    utf16ToUtf8(text.data(), text.size(), utf8);
+    ASSERT_EQ(utf8, expected);
+    utf8ToUtf16(utf8.data(), utf8.size(), utf16);
+    ASSERT_EQ(utf16, text);
+  }
+}
@@ -44,6 +44,20 @@ TEST(GumboParserTest, TagOmissions) {
   EXPECT_EQ(GumboParser::normalizeHtml("<body><p>x</p></body>"), "<p>x</p>");
 }
 
+TEST(GumboParserTest, DocumentPreamble) {
+  // Pasted documents are parsed as body content; their head, comments and
+  // indentation must not leak into the result.
+  EXPECT_EQ(GumboParser::normalizeHtml(
+                "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n"
+                "<title>t</title>\n<style>p { margin: 0 }</style>\n</head>\n"
+                "<body><!--StartFragment--><p>x</p><!--EndFragment--></body>"
+                "</html>"),
+            "<p>x</p>");
+  EXPECT_EQ(GumboParser::normalizeHtml("  <p>x</p>"), "<p>x</p>");
+  EXPECT_EQ(GumboParser::normalizeHtml("<p>x</p><style>p {}</style>y"),
+            "<p>x</p><p>y</p>");
+}
+
 TEST(GumboParserTest, TableOmissions) {
   EXPECT_EQ(GumboParser::normalizeHtml("<table></table>"), "");
   EXPECT_EQ(GumboParser::normalizeHtml("<thead></thead>"), "");
@@ -455,3 +469,108 @@ TEST(GumboParserTest, BrRemappings) {
             "<p><b>Asdasdasd</b></p><br><br><p>Sent with <a "
             "href=\"https://google.com\">Net</a></p>");
 }
+
+TEST(GumboParserTest, InlineRunCoalescing) {
+  // Adjacent runs with the same styles merge
+  EXPECT_EQ(GumboParser::normalizeHtml(
+                "<p><span style=\"font-weight:700\">a</span><span "
+                "style=\"font-weight:700\">b</span><span "
+                "style=\"font-weight:700;font-style:italic\">c</span></p>"),
+            "<p><b>ab<i>c</i></b></p>");
+  EXPECT_EQ(GumboParser::normalizeHtml("<i>a</i><b><i>b</i></b>"),
+            "<i>a<b>b</b></i>");
+
+  // Redundant nesting and empty marks disappear
+  EXPECT_EQ(GumboParser::normalizeHtml("<b><i><strong>x</strong></i></b>"),
+            "<b><i>x</i></b>");
+  EXPECT_EQ(GumboParser::normalizeHtml("<p><b></b>x</p>"), "<p>x</p>");
+
+  // Marks never cross block boundaries or overlap links
+  EXPECT_EQ(GumboParser::normalizeHtml("<p><b>a</b></p><p><b>b</b></p>"),
+            "<p><b>a</b></p><p><b>b</b></p>");
+  EXPECT_EQ(GumboParser::normalizeHtml("<b>a<a href=\"u\">b</a>c</b>"),
+            "<b>a<a href=\"u\">b</a>c</b>");
+  EXPECT_EQ(GumboParser::normalizeHtml("<b>a</b><a href=\"u\"><b>b</b></a>"),
+            "<b>a</b><a href=\"u\"><b>b</b></a>");
+}
+
+TEST(GumboParserTest, BufferOverloadKeepsSupplementaryCharacters) {
+  // Real UTF-8, not the CESU-8 surrogate pairs of Java's modified UTF-8.
+  std::string html = "<strong>\xF0\x9F\x91\x8B hi</strong>";
+  std::string result;
+  EXPECT_TRUE(GumboParser::normalizeHtml(
+      html.data(), html.size(),
+      [&](const char *data, size_t length) { result.assign(data, length); }));
+  EXPECT_EQ(result, "<b>\xF0\x9F\x91\x8B hi</b>");
+
+  bool called = false;
+  EXPECT_FALSE(GumboParser::normalizeHtml(
+      "", 0, [&](const char *, size_t) { called = true; }));
+  EXPECT_FALSE(called);
+}
+
+TEST(GumboParserTest, CanonicalValidation) {
+  EXPECT_TRUE(GumboParser::isCanonicalHtml(""));
+  EXPECT_TRUE(GumboParser::isCanonicalHtml("<p><b>x</b></p>"));
+  EXPECT_TRUE(GumboParser::isCanonicalHtml("<ul><li>x</li><li>y</li></ul>"));
+  EXPECT_FALSE(GumboParser::isCanonicalHtml("<strong>x</strong>"));
+  EXPECT_FALSE(GumboParser::isCanonicalHtml("<div>x</div>"));
+  EXPECT_FALSE(GumboParser::isCanonicalHtml("<html><p>x</p></html>"));
+}
+
+TEST(GumboParserTest, CanonicalHash) {
+  uint64_t hash = GumboParser::canonicalHash("<p><b>x</b></p>");
+  EXPECT_NE(hash, 0u);
+  EXPECT_EQ(GumboParser::canonicalHash("<p><strong>x</strong></p>"), hash);
+  EXPECT_EQ(GumboParser::canonicalHash("<html><p><b>x</b></p></html>"), hash);
+  EXPECT_NE(GumboParser::canonicalHash("<p><b>y</b></p>"), hash);
+  EXPECT_NE(GumboParser::canonicalHash("<p><i>x</i></p>"), hash);
+  EXPECT_NE(GumboParser::canonicalHash("<p><b>x</b></p><p></p>"), hash);
+
+  std::string normalized =
+      GumboParser::normalizeHtml("<p><strong>x</strong></p>");
+  EXPECT_EQ(GumboParser::hashNormalized(normalized.data(), normalized.size()),
+            hash);
+
+  // Every length, so the word loop and the tail both see each byte
+  std::string text;
+  for (int i = 0; i < 40; i++) {
+    text += static_cast<char>('a' + i % 26);
+    std::string html = "<p>" + text + "</p>";
+    EXPECT_EQ(GumboParser::canonicalHash(html),
+              GumboParser::canonicalHash(html.data(), html.size()));
+    std::string changed = html;
+    changed[3 + i] = '!';
+    EXPECT_NE(GumboParser::canonicalHash(changed),
+              GumboParser::canonicalHash(html))
+        << i;
+  }
+}
+
+TEST(GumboParserTest, PlainTextAndStats) {
+  HtmlStats stats;
+  EXPECT_EQ(GumboParser::toPlainText(
+                "<h1>Title</h1><p>Hi <a href=\"https://x.com\">there</a> "
+                "&amp; <mention text=\"@jo\" indicator=\"@\">@jo</mention></p>"
+                "<br><ul><li>one</li><li>two<br>lines</li></ul>"
+                "<codeblock><p>code</p></codeblock>",
+                &stats),
+            "Title\nHi there & @jo\n\none\ntwo\nlines\ncode");
+  EXPECT_EQ(stats.paragraphs, 7u);
+  EXPECT_EQ(stats.links, 1u);
+  EXPECT_EQ(stats.mentions, 1u);
+  EXPECT_EQ(stats.images, 0u);
+  EXPECT_EQ(stats.characters, 40u);
+
+  // External HTML goes through the normalizer first.
+  EXPECT_EQ(GumboParser::toPlainText("<div>a</div><div>b</div>"), "a\nb");
+  EXPECT_EQ(GumboParser::toPlainText("x<br>y"), "x\ny");
+
+  stats = GumboParser::stats("<p>\xF0\x9F\x91\x8B<img src=\"a.png\"></p>");
+  EXPECT_EQ(stats.characters, 3u);
+  EXPECT_EQ(stats.images, 1u);
+  EXPECT_EQ(stats.paragraphs, 1u);
+
+  EXPECT_EQ(GumboParser::toPlainText(""), "");
+  EXPECT_EQ(GumboParser::stats("").paragraphs, 0u);
+}
@@ -0,0 +1,96 @@
+#include "LinkDetector.hpp"
+#include <gtest/gtest.h>
+
+using namespace enriched;
+
+namespace {
+
+bool matches(const LinkDetector &detector, const std::u16string &word) {
+  return detector.matches(word.data(), word.size());
+}
+
+} // namespace
+
+TEST(LinkDetectorTest, DefaultGrammar) {
+  LinkDetector detector;
+  EXPECT_TRUE(detector.isDefault());
+  EXPECT_TRUE(matches(detector, u"https://www.example.com/path?q=1"));
+  EXPECT_TRUE(matches(detector, u"www.example.com"));
+  EXPECT_TRUE(matches(detector, u"example.com"));
+  EXPECT_TRUE(matches(detector, u"(example.com)"));
+  EXPECT_FALSE(matches(detector, u"example"));
+  EXPECT_FALSE(matches(detector, u"example.c"));
+  EXPECT_FALSE(matches(detector, u"example.c0m"));
+}
+
+TEST(LinkDetectorTest, DefaultGrammarTopLevelDomains) {
+  LinkDetector detector;
+  EXPECT_TRUE(matches(detector, u"example.COM"));
+  EXPECT_TRUE(matches(detector, u"HTTPS://WWW.Example.Org"));
+  EXPECT_TRUE(matches(detector, u"example.photography"));
+  EXPECT_TRUE(matches(detector, u"swmansion.technology/about"));
+  EXPECT_FALSE(matches(detector, u"example.C"));
+}
+
+TEST(LinkDetectorTest, DefaultGrammarLinksWholeWord) {
+  LinkDetector detector;
+  EXPECT_EQ(detector.detect(u"see (https://www.example.com/a)"),
+            (std::vector<TextRange>{{4, 27}}));
+}
+
+TEST(LinkDetectorTest, DetectScansEditedWords) {
+  LinkDetector detector;
+  std::u16string text = u"see example.com and\n\u200Bwww.test.org now";
+
+  // Only the words touching the range are scanned.
+  EXPECT_EQ(detector.detect(text.data(), text.size(), {0, 2}),
+            std::vector<TextRange>{});
+  EXPECT_EQ(detector.detect(text.data(), text.size(), {8, 0}),
+            (std::vector<TextRange>{{4, 11}}));
+
+  // A leading zero-width space stays outside the link.
+  EXPECT_EQ(detector.detect(text),
+            (std::vector<TextRange>{{4, 11}, {21, 12}}));
+
+  // Any Unicode white space separates words, but not a space the previous
+  // character's cluster absorbs.
+  EXPECT_EQ(detector.detect(u"a\u00A0example.com\u3000b"),
+            (std::vector<TextRange>{{2, 11}}));
+}
+
+TEST(LinkDetectorTest, UserPattern) {
+  LinkRegexConfig config;
+  config.isDefault = false;
+  config.pattern = u"^ticket-\\d+$";
+  config.caseInsensitive = true;
+  auto detector = LinkDetector::fromConfig(config);
+  ASSERT_TRUE(detector);
+  EXPECT_FALSE(detector->isDefault());
+  EXPECT_TRUE(matches(*detector, u"TICKET-42"));
+  EXPECT_FALSE(matches(*detector, u"example.com"));
+
+  // User patterns turn the whole word into a link.
+  auto links = detector->detect(u"a ticket-7 b");
+  EXPECT_EQ(links, (std::vector<TextRange>{{2, 8}}));
+
+  config.pattern = u"ticket";
+  detector = LinkDetector::fromConfig(config);
+  EXPECT_EQ(detector->detect(u"my-ticket!"),
+            (std::vector<TextRange>{{0, 10}}));
+}
+
+TEST(LinkDetectorTest, DisabledAndUnsupportedConfigs) {
+  LinkRegexConfig config;
+  config.isDisabled = true;
+  auto disabled = LinkDetector::fromConfig(config);
+  ASSERT_TRUE(disabled);
+  EXPECT_TRUE(disabled->isDisabled());
+  EXPECT_TRUE(disabled->detect(u"example.com").empty());
+
+  config = {};
+  config.isDefault = false;
+  config.pattern = u"(?<=@)\\w+";
+  std::string error;
+  EXPECT_FALSE(LinkDetector::fromConfig(config, &error));
+  EXPECT_FALSE(error.empty());
+}
@@ -0,0 +1,148 @@
+#include "ListNumbering.hpp"
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+using namespace enriched;
+
+namespace {
+
+TextRange applyEdit(ListNumbering &numbering, TextRange range,
+                    const std::u16string &replacement) {
+  return numbering.applyEdit(range, replacement.data(), replacement.size());
+}
+
+} // namespace
+
+TEST(ListNumberingTest, NumbersRuns) {
+  ListNumbering numbering(u"a\nb\nc\nd\ne\nf");
+  EXPECT_EQ(numbering.paragraphCount(), 6u);
+  for (size_t p : {0, 1, 2, 4, 5})
+    numbering.setItem(p, true);
+
+  EXPECT_EQ(numbering.number(0), 1u);
+  EXPECT_EQ(numbering.number(1), 2u);
+  EXPECT_EQ(numbering.number(2), 3u);
+  EXPECT_EQ(numbering.number(3), 0u);
+  EXPECT_EQ(numbering.number(4), 1u);
+  EXPECT_EQ(numbering.number(5), 2u);
+  EXPECT_EQ(numbering.numberAt(10), 2u);
+
+  // Joining the two lists renumbers the second one
+  numbering.setItem(3, true);
+  EXPECT_EQ(numbering.number(5), 6u);
+  numbering.setItem(0, false);
+  EXPECT_EQ(numbering.number(5), 5u);
+  EXPECT_FALSE(numbering.isItem(0));
+  EXPECT_EQ(numbering.number(10), 0u);
+}
+
+TEST(ListNumberingTest, Edits) {
+  ListNumbering numbering(u"one\ntwo\nthree");
+  for (size_t p = 0; p < 3; p++)
+    numbering.setItem(p, true);
+
+  // Typing inside an item keeps the paragraphs
+  EXPECT_EQ(applyEdit(numbering, {5, 0}, u"xx"), (TextRange{1, 1}));
+  EXPECT_EQ(numbering.number(2), 3u);
+
+  // Splitting an item: the new paragraph isn't an item until marked
+  EXPECT_EQ(applyEdit(numbering, {1, 0}, u"\n"), (TextRange{0, 2}));
+  EXPECT_EQ(numbering.paragraphCount(), 4u);
+  EXPECT_TRUE(numbering.isItem(0));
+  EXPECT_FALSE(numbering.isItem(1));
+  EXPECT_EQ(numbering.number(3), 2u);
+  numbering.setItem(1, true);
+  EXPECT_EQ(numbering.number(3), 4u);
+
+  // Merging paragraphs drops the later ones
+  EXPECT_EQ(applyEdit(numbering, {1, 1}, u""), (TextRange{0, 1}));
+  EXPECT_EQ(numbering.paragraphCount(), 3u);
+  EXPECT_EQ(numbering.number(2), 3u);
+
+  // Replacing everything
+  EXPECT_EQ(applyEdit(numbering, {0, numbering.length()}, u"x\ny"),
+            (TextRange{0, 2}));
+  EXPECT_TRUE(numbering.isItem(0));
+  EXPECT_FALSE(numbering.isItem(1));
+}
+
+TEST(ListNumberingTest, SetValueThenEdit) {
+  ListNumbering numbering(u"old\ntext");
+  numbering.setItem(0, true);
+
+  // setValue replaces the whole text; the platform re-reads the touched
+  // paragraphs from the spans that came with it
+  std::u16string value = u"intro\none\ntwo\nthree";
+  TextRange touched = applyEdit(numbering, {0, 8}, value);
+  EXPECT_EQ(touched, (TextRange{0, 4}));
+  for (size_t p = touched.start; p < touched.start + touched.length; p++)
+    numbering.setItem(p, p > 0);
+  EXPECT_EQ(numbering.number(0), 0u);
+  EXPECT_EQ(numbering.number(3), 3u);
+
+  // Typing in the third item keeps the numbers
+  touched = applyEdit(numbering, {20, 0}, u"s");
+  EXPECT_EQ(touched, (TextRange{3, 1}));
+  EXPECT_EQ(numbering.number(3), 3u);
+  EXPECT_EQ(numbering.numberAt(21), 3u);
+}
+
+TEST(ListNumberingTest, LongList) {
+  std::u16string text;
+  for (int i = 0; i < 100000; i++)
+    text += u"item\n";
+  ListNumbering numbering(text);
+  for (size_t p = 0; p < 100000; p++)
+    numbering.setItem(p, true);
+  EXPECT_EQ(numbering.number(99999), 100000u);
+
+  // Enter at the start of the second item
+  applyEdit(numbering, {5, 0}, u"\n");
+  numbering.setItem(2, true);
+  EXPECT_EQ(numbering.number(100000), 100001u);
+  numbering.setItem(50000, false);
+  EXPECT_EQ(numbering.number(100000), 50000u);
+}
+
+TEST(ListNumberingTest, MatchesNaiveModel) {
+  std::mt19937 rng(7);
+  std::u16string text;
+  std::vector<bool> items(1, false);
+  ListNumbering numbering;
+
+  for (int step = 0; step < 3000; step++) {
+    if (rng() % 2 == 0) {
+      size_t pos = rng() % (text.size() + 1);
+      size_t removed = std::min<size_t>(rng() % 4, text.size() - pos);
+      std::u16string inserted;
+      for (size_t i = rng() % 4; i > 0; i--)
+        inserted += rng() % 2 == 0 ? u'\n' : u'a';
+
+      size_t first = ParagraphIndex(text).paragraphAt(pos);
+      size_t last = ParagraphIndex(text).paragraphAt(pos + removed);
+      text.replace(pos, removed, inserted);
+      size_t added = ParagraphIndex(text).paragraphCount() + (last - first) -
+                     items.size();
+      items.erase(items.begin() + first + 1, items.begin() + last + 1);
+      items.insert(items.begin() + first + 1, added, false);
+
+      ASSERT_EQ(applyEdit(numbering, {pos, removed}, inserted),
+                (TextRange{first, added + 1}));
+    } else {
+      size_t paragraph = rng() % items.size();
+      bool isItem = rng() % 4 != 0;
+      items[paragraph] = isItem;
+      numbering.setItem(paragraph, isItem);
+    }
+
+    ASSERT_EQ(numbering.paragraphCount(), items.size());
+    ASSERT_EQ(numbering.length(), text.size());
+    size_t run = 0;
+    for (size_t p = 0; p < items.size(); p++) {
+      run = items[p] ? run + 1 : 0;
+      ASSERT_EQ(numbering.number(p), run) << step << " " << p;
+    }
+  }
+}
@@ -0,0 +1,53 @@
+#include "MentionMatcher.hpp"
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace enriched;
+
+TEST(MentionMatcherTest, IndicatorAtStart) {
+  MentionMatcher matcher({u"@", u"#", u"@@"});
+  EXPECT_EQ(matcher.indicatorAtStart(u"@john"), 0);
+  EXPECT_EQ(matcher.indicatorAtStart(u"#tag"), 1);
+  // Earlier indicators win, like the ordered alternation did.
+  EXPECT_EQ(matcher.indicatorAtStart(u"@@team"), 0);
+  EXPECT_EQ(matcher.indicatorAtStart(u"john@"), MentionMatcher::kNoMatch);
+  EXPECT_EQ(matcher.indicatorAtStart(u""), MentionMatcher::kNoMatch);
+
+  MentionMatcher longestFirst({u"@@", u"@"});
+  EXPECT_EQ(longestFirst.indicatorAtStart(u"@@team"), 0);
+  EXPECT_EQ(longestFirst.indicatorAtStart(u"@x"), 1);
+}
+
+TEST(MentionMatcherTest, EmptyConfig) {
+  MentionMatcher matcher;
+  EXPECT_EQ(matcher.indicatorAtStart(u"@john"), MentionMatcher::kNoMatch);
+  EXPECT_EQ(matcher.indicatorAtStart(u""), MentionMatcher::kNoMatch);
+
+  matcher.reset({u"", u"@"});
+  EXPECT_EQ(matcher.indicatorAtStart(u"@john"), 1);
+}
+
+TEST(MentionMatcherTest, MatchesOrderedAlternation) {
+  std::mt19937 rng(32);
+  for (int round = 0; round < 200; round++) {
+    std::vector<std::u16string> indicators(1 + rng() % 6);
+    for (std::u16string &indicator : indicators)
+      for (int i = 0, n = 1 + rng() % 3; i < n; i++)
+        indicator.push_back(u"ab@"[rng() % 3]);
+    MentionMatcher matcher(indicators);
+
+    std::u16string text;
+    for (int i = 0, n = rng() % 20; i < n; i++)
+      text.push_back(u"ab@"[rng() % 3]);
+
+    int expected = MentionMatcher::kNoMatch;
+    for (size_t i = 0; i < indicators.size(); i++) {
+      if (text.compare(0, indicators[i].size(), indicators[i]) == 0) {
+        expected = static_cast<int>(i);
+        break;
+      }
+    }
+    ASSERT_EQ(matcher.indicatorAtStart(text), expected);
+  }
+}
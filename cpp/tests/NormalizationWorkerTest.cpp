@@ -0,0 +1,56 @@
+#include "NormalizationWorker.hpp"
+#include <gtest/gtest.h>
+
+#include <future>
+#include <vector>
+
+using namespace enriched;
+
+TEST(NormalizationWorkerTest, CompletesInOrder) {
+  NormalizationWorker worker;
+  std::vector<std::string> results;
+  for (const char *html : {"<strong>a</strong>", "<em>b</em>", "<del>c</del>"})
+    worker.submit(html, [&](const char *data, size_t length) {
+      results.emplace_back(data, length);
+    });
+  worker.waitUntilIdle();
+  EXPECT_EQ(results, (std::vector<std::string>{"<b>a</b>", "<i>b</i>",
+                                               "<s>c</s>"}));
+}
+
+TEST(NormalizationWorkerTest, ReportsFailure) {
+  NormalizationWorker worker;
+  bool failed = false;
+  worker.submit("", [&](const char *data, size_t length) {
+    failed = data == nullptr && length == 0;
+  });
+  worker.waitUntilIdle();
+  EXPECT_TRUE(failed);
+}
+
+TEST(NormalizationWorkerTest, CancelledJobsDontComplete) {
+  NormalizationWorker worker;
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::vector<std::string> results;
+
+  // Hold the worker in the first completion while the rest are queued.
+  worker.submit("<p>first</p>", [&](const char *data, size_t length) {
+    released.wait();
+    results.emplace_back(data, length);
+  });
+  auto superseded =
+      worker.submit("<p>second</p>", [&](const char *data, size_t length) {
+        results.emplace_back(data, length);
+      });
+  worker.submit("<p>third</p>", [&](const char *data, size_t length) {
+    results.emplace_back(data, length);
+  });
+
+  superseded->cancel();
+  EXPECT_TRUE(superseded->isCancelled());
+  release.set_value();
+  worker.waitUntilIdle();
+  EXPECT_EQ(results,
+            (std::vector<std::string>{"<p>first</p>", "<p>third</p>"}));
+}
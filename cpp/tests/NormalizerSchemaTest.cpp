@@ -0,0 +1,188 @@
+#include "GumboParser.hpp"
+#include "NormalizationWorker.hpp"
+#include "NormalizerSchema.hpp"
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+using namespace enriched;
+
+namespace {
+
+using TagKind = NormalizerSchema::TagKind;
+using Normalize = std::string (*)(const std::string &,
+                                  const NormalizerSchema &);
+
+std::string normalize(const std::string &html,
+                      const NormalizerSchema &schema) {
+  return GumboParser::normalizeHtml(html, schema);
+}
+
+// An empty table sends the input down the tree path without adding output
+// (as long as nothing before it is left open).
+std::string viaTree(const std::string &html, const NormalizerSchema &schema) {
+  return GumboParser::normalizeHtml(html + "<table></table>", schema);
+}
+
+} // namespace
+
+TEST(NormalizerSchemaTest, CanonicalSchemaMatchesBuiltIn) {
+  NormalizerSchema schema;
+  ASSERT_TRUE(schema.compile());
+  const char *const corpus[] = {
+      "<strong>x</strong><em>y</em><del>z</del><ins>w</ins>",
+      "<pre>code</pre>",
+      "<p>a<sup>2</sup><font>b</font></p>",
+      "<a href='https://example.com' target=_blank>x</a>",
+      "<img src='a.png' alt=x width=1 height=2 title=t>",
+      "<ul data-type='checkbox'><li checked>x</li><li>y</li></ul>",
+      "<ul data-type='bullet'><li checked=false>x</li></ul>",
+      "<mention id=1 text='@a' indicator='@' data-id=7>@a</mention>",
+      "<table><tr><td>a</td><td>b</td></tr></table>",
+  };
+  for (const char *html : corpus)
+    EXPECT_EQ(GumboParser::normalizeHtml(html, schema),
+              GumboParser::normalizeHtml(html))
+        << html;
+}
+
+TEST(NormalizerSchemaTest, KeepsAddedTags) {
+  NormalizerSchema schema;
+  schema.allowTag("sup", TagKind::Inline).allowTag("SUB", TagKind::Inline);
+  ASSERT_TRUE(schema.compile());
+
+  EXPECT_EQ(GumboParser::normalizeHtml("<p>x<sup>2</sup><sub>i</sub></p>"),
+            "<p>x2i</p>");
+  EXPECT_EQ(GumboParser::normalizeHtml("<p>x<sup>2</sup><sub>i</sub></p>",
+                                       schema),
+            "<p>x<sup>2</sup><sub>i</sub></p>");
+  EXPECT_EQ(viaTree("<p>x<sup>2</sup></p>", schema), "<p>x<sup>2</sup></p>");
+  // Styles inside still apply
+  EXPECT_EQ(GumboParser::normalizeHtml(
+                "<sup><span style='font-weight:bold'>2</span></sup>", schema),
+            "<sup><b>2</b></sup>");
+}
+
+TEST(NormalizerSchemaTest, RemapsAndStripsTags) {
+  NormalizerSchema schema;
+  schema.allowTag("mark", TagKind::Inline, "u")
+      .allowTag("code", TagKind::Strip)
+      .allowTag("strong", TagKind::Inline, "strong");
+  ASSERT_TRUE(schema.compile());
+
+  for (Normalize normalize : {viaTree, ::normalize}) {
+    EXPECT_EQ(normalize("<p><mark>a</mark> <code>b</code></p>", schema),
+              "<p><u>a</u> b</p>");
+    EXPECT_EQ(normalize("<p><strong>a</strong></p>", schema),
+              "<p><strong>a</strong></p>");
+  }
+}
+
+TEST(NormalizerSchemaTest, KeepsAddedBlocks) {
+  NormalizerSchema schema;
+  schema.allowTag("section", TagKind::Block, "p")
+      .allowTag("hr", TagKind::Void);
+  ASSERT_TRUE(schema.compile());
+
+  // Blocks group the inline runs around them into paragraphs
+  EXPECT_EQ(GumboParser::normalizeHtml("a<section>b</section>c<hr>", schema),
+            "<p>a</p><p>b</p><p>c<hr></p>");
+}
+
+TEST(NormalizerSchemaTest, CoalescesSchemaTags) {
+  NormalizerSchema schema;
+  schema.allowTag("sup", TagKind::Inline)
+      .allowTag("strong", TagKind::Inline)
+      .allowTag("hr", TagKind::Void);
+  ASSERT_TRUE(schema.compile());
+
+  for (Normalize normalize : {viaTree, ::normalize}) {
+    // An added inline tag doesn't split the marks around it
+    EXPECT_EQ(normalize("<p><b>x<sup>2</sup>y</b></p>", schema),
+              "<p><b>x<sup>2</sup>y</b></p>");
+    // Kept under its own name, <strong> merges like <b>
+    EXPECT_EQ(normalize("<p><strong>a</strong><strong>b</strong></p>", schema),
+              "<p><strong>ab</strong></p>");
+  }
+
+  // A void tag is content and leaves no frame open that would reorder the
+  // marks after it
+  EXPECT_EQ(GumboParser::normalizeHtml("<u>x<hr>y</u> <i><u>z</u></i>", schema),
+            "<u>x<hr>y</u> <i><u>z</u></i>");
+}
+
+TEST(NormalizerSchemaTest, FiltersAttributes) {
+  NormalizerSchema schema;
+  schema.allowAttribute("mention", "data-*")
+      .allowAttribute("a", "title")
+      .allowAttributeValue("ol", "type", "a")
+      .allowBooleanAttribute("li", "data-done");
+  ASSERT_TRUE(schema.compile());
+
+  for (Normalize normalize : {viaTree, ::normalize}) {
+    EXPECT_EQ(normalize("<p><mention id=1 text='@a' indicator='@' "
+                        "data-user=42 data-empty='' onclick=x>@a</mention></p>",
+                        schema),
+              "<p><mention id=\"1\" text=\"@a\" indicator=\"@\" "
+              "data-user=\"42\">@a</mention></p>");
+    EXPECT_EQ(normalize("<p><a href=x title=y rel=z>l</a></p>", schema),
+              "<p><a href=\"x\" title=\"y\">l</a></p>");
+    EXPECT_EQ(normalize("<ol type=a><li data-done=no>x</li></ol>"
+                        "<ol type=i><li>y</li></ol>",
+                        schema),
+              "<ol type=\"a\"><li data-done>x</li></ol><ol><li>y</li></ol>");
+  }
+}
+
+TEST(NormalizerSchemaTest, StartsEmpty) {
+  NormalizerSchema schema(false);
+  schema.allowTag("p", TagKind::Block).allowTag("b", TagKind::Inline);
+  ASSERT_TRUE(schema.compile());
+  EXPECT_EQ(GumboParser::normalizeHtml(
+                "<h1>t</h1><p><b>x</b><i>y</i><a href=z>l</a></p>", schema),
+            "<p>t</p><p><b>x</b>yl</p>");
+}
+
+TEST(NormalizerSchemaTest, CompilesLargeSchemas) {
+  NormalizerSchema schema(false);
+  for (int i = 0; i < 2000; i++)
+    schema.allowTag("x-" + std::to_string(i), TagKind::Inline);
+  ASSERT_TRUE(schema.compile());
+  for (int i = 0; i < 2000; i += 97) {
+    std::string tag = "x-" + std::to_string(i);
+    std::string html = "<" + tag + ">v</" + tag + ">";
+    EXPECT_EQ(GumboParser::normalizeHtml(html, schema), html);
+  }
+  EXPECT_EQ(GumboParser::normalizeHtml("<x-2000>v</x-2000>", schema), "v");
+}
+
+TEST(NormalizerSchemaTest, RejectsInvalidRules) {
+  NormalizerSchema uncompiled;
+  EXPECT_EQ(GumboParser::normalizeHtml("<b>x</b>", uncompiled), "");
+
+  NormalizerSchema emptyName;
+  emptyName.allowTag("", TagKind::Inline);
+  EXPECT_FALSE(emptyName.compile());
+
+  NormalizerSchema badAttribute;
+  badAttribute.allowAttribute("a", "on click");
+  EXPECT_FALSE(badAttribute.compile());
+  EXPECT_EQ(GumboParser::normalizeHtml("<b>x</b>", badAttribute), "");
+}
+
+TEST(NormalizerSchemaTest, WorkerUsesSchema) {
+  auto schema = std::make_shared<NormalizerSchema>();
+  schema->allowTag("sup", TagKind::Inline);
+  ASSERT_TRUE(schema->compile());
+
+  NormalizationWorker worker;
+  std::string result;
+  worker.submit(
+      "<p>x<sup>2</sup></p>",
+      [&](const char *data, size_t length) { result.assign(data, length); },
+      schema);
+  schema.reset();
+  worker.waitUntilIdle();
+  EXPECT_EQ(result, "<p>x<sup>2</sup></p>");
+}
@@ -0,0 +1,293 @@
+#include "OperationLog.hpp"
+#include <gtest/gtest.h>
+
+using namespace enriched;
+
+namespace {
+// Applies operations to a plain string, ignoring styles.
+void applyText(std::u16string &text,
+               const std::vector<EditOperation> &operations) {
+  for (const EditOperation &op : operations) {
+    if (op.kind == EditOperation::Kind::ReplaceText)
+      text.replace(op.range.start, op.removedText.size(), op.insertedText);
+  }
+}
+} // namespace
+
+TEST(OperationLogTest, CoalescesTypingBurst) {
+  OperationLog log;
+  std::u16string text;
+  uint64_t time = 0;
+  for (char16_t c : std::u16string(u"hello")) {
+    log.recordReplace(text.size(), u"", std::u16string(1, c), time += 100);
+    text += c;
+  }
+  EXPECT_EQ(log.undoDepth(), 1u);
+
+  auto ops = log.undo();
+  ASSERT_EQ(ops.size(), 1u);
+  EXPECT_EQ(ops[0].removedText, u"hello");
+  applyText(text, ops);
+  EXPECT_EQ(text, u"");
+
+  applyText(text, log.redo());
+  EXPECT_EQ(text, u"hello");
+}
+
+TEST(OperationLogTest, BurstBreaks) {
+  OperationLog log({100, 1 << 20, 500});
+  log.recordReplace(0, u"", u"a", 0);
+  log.recordReplace(1, u"", u"b", 100);
+  // Too late for the window.
+  log.recordReplace(2, u"", u"c", 1000);
+  // Not adjacent.
+  log.recordReplace(0, u"", u"d", 1100);
+  log.recordReplace(1, u"", u"\n", 1200);
+  // A newline closes the burst.
+  log.recordReplace(2, u"", u"e", 1300);
+  EXPECT_EQ(log.undoDepth(), 4u);
+
+  log.breakCoalescing();
+  log.recordReplace(3, u"", u"f", 1400);
+  EXPECT_EQ(log.undoDepth(), 5u);
+}
+
+TEST(OperationLogTest, CoalescesDeletions) {
+  OperationLog log;
+  std::u16string text = u"abcdef";
+  // Backspace three times from the end.
+  for (size_t pos = 5; pos >= 3; pos--) {
+    log.recordReplace(pos, text.substr(pos, 1), u"");
+    text.erase(pos, 1);
+  }
+  // Forward delete twice at the start.
+  log.breakCoalescing();
+  for (int i = 0; i < 2; i++) {
+    log.recordReplace(0, text.substr(0, 1), u"");
+    text.erase(0, 1);
+  }
+  EXPECT_EQ(text, u"c");
+  EXPECT_EQ(log.undoDepth(), 2u);
+
+  applyText(text, log.undo());
+  EXPECT_EQ(text, u"abc");
+  applyText(text, log.undo());
+  EXPECT_EQ(text, u"abcdef");
+}
+
+TEST(OperationLogTest, DeletedTextKeepsItsStyles) {
+  OperationLog log;
+  // "ab**cd**ef", then select "bcd" and delete it.
+  log.recordReplace(1, u"bcd", u"", 0, {{{2, 2}, StyleType::Bold}});
+  auto ops = log.undo();
+  ASSERT_EQ(ops.size(), 1u);
+  EXPECT_EQ(ops[0].insertedText, u"bcd");
+  ASSERT_EQ(ops[0].spans.size(), 1u);
+  EXPECT_EQ(ops[0].spans[0].range, (TextRange{2, 2}));
+  EXPECT_EQ(ops[0].spans[0].type, StyleType::Bold);
+
+  ops = log.redo();
+  ASSERT_EQ(ops.size(), 1u);
+  EXPECT_TRUE(ops[0].spans.empty());
+  EXPECT_EQ(ops[0].removedSpans.size(), 1u);
+}
+
+TEST(OperationLogTest, CoalescedDeletionsKeepStyles) {
+  OperationLog log;
+  // Backspace "d" and "c" out of "ab**cd**": one span for the burst.
+  log.recordReplace(3, u"d", u"", 0, {{{3, 1}, StyleType::Bold}});
+  log.recordReplace(2, u"c", u"", 100, {{{2, 1}, StyleType::Bold}});
+  // Forward delete "a" and "*b*" from the start.
+  log.breakCoalescing();
+  log.recordReplace(0, u"a", u"", 200);
+  log.recordReplace(0, u"b", u"", 300, {{{0, 1}, StyleType::Italic}});
+
+  auto ops = log.undo();
+  ASSERT_EQ(ops.size(), 1u);
+  EXPECT_EQ(ops[0].insertedText, u"ab");
+  ASSERT_EQ(ops[0].spans.size(), 1u);
+  EXPECT_EQ(ops[0].spans[0].range, (TextRange{1, 1}));
+  EXPECT_EQ(ops[0].spans[0].type, StyleType::Italic);
+
+  ops = log.undo();
+  ASSERT_EQ(ops.size(), 1u);
+  EXPECT_EQ(ops[0].insertedText, u"cd");
+  ASSERT_EQ(ops[0].spans.size(), 1u);
+  EXPECT_EQ(ops[0].spans[0].range, (TextRange{2, 2}));
+}
+
+TEST(OperationLogTest, GroupsAndStyles) {
+  OperationLog log;
+  log.beginGroup();
+  log.recordReplace(0, u"", u"title");
+  log.beginGroup();
+  log.recordStyle({0, 5}, StyleType::H1, 0, true, {});
+  log.endGroup();
+  EXPECT_FALSE(log.canUndo());
+  log.endGroup();
+  log.recordStyle({0, 5}, StyleType::Bold, 0, false,
+                  {{{1, 2}, StyleType::Bold}});
+  EXPECT_EQ(log.undoDepth(), 2u);
+
+  auto ops = log.undo();
+  ASSERT_EQ(ops.size(), 1u);
+  EXPECT_EQ(ops[0].kind, EditOperation::Kind::RestoreStyle);
+  ASSERT_EQ(ops[0].spans.size(), 1u);
+  EXPECT_EQ(ops[0].spans[0].range, (TextRange{1, 2}));
+
+  ops = log.undo();
+  ASSERT_EQ(ops.size(), 2u);
+  EXPECT_EQ(ops[0].kind, EditOperation::Kind::RestoreStyle);
+  EXPECT_EQ(ops[0].style, StyleType::H1);
+  EXPECT_EQ(ops[1].kind, EditOperation::Kind::ReplaceText);
+  EXPECT_EQ(ops[1].removedText, u"title");
+
+  ops = log.redo();
+  ASSERT_EQ(ops.size(), 2u);
+  EXPECT_EQ(ops[0].kind, EditOperation::Kind::ReplaceText);
+  EXPECT_EQ(ops[1].kind, EditOperation::Kind::AddStyle);
+
+  // A new edit drops the redo history.
+  log.recordReplace(0, u"", u"x");
+  EXPECT_FALSE(log.canRedo());
+}
+
+TEST(OperationLogTest, GroupedTypingStillCoalesces) {
+  OperationLog log;
+  log.beginGroup();
+  log.recordReplace(0, u"", u"a", 0);
+  log.endGroup();
+  // The platform restyles what it just inserted in the same step.
+  log.beginGroup();
+  log.recordReplace(1, u"", u"b", 100);
+  log.recordStyles({1, 1}, {}, {{{1, 1}, StyleType::Bold}});
+  log.endGroup();
+  EXPECT_EQ(log.undoDepth(), 1u);
+
+  auto ops = log.undo();
+  ASSERT_EQ(ops.size(), 1u);
+  EXPECT_EQ(ops[0].removedText, u"ab");
+  ASSERT_EQ(ops[0].removedSpans.size(), 1u);
+  EXPECT_EQ(ops[0].removedSpans[0].range, (TextRange{1, 1}));
+  EXPECT_EQ(ops[0].removedSpans[0].type, StyleType::Bold);
+
+  // Restyling text typed earlier is a step of its own.
+  log.redo();
+  log.beginGroup();
+  log.recordStyles({0, 1}, {}, {{{0, 1}, StyleType::Italic}});
+  log.endGroup();
+  EXPECT_EQ(log.undoDepth(), 2u);
+}
+
+TEST(OperationLogTest, RestylesMerge) {
+  OperationLog log;
+  log.recordStyles({0, 2}, {{{0, 2}, StyleType::Bold}},
+                   {{{0, 2}, StyleType::Bold}});
+  // Split differently, styled the same
+  log.recordStyles({0, 4},
+                   {{{0, 2}, StyleType::Bold}, {{2, 2}, StyleType::Bold}},
+                   {{{0, 4}, StyleType::Bold}});
+  EXPECT_FALSE(log.canUndo());
+
+  // Only the part that changed is kept
+  log.recordStyles({0, 8}, {{{0, 5}, StyleType::Bold}},
+                   {{{0, 6}, StyleType::Bold}});
+  auto trimmed = log.undo();
+  ASSERT_EQ(trimmed.size(), 1u);
+  EXPECT_EQ(trimmed[0].range, (TextRange{5, 1}));
+  EXPECT_TRUE(trimmed[0].spans.empty());
+  ASSERT_EQ(trimmed[0].removedSpans.size(), 1u);
+  EXPECT_EQ(trimmed[0].removedSpans[0].range, (TextRange{5, 1}));
+  log.clear();
+
+  // Bold over "abc|def", where "def" was italic, one run at a time.
+  log.beginGroup();
+  log.recordStyles({0, 3}, {}, {{{0, 3}, StyleType::Bold}});
+  log.recordStyles({3, 3}, {{{3, 3}, StyleType::Italic}},
+                   {{{3, 3}, StyleType::Italic}, {{3, 3}, StyleType::Bold}});
+  log.endGroup();
+  EXPECT_EQ(log.undoDepth(), 1u);
+
+  auto ops = log.undo();
+  ASSERT_EQ(ops.size(), 1u);
+  EXPECT_EQ(ops[0].kind, EditOperation::Kind::ReplaceStyles);
+  EXPECT_EQ(ops[0].range, (TextRange{0, 6}));
+  ASSERT_EQ(ops[0].spans.size(), 1u);
+  EXPECT_EQ(ops[0].spans[0].range, (TextRange{3, 3}));
+  EXPECT_EQ(ops[0].spans[0].type, StyleType::Italic);
+  ASSERT_EQ(ops[0].removedSpans.size(), 2u);
+  EXPECT_EQ(ops[0].removedSpans[0].range, (TextRange{0, 6}));
+  EXPECT_EQ(ops[0].removedSpans[0].type, StyleType::Bold);
+
+  ops = log.redo();
+  ASSERT_EQ(ops.size(), 1u);
+  EXPECT_EQ(ops[0].spans.size(), 2u);
+}
+
+TEST(OperationLogTest, HistoryIsBounded) {
+  OperationLog log({10, 1 << 20, 0});
+  for (size_t i = 0; i < 50; i++) {
+    log.breakCoalescing();
+    log.recordReplace(i, u"", u"x");
+  }
+  EXPECT_EQ(log.undoDepth(), 10u);
+
+  log.setConfig({100, 4096, 0});
+  for (size_t i = 0; i < 50; i++) {
+    log.breakCoalescing();
+    log.recordReplace(0, u"", std::u16string(200, u'y'));
+  }
+  EXPECT_LE(log.memoryUsage(), 4096u);
+  EXPECT_GE(log.undoDepth(), 1u);
+
+  log.clear();
+  EXPECT_EQ(log.memoryUsage(), 0u);
+  EXPECT_FALSE(log.canUndo());
+}
+
+TEST(OperationLogTest, ValuesLiveAsLongAsTheirSteps) {
+  OperationLog log({2, 1 << 20, 0});
+  for (uint32_t value = 0; value < 3; value++) {
+    log.setValueSize(value, 100);
+    log.breakCoalescing();
+    log.recordReplace(value, u"", u"x", 0, {},
+                      {{{value, 1}, StyleType::Bold, value}});
+    // followed by a restyle back to the previous value
+    if (value > 0)
+      log.recordStyles({0, 1}, {}, {{{0, 1}, StyleType::Bold, value - 1}});
+  }
+
+  // The oldest steps were trimmed; value 0 was only in those
+  EXPECT_EQ(log.takeReleasedValues(), (std::vector<uint32_t>{0}));
+  EXPECT_FALSE(log.isValueReferenced(0));
+  EXPECT_TRUE(log.isValueReferenced(1));
+  EXPECT_TRUE(log.isValueReferenced(2));
+  EXPECT_TRUE(log.takeReleasedValues().empty());
+
+  // Recording drops the undone steps, and with them value 2
+  log.undo();
+  log.undo();
+  log.recordReplace(0, u"", u"y");
+  EXPECT_EQ(log.takeReleasedValues(), (std::vector<uint32_t>{1, 2}));
+
+  log.clear();
+  EXPECT_EQ(log.memoryUsage(), 0u);
+}
+
+TEST(OperationLogTest, ValueSizesCountTowardMaxBytes) {
+  OperationLog log({100, 4096, 0});
+  log.recordReplace(0, u"", u"a", 0, {}, {{{0, 1}, StyleType::Link, 7}});
+  size_t withoutPayload = log.memoryUsage();
+  log.setValueSize(7, 1000);
+  EXPECT_EQ(log.memoryUsage(), withoutPayload + 1000);
+
+  // Large payloads push the oldest steps out even though the steps are small
+  for (uint32_t value = 8; value < 20; value++) {
+    log.setValueSize(value, 1000);
+    log.breakCoalescing();
+    log.recordReplace(0, u"", u"b", 0, {}, {{{0, 1}, StyleType::Link, value}});
+  }
+  EXPECT_LE(log.memoryUsage(), 4096u);
+  EXPECT_FALSE(log.isValueReferenced(7));
+  EXPECT_TRUE(log.isValueReferenced(19));
+}
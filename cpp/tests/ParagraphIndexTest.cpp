@@ -0,0 +1,90 @@
+#include "ParagraphIndex.hpp"
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace enriched;
+
+TEST(ParagraphIndexTest, Lookups) {
+  ParagraphIndex index(u"first\nsecond\n\nfourth");
+  EXPECT_EQ(index.paragraphCount(), 4u);
+  EXPECT_EQ(index.length(), 20u);
+
+  EXPECT_EQ(index.paragraphAt(0), 0u);
+  EXPECT_EQ(index.paragraphAt(5), 0u);
+  EXPECT_EQ(index.paragraphAt(6), 1u);
+  EXPECT_EQ(index.paragraphAt(13), 2u);
+  EXPECT_EQ(index.paragraphAt(14), 3u);
+  EXPECT_EQ(index.paragraphAt(20), 3u);
+
+  EXPECT_EQ(index.paragraphStart(3), 14u);
+  EXPECT_EQ(index.paragraphRange(1), (TextRange{6, 7}));
+  EXPECT_EQ(index.paragraphRangeForRange({3, 4}), (TextRange{0, 13}));
+  EXPECT_EQ(index.paragraphRangeForRange({6, 0}), (TextRange{6, 7}));
+}
+
+TEST(ParagraphIndexTest, EmptyText) {
+  ParagraphIndex index;
+  EXPECT_EQ(index.paragraphCount(), 1u);
+  EXPECT_EQ(index.paragraphAt(0), 0u);
+  EXPECT_EQ(index.paragraphRange(0), (TextRange{0, 0}));
+
+  index.applyEdit({0, 0}, u"a\nb");
+  EXPECT_EQ(index.paragraphCount(), 2u);
+  EXPECT_EQ(index.paragraphRange(1), (TextRange{2, 1}));
+}
+
+TEST(ParagraphIndexTest, Edits) {
+  ParagraphIndex index(u"one\ntwo\nthree");
+
+  // Typing inside a paragraph only shifts offsets.
+  index.applyEdit({5, 0}, u"xx");
+  EXPECT_EQ(index.paragraphCount(), 3u);
+  EXPECT_EQ(index.paragraphRange(1), (TextRange{4, 6}));
+  EXPECT_EQ(index.paragraphStart(2), 10u);
+
+  // Splitting a paragraph.
+  index.applyEdit({1, 0}, u"\n");
+  EXPECT_EQ(index.paragraphCount(), 4u);
+  EXPECT_EQ(index.paragraphRange(0), (TextRange{0, 2}));
+  EXPECT_EQ(index.paragraphRange(1), (TextRange{2, 3}));
+
+  // Backspace over a newline merges paragraphs.
+  index.applyEdit({1, 1}, u"");
+  EXPECT_EQ(index.paragraphCount(), 3u);
+  EXPECT_EQ(index.paragraphRange(0), (TextRange{0, 4}));
+
+  // Replacing across paragraphs.
+  index.applyEdit({2, 7}, u"Z");
+  EXPECT_EQ(index.paragraphCount(), 2u);
+  EXPECT_EQ(index.paragraphRange(0), (TextRange{0, 4}));
+  EXPECT_EQ(index.paragraphRange(1), (TextRange{4, 5}));
+}
+
+TEST(ParagraphIndexTest, MatchesNaiveModel) {
+  std::mt19937 rng(3);
+  std::u16string text;
+  ParagraphIndex index;
+
+  for (int step = 0; step < 2000; step++) {
+    size_t pos = rng() % (text.size() + 1);
+    size_t removed = std::min<size_t>(rng() % 4, text.size() - pos);
+    std::u16string inserted;
+    for (size_t i = rng() % 4; i > 0; i--)
+      inserted += rng() % 3 == 0 ? u'\n' : u'a';
+    index.applyEdit({pos, removed}, inserted);
+    text.replace(pos, removed, inserted);
+
+    ParagraphIndex fresh(text);
+    ASSERT_EQ(index.paragraphCount(), fresh.paragraphCount());
+    ASSERT_EQ(index.length(), text.size());
+    for (size_t i = 0; i < fresh.paragraphCount(); i++)
+      ASSERT_EQ(index.paragraphRange(i), fresh.paragraphRange(i));
+
+    size_t probe = rng() % (text.size() + 1);
+    size_t newlines = 0;
+    for (size_t i = 0; i < probe; i++)
+      newlines += text[i] == u'\n';
+    ASSERT_EQ(index.paragraphAt(probe), newlines);
+  }
+}
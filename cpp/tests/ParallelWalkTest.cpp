@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <random>
+#include <string>
+
+extern "C" char *normalize_html_tree_chunked(const char *html, size_t len,
+                                             unsigned int chunks);
+
+namespace {
+
+std::string normalize(const std::string &html, unsigned int chunks) {
+  char *raw = normalize_html_tree_chunked(html.data(), html.size(), chunks);
+  std::string result = raw ? raw : "";
+  std::free(raw);
+  return result;
+}
+
+void expectSameForAllChunkCounts(const std::string &html) {
+  std::string serial = normalize(html, 1);
+  for (unsigned int chunks = 2; chunks <= 8; chunks++)
+    ASSERT_EQ(normalize(html, chunks), serial) << chunks << " chunks: " << html;
+}
+
+// A flat run of top-level children: inline runs, breaks, blocks and runs of
+// blockquotes, so that chunk boundaries land in and around all of them.
+std::string topLevel(std::mt19937 &rng, int children) {
+  static const char *const kChildren[] = {
+      "<p>para</p>",
+      "<h2>heading</h2>",
+      "<blockquote>quote</blockquote>",
+      "<blockquote><p>a</p>b</blockquote>",
+      "<blockquote>q</blockquote><blockquote>r</blockquote>",
+      "text ",
+      "<b>bold</b>",
+      "<span style=\"font-style: italic\">it</span>",
+      "<br>",
+      "\n",
+      "<!-- c -->",
+      "<div>div</div>",
+      "<div><p>x</p>y</div>",
+      "<ul><li>a</li><li>b</li></ul>",
+      "<table><tr><td>t</td></tr></table>",
+      "<b id=\"docs-internal-guid-0123456789\"><p>wrapped</p></b>",
+      "<pre>code</pre>",
+  };
+  std::string html;
+  for (int i = 0; i < children; i++)
+    html += kChildren[rng() % (sizeof(kChildren) / sizeof(*kChildren))];
+  return html;
+}
+
+} // namespace
+
+TEST(ParallelWalkTest, MatchesSerialWalk) {
+  expectSameForAllChunkCounts("");
+  expectSameForAllChunkCounts("<p>x</p>");
+  // Only inline children: no auto-paragraphs, any split is fine
+  expectSameForAllChunkCounts("a<b>b</b>c<br>d<i>e</i>f<br><br>g");
+  // One long inline run between blocks can't be split
+  expectSameForAllChunkCounts("<p>x</p>a<b>b</b>c<br>d<i>e</i>f<p>y</p>");
+  // Nor can a run of blockquotes
+  expectSameForAllChunkCounts(
+      "<p>x</p><blockquote>a</blockquote><blockquote>b</blockquote>"
+      "<blockquote>c</blockquote><blockquote>d</blockquote><p>y</p>");
+  expectSameForAllChunkCounts(
+      "<blockquote>a</blockquote><blockquote>b</blockquote> "
+      "<blockquote>c</blockquote><blockquote>d</blockquote>");
+}
+
+TEST(ParallelWalkTest, MatchesSerialWalkOnGeneratedDocuments) {
+  std::mt19937 rng(4711);
+  for (int i = 0; i < 200; i++)
+    expectSameForAllChunkCounts(topLevel(rng, 1 + rng() % 60));
+}
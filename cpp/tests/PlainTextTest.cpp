@@ -0,0 +1,101 @@
+#include "PlainText.hpp"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace enriched;
+
+namespace {
+
+// The loop the inputs used to run on every change.
+size_t storageIndexByScan(const std::u16string &storage, size_t visible) {
+  size_t count = 0;
+  size_t index = 0;
+  for (; index < storage.size(); index++) {
+    if (count == visible)
+      return index;
+    if (storage[index] != kZeroWidthSpace)
+      count++;
+  }
+  return index;
+}
+
+} // namespace
+
+TEST(PlainTextTest, StripsZeroWidthSpaces) {
+  PlainText plain = extractPlainText(u"\u200Bab\u200B\u200Bc\u200B");
+  EXPECT_EQ(plain.text, u"abc");
+  EXPECT_EQ(plain.removed, (std::vector<uint32_t>{0, 3, 4, 6}));
+
+  EXPECT_EQ(extractPlainText(u"").text, u"");
+  EXPECT_EQ(extractPlainText(u"\u200B\u200B").text, u"");
+  EXPECT_TRUE(extractPlainText(u"no anchors here").removed.empty());
+}
+
+TEST(PlainTextTest, AttachmentPlaceholders) {
+  std::u16string storage = u"a\uFFFCb\u200B";
+  EXPECT_EQ(extractPlainText(storage).text, u"a\uFFFCb");
+
+  PlainText dropped = extractPlainText(storage, {0});
+  EXPECT_EQ(dropped.text, u"ab");
+  EXPECT_EQ(dropped.removed, (std::vector<uint32_t>{1, 3}));
+
+  PlainText replaced = extractPlainText(storage, {u' '});
+  EXPECT_EQ(replaced.text, u"a b");
+  EXPECT_EQ(replaced.removed, (std::vector<uint32_t>{3}));
+}
+
+TEST(PlainTextTest, IndexMapping) {
+  std::u16string storage = u"\u200Bab\u200B\u200Bc";
+  PlainText plain = extractPlainText(storage);
+  for (size_t visible = 0; visible <= plain.text.size() + 1; visible++)
+    EXPECT_EQ(plain.storageIndex(visible), storageIndexByScan(storage, visible))
+        << visible;
+
+  EXPECT_EQ(plain.visibleIndex(0), 0u);
+  EXPECT_EQ(plain.visibleIndex(1), 0u);
+  EXPECT_EQ(plain.visibleIndex(3), 2u);
+  EXPECT_EQ(plain.visibleIndex(5), 2u);
+  EXPECT_EQ(plain.visibleIndex(6), 3u);
+}
+
+TEST(PlainTextTest, MatchesScalarReferenceAcrossBlocks) {
+  const char16_t alphabet[] = {u'a', u'\n', kZeroWidthSpace, kObjectReplacement,
+                               u'\u00E9'};
+  std::mt19937 random(7);
+  for (int round = 0; round < 300; round++) {
+    std::u16string storage(random() % 70, u'x');
+    for (char16_t &c : storage)
+      c = alphabet[random() % (round % 3 == 0 ? 5 : 3)];
+
+    for (char16_t replacement : {kObjectReplacement, char16_t(0), u'*'}) {
+      std::u16string expected;
+      std::vector<uint32_t> removed;
+      for (size_t i = 0; i < storage.size(); i++) {
+        char16_t c = storage[i];
+        if (c == kObjectReplacement)
+          c = replacement;
+        if (c == kZeroWidthSpace || c == 0)
+          removed.push_back(static_cast<uint32_t>(i));
+        else
+          expected.push_back(c);
+      }
+
+      PlainText plain = extractPlainText(storage, {replacement});
+      ASSERT_EQ(plain.text, expected);
+      ASSERT_EQ(plain.removed, removed);
+
+      std::u16string inPlace = storage;
+      size_t written = stripPlainText(inPlace.data(), inPlace.size(),
+                                      &inPlace[0], {replacement});
+      inPlace.resize(written);
+      ASSERT_EQ(inPlace, expected);
+    }
+
+    PlainText plain = extractPlainText(storage);
+    for (size_t visible = 0; visible <= plain.text.size(); visible++)
+      ASSERT_EQ(plain.storageIndex(visible),
+                storageIndexByScan(storage, visible));
+    for (size_t index = 0; index <= storage.size(); index++)
+      ASSERT_LE(plain.storageIndex(plain.visibleIndex(index)), index);
+  }
+}
@@ -0,0 +1,194 @@
+#include "RegexDfa.hpp"
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <random>
+#include <regex>
+
+using namespace enriched;
+
+namespace {
+
+std::unique_ptr<RegexDfa> compile(const std::u16string &pattern,
+                                  RegexOptions options = {}) {
+  std::string error;
+  auto regex = RegexDfa::compile(pattern, options, &error);
+  EXPECT_TRUE(regex) << error;
+  return regex;
+}
+
+TextRange findIn(const RegexDfa &regex, const std::u16string &text) {
+  TextRange match{SIZE_MAX, 0};
+  regex.find(text, match);
+  return match;
+}
+
+} // namespace
+
+TEST(RegexDfaTest, Literals) {
+  auto regex = compile(u"abc");
+  EXPECT_TRUE(regex->search(u"xxabcxx"));
+  EXPECT_FALSE(regex->search(u"ab"));
+  EXPECT_EQ(findIn(*regex, u"xxabcxx"), (TextRange{2, 3}));
+}
+
+TEST(RegexDfaTest, ClassesAndEscapes) {
+  auto regex = compile(u"^[a-c\\d]+\\.\\w\\s\\x41\\u0042$");
+  EXPECT_TRUE(regex->search(u"a1b.z AB"));
+  EXPECT_FALSE(regex->search(u"a1d.z AB"));
+
+  auto negated = compile(u"[^-a]");
+  EXPECT_FALSE(negated->search(u"a-a"));
+  EXPECT_TRUE(negated->search(u"a-b"));
+
+  auto dashes = compile(u"^[\\d-x]+$");
+  EXPECT_TRUE(dashes->search(u"1-x"));
+  EXPECT_FALSE(dashes->search(u"w"));
+}
+
+TEST(RegexDfaTest, Quantifiers) {
+  auto regex = compile(u"^a{2,3}b?c*$");
+  EXPECT_FALSE(regex->search(u"a"));
+  EXPECT_TRUE(regex->search(u"aa"));
+  EXPECT_TRUE(regex->search(u"aaabccc"));
+  EXPECT_FALSE(regex->search(u"aaaa"));
+
+  auto lazy = compile(u"a+?b");
+  EXPECT_EQ(findIn(*lazy, u"xaaab"), (TextRange{1, 4}));
+
+  auto literalBrace = compile(u"a{,2}");
+  EXPECT_TRUE(literalBrace->search(u"a{,2}"));
+}
+
+TEST(RegexDfaTest, LeftmostLongest) {
+  auto regex = compile(u"ab|abcd|bcdef");
+  EXPECT_EQ(findIn(*regex, u"xabcdef"), (TextRange{1, 4}));
+
+  auto empty = compile(u"x*");
+  EXPECT_EQ(findIn(*empty, u"abc"), (TextRange{0, 0}));
+}
+
+TEST(RegexDfaTest, Assertions) {
+  auto word = compile(u"\\bcat\\b");
+  EXPECT_TRUE(word->search(u"a cat."));
+  EXPECT_FALSE(word->search(u"concat"));
+  EXPECT_EQ(findIn(*word, u"cats cat"), (TextRange{5, 3}));
+
+  auto inside = compile(u"\\Bcat");
+  EXPECT_TRUE(inside->search(u"concat"));
+  EXPECT_FALSE(inside->search(u"cat"));
+
+  auto anchored = compile(u"^ab|cd$");
+  EXPECT_TRUE(anchored->search(u"abx"));
+  EXPECT_FALSE(anchored->search(u"xab"));
+  EXPECT_TRUE(anchored->search(u"xcd"));
+  EXPECT_FALSE(anchored->search(u"cdx"));
+}
+
+TEST(RegexDfaTest, Flags) {
+  RegexOptions options;
+  options.caseInsensitive = true;
+  auto insensitive = compile(u"^[a-c]x[^d]$", options);
+  EXPECT_TRUE(insensitive->search(u"BXe"));
+  EXPECT_FALSE(insensitive->search(u"bxD"));
+
+  auto dot = compile(u"a.b");
+  EXPECT_FALSE(dot->search(u"a\nb"));
+  options = {};
+  options.dotAll = true;
+  auto dotAll = compile(u"a.b", options);
+  EXPECT_TRUE(dotAll->search(u"a\nb"));
+}
+
+TEST(RegexDfaTest, Groups) {
+  auto regex = compile(u"^(?:ab)+(?<tail>c|d)(e)$");
+  EXPECT_TRUE(regex->search(u"ababde"));
+  EXPECT_FALSE(regex->search(u"abade"));
+}
+
+TEST(RegexDfaTest, RejectsUnsupportedSyntax) {
+  for (const char16_t *pattern :
+       {u"a(?=b)", u"a(?!b)", u"(?<=a)b", u"(?<!a)b", u"(a)\\1", u"(a", u"a)",
+        u"[a", u"*a", u"a**", u"a{3,2}", u"[z-a]", u"a{5000}", u"\\"}) {
+    std::string error;
+    EXPECT_FALSE(RegexDfa::compile(pattern, {}, &error))
+        << std::string(pattern, pattern + std::char_traits<char16_t>::length(
+                                              pattern));
+    EXPECT_FALSE(error.empty());
+  }
+}
+
+TEST(RegexDfaTest, NoCatastrophicBacktracking) {
+  auto regex = compile(u"(a|aa)*(a*)*b");
+  std::u16string text(20000, u'a');
+  EXPECT_FALSE(regex->search(text));
+  text.push_back(u'b');
+  EXPECT_TRUE(regex->search(text));
+}
+
+TEST(RegexDfaTest, MatchesStdRegex) {
+  // Random patterns over a tiny alphabet compared against std::regex, which
+  // implements the same ECMAScript semantics by backtracking. Match starts
+  // agree for leftmost-longest; ends may not, so only starts are compared.
+  std::mt19937 rng(31);
+  const char *atoms[] = {"a", "b", ".", "[ab]", "[^a]", "\\b", "\\B", "^",
+                         "$", "\\w", " "};
+
+  std::function<std::string(int)> generate = [&](int depth) {
+    std::string out;
+    int items = 1 + rng() % 3;
+    for (int i = 0; i < items; i++) {
+      std::string item;
+      if (depth > 0 && rng() % 4 == 0)
+        item = "(" + generate(depth - 1) + "|" + generate(depth - 1) + ")";
+      else
+        item = atoms[rng() % (sizeof(atoms) / sizeof(atoms[0]))];
+      bool assertion = item == "\\b" || item == "\\B" || item == "^" ||
+                       item == "$";
+      if (!assertion) {
+        switch (rng() % 6) {
+        case 0:
+          item += "*";
+          break;
+        case 1:
+          item += "+";
+          break;
+        case 2:
+          item += "?";
+          break;
+        case 3:
+          item += "{1,2}";
+          break;
+        }
+      }
+      out += item;
+    }
+    return out;
+  };
+
+  for (int round = 0; round < 400; round++) {
+    std::string pattern = generate(2);
+    std::regex reference(pattern, std::regex::ECMAScript);
+    auto regex = compile(std::u16string(pattern.begin(), pattern.end()));
+    ASSERT_TRUE(regex) << pattern;
+
+    for (int sample = 0; sample < 20; sample++) {
+      std::string text;
+      int length = rng() % 8;
+      for (int i = 0; i < length; i++)
+        text.push_back("ab c"[rng() % 4]);
+      std::u16string text16(text.begin(), text.end());
+
+      std::smatch expected;
+      bool found = std::regex_search(text, expected, reference);
+      ASSERT_EQ(regex->search(text16), found)
+          << "/" << pattern << "/ on \"" << text << "\"";
+      TextRange match;
+      ASSERT_EQ(regex->find(text16, match), found);
+      if (found) {
+        ASSERT_EQ(match.start, static_cast<size_t>(expected.position(0)))
+            << "/" << pattern << "/ on \"" << text << "\"";
+      }
+    }
+  }
+}
@@ -0,0 +1,155 @@
+#include "ShortcutEngine.hpp"
+#include <gtest/gtest.h>
+
+using namespace enriched;
+
+namespace {
+
+ShortcutEngine defaultEngine() {
+  return ShortcutEngine({{u"# ", "h1"},
+                         {u"## ", "h2"},
+                         {u"- ", "unordered_list"},
+                         {u"**", "bold"},
+                         {u"*", "italic"},
+                         {u"~~", "strikethrough"},
+                         {u"`", "inline_code"},
+                         {u"", "bold"},
+                         {u"!!", "unknown"}});
+}
+
+std::vector<ShortcutMatch> paragraphMatches(const ShortcutEngine &engine,
+                                            const std::u16string &text,
+                                            size_t triggerStart = 0) {
+  return engine.paragraphMatches(text.data(), text.size(), triggerStart);
+}
+
+std::vector<ShortcutMatch> inlineMatches(const ShortcutEngine &engine,
+                                         const std::u16string &text,
+                                         size_t paragraphStart = 0) {
+  return engine.inlineMatches(text.data(), text.size(), paragraphStart);
+}
+
+} // namespace
+
+TEST(ShortcutEngineTest, StyleNames) {
+  EXPECT_EQ(ShortcutEngine::styleForName("h3"), StyleType::H3);
+  EXPECT_EQ(ShortcutEngine::styleForName("inline_code"),
+            StyleType::InlineCode);
+  EXPECT_EQ(ShortcutEngine::styleForName("link"), StyleType::None);
+  EXPECT_TRUE(ShortcutEngine::isInlineStyle(StyleType::Bold));
+  EXPECT_FALSE(ShortcutEngine::isInlineStyle(StyleType::CodeBlock));
+
+  EXPECT_TRUE(ShortcutEngine().empty());
+  EXPECT_TRUE(ShortcutEngine({{u"", "h1"}, {u"x", "nope"}}).empty());
+  EXPECT_FALSE(defaultEngine().empty());
+}
+
+TEST(ShortcutEngineTest, ParagraphTriggerAtParagraphStart) {
+  ShortcutEngine engine = defaultEngine();
+
+  auto matches = paragraphMatches(engine, u"# ");
+  ASSERT_EQ(matches.size(), 1u);
+  EXPECT_EQ(matches[0].shortcut, 0u);
+  EXPECT_EQ(matches[0].style, StyleType::H1);
+  EXPECT_EQ(matches[0].closeDelete, (TextRange{0, 2}));
+
+  EXPECT_EQ(paragraphMatches(engine, u"## ")[0].style, StyleType::H2);
+  // The trigger has to end at the cursor.
+  EXPECT_TRUE(paragraphMatches(engine, u"#").empty());
+  EXPECT_TRUE(paragraphMatches(engine, u"# a").empty());
+  EXPECT_TRUE(paragraphMatches(engine, u"a# ").empty());
+
+  // Content may start after a placeholder character.
+  std::u16string placeholder = u"\u200B- ";
+  matches = paragraphMatches(engine, placeholder, 1);
+  ASSERT_EQ(matches.size(), 1u);
+  EXPECT_EQ(matches[0].closeDelete, (TextRange{1, 2}));
+}
+
+TEST(ShortcutEngineTest, DuplicateTriggersKeepConfigOrder) {
+  ShortcutEngine engine({{u"> ", "blockquote"}, {u"> ", "codeblock"}});
+  auto matches = paragraphMatches(engine, u"> ");
+  ASSERT_EQ(matches.size(), 2u);
+  EXPECT_EQ(matches[0].style, StyleType::BlockQuote);
+  EXPECT_EQ(matches[1].style, StyleType::CodeBlock);
+}
+
+TEST(ShortcutEngineTest, InlinePair) {
+  ShortcutEngine engine = defaultEngine();
+  std::u16string text = u"say **hi**";
+  auto matches = inlineMatches(engine, text);
+  ASSERT_EQ(matches.size(), 1u);
+  EXPECT_EQ(matches[0].style, StyleType::Bold);
+  EXPECT_EQ(matches[0].openDelete, (TextRange{4, 2}));
+  EXPECT_EQ(matches[0].closeDelete, (TextRange{8, 2}));
+  EXPECT_EQ(matches[0].content, (TextRange{6, 2}));
+  EXPECT_EQ(matches[0].finalContent, (TextRange{4, 2}));
+
+  matches = inlineMatches(engine, u"`code`");
+  ASSERT_EQ(matches.size(), 1u);
+  EXPECT_EQ(matches[0].style, StyleType::InlineCode);
+}
+
+TEST(ShortcutEngineTest, ShorterTriggerInsideLongerOne) {
+  ShortcutEngine engine = defaultEngine();
+
+  // The opening `*` belongs to `**`, so `*` can't close it.
+  EXPECT_TRUE(inlineMatches(engine, u"**a*").empty());
+
+  // Plain italics still work.
+  auto matches = inlineMatches(engine, u"*a*");
+  ASSERT_EQ(matches.size(), 1u);
+  EXPECT_EQ(matches[0].style, StyleType::Italic);
+
+  // `*` also ends at the cursor but has no content; `**` wins.
+  matches = inlineMatches(engine, u"*x* **a**");
+  ASSERT_EQ(matches.size(), 1u);
+  EXPECT_EQ(matches[0].style, StyleType::Bold);
+  EXPECT_EQ(matches[0].openDelete, (TextRange{4, 2}));
+}
+
+TEST(ShortcutEngineTest, LongerTriggersComeFirst) {
+  ShortcutEngine engine({{u"_", "italic"}, {u"__", "underline"}});
+  auto matches = inlineMatches(engine, u"_a_ __b__");
+  ASSERT_EQ(matches.size(), 1u);
+  EXPECT_EQ(matches[0].style, StyleType::Underline);
+
+  ShortcutEngine distinct({{u"+", "italic"}, {u"=+", "underline"}});
+  matches = inlineMatches(distinct, u"+q =+r+ s=+");
+  ASSERT_EQ(matches.size(), 2u);
+  EXPECT_EQ(matches[0].style, StyleType::Underline);
+  EXPECT_EQ(matches[0].openDelete, (TextRange{3, 2}));
+  EXPECT_EQ(matches[1].style, StyleType::Italic);
+  EXPECT_EQ(matches[1].openDelete, (TextRange{6, 1}));
+}
+
+TEST(ShortcutEngineTest, InlineNeedsContentInsideParagraph) {
+  ShortcutEngine engine = defaultEngine();
+  EXPECT_TRUE(inlineMatches(engine, u"****").empty());
+  EXPECT_TRUE(inlineMatches(engine, u"**").empty());
+  EXPECT_TRUE(inlineMatches(engine, u"~~a~").empty());
+
+  // The opening delimiter has to be in the current paragraph.
+  std::u16string text = u"**a\nb**";
+  EXPECT_TRUE(inlineMatches(engine, text, 4).empty());
+  EXPECT_EQ(inlineMatches(engine, text, 0).size(), 1u);
+}
+
+TEST(ShortcutEngineTest, UsesLastOpeningDelimiter) {
+  ShortcutEngine engine = defaultEngine();
+  auto matches = inlineMatches(engine, u"~~a~~b~~c~~");
+  ASSERT_EQ(matches.size(), 1u);
+  EXPECT_EQ(matches[0].openDelete, (TextRange{6, 2}));
+  EXPECT_EQ(matches[0].content, (TextRange{8, 1}));
+}
+
+TEST(ShortcutEngineTest, OpeningDelimiterSearchIsBounded) {
+  ShortcutEngine engine = defaultEngine();
+  std::u16string content(ShortcutEngine::kMaxInlineContentLength, u'a');
+  auto matches = inlineMatches(engine, u"x~~" + content + u"~~", 1);
+  ASSERT_EQ(matches.size(), 1u);
+  EXPECT_EQ(matches[0].content,
+            (TextRange{3, ShortcutEngine::kMaxInlineContentLength}));
+
+  EXPECT_TRUE(inlineMatches(engine, u"x~~a" + content + u"~~", 1).empty());
+}
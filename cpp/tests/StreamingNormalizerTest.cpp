@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <random>
+#include <string>
+
+extern "C" {
+char *normalize_html_streaming(const char *html, size_t len);
+char *normalize_html_tree(const char *html, size_t len);
+}
+
+namespace {
+
+struct Result {
+  bool streamed;
+  std::string html;
+};
+
+std::string take(char *raw) {
+  std::string result = raw ? raw : "";
+  std::free(raw);
+  return result;
+}
+
+Result streaming(const std::string &html) {
+  char *raw = normalize_html_streaming(html.data(), html.size());
+  return {raw != nullptr, take(raw)};
+}
+
+std::string tree(const std::string &html) {
+  return take(normalize_html_tree(html.data(), html.size()));
+}
+
+// Well-nested markup in the shapes pastes take: blocks in containers,
+// inline runs, lists with nested lists, quotes, Google Docs wrappers.
+class Generator {
+public:
+  explicit Generator(unsigned seed) : rng_(seed) {}
+
+  std::string document() {
+    std::string html;
+    if (chance(4))
+      html += "<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"></head>"
+              "<body>\n";
+    if (chance(4))
+      html += "<!--StartFragment-->";
+    blocks(html, 0);
+    return html;
+  }
+
+private:
+  std::mt19937 rng_;
+
+  bool chance(int oneIn) { return rng_() % oneIn == 0; }
+
+  template <size_t N> const char *pick(const char *const (&items)[N]) {
+    return items[rng_() % N];
+  }
+
+  void text(std::string &html) {
+    static const char *const kText[] = {
+        "x",      "Hello",  "a b",    " ",       "\n",      "&amp;",
+        "&lt;",   "&gt;",   "&nbsp;", "&#65;",   "&#x263A;", "caf\xc3\xa9",
+        "\r\n",   "1 < 2",  "a & b",  "&hellip;", "\t",     "<!-- c -->"};
+    html += pick(kText);
+  }
+
+  void attributes(std::string &html, const char *tag) {
+    static const char *const kStyle[] = {
+        " style=\"font-weight:700\"", " style='font-style: italic'",
+        " style=text-decoration:underline",
+        " style=\"font-weight: bold; text-decoration: line-through\"",
+        " dir=ltr", " class=\"x\" STYLE=\"font-weight:normal\""};
+    if (std::string(tag) == "a")
+      html += " href=\"https://example.com/?a=1&amp;b=2\"";
+    else if (std::string(tag) == "li" && chance(3))
+      html += " checked";
+    else if (std::string(tag) == "ul" && chance(3))
+      html += " data-type='checkbox'";
+    else if (std::string(tag) == "mention")
+      html += " text='@x' indicator=\"@\" id=1";
+    if (chance(3))
+      html += pick(kStyle);
+  }
+
+  void inlines(std::string &html, int depth) {
+    static const char *const kInline[] = {
+        "b",    "i",    "u",  "s",   "span", "span",   "strong", "em",
+        "code", "a",    "del", "ins", "font", "sub",   "mark",   "mention"};
+    int count = rng_() % 4 + 1;
+    for (int i = 0; i < count; i++) {
+      int kind = rng_() % 10;
+      if (kind < 5 || depth > 3) {
+        text(html);
+      } else if (kind < 6) {
+        html += chance(2) ? "<br>" : "<img src=\"a.png\" alt=x width=1>";
+      } else {
+        const char *tag = pick(kInline);
+        html += std::string("<") + tag;
+        attributes(html, tag);
+        html += ">";
+        // <a> inside <a> is the adoption agency's business
+        if (std::string(tag) != "a")
+          inlines(html, depth + 1);
+        else
+          text(html);
+        html += std::string("</") + tag + ">";
+      }
+    }
+  }
+
+  void list(std::string &html, int depth) {
+    const char *tag = chance(2) ? "ul" : "ol";
+    html += std::string("<") + tag;
+    attributes(html, tag);
+    html += ">";
+    int items = rng_() % 3 + 1;
+    for (int i = 0; i < items; i++) {
+      html += "<li";
+      attributes(html, "li");
+      html += ">";
+      if (chance(3))
+        blocks(html, depth + 1);
+      else
+        inlines(html, depth);
+      if (depth < 3 && chance(3))
+        list(html, depth + 1);
+      if (!chance(4))
+        html += "</li>";
+    }
+    html += std::string("</") + tag + ">";
+  }
+
+  void blocks(std::string &html, int depth) {
+    static const char *const kBlock[] = {"p", "p", "h1", "h3", "codeblock"};
+    int count = rng_() % 4 + 1;
+    for (int i = 0; i < count; i++) {
+      int kind = depth > 3 ? 0 : rng_() % 9;
+      if (kind < 3) {
+        const char *tag = pick(kBlock);
+        html += std::string("<") + tag;
+        attributes(html, tag);
+        html += ">";
+        inlines(html, 1);
+        html += std::string("</") + tag + ">";
+      } else if (kind < 4) {
+        inlines(html, 0);
+      } else if (kind < 5) {
+        html += "<div";
+        attributes(html, "div");
+        html += ">";
+        blocks(html, depth + 1);
+        html += "</div>";
+      } else if (kind < 6) {
+        list(html, depth);
+      } else if (kind < 7) {
+        html += "<blockquote>";
+        blocks(html, depth + 1);
+        html += "</blockquote>";
+      } else if (kind < 8) {
+        html += "<b id=\"docs-internal-guid-0123456789\">";
+        blocks(html, depth + 1);
+        html += "</b>";
+      } else {
+        html += chance(2) ? "<br>" : "\n";
+      }
+    }
+  }
+};
+
+} // namespace
+
+TEST(StreamingNormalizerTest, MatchesTreeOnCorpus) {
+  const char *const corpus[] = {
+      "<strong>x</strong>",
+      "<pre>x</pre>",
+      "<b id=\"docs-internal-guid-1234567890\">x</b>",
+      "<b id=\"docs-internal-guid-1234567890\"></b>",
+      "<html><head></head><body></body></html>",
+      "<html><body><p>x</p></body></html>",
+      "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n"
+      "</head>\n<body><!--StartFragment--><p>x</p><!--EndFragment-->"
+      "</body></html>",
+      "  <p>x</p>",
+      "<span style=\"font-weight: bold; font-style: italic;\">x</span>",
+      "<codeblock>x</codeblock>",
+      "<codeblock><p>x</p></codeblock>",
+      "<blockquote>x</blockquote><blockquote><p>y</p></blockquote>",
+      "<h1>x</h1><h2>y",
+      "<img src='x' width='100' height='100' />",
+      "<ul data-type='checkbox'><li checked>x</li><li>y</ul>",
+      "<ul><li>a<ul><li>b</li></ul>c</li></ul>",
+      "<ol><li><p>a</p><p>b</p></li></ol>",
+      "<mention text='@John Doe' indicator='@' id='1'>@John Doe</mention>",
+      "<a href='https://www.google.com'>Google</a>",
+      "<div><div><span>x</span></div><span>y</span></div>",
+      "<span>--</span><br><div><div><span>John<span> </span></span><b>Doe</b>"
+      "<div><u><i>Software</i></u><span> </span>Engineer</div></div></div>",
+      "<div>a<br>b<br><br>c</div>",
+      "<p>a</p>\n<p>b</p>",
+      "x &amp; y &lt;z&gt; &nbsp;&#169;&#x2603;",
+      "<p>line\r\nbreak\rhere</p>",
+      "<table><tr><td>a</td></tr></table>",
+      "<b><i>x</b>y</i>",
+      "<p><div>x</div></p>",
+      "<b><p>x</p></b>",
+      "<script>x</script><p>y</p>",
+      // Gumbo quirks: unknown end tags close any unknown element, CR isn't a
+      // tag name terminator, a valueless duplicate attribute leaks its name
+      "<codeblock>a</x>b",
+      "<mention id=1>a</foo>b",
+      "<codeblock\r>x</codeblock>",
+      "<a href=x href y=1>z</a>",
+  };
+  for (const char *html : corpus) {
+    Result result = streaming(html);
+    if (result.streamed) {
+      EXPECT_EQ(result.html, tree(html)) << html;
+    }
+  }
+}
+
+TEST(StreamingNormalizerTest, FallsBackForTreeConstruction) {
+  // Adoption agency, foster parenting, raw text and implied paragraphs
+  EXPECT_FALSE(streaming("<b><i>x</b>y</i>").streamed);
+  EXPECT_FALSE(streaming("<a href=x>1<a href=y>2</a>").streamed);
+  EXPECT_FALSE(streaming("<table><tr><td>a</td></tr></table>").streamed);
+  EXPECT_FALSE(streaming("<p>x</p><style>p {}</style>").streamed);
+  EXPECT_FALSE(streaming("x</p>").streamed);
+  EXPECT_FALSE(streaming("<b><p>x</p></b>").streamed);
+  // Markup the tokenizer has to repair
+  EXPECT_FALSE(streaming(std::string("a\0b", 3)).streamed);
+  EXPECT_FALSE(streaming("caf\xe9").streamed);
+  EXPECT_FALSE(streaming("&copy").streamed);
+
+  EXPECT_TRUE(streaming("<p><b>x</b> &amp; <i>y</i></p>").streamed);
+  EXPECT_TRUE(streaming("<ul><li>a<li>b</ul>").streamed);
+}
+
+TEST(StreamingNormalizerTest, MatchesTreeOnGeneratedMarkup) {
+  Generator generator(20240611);
+  int streamed = 0;
+  const int kDocuments = 1000;
+  for (int i = 0; i < kDocuments; i++) {
+    std::string html = generator.document();
+    Result result = streaming(html);
+    if (!result.streamed)
+      continue;
+    streamed++;
+    ASSERT_EQ(result.html, tree(html)) << html;
+  }
+  // The generator sticks to markup the fast path is meant to cover
+  EXPECT_GT(streamed, kDocuments * 3 / 4);
+}
@@ -0,0 +1,168 @@
+#include "StyleIntervalTree.hpp"
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace enriched;
+
+namespace {
+constexpr StyleMask kBold = styleBit(StyleType::Bold);
+constexpr StyleMask kItalic = styleBit(StyleType::Italic);
+constexpr StyleMask kLink = styleBit(StyleType::Link);
+} // namespace
+
+TEST(StyleIntervalTreeTest, PointAndRangeQueries) {
+  StyleIntervalTree tree;
+  tree.add({{0, 5}, StyleType::Bold});
+  tree.add({{3, 6}, StyleType::Italic});
+  tree.add({{20, 4}, StyleType::Link, 7});
+
+  EXPECT_EQ(tree.stylesAt(0), kBold);
+  EXPECT_EQ(tree.stylesAt(4), kBold | kItalic);
+  EXPECT_EQ(tree.stylesAt(5), kItalic);
+  EXPECT_EQ(tree.stylesAt(9), 0u);
+  EXPECT_EQ(tree.stylesAt(23), kLink);
+
+  EXPECT_EQ(tree.stylesIntersecting({5, 20}), kItalic | kLink);
+  EXPECT_EQ(tree.stylesIntersecting({9, 11}), 0u);
+
+  auto links = tree.intervalsAt(21);
+  ASSERT_EQ(links.size(), 1u);
+  EXPECT_EQ(links[0].range, (TextRange{20, 4}));
+  EXPECT_EQ(links[0].value, 7u);
+}
+
+TEST(StyleIntervalTreeTest, CoveringQueries) {
+  StyleIntervalTree tree;
+  tree.add({{0, 5}, StyleType::Bold});
+  tree.add({{3, 6}, StyleType::Italic});
+  tree.add({{10, 2}, StyleType::Italic});
+  tree.add({{0, 4}, StyleType::Link, 1});
+  tree.add({{4, 4}, StyleType::Link, 2});
+
+  EXPECT_EQ(tree.stylesCovering({0, 5}), kBold | kLink);
+  EXPECT_EQ(tree.stylesCovering({3, 2}), kBold | kItalic | kLink);
+  EXPECT_EQ(tree.stylesCovering({4, 6}), 0u);
+  EXPECT_EQ(tree.stylesCovering({5, 4}), kItalic);
+  // the gap between the italic spans
+  EXPECT_EQ(tree.stylesCovering({8, 3}), 0u);
+  EXPECT_EQ(tree.stylesCovering({2, 0}), 0u);
+}
+
+TEST(StyleIntervalTreeTest, CoalescesTouchingSpans) {
+  StyleIntervalTree tree;
+  tree.add({{0, 3}, StyleType::Bold});
+  tree.add({{3, 3}, StyleType::Bold});
+  tree.add({{10, 2}, StyleType::Bold});
+  ASSERT_EQ(tree.size(), 2u);
+  EXPECT_EQ(tree.intervals()[0].range, (TextRange{0, 6}));
+
+  // Different payloads of the same style do not merge but overwrite.
+  tree.add({{20, 5}, StyleType::Link, 1});
+  tree.add({{22, 5}, StyleType::Link, 2});
+  auto links = tree.intervalsIntersecting({20, 10});
+  ASSERT_EQ(links.size(), 2u);
+  EXPECT_EQ(links[0].range, (TextRange{20, 2}));
+  EXPECT_EQ(links[0].value, 1u);
+  EXPECT_EQ(links[1].range, (TextRange{22, 5}));
+  EXPECT_EQ(links[1].value, 2u);
+}
+
+TEST(StyleIntervalTreeTest, RemoveTrimsSpans) {
+  StyleIntervalTree tree;
+  tree.add({{0, 10}, StyleType::Bold});
+  tree.add({{0, 10}, StyleType::Italic});
+  tree.remove({3, 4}, StyleType::Bold);
+
+  auto spans = tree.intervals();
+  ASSERT_EQ(spans.size(), 3u);
+  EXPECT_EQ(tree.stylesAt(2), kBold | kItalic);
+  EXPECT_EQ(tree.stylesAt(3), kItalic);
+  EXPECT_EQ(tree.stylesAt(7), kBold | kItalic);
+}
+
+TEST(StyleIntervalTreeTest, ShiftsOnEdits) {
+  StyleIntervalTree tree;
+  tree.add({{0, 4}, StyleType::Bold});
+  tree.add({{4, 4}, StyleType::Italic});
+  tree.add({{10, 2}, StyleType::Link});
+
+  tree.applyInsertion(2, 3); // inside bold
+  auto spans = tree.intervals();
+  ASSERT_EQ(spans.size(), 3u);
+  EXPECT_EQ(spans[0].range, (TextRange{0, 7}));
+  EXPECT_EQ(spans[1].range, (TextRange{7, 4}));
+  EXPECT_EQ(spans[2].range, (TextRange{13, 2}));
+
+  tree.applyDeletion({5, 8}); // tail of bold, all of italic, head of link
+  spans = tree.intervals();
+  ASSERT_EQ(spans.size(), 2u);
+  EXPECT_EQ(spans[0].range, (TextRange{0, 5}));
+  EXPECT_EQ(spans[0].type, StyleType::Bold);
+  EXPECT_EQ(spans[1].range, (TextRange{5, 2}));
+  EXPECT_EQ(spans[1].type, StyleType::Link);
+}
+
+TEST(StyleIntervalTreeTest, MatchesNaiveModel) {
+  std::mt19937 rng(7);
+  StyleIntervalTree tree;
+  std::vector<StyleMask> model(200, 0);
+  const StyleType types[] = {StyleType::Bold, StyleType::Italic,
+                             StyleType::Link};
+
+  for (int step = 0; step < 3000; step++) {
+    size_t len = model.size();
+    switch (rng() % 4) {
+    case 0: {
+      size_t pos = rng() % len;
+      size_t n = std::min<size_t>(1 + rng() % 20, len - pos);
+      StyleType type = types[rng() % 3];
+      tree.add({{pos, n}, type});
+      for (size_t i = pos; i < pos + n; i++)
+        model[i] |= styleBit(type);
+      break;
+    }
+    case 1: {
+      size_t pos = rng() % len;
+      size_t n = std::min<size_t>(1 + rng() % 20, len - pos);
+      StyleType type = types[rng() % 3];
+      tree.remove({pos, n}, type);
+      for (size_t i = pos; i < pos + n; i++)
+        model[i] &= ~styleBit(type);
+      break;
+    }
+    case 2: {
+      size_t pos = rng() % (len + 1);
+      size_t n = 1 + rng() % 5;
+      tree.applyInsertion(pos, n);
+      // Inserted text inherits styles spanning both of its neighbours.
+      StyleMask inherited =
+          pos > 0 && pos < len ? (model[pos - 1] & model[pos]) : 0;
+      model.insert(model.begin() + pos, n, inherited);
+      break;
+    }
+    case 3: {
+      if (len < 20)
+        break;
+      size_t pos = rng() % len;
+      size_t n = std::min<size_t>(1 + rng() % 5, len - pos);
+      tree.applyDeletion({pos, n});
+      model.erase(model.begin() + pos, model.begin() + pos + n);
+      break;
+    }
+    }
+
+    size_t probe = rng() % model.size();
+    ASSERT_EQ(tree.stylesAt(probe), model[probe]) << "step " << step;
+    size_t from = rng() % model.size();
+    size_t to = std::min(model.size(), from + 1 + rng() % 30);
+    StyleMask expected = 0;
+    StyleMask covering = ~StyleMask(0);
+    for (size_t i = from; i < to; i++) {
+      expected |= model[i];
+      covering &= model[i];
+    }
+    ASSERT_EQ(tree.stylesIntersecting({from, to - from}), expected);
+    ASSERT_EQ(tree.stylesCovering({from, to - from}), covering);
+  }
+}
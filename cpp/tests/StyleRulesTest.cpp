@@ -0,0 +1,88 @@
+#include "StyleRules.hpp"
+#include <gtest/gtest.h>
+
+using namespace enriched;
+
+static_assert(kDefaultStyleRules[static_cast<size_t>(StyleType::Bold)].blocks ==
+                  styleBit(StyleType::CodeBlock),
+              "the table is built at compile time");
+
+TEST(StyleRulesTest, BlockStylesReplaceEachOther) {
+  StyleRules rules;
+  for (StyleType type :
+       {StyleType::H1, StyleType::H4, StyleType::OrderedList,
+        StyleType::CheckboxList, StyleType::BlockQuote, StyleType::CodeBlock}) {
+    EXPECT_EQ(rules.conflicts(type) & styleBit(type), 0u);
+    EXPECT_NE(rules.conflicts(type) & styleBit(StyleType::UnorderedList), 0u);
+    EXPECT_EQ(rules.blocks(type), 0u);
+  }
+  EXPECT_NE(rules.conflicts(StyleType::CodeBlock) & styleBit(StyleType::Bold),
+            0u);
+  EXPECT_EQ(rules.conflicts(StyleType::BlockQuote) & styleBit(StyleType::Bold),
+            0u);
+  EXPECT_EQ(rules.conflicts(StyleType::Alignment), 0u);
+  EXPECT_EQ(rules.conflicts(StyleType::None), 0u);
+}
+
+TEST(StyleRulesTest, Resolve) {
+  StyleRules rules;
+  StyleMask active = styleMask(
+      {StyleType::Bold, StyleType::Link, StyleType::UnorderedList});
+
+  StyleResolution code = rules.resolve(StyleType::InlineCode, active);
+  EXPECT_FALSE(code.blocked);
+  EXPECT_EQ(code.removed, styleBit(StyleType::Link));
+
+  StyleResolution heading = rules.resolve(StyleType::H2, active);
+  EXPECT_FALSE(heading.blocked);
+  EXPECT_EQ(heading.removed, styleBit(StyleType::UnorderedList));
+
+  active |= styleBit(StyleType::CodeBlock);
+  EXPECT_TRUE(rules.resolve(StyleType::Italic, active).blocked);
+  EXPECT_TRUE(rules.resolve(StyleType::Mention, active).blocked);
+  EXPECT_FALSE(rules.resolve(StyleType::H2, active).blocked);
+}
+
+TEST(StyleRulesTest, HeadingBold) {
+  StyleRules rules;
+  StyleMask heading = styleBit(StyleType::H3);
+  EXPECT_FALSE(rules.resolve(StyleType::Bold, heading).blocked);
+
+  rules.setHeadingBold(StyleType::H3, true);
+  EXPECT_TRUE(rules.resolve(StyleType::Bold, heading).blocked);
+  EXPECT_FALSE(
+      rules.resolve(StyleType::Bold, styleBit(StyleType::H2)).blocked);
+  EXPECT_EQ(rules.resolve(StyleType::H3, styleBit(StyleType::Bold)).removed,
+            styleBit(StyleType::Bold));
+
+  rules.setHeadingBold(StyleType::H3, false);
+  EXPECT_FALSE(rules.resolve(StyleType::Bold, heading).blocked);
+  EXPECT_EQ(rules.conflicts(StyleType::H3) & styleBit(StyleType::Bold), 0u);
+
+  // Only headings can be bold
+  rules.setHeadingBold(StyleType::Italic, true);
+  EXPECT_EQ(rules.blocks(StyleType::Bold), styleBit(StyleType::CodeBlock));
+}
+
+TEST(StyleRulesTest, BlockedBy) {
+  StyleRules rules;
+  EXPECT_EQ(rules.blockedBy(0), 0u);
+  EXPECT_EQ(rules.blockedBy(styleBit(StyleType::InlineCode)),
+            styleMask({StyleType::Link, StyleType::Mention, StyleType::Image}));
+  EXPECT_EQ(rules.blockedBy(styleBit(StyleType::CodeBlock)),
+            styleMask({StyleType::Bold, StyleType::Italic,
+                       StyleType::Underline, StyleType::Strikethrough,
+                       StyleType::InlineCode, StyleType::Link,
+                       StyleType::Mention}));
+
+  rules.setHeadingBold(StyleType::H1, true);
+  EXPECT_EQ(rules.blockedBy(styleBit(StyleType::H1)),
+            styleBit(StyleType::Bold));
+
+  StyleMask seen = 0;
+  for (StyleMask mask = rules.blockedBy(styleBit(StyleType::InlineCode));
+       mask != 0; mask &= mask - 1)
+    seen |= styleBit(firstStyle(mask));
+  EXPECT_EQ(seen,
+            styleMask({StyleType::Link, StyleType::Mention, StyleType::Image}));
+}
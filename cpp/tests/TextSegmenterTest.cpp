@@ -0,0 +1,155 @@
+#include "TextSegmenter.hpp"
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace enriched;
+
+namespace {
+
+std::vector<std::u16string> split(const std::u16string &text,
+                                  TextRange (*segment)(const std::u16string &,
+                                                       size_t)) {
+  std::vector<std::u16string> parts;
+  size_t p = 0;
+  while (p < text.size()) {
+    TextRange range = segment(text, p);
+    if (range.start != p || range.length == 0)
+      break;
+    parts.push_back(text.substr(range.start, range.length));
+    p = range.end();
+  }
+  return parts;
+}
+
+std::vector<std::u16string> graphemes(const std::u16string &text) {
+  return split(text, graphemeAt);
+}
+
+std::vector<std::u16string> words(const std::u16string &text) {
+  return split(text, wordSegmentAt);
+}
+
+using Parts = std::vector<std::u16string>;
+
+} // namespace
+
+TEST(TextSegmenterTest, Graphemes) {
+  // Combining marks, CR LF and Hangul jamo
+  EXPECT_EQ(graphemes(u"e\u0301a\r\nb"),
+            (Parts{u"e\u0301", u"a", u"\r\n", u"b"}));
+  EXPECT_EQ(graphemes(u"\u1100\u1161\u11A8\uAC00"),
+            (Parts{u"\u1100\u1161\u11A8", u"\uAC00"}));
+  // ZWJ family, skin tone and flags; regional indicators pair up
+  std::u16string family = u"\U0001F468\u200D\U0001F469\u200D\U0001F467";
+  std::u16string thumb = u"\U0001F44D\U0001F3FD";
+  EXPECT_EQ(graphemes(family + thumb), (Parts{family, thumb}));
+  EXPECT_EQ(graphemes(u"\U0001F1F5\U0001F1F1\U0001F1FA\U0001F1F8\U0001F1E6"),
+            (Parts{u"\U0001F1F5\U0001F1F1", u"\U0001F1FA\U0001F1F8",
+                   u"\U0001F1E6"}));
+  // Devanagari conjunct: consonant, virama, consonant (GB9c)
+  EXPECT_EQ(graphemes(u"\u0915\u094D\u0937a"),
+            (Parts{u"\u0915\u094D\u0937", u"a"}));
+  // ZWJ after a letter doesn't join the next pictographic
+  EXPECT_EQ(graphemes(u"a\u200D\U0001F600"),
+            (Parts{u"a\u200D", u"\U0001F600"}));
+}
+
+TEST(TextSegmenterTest, GraphemeAtAnyIndex) {
+  std::u16string text = u"x\U0001F44D\U0001F3FDy";
+  EXPECT_EQ(graphemeAt(text, 0), (TextRange{0, 1}));
+  for (size_t i = 1; i < 5; i++)
+    EXPECT_EQ(graphemeAt(text, i), (TextRange{1, 4})) << i;
+  EXPECT_EQ(graphemeAt(text, 5), (TextRange{5, 1}));
+  EXPECT_EQ(graphemeAt(text, 6), (TextRange{6, 0}));
+  // Unpaired surrogates are clusters of their own
+  EXPECT_EQ(graphemes(u"\xD800"
+                      u"a\xDC00"),
+            (Parts{u"\xD800", u"a", u"\xDC00"}));
+}
+
+TEST(TextSegmenterTest, Words) {
+  EXPECT_EQ(words(u"can't stop"), (Parts{u"can't", u" ", u"stop"}));
+  EXPECT_EQ(words(u"pi is 3.14, e=2,71."),
+            (Parts{u"pi", u" ", u"is", u" ", u"3.14", u",", u" ", u"e", u"=",
+                   u"2,71", u"."}));
+  EXPECT_EQ(words(u"snake_case  x"), (Parts{u"snake_case", u"  ", u"x"}));
+  EXPECT_EQ(words(u"\u30AB\u30BF\u30AB\u30CA\u6F22"),
+            (Parts{u"\u30AB\u30BF\u30AB\u30CA", u"\u6F22"}));
+  // Marks and format characters attach to the word before them
+  EXPECT_EQ(words(u"cafe\u0301\u00AD!"), (Parts{u"cafe\u0301\u00AD", u"!"}));
+  // URLs and mentions are several words
+  EXPECT_EQ(words(u"@ann"), (Parts{u"@", u"ann"}));
+  EXPECT_EQ(words(u"a.com/b").size(), 3u);
+}
+
+TEST(TextSegmenterTest, Tokens) {
+  // No-break space separates too
+  std::u16string text = u"see www.example.com/a?b=1 @ann\u00A0ok";
+  EXPECT_EQ(tokenAt(text, 0), (TextRange{0, 3}));
+  EXPECT_EQ(tokenAt(text, 3), (TextRange{0, 3}));
+  EXPECT_EQ(tokenAt(text, 10), (TextRange{4, 21}));
+  EXPECT_EQ(tokenAt(text, 27), (TextRange{26, 4}));
+  EXPECT_EQ(tokensIn(text), (std::vector<TextRange>{
+                                {0, 3}, {4, 21}, {26, 4}, {31, 2}}));
+
+  // Between two spaces the token is empty
+  EXPECT_EQ(tokenAt(u"a  b", 2), (TextRange{2, 0}));
+  // A mark after a space belongs to the space's cluster
+  EXPECT_EQ(tokensIn(u"a \u0301b"),
+            (std::vector<TextRange>{{0, 1}, {3, 1}}));
+  // U+200B isn't white space
+  EXPECT_EQ(tokenAt(u"a\u200Bb c", 1), (TextRange{0, 3}));
+  // A caret inside an emoji snaps to its start
+  EXPECT_EQ(tokenAt(u"x \U0001F600y", 3), (TextRange{2, 3}));
+}
+
+TEST(TextSegmenterTest, TokensInRange) {
+  std::u16string text = u"one two three four";
+  std::vector<TextRange> tokens;
+  ASSERT_TRUE(tokensIn(TextWindow(text), {5, 4}, tokens));
+  EXPECT_EQ(tokens, (std::vector<TextRange>{{4, 3}, {8, 5}}));
+  tokens.clear();
+  ASSERT_TRUE(tokensIn(TextWindow(text), {7, 1}, tokens));
+  EXPECT_EQ(tokens, (std::vector<TextRange>{{4, 3}, {8, 5}}));
+}
+
+TEST(TextSegmenterTest, Windows) {
+  std::u16string text =
+      u"alpha beta\U0001F1F5\U0001F1F1\U0001F1FA\U0001F1F8 gamma";
+  // A window around "beta" needs the spaces and the character before the
+  // first one, which could be a prepended mark holding on to it
+  TextWindow window(text.data() + 4, 4, 16, text.size());
+  TextRange token;
+  ASSERT_TRUE(tokenAt(window, 8, token));
+  EXPECT_EQ(token, (TextRange{6, 12}));
+
+  // One that cuts the token short asks for more
+  TextWindow narrow(text.data() + 7, 7, 4, text.size());
+  EXPECT_FALSE(tokenAt(narrow, 8, token));
+  std::vector<TextRange> tokens{{0, 1}};
+  EXPECT_FALSE(tokensIn(narrow, {8, 1}, tokens));
+  EXPECT_EQ(tokens.size(), 1u);
+
+  // Flags need every regional indicator before them for pairing, and the
+  // character after them to end the cluster
+  TextRange grapheme;
+  TextWindow flags(text.data() + 14, 14, 5, text.size());
+  EXPECT_FALSE(graphemeAt(flags, 14, grapheme));
+  TextWindow wider(text.data() + 9, 9, 10, text.size());
+  ASSERT_TRUE(graphemeAt(wider, 15, grapheme));
+  EXPECT_EQ(grapheme, (TextRange{14, 4}));
+
+  // Outside the window
+  EXPECT_FALSE(wordSegmentAt(window, 2, token));
+}
+
+TEST(TextSegmenterTest, WhiteSpace) {
+  for (char32_t c : {U' ', U'\t', U'\n', U'\u00A0', U'\u2003', U'\u3000',
+                     U'\u2028'})
+    EXPECT_TRUE(isWhiteSpace(c)) << unsigned(c);
+  for (char32_t c : {U'a', U'\u200B', U'\u200D', U'\uFEFF'})
+    EXPECT_FALSE(isWhiteSpace(c)) << unsigned(c);
+  EXPECT_STREQ(segmentationUnicodeVersion(), "16.0.0");
+}
@@ -0,0 +1,84 @@
+#include "PlainText.hpp"
+#include "VisibleIndex.hpp"
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace enriched;
+
+TEST(VisibleIndexTest, Lookups) {
+  VisibleIndex index(u"\u200Bab\u200B\u200Bc");
+  EXPECT_EQ(index.length(), 6u);
+  EXPECT_EQ(index.visibleLength(), 3u);
+  EXPECT_EQ(index.anchorCount(), 3u);
+
+  EXPECT_EQ(index.storageIndex(0), 0u);
+  EXPECT_EQ(index.storageIndex(1), 2u);
+  EXPECT_EQ(index.storageIndex(2), 3u);
+  EXPECT_EQ(index.storageIndex(3), 6u);
+  EXPECT_EQ(index.storageIndex(10), 6u);
+
+  EXPECT_EQ(index.visibleIndex(0), 0u);
+  EXPECT_EQ(index.visibleIndex(1), 0u);
+  EXPECT_EQ(index.visibleIndex(3), 2u);
+  EXPECT_EQ(index.visibleIndex(5), 2u);
+  EXPECT_EQ(index.visibleIndex(6), 3u);
+}
+
+TEST(VisibleIndexTest, EmptyText) {
+  VisibleIndex index;
+  EXPECT_EQ(index.length(), 0u);
+  EXPECT_EQ(index.storageIndex(0), 0u);
+  EXPECT_EQ(index.visibleIndex(0), 0u);
+
+  index.applyEdit({0, 0}, u"\u200B");
+  EXPECT_EQ(index.length(), 1u);
+  EXPECT_EQ(index.visibleLength(), 0u);
+  EXPECT_EQ(index.storageIndex(0), 0u);
+  EXPECT_EQ(index.visibleIndex(1), 0u);
+}
+
+TEST(VisibleIndexTest, Edits) {
+  VisibleIndex index(u"ab\u200Bcd");
+
+  // Typing between anchors only shifts offsets.
+  index.applyEdit({4, 0}, u"xx");
+  EXPECT_EQ(index.anchorCount(), 1u);
+  EXPECT_EQ(index.storageIndex(4), 5u);
+
+  // An anchor inserted in front of a new list item.
+  index.applyEdit({0, 0}, u"\u200B");
+  EXPECT_EQ(index.anchorCount(), 2u);
+  EXPECT_EQ(index.storageIndex(0), 0u);
+  EXPECT_EQ(index.storageIndex(1), 2u);
+
+  // Removing a range with both anchors in it.
+  index.applyEdit({0, 5}, u"");
+  EXPECT_EQ(index.anchorCount(), 0u);
+  EXPECT_EQ(index.length(), 3u);
+  EXPECT_EQ(index.storageIndex(2), 2u);
+}
+
+TEST(VisibleIndexTest, MatchesPlainText) {
+  std::mt19937 rng(5);
+  std::u16string text;
+  VisibleIndex index;
+
+  for (int step = 0; step < 2000; step++) {
+    size_t pos = rng() % (text.size() + 1);
+    size_t removed = std::min<size_t>(rng() % 4, text.size() - pos);
+    std::u16string inserted;
+    for (size_t i = rng() % 4; i > 0; i--)
+      inserted += rng() % 3 == 0 ? kZeroWidthSpace : u'a';
+    index.applyEdit({pos, removed}, inserted);
+    text.replace(pos, removed, inserted);
+
+    PlainText plain = extractPlainText(text);
+    ASSERT_EQ(index.length(), text.size());
+    ASSERT_EQ(index.visibleLength(), plain.text.size());
+    for (size_t i = 0; i <= plain.text.size(); i++)
+      ASSERT_EQ(index.storageIndex(i), plain.storageIndex(i));
+    for (size_t i = 0; i <= text.size(); i++)
+      ASSERT_EQ(index.visibleIndex(i), plain.visibleIndex(i));
+  }
+}
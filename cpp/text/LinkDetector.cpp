@@ -0,0 +1,74 @@
+#include "LinkDetector.hpp"
+
+#include "TextSegmenter.hpp"
+
+namespace enriched {
+
+namespace {
+
+// A full URL, a www. prefixed host or a bare host. Compiled case-insensitive,
+// so "EXAMPLE.COM" links too; any TLD of two or more letters is accepted.
+#define ENRICHED_URL_TAIL                                                      \
+  u"[-a-z0-9@:%._\\+~#=]{1,256}\\.[a-z]{2,}\\b"                                \
+  u"([-a-z0-9@:%_\\+.~#?&//=]*)"
+const char16_t kDefaultPattern[] = u"http(s)?:\\/\\/www\\." ENRICHED_URL_TAIL
+    u"|www\\." ENRICHED_URL_TAIL u"|" ENRICHED_URL_TAIL;
+#undef ENRICHED_URL_TAIL
+
+constexpr char16_t kZeroWidthSpace = 0x200B;
+
+std::unique_ptr<RegexDfa> compileDefaultPattern() {
+  RegexOptions options;
+  options.caseInsensitive = true;
+  return RegexDfa::compile(kDefaultPattern, options);
+}
+
+} // namespace
+
+LinkDetector::LinkDetector() : LinkDetector(compileDefaultPattern(), true) {}
+
+LinkDetector::LinkDetector(std::unique_ptr<RegexDfa> regex, bool isDefault)
+    : regex_(std::move(regex)), isDefault_(isDefault) {}
+
+std::unique_ptr<LinkDetector>
+LinkDetector::fromConfig(const LinkRegexConfig &config, std::string *error) {
+  if (config.isDisabled)
+    return std::unique_ptr<LinkDetector>(new LinkDetector(nullptr, false));
+  if (config.isDefault)
+    return std::make_unique<LinkDetector>();
+
+  RegexOptions options;
+  options.caseInsensitive = config.caseInsensitive;
+  options.dotAll = config.dotAll;
+  auto regex = RegexDfa::compile(config.pattern, options, error);
+  if (!regex)
+    return nullptr;
+  return std::unique_ptr<LinkDetector>(
+      new LinkDetector(std::move(regex), false));
+}
+
+bool LinkDetector::matches(const char16_t *word, size_t length) const {
+  return regex_ && regex_->search(word, length);
+}
+
+std::vector<TextRange> LinkDetector::detect(const char16_t *text,
+                                            size_t length,
+                                            TextRange range) const {
+  std::vector<TextRange> links;
+  if (!regex_)
+    return links;
+
+  std::vector<TextRange> words;
+  tokensIn(TextWindow(text, length), range, words);
+  for (TextRange word : words) {
+    size_t wordStart = word.start;
+    if (text[wordStart] == kZeroWidthSpace)
+      wordStart++;
+    if (wordStart < word.end() &&
+        matches(text + wordStart, word.end() - wordStart))
+      links.push_back({wordStart, word.end() - wordStart});
+  }
+  return links;
+}
+
+} // namespace enriched
@@ -0,0 +1,70 @@
+/**
+ * Automatic link detection shared by both platforms.
+ */
+
+#pragma once
+
+#include "RegexDfa.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace enriched {
+
+/** Mirrors `LinkNativeRegex` from src/utils/regexParser.ts. */
+struct LinkRegexConfig {
+  std::u16string pattern;
+  bool caseInsensitive = false;
+  bool dotAll = false;
+  bool isDisabled = false;
+  bool isDefault = true;
+};
+
+/**
+ * Finds links in whitespace-separated words (TextSegmenter tokens). The
+ * default grammar is the URL pattern the iOS input has always used
+ * (`http(s)://www.` prefixed, `www.` prefixed and bare domains with an
+ * optional path); user patterns are compiled with RegexDfa.
+ *
+ * Like RegexDfa, an instance must not be used from several threads at once.
+ */
+class LinkDetector {
+public:
+  /** Detector for the default URL grammar. */
+  LinkDetector();
+
+  /**
+   * Returns nullptr when the user pattern is outside the RegexDfa subset,
+   * so the caller can keep using its platform regex for that config.
+   * Disabled and default configs always succeed.
+   */
+  static std::unique_ptr<LinkDetector>
+  fromConfig(const LinkRegexConfig &config, std::string *error = nullptr);
+
+  bool isDisabled() const { return !regex_; }
+  bool isDefault() const { return isDefault_; }
+
+  /** True if the pattern matches anywhere in the word. */
+  bool matches(const char16_t *word, size_t length) const;
+
+  /**
+   * Scans the words overlapping `range` (extended to word boundaries) and
+   * returns the link ranges in text coordinates. A word the pattern matches
+   * anywhere becomes a link as a whole, as iOS has always linked it; a
+   * leading zero-width space is never part of a link.
+   */
+  std::vector<TextRange> detect(const char16_t *text, size_t length,
+                                TextRange range) const;
+  std::vector<TextRange> detect(const std::u16string &text) const {
+    return detect(text.data(), text.size(), {0, text.size()});
+  }
+
+private:
+  explicit LinkDetector(std::unique_ptr<RegexDfa> regex, bool isDefault);
+
+  std::unique_ptr<RegexDfa> regex_;
+  bool isDefault_;
+};
+
+} // namespace enriched
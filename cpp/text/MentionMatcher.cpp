@@ -0,0 +1,60 @@
+#include "MentionMatcher.hpp"
+
+#include <algorithm>
+
+namespace enriched {
+
+void MentionMatcher::reset(const std::vector<std::u16string> &indicators) {
+  indicators_ = indicators;
+  nodes_.assign(1, Node());
+
+  for (size_t i = 0; i < indicators_.size(); i++) {
+    const std::u16string &indicator = indicators_[i];
+    if (indicator.empty())
+      continue;
+    uint32_t node = kRoot;
+    for (char16_t c : indicator) {
+      std::vector<Edge> &edges = nodes_[node].edges;
+      auto it = std::lower_bound(
+          edges.begin(), edges.end(), c,
+          [](const Edge &edge, char16_t value) { return edge.c < value; });
+      if (it != edges.end() && it->c == c) {
+        node = it->target;
+        continue;
+      }
+      uint32_t target = static_cast<uint32_t>(nodes_.size());
+      edges.insert(it, {c, target});
+      nodes_.emplace_back();
+      node = target;
+    }
+    if (nodes_[node].terminal == kNoMatch)
+      nodes_[node].terminal = static_cast<int>(i);
+  }
+}
+
+uint32_t MentionMatcher::child(uint32_t node, char16_t c) const {
+  const std::vector<Edge> &edges = nodes_[node].edges;
+  auto it = std::lower_bound(
+      edges.begin(), edges.end(), c,
+      [](const Edge &edge, char16_t value) { return edge.c < value; });
+  return it != edges.end() && it->c == c ? it->target : kRoot;
+}
+
+int MentionMatcher::indicatorAtStart(const char16_t *word,
+                                     size_t length) const {
+  // Indicators the word starts with lie on one path; keep the one
+  // configured first.
+  int best = kNoMatch;
+  uint32_t node = kRoot;
+  for (size_t i = 0; i < length; i++) {
+    node = child(node, word[i]);
+    if (node == kRoot)
+      break;
+    int terminal = nodes_[node].terminal;
+    if (terminal != kNoMatch && (best == kNoMatch || terminal < best))
+      best = terminal;
+  }
+  return best;
+}
+
+} // namespace enriched
@@ -0,0 +1,64 @@
+/**
+ * Prefix matcher for mention indicators.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace enriched {
+
+/**
+ * Trie over the configured indicators, built once when they change.
+ * Lookups cost O(word length) regardless of how many indicators there are.
+ *
+ * When several indicators apply, the one configured first wins, the same
+ * way the ordered regex alternation it replaces behaved. Empty indicators
+ * are ignored.
+ */
+class MentionMatcher {
+public:
+  static constexpr int kNoMatch = -1;
+
+  MentionMatcher() { reset({}); }
+  explicit MentionMatcher(const std::vector<std::u16string> &indicators) {
+    reset(indicators);
+  }
+
+  void reset(const std::vector<std::u16string> &indicators);
+
+  size_t indicatorCount() const { return indicators_.size(); }
+  const std::u16string &indicator(size_t index) const {
+    return indicators_[index];
+  }
+
+  /** Index of the indicator the word starts with, or kNoMatch. */
+  int indicatorAtStart(const char16_t *word, size_t length) const;
+  int indicatorAtStart(const std::u16string &word) const {
+    return indicatorAtStart(word.data(), word.size());
+  }
+
+private:
+  static constexpr uint32_t kRoot = 0;
+
+  struct Edge {
+    char16_t c;
+    uint32_t target;
+  };
+
+  struct Node {
+    std::vector<Edge> edges; // sorted by character
+    /** Indicator spelled by this node, kNoMatch if none. */
+    int terminal = kNoMatch;
+  };
+
+  /** Child node or kRoot (the root is never a child). */
+  uint32_t child(uint32_t node, char16_t c) const;
+
+  std::vector<std::u16string> indicators_;
+  std::vector<Node> nodes_;
+};
+
+} // namespace enriched
@@ -0,0 +1,125 @@
+#include "PlainText.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace enriched {
+
+namespace {
+
+constexpr size_t kBlock = 8;
+
+/** Does any of the kBlock code units at `p` equal `a` or `b`? */
+inline bool blockContains(const char16_t *p, char16_t a, char16_t b) {
+#if defined(__SSE2__)
+  __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+  __m128i hits =
+      _mm_or_si128(_mm_cmpeq_epi16(chunk, _mm_set1_epi16(a)),
+                   _mm_cmpeq_epi16(chunk, _mm_set1_epi16(b)));
+  return _mm_movemask_epi8(hits) != 0;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  uint16x8_t chunk = vld1q_u16(reinterpret_cast<const uint16_t *>(p));
+  uint16x8_t hits = vorrq_u16(vceqq_u16(chunk, vdupq_n_u16(a)),
+                              vceqq_u16(chunk, vdupq_n_u16(b)));
+  return vmaxvq_u16(hits) != 0;
+#else
+  for (size_t i = 0; i < kBlock; i++)
+    if (p[i] == a || p[i] == b)
+      return true;
+  return false;
+#endif
+}
+
+/**
+ * Shared driver: copies runs of ordinary text with memmove and calls
+ * `onRemoved(storageIndex)` for every dropped code unit.
+ */
+template <typename OnRemoved>
+size_t extract(const char16_t *data, size_t length, char16_t *out,
+               const PlainTextOptions &options, OnRemoved onRemoved) {
+  char16_t replacement = options.attachmentReplacement;
+  // With attachments left alone only zero-width spaces need a look.
+  char16_t other =
+      replacement == kObjectReplacement ? kZeroWidthSpace : kObjectReplacement;
+
+  size_t written = 0;
+  auto copyOne = [&](size_t i) {
+    char16_t c = data[i];
+    if (c == kZeroWidthSpace) {
+      onRemoved(i);
+    } else if (c == kObjectReplacement && replacement != kObjectReplacement) {
+      if (replacement == 0)
+        onRemoved(i);
+      else
+        out[written++] = replacement;
+    } else {
+      out[written++] = c;
+    }
+  };
+
+  size_t i = 0;
+  size_t runStart = 0;
+  for (; i + kBlock <= length; i += kBlock) {
+    if (!blockContains(data + i, kZeroWidthSpace, other))
+      continue;
+    // Flush the clean run before this block, then handle it unit by unit.
+    std::memmove(out + written, data + runStart,
+                 (i - runStart) * sizeof(char16_t));
+    written += i - runStart;
+    for (size_t j = i; j < i + kBlock; j++)
+      copyOne(j);
+    runStart = i + kBlock;
+  }
+  std::memmove(out + written, data + runStart,
+               (i - runStart) * sizeof(char16_t));
+  written += i - runStart;
+  for (; i < length; i++)
+    copyOne(i);
+  return written;
+}
+
+} // namespace
+
+size_t PlainText::storageIndex(size_t visibleIndex) const {
+  // removed[j] - j is the visible index at the j-th dropped unit and never
+  // decreases; every dropped unit before the target shifts it by one.
+  size_t low = 0, high = removed.size();
+  while (low < high) {
+    size_t mid = (low + high) / 2;
+    if (removed[mid] - mid < visibleIndex)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return std::min(visibleIndex + low, text.size() + removed.size());
+}
+
+size_t PlainText::visibleIndex(size_t storageIndex) const {
+  auto before = std::lower_bound(removed.begin(), removed.end(), storageIndex);
+  return storageIndex - static_cast<size_t>(before - removed.begin());
+}
+
+PlainText extractPlainText(const char16_t *data, size_t length,
+                           const PlainTextOptions &options) {
+  PlainText result;
+  result.text.resize(length);
+  size_t written =
+      extract(data, length, &result.text[0], options, [&](size_t index) {
+        result.removed.push_back(static_cast<uint32_t>(index));
+      });
+  result.text.resize(written);
+  return result;
+}
+
+size_t stripPlainText(const char16_t *data, size_t length, char16_t *out,
+                      const PlainTextOptions &options) {
+  return extract(data, length, out, options, [](size_t) {});
+}
+
+} // namespace enriched
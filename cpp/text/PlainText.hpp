@@ -0,0 +1,60 @@
+/**
+ * Plain-text extraction from the inputs' storage strings.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace enriched {
+
+/** Anchors empty paragraphs and lists; never part of the user's text. */
+constexpr char16_t kZeroWidthSpace = u'\u200B';
+/** Placeholder character carrying an image attachment. */
+constexpr char16_t kObjectReplacement = u'\uFFFC';
+
+struct PlainTextOptions {
+  /** What an attachment placeholder becomes; 0 drops it. */
+  char16_t attachmentReplacement = kObjectReplacement;
+};
+
+/**
+ * Visible text of a storage string together with the storage positions that
+ * were dropped, which is all that's needed to translate indices both ways.
+ */
+struct PlainText {
+  std::u16string text;
+  std::vector<uint32_t> removed; // sorted storage indices
+
+  /**
+   * First storage index whose visible index is `visibleIndex`, so a
+   * position right before a run of zero-width spaces maps to the start of
+   * the run. Indices past the end clamp to the storage length.
+   */
+  size_t storageIndex(size_t visibleIndex) const;
+  /** Number of visible characters before `storageIndex`. */
+  size_t visibleIndex(size_t storageIndex) const;
+};
+
+/**
+ * One pass over `data` that removes zero-width spaces and maps attachment
+ * placeholders. Blocks without either character are copied whole; with
+ * SSE2 or NEON checking a block costs a couple of vector compares.
+ */
+PlainText extractPlainText(const char16_t *data, size_t length,
+                           const PlainTextOptions &options = {});
+inline PlainText extractPlainText(const std::u16string &text,
+                                  const PlainTextOptions &options = {}) {
+  return extractPlainText(text.data(), text.size(), options);
+}
+
+/**
+ * Text only, without the index mapping. `out` must have room for `length`
+ * code units and may alias `data`. Returns the number written.
+ */
+size_t stripPlainText(const char16_t *data, size_t length, char16_t *out,
+                      const PlainTextOptions &options = {});
+
+} // namespace enriched
@@ -0,0 +1,952 @@
+#include "RegexDfa.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace enriched {
+
+namespace {
+
+/* --- character sets --- */
+
+struct CharRange {
+  char16_t lo, hi; // inclusive
+};
+
+using CharSet = std::vector<CharRange>;
+
+const CharSet kDigits = {{u'0', u'9'}};
+const CharSet kWordChars = {{u'0', u'9'}, {u'A', u'Z'}, {u'_', u'_'},
+                            {u'a', u'z'}};
+const CharSet kSpaces = {{u'\t', u'\r'},         {u' ', u' '},
+                         {0x00A0, 0x00A0},       {0x1680, 0x1680},
+                         {0x2000, 0x200A},       {0x2028, 0x2029},
+                         {0x202F, 0x202F},       {0x205F, 0x205F},
+                         {0x3000, 0x3000},       {0xFEFF, 0xFEFF}};
+const CharSet kLineTerminators = {
+    {u'\n', u'\n'}, {u'\r', u'\r'}, {0x2028, 0x2029}};
+
+void normalize(CharSet &set) {
+  std::sort(set.begin(), set.end(),
+            [](CharRange a, CharRange b) { return a.lo < b.lo; });
+  size_t out = 0;
+  for (const CharRange &range : set) {
+    if (out > 0 && range.lo <= static_cast<uint32_t>(set[out - 1].hi) + 1)
+      set[out - 1].hi = std::max(set[out - 1].hi, range.hi);
+    else
+      set[out++] = range;
+  }
+  set.resize(out);
+}
+
+CharSet negate(CharSet set) {
+  normalize(set);
+  CharSet out;
+  uint32_t next = 0;
+  for (const CharRange &range : set) {
+    if (range.lo > next)
+      out.push_back({static_cast<char16_t>(next),
+                     static_cast<char16_t>(range.lo - 1)});
+    next = static_cast<uint32_t>(range.hi) + 1;
+  }
+  if (next <= 0xFFFF)
+    out.push_back({static_cast<char16_t>(next), 0xFFFF});
+  return out;
+}
+
+void append(CharSet &set, const CharSet &other) {
+  set.insert(set.end(), other.begin(), other.end());
+}
+
+void foldAsciiCase(CharSet &set) {
+  size_t count = set.size();
+  for (size_t i = 0; i < count; i++) {
+    uint32_t lo = set[i].lo, hi = set[i].hi;
+    uint32_t upperLo = std::max<uint32_t>(lo, 'A');
+    uint32_t upperHi = std::min<uint32_t>(hi, 'Z');
+    if (upperLo <= upperHi)
+      set.push_back({static_cast<char16_t>(upperLo + 32),
+                     static_cast<char16_t>(upperHi + 32)});
+    uint32_t lowerLo = std::max<uint32_t>(lo, 'a');
+    uint32_t lowerHi = std::min<uint32_t>(hi, 'z');
+    if (lowerLo <= lowerHi)
+      set.push_back({static_cast<char16_t>(lowerLo - 32),
+                     static_cast<char16_t>(lowerHi - 32)});
+  }
+  normalize(set);
+}
+
+bool isWordChar(char16_t c) {
+  return (c >= u'0' && c <= u'9') || (c >= u'A' && c <= u'Z') ||
+         (c >= u'a' && c <= u'z') || c == u'_';
+}
+
+int hexValue(char16_t c) {
+  if (c >= u'0' && c <= u'9')
+    return c - u'0';
+  if (c >= u'a' && c <= u'f')
+    return c - u'a' + 10;
+  if (c >= u'A' && c <= u'F')
+    return c - u'A' + 10;
+  return -1;
+}
+
+/* --- syntax tree --- */
+
+enum class Assertion : uint8_t {
+  BeginText,
+  EndText,
+  WordBoundary,
+  NotWordBoundary
+};
+
+constexpr int kUnbounded = -1;
+constexpr int kMaxRepeat = 1000;
+
+struct Node {
+  enum Kind : uint8_t { Empty, Chars, Concat, Alternate, Repeat, Assert };
+
+  Kind kind = Empty;
+  CharSet chars;
+  std::vector<int> children;
+  int min = 0, max = 0;
+  Assertion assertion = Assertion::BeginText;
+};
+
+class Parser {
+public:
+  Parser(const std::u16string &pattern, RegexOptions options,
+         std::vector<Node> &nodes)
+      : pattern_(pattern), options_(options), nodes_(nodes) {}
+
+  int parse(std::string &error) {
+    int root = parseAlternation();
+    if (root >= 0 && pos_ < pattern_.size())
+      root = fail("unmatched )");
+    error = error_;
+    return root;
+  }
+
+private:
+  bool atEnd() const { return pos_ >= pattern_.size(); }
+  char16_t peek(size_t offset = 0) const {
+    return pos_ + offset < pattern_.size() ? pattern_[pos_ + offset] : 0;
+  }
+
+  int fail(const char *message) {
+    if (error_.empty())
+      error_ = message;
+    return -1;
+  }
+
+  int add(Node node) {
+    nodes_.push_back(std::move(node));
+    return static_cast<int>(nodes_.size()) - 1;
+  }
+
+  int addChars(CharSet chars) {
+    if (options_.caseInsensitive)
+      foldAsciiCase(chars);
+    else
+      normalize(chars);
+    Node node;
+    node.kind = Node::Chars;
+    node.chars = std::move(chars);
+    return add(std::move(node));
+  }
+
+  int addAssert(Assertion assertion) {
+    Node node;
+    node.kind = Node::Assert;
+    node.assertion = assertion;
+    return add(std::move(node));
+  }
+
+  int parseAlternation() {
+    std::vector<int> alternatives;
+    while (true) {
+      int sequence = parseSequence();
+      if (sequence < 0)
+        return -1;
+      alternatives.push_back(sequence);
+      if (peek() != u'|' || atEnd())
+        break;
+      pos_++;
+    }
+    if (alternatives.size() == 1)
+      return alternatives[0];
+    Node node;
+    node.kind = Node::Alternate;
+    node.children = std::move(alternatives);
+    return add(std::move(node));
+  }
+
+  int parseSequence() {
+    std::vector<int> items;
+    while (!atEnd() && peek() != u'|' && peek() != u')') {
+      int item = parseQuantified();
+      if (item < 0)
+        return -1;
+      items.push_back(item);
+    }
+    if (items.size() == 1)
+      return items[0];
+    Node node;
+    node.kind = items.empty() ? Node::Empty : Node::Concat;
+    node.children = std::move(items);
+    return add(std::move(node));
+  }
+
+  bool isQuantifier() const {
+    char16_t c = peek();
+    if (c == u'*' || c == u'+' || c == u'?')
+      return true;
+    size_t end;
+    int min, max;
+    return c == u'{' && readCount(end, min, max);
+  }
+
+  /** Reads {n}, {n,} or {n,m} at pos_ without consuming it. */
+  bool readCount(size_t &end, int &min, int &max) const {
+    size_t i = pos_ + 1;
+    auto readNumber = [&](int &value) {
+      size_t start = i;
+      long long n = 0;
+      while (i < pattern_.size() && pattern_[i] >= u'0' &&
+             pattern_[i] <= u'9') {
+        n = std::min<long long>(n * 10 + (pattern_[i] - u'0'), INT32_MAX);
+        i++;
+      }
+      value = static_cast<int>(n);
+      return i > start;
+    };
+    if (!readNumber(min))
+      return false;
+    max = min;
+    if (i < pattern_.size() && pattern_[i] == u',') {
+      i++;
+      if (!readNumber(max))
+        max = kUnbounded;
+    }
+    if (i >= pattern_.size() || pattern_[i] != u'}')
+      return false;
+    end = i + 1;
+    return true;
+  }
+
+  int parseQuantified() {
+    size_t atomStart = pos_;
+    int atom = parseAtom();
+    if (atom < 0 || !isQuantifier())
+      return atom;
+    if (nodes_[atom].kind == Node::Assert || pos_ == atomStart)
+      return fail("nothing to repeat");
+
+    int min, max;
+    char16_t c = peek();
+    if (c == u'{') {
+      size_t end;
+      readCount(end, min, max);
+      pos_ = end;
+    } else {
+      pos_++;
+      min = c == u'+' ? 1 : 0;
+      max = c == u'?' ? 1 : kUnbounded;
+    }
+    if (peek() == u'?' && !atEnd())
+      pos_++; // lazy; the DFA reports leftmost-longest regardless
+    if (max != kUnbounded && max < min)
+      return fail("numbers out of order in {} quantifier");
+    if (min > kMaxRepeat || max > kMaxRepeat)
+      return fail("repeat count too large");
+    if (isQuantifier())
+      return fail("nothing to repeat");
+
+    Node node;
+    node.kind = Node::Repeat;
+    node.children = {atom};
+    node.min = min;
+    node.max = max;
+    return add(std::move(node));
+  }
+
+  int parseAtom() {
+    char16_t c = peek();
+    switch (c) {
+    case u'(': {
+      pos_++;
+      if (peek() == u'?') {
+        if (peek(1) == u':') {
+          pos_ += 2;
+        } else if (peek(1) == u'<' && peek(2) != u'=' && peek(2) != u'!') {
+          size_t close = pattern_.find(u'>', pos_);
+          if (close == std::u16string::npos)
+            return fail("invalid capture group name");
+          pos_ = close + 1;
+        } else {
+          return fail("lookaround assertions are not supported");
+        }
+      }
+      int inner = parseAlternation();
+      if (inner < 0)
+        return -1;
+      if (peek() != u')' || atEnd())
+        return fail("unterminated group");
+      pos_++;
+      return inner;
+    }
+    case u'*':
+    case u'+':
+    case u'?':
+      return fail("nothing to repeat");
+    case u'{': {
+      size_t end;
+      int min, max;
+      if (readCount(end, min, max))
+        return fail("nothing to repeat");
+      pos_++;
+      return addChars({{c, c}});
+    }
+    case u'[': {
+      pos_++;
+      CharSet set;
+      if (!parseClass(set))
+        return -1;
+      return addChars(std::move(set));
+    }
+    case u'.':
+      pos_++;
+      return addChars(options_.dotAll ? CharSet{{0, 0xFFFF}}
+                                      : negate(kLineTerminators));
+    case u'^':
+      pos_++;
+      return addAssert(Assertion::BeginText);
+    case u'$':
+      pos_++;
+      return addAssert(Assertion::EndText);
+    case u'\\': {
+      pos_++;
+      CharSet set;
+      Assertion assertion;
+      bool isAssertion = false;
+      if (!parseEscape(set, false, isAssertion, assertion))
+        return -1;
+      return isAssertion ? addAssert(assertion) : addChars(std::move(set));
+    }
+    default:
+      pos_++;
+      return addChars({{c, c}});
+    }
+  }
+
+  /** Parses the escape after a backslash into `set` or an assertion. */
+  bool parseEscape(CharSet &set, bool inClass, bool &isAssertion,
+                   Assertion &assertion) {
+    if (atEnd()) {
+      fail("\\ at end of pattern");
+      return false;
+    }
+    char16_t c = pattern_[pos_++];
+    auto single = [&](char16_t value) {
+      set.push_back({value, value});
+      return true;
+    };
+    switch (c) {
+    case u'd':
+      append(set, kDigits);
+      return true;
+    case u'D':
+      append(set, negate(kDigits));
+      return true;
+    case u'w':
+      append(set, kWordChars);
+      return true;
+    case u'W':
+      append(set, negate(kWordChars));
+      return true;
+    case u's':
+      append(set, kSpaces);
+      return true;
+    case u'S':
+      append(set, negate(kSpaces));
+      return true;
+    case u'b':
+      if (inClass)
+        return single(u'\b');
+      isAssertion = true;
+      assertion = Assertion::WordBoundary;
+      return true;
+    case u'B':
+      if (inClass) {
+        fail("invalid class escape");
+        return false;
+      }
+      isAssertion = true;
+      assertion = Assertion::NotWordBoundary;
+      return true;
+    case u'n':
+      return single(u'\n');
+    case u'r':
+      return single(u'\r');
+    case u't':
+      return single(u'\t');
+    case u'f':
+      return single(u'\f');
+    case u'v':
+      return single(u'\v');
+    case u'0':
+      if (peek() >= u'0' && peek() <= u'9') {
+        fail("octal escapes are not supported");
+        return false;
+      }
+      return single(0);
+    case u'x':
+      if (hexValue(peek()) >= 0 && hexValue(peek(1)) >= 0) {
+        char16_t value =
+            static_cast<char16_t>(hexValue(peek()) * 16 + hexValue(peek(1)));
+        pos_ += 2;
+        return single(value);
+      }
+      return single(c);
+    case u'u': {
+      int value = 0;
+      for (size_t i = 0; i < 4; i++) {
+        int digit = hexValue(peek(i));
+        if (digit < 0 || pos_ + i >= pattern_.size())
+          return single(c);
+        value = value * 16 + digit;
+      }
+      pos_ += 4;
+      return single(static_cast<char16_t>(value));
+    }
+    case u'c': {
+      char16_t letter = peek();
+      if ((letter >= u'a' && letter <= u'z') ||
+          (letter >= u'A' && letter <= u'Z')) {
+        pos_++;
+        return single(static_cast<char16_t>(letter % 32));
+      }
+      fail("invalid control escape");
+      return false;
+    }
+    case u'k':
+      if (peek() == u'<') {
+        fail("backreferences are not supported");
+        return false;
+      }
+      return single(c);
+    default:
+      if (c >= u'1' && c <= u'9') {
+        fail("backreferences are not supported");
+        return false;
+      }
+      return single(c);
+    }
+  }
+
+  /** Parses a class after its opening bracket. */
+  bool parseClass(CharSet &set) {
+    bool negated = peek() == u'^' && !atEnd();
+    if (negated)
+      pos_++;
+
+    // Reads one class atom; `single` is false for escapes like \d.
+    auto readItem = [&](CharSet &item, bool &single) {
+      single = true;
+      char16_t c = pattern_[pos_++];
+      if (c != u'\\') {
+        item.push_back({c, c});
+        return true;
+      }
+      char16_t escaped = peek();
+      Assertion unused;
+      bool isAssertion = false;
+      if (!parseEscape(item, true, isAssertion, unused))
+        return false;
+      single = escaped != u'd' && escaped != u'D' && escaped != u'w' &&
+               escaped != u'W' && escaped != u's' && escaped != u'S';
+      return true;
+    };
+
+    while (true) {
+      if (atEnd()) {
+        fail("missing terminating ] for character class");
+        return false;
+      }
+      if (peek() == u']') {
+        pos_++;
+        break;
+      }
+      CharSet first;
+      bool firstSingle;
+      if (!readItem(first, firstSingle))
+        return false;
+      if (peek() == u'-' && peek(1) != u']' && pos_ + 1 < pattern_.size()) {
+        pos_++;
+        CharSet second;
+        bool secondSingle;
+        if (!readItem(second, secondSingle))
+          return false;
+        if (firstSingle && secondSingle) {
+          if (first[0].lo > second[0].lo) {
+            fail("range out of order in character class");
+            return false;
+          }
+          set.push_back({first[0].lo, second[0].lo});
+        } else {
+          // Annex B: a dash next to a class escape is literal.
+          append(set, first);
+          set.push_back({u'-', u'-'});
+          append(set, second);
+        }
+        continue;
+      }
+      append(set, first);
+    }
+
+    if (negated) {
+      if (options_.caseInsensitive)
+        foldAsciiCase(set);
+      set = negate(set);
+    }
+    return true;
+  }
+
+  const std::u16string &pattern_;
+  RegexOptions options_;
+  std::vector<Node> &nodes_;
+  size_t pos_ = 0;
+  std::string error_;
+};
+
+/* --- NFA --- */
+
+constexpr size_t kMaxNfaStates = 200000;
+
+struct NfaState {
+  enum Kind : uint8_t { Chars, Split, Assert, Match };
+
+  Kind kind;
+  Assertion assertion = Assertion::BeginText;
+  int set = -1;
+  int out = -1;
+  int out1 = -1;
+};
+
+struct Nfa {
+  std::vector<NfaState> states;
+  int start = -1;
+};
+
+/**
+ * Thompson construction, built back to front so every fragment knows its
+ * continuation. The reversed automaton matches mirrored strings and is used
+ * to locate the leftmost match start.
+ */
+class NfaBuilder {
+public:
+  NfaBuilder(const std::vector<Node> &nodes, const std::vector<int> &setOf,
+             bool reversed)
+      : nodes_(nodes), setOf_(setOf), reversed_(reversed) {}
+
+  bool build(int root, Nfa &nfa) {
+    nfa_ = &nfa;
+    int match = addState({NfaState::Match});
+    nfa.start = emit(root, match);
+    return !overflow_;
+  }
+
+private:
+  int addState(NfaState state) {
+    if (nfa_->states.size() >= kMaxNfaStates) {
+      overflow_ = true;
+      return 0;
+    }
+    nfa_->states.push_back(state);
+    return static_cast<int>(nfa_->states.size()) - 1;
+  }
+
+  int split(int out, int out1) {
+    NfaState state{NfaState::Split};
+    state.out = out;
+    state.out1 = out1;
+    return addState(state);
+  }
+
+  int emit(int index, int next) {
+    if (overflow_)
+      return 0;
+    const Node &node = nodes_[index];
+    switch (node.kind) {
+    case Node::Empty:
+      return next;
+    case Node::Chars: {
+      NfaState state{NfaState::Chars};
+      state.set = setOf_[index];
+      state.out = next;
+      return addState(state);
+    }
+    case Node::Concat:
+      if (reversed_) {
+        for (int child : node.children)
+          next = emit(child, next);
+      } else {
+        for (auto it = node.children.rbegin(); it != node.children.rend();
+             ++it)
+          next = emit(*it, next);
+      }
+      return next;
+    case Node::Alternate: {
+      int chain = emit(node.children.back(), next);
+      for (size_t i = node.children.size() - 1; i-- > 0;)
+        chain = split(emit(node.children[i], next), chain);
+      return chain;
+    }
+    case Node::Repeat: {
+      int child = node.children[0];
+      int current = next;
+      if (node.max == kUnbounded) {
+        int loop = split(-1, next);
+        int body = emit(child, loop);
+        if (!overflow_)
+          nfa_->states[loop].out = body;
+        current = loop;
+      } else {
+        for (int i = node.min; i < node.max && !overflow_; i++)
+          current = split(emit(child, current), next);
+      }
+      for (int i = 0; i < node.min && !overflow_; i++)
+        current = emit(child, current);
+      return current;
+    }
+    case Node::Assert: {
+      NfaState state{NfaState::Assert};
+      state.assertion = node.assertion;
+      if (reversed_ && node.assertion == Assertion::BeginText)
+        state.assertion = Assertion::EndText;
+      else if (reversed_ && node.assertion == Assertion::EndText)
+        state.assertion = Assertion::BeginText;
+      state.out = next;
+      return addState(state);
+    }
+    }
+    return next;
+  }
+
+  const std::vector<Node> &nodes_;
+  const std::vector<int> &setOf_;
+  bool reversed_;
+  Nfa *nfa_ = nullptr;
+  bool overflow_ = false;
+};
+
+/* --- lazy DFA --- */
+
+/** What lies on one side of a position. */
+enum Context : uint8_t { kEdge, kWord, kOther };
+
+bool holds(Assertion assertion, Context before, Context after) {
+  switch (assertion) {
+  case Assertion::BeginText:
+    return before == kEdge;
+  case Assertion::EndText:
+    return after == kEdge;
+  case Assertion::WordBoundary:
+    return (before == kWord) != (after == kWord);
+  case Assertion::NotWordBoundary:
+    return (before == kWord) == (after == kWord);
+  }
+  return false;
+}
+
+constexpr size_t kMaxCachedStates = 4096;
+
+/**
+ * A DFA state is the set of NFA states reached after consuming a character
+ * (its kernel) plus the context of that character. Assertions depend on the
+ * next character too, so the epsilon closure is taken when leaving a state.
+ * Every transition also records whether a match ends just before the
+ * character it consumes.
+ */
+struct DfaState {
+  std::vector<int> kernel;
+  Context before;
+  bool dead;
+  std::vector<int32_t> next; // target << 1 | matchBefore, -1 if unknown
+  int8_t matchAtEnd = -1;
+};
+
+} // namespace
+
+struct RegexDfa::Program {
+  std::vector<char16_t> classStart;
+  uint16_t asciiClass[128];
+  std::vector<Context> classContext;
+  std::vector<std::vector<bool>> accepts; // [set][class]
+
+  Nfa forward, reverse;
+
+  class Dfa {
+  public:
+    Dfa(const Program &program, const Nfa &nfa, bool unanchored)
+        : program_(program), nfa_(nfa), unanchored_(unanchored),
+          marks_(nfa.states.size(), 0) {}
+
+    int start(Context before) { return intern({nfa_.start}, before); }
+
+    bool dead(int state) const { return states_[state].dead; }
+
+    int32_t transition(int state, int cls) {
+      int32_t cached = states_[state].next[cls];
+      if (cached >= 0)
+        return cached;
+
+      Context after = program_.classContext[cls];
+      bool match = closure(states_[state].kernel, states_[state].before,
+                           after);
+      std::vector<int> kernel;
+      for (int s : closure_) {
+        const NfaState &nfaState = nfa_.states[s];
+        if (program_.accepts[nfaState.set][cls])
+          kernel.push_back(nfaState.out);
+      }
+      if (unanchored_)
+        kernel.push_back(nfa_.start);
+      std::sort(kernel.begin(), kernel.end());
+      kernel.erase(std::unique(kernel.begin(), kernel.end()), kernel.end());
+
+      size_t flushes = flushes_;
+      int target = intern(std::move(kernel), after);
+      int32_t packed = (target << 1) | (match ? 1 : 0);
+      if (flushes == flushes_)
+        states_[state].next[cls] = packed;
+      return packed;
+    }
+
+    bool matchAtEnd(int state) {
+      DfaState &dfaState = states_[state];
+      if (dfaState.matchAtEnd < 0)
+        dfaState.matchAtEnd =
+            closure(dfaState.kernel, dfaState.before, kEdge) ? 1 : 0;
+      return dfaState.matchAtEnd == 1;
+    }
+
+  private:
+    int intern(std::vector<int> kernel, Context before) {
+      auto key = std::make_pair(static_cast<int>(before), kernel);
+      auto it = index_.find(key);
+      if (it != index_.end())
+        return it->second;
+      if (states_.size() >= kMaxCachedStates) {
+        states_.clear();
+        index_.clear();
+        flushes_++;
+      }
+      DfaState state;
+      state.dead = kernel.empty();
+      state.kernel = std::move(kernel);
+      state.before = before;
+      state.next.assign(program_.classStart.size(), -1);
+      states_.push_back(std::move(state));
+      int id = static_cast<int>(states_.size()) - 1;
+      index_.emplace(std::move(key), id);
+      return id;
+    }
+
+    /** Fills closure_ with the reachable character states. */
+    bool closure(const std::vector<int> &kernel, Context before,
+                 Context after) {
+      if (++generation_ == 0) {
+        std::fill(marks_.begin(), marks_.end(), 0);
+        generation_ = 1;
+      }
+      closure_.clear();
+      stack_.assign(kernel.rbegin(), kernel.rend());
+      bool match = false;
+      while (!stack_.empty()) {
+        int s = stack_.back();
+        stack_.pop_back();
+        if (marks_[s] == generation_)
+          continue;
+        marks_[s] = generation_;
+        const NfaState &state = nfa_.states[s];
+        switch (state.kind) {
+        case NfaState::Chars:
+          closure_.push_back(s);
+          break;
+        case NfaState::Match:
+          match = true;
+          break;
+        case NfaState::Split:
+          stack_.push_back(state.out1);
+          stack_.push_back(state.out);
+          break;
+        case NfaState::Assert:
+          if (holds(state.assertion, before, after))
+            stack_.push_back(state.out);
+          break;
+        }
+      }
+      return match;
+    }
+
+    const Program &program_;
+    const Nfa &nfa_;
+    bool unanchored_;
+    std::vector<DfaState> states_;
+    std::map<std::pair<int, std::vector<int>>, int> index_;
+    size_t flushes_ = 0;
+    std::vector<uint32_t> marks_;
+    uint32_t generation_ = 0;
+    std::vector<int> closure_;
+    std::vector<int> stack_;
+  };
+
+  std::unique_ptr<Dfa> searcher, anchored, reverseSearcher;
+
+  int classOf(char16_t c) const {
+    if (c < 128)
+      return asciiClass[c];
+    return static_cast<int>(std::upper_bound(classStart.begin(),
+                                             classStart.end(), c) -
+                            classStart.begin()) -
+           1;
+  }
+
+  Context contextAt(const char16_t *text, size_t position) const {
+    return position == 0 ? kEdge : classContext[classOf(text[position - 1])];
+  }
+};
+
+RegexDfa::RegexDfa(std::unique_ptr<Program> program)
+    : program_(std::move(program)) {}
+
+RegexDfa::~RegexDfa() = default;
+
+std::unique_ptr<RegexDfa> RegexDfa::compile(const std::u16string &pattern,
+                                            RegexOptions options,
+                                            std::string *error) {
+  std::vector<Node> nodes;
+  std::string message;
+  int root = Parser(pattern, options, nodes).parse(message);
+  if (root < 0) {
+    if (error)
+      *error = message;
+    return nullptr;
+  }
+
+  auto program = std::make_unique<Program>();
+
+  // Split the code unit range into classes that every set either fully
+  // contains or misses, and that never straddle a word character boundary.
+  std::vector<int> setOf(nodes.size(), -1);
+  std::vector<const CharSet *> sets;
+  std::vector<uint32_t> bounds = {0};
+  auto addBounds = [&](const CharSet &set) {
+    for (const CharRange &range : set) {
+      bounds.push_back(range.lo);
+      bounds.push_back(static_cast<uint32_t>(range.hi) + 1);
+    }
+  };
+  addBounds(kWordChars);
+  for (size_t i = 0; i < nodes.size(); i++) {
+    if (nodes[i].kind != Node::Chars)
+      continue;
+    setOf[i] = static_cast<int>(sets.size());
+    sets.push_back(&nodes[i].chars);
+    addBounds(nodes[i].chars);
+  }
+  std::sort(bounds.begin(), bounds.end());
+  bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+  for (uint32_t bound : bounds)
+    if (bound <= 0xFFFF)
+      program->classStart.push_back(static_cast<char16_t>(bound));
+
+  size_t classCount = program->classStart.size();
+  for (char16_t c = 0; c < 128; c++)
+    program->asciiClass[c] = static_cast<uint16_t>(
+        std::upper_bound(program->classStart.begin(),
+                         program->classStart.end(), c) -
+        program->classStart.begin() - 1);
+  for (char16_t start : program->classStart)
+    program->classContext.push_back(isWordChar(start) ? kWord : kOther);
+
+  program->accepts.assign(sets.size(), std::vector<bool>(classCount, false));
+  for (size_t s = 0; s < sets.size(); s++) {
+    size_t cls = 0;
+    for (const CharRange &range : *sets[s]) {
+      while (program->classStart[cls] < range.lo)
+        cls++;
+      for (; cls < classCount && program->classStart[cls] <= range.hi; cls++)
+        program->accepts[s][cls] = true;
+      if (cls == classCount)
+        break;
+    }
+  }
+
+  if (!NfaBuilder(nodes, setOf, false).build(root, program->forward) ||
+      !NfaBuilder(nodes, setOf, true).build(root, program->reverse)) {
+    if (error)
+      *error = "pattern too large";
+    return nullptr;
+  }
+
+  program->searcher =
+      std::make_unique<Program::Dfa>(*program, program->forward, true);
+  program->anchored =
+      std::make_unique<Program::Dfa>(*program, program->forward, false);
+  program->reverseSearcher =
+      std::make_unique<Program::Dfa>(*program, program->reverse, true);
+  return std::unique_ptr<RegexDfa>(new RegexDfa(std::move(program)));
+}
+
+bool RegexDfa::search(const char16_t *text, size_t length) const {
+  Program::Dfa &dfa = *program_->searcher;
+  int state = dfa.start(kEdge);
+  for (size_t i = 0; i < length; i++) {
+    int32_t packed = dfa.transition(state, program_->classOf(text[i]));
+    if (packed & 1)
+      return true;
+    state = packed >> 1;
+  }
+  return dfa.matchAtEnd(state);
+}
+
+bool RegexDfa::find(const char16_t *text, size_t length,
+                    TextRange &match) const {
+  // The reversed pattern, scanned right to left, reports every position
+  // where some match starts; the smallest one is the leftmost start.
+  Program::Dfa &reverse = *program_->reverseSearcher;
+  int state = reverse.start(kEdge);
+  size_t start = SIZE_MAX;
+  for (size_t i = length; i > 0; i--) {
+    int32_t packed = reverse.transition(state, program_->classOf(text[i - 1]));
+    if (packed & 1)
+      start = i;
+    state = packed >> 1;
+  }
+  if (reverse.matchAtEnd(state))
+    start = 0;
+  if (start == SIZE_MAX)
+    return false;
+
+  Program::Dfa &forward = *program_->anchored;
+  state = forward.start(program_->contextAt(text, start));
+  size_t end = start;
+  size_t i = start;
+  for (; i < length && !forward.dead(state); i++) {
+    int32_t packed = forward.transition(state, program_->classOf(text[i]));
+    if (packed & 1)
+      end = i;
+    state = packed >> 1;
+  }
+  if (i == length && !forward.dead(state) && forward.matchAtEnd(state))
+    end = length;
+  match = {start, end - start};
+  return true;
+}
+
+} // namespace enriched
@@ -0,0 +1,68 @@
+/**
+ * Linear-time regular expression matcher.
+ * Compiles the JavaScript regex subset used for link detection into an NFA
+ * and runs it as a lazily built DFA, so matching never backtracks.
+ */
+
+#pragma once
+
+#include "StyleType.hpp"
+
+#include <memory>
+#include <string>
+
+namespace enriched {
+
+struct RegexOptions {
+  /** The `i` flag, folding ASCII letters only (no Unicode case folding). */
+  bool caseInsensitive = false;
+  bool dotAll = false;
+};
+
+/**
+ * Supported syntax: literals and escapes, `.`, character classes with
+ * ranges and negation, \d \D \w \W \s \S, groups (capturing, non-capturing
+ * and named groups all just group), alternation, greedy and lazy
+ * quantifiers including counted ones, and the assertions ^ $ \b \B.
+ * Lookarounds and backreferences cannot be expressed as a DFA and make
+ * compile() fail, so callers can fall back to a backtracking engine.
+ *
+ * Matching works on UTF-16 code units like a JavaScript regex without the
+ * `u` flag. Case-insensitive matching folds ASCII letters only.
+ *
+ * DFA states are built on first use and cached in the instance, which makes
+ * the matching methods unsafe to call concurrently on the same object.
+ */
+class RegexDfa {
+public:
+  ~RegexDfa();
+
+  /** Returns nullptr (and an error message) for unsupported patterns. */
+  static std::unique_ptr<RegexDfa> compile(const std::u16string &pattern,
+                                           RegexOptions options = {},
+                                           std::string *error = nullptr);
+
+  /** True if the pattern matches anywhere in the text. */
+  bool search(const char16_t *text, size_t length) const;
+  /**
+   * Leftmost-longest match. For patterns with lazy quantifiers or ordered
+   * alternatives the end may differ from what a backtracking engine picks.
+   */
+  bool find(const char16_t *text, size_t length, TextRange &match) const;
+
+  bool search(const std::u16string &text) const {
+    return search(text.data(), text.size());
+  }
+  bool find(const std::u16string &text, TextRange &match) const {
+    return find(text.data(), text.size(), match);
+  }
+
+  struct Program;
+
+private:
+  explicit RegexDfa(std::unique_ptr<Program> program);
+
+  std::unique_ptr<Program> program_;
+};
+
+} // namespace enriched
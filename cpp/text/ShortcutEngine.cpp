@@ -0,0 +1,206 @@
+#include "ShortcutEngine.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace enriched {
+
+/* --- trie --- */
+
+void ShortcutEngine::Trie::clear() {
+  nodes.assign(1, Node());
+  maxDepth = 0;
+}
+
+uint32_t ShortcutEngine::Trie::insert(const char16_t *chars, size_t length,
+                                      bool reversed) {
+  uint32_t node = 0;
+  for (size_t i = 0; i < length; i++) {
+    char16_t c = reversed ? chars[length - 1 - i] : chars[i];
+    auto &edges = nodes[node].edges;
+    auto it = std::lower_bound(
+        edges.begin(), edges.end(), c,
+        [](const std::pair<char16_t, uint32_t> &edge, char16_t value) {
+          return edge.first < value;
+        });
+    if (it != edges.end() && it->first == c) {
+      node = it->second;
+      continue;
+    }
+    uint32_t target = static_cast<uint32_t>(nodes.size());
+    edges.insert(it, {c, target});
+    nodes.emplace_back();
+    node = target;
+  }
+  maxDepth = std::max(maxDepth, length);
+  return node;
+}
+
+uint32_t ShortcutEngine::Trie::child(uint32_t node, char16_t c) const {
+  const auto &edges = nodes[node].edges;
+  auto it = std::lower_bound(
+      edges.begin(), edges.end(), c,
+      [](const std::pair<char16_t, uint32_t> &edge, char16_t value) {
+        return edge.first < value;
+      });
+  return it != edges.end() && it->first == c ? it->second : 0;
+}
+
+/* --- engine --- */
+
+StyleType ShortcutEngine::styleForName(const std::string &name) {
+  static const std::unordered_map<std::string, StyleType> kStyles = {
+      // Paragraph shortcuts
+      {"h1", StyleType::H1},
+      {"h2", StyleType::H2},
+      {"h3", StyleType::H3},
+      {"h4", StyleType::H4},
+      {"h5", StyleType::H5},
+      {"h6", StyleType::H6},
+      {"blockquote", StyleType::BlockQuote},
+      {"codeblock", StyleType::CodeBlock},
+      {"unordered_list", StyleType::UnorderedList},
+      {"ordered_list", StyleType::OrderedList},
+      {"checkbox_list", StyleType::CheckboxList},
+      // Inline shortcuts
+      {"bold", StyleType::Bold},
+      {"italic", StyleType::Italic},
+      {"underline", StyleType::Underline},
+      {"strikethrough", StyleType::Strikethrough},
+      {"inline_code", StyleType::InlineCode},
+  };
+  auto it = kStyles.find(name);
+  return it != kStyles.end() ? it->second : StyleType::None;
+}
+
+bool ShortcutEngine::isInlineStyle(StyleType style) {
+  return style == StyleType::Bold || style == StyleType::Italic ||
+         style == StyleType::Underline || style == StyleType::Strikethrough ||
+         style == StyleType::InlineCode;
+}
+
+void ShortcutEngine::reset(const std::vector<TextShortcut> &shortcuts) {
+  styles_.clear();
+  paragraphTrie_.clear();
+  inlineTrie_.clear();
+  paragraphCount_ = 0;
+  inlineCount_ = 0;
+
+  for (size_t i = 0; i < shortcuts.size(); i++) {
+    const std::u16string &trigger = shortcuts[i].trigger;
+    StyleType style = styleForName(shortcuts[i].style);
+    styles_.push_back(style);
+    if (trigger.empty() || style == StyleType::None)
+      continue;
+
+    bool isInline = isInlineStyle(style);
+    Trie &trie = isInline ? inlineTrie_ : paragraphTrie_;
+    uint32_t node = trie.insert(trigger.data(), trigger.size(), isInline);
+    trie.nodes[node].shortcuts.push_back(static_cast<uint32_t>(i));
+    (isInline ? inlineCount_ : paragraphCount_)++;
+  }
+}
+
+std::vector<ShortcutMatch>
+ShortcutEngine::paragraphMatches(const char16_t *text, size_t length,
+                                 size_t triggerStart) const {
+  std::vector<ShortcutMatch> matches;
+  if (triggerStart >= length ||
+      length - triggerStart > paragraphTrie_.maxDepth)
+    return matches;
+
+  uint32_t node = 0;
+  for (size_t i = triggerStart; i < length; i++) {
+    node = paragraphTrie_.child(node, text[i]);
+    if (node == 0)
+      return matches;
+  }
+
+  TextRange trigger{triggerStart, length - triggerStart};
+  for (uint32_t shortcut : paragraphTrie_.nodes[node].shortcuts)
+    matches.push_back({shortcut,
+                       styles_[shortcut],
+                       {triggerStart, 0},
+                       trigger,
+                       {length, 0},
+                       {triggerStart, 0}});
+  return matches;
+}
+
+bool ShortcutEngine::isPartOfLongerTrigger(const char16_t *text, size_t end,
+                                           size_t triggerLength) const {
+  uint32_t node = 0;
+  for (size_t depth = 1; depth <= inlineTrie_.maxDepth && depth <= end;
+       depth++) {
+    node = inlineTrie_.child(node, text[end - depth]);
+    if (node == 0)
+      return false;
+    if (depth > triggerLength && !inlineTrie_.nodes[node].shortcuts.empty())
+      return true;
+  }
+  return false;
+}
+
+std::vector<ShortcutMatch>
+ShortcutEngine::inlineMatches(const char16_t *text, size_t length,
+                              size_t paragraphStart) const {
+  std::vector<ShortcutMatch> matches;
+  if (inlineCount_ == 0 || paragraphStart > length)
+    return matches;
+
+  // Triggers ending at the cursor lie on one path of the reversed trie,
+  // shortest first.
+  std::vector<std::pair<uint32_t, size_t>> closing;
+  uint32_t node = 0;
+  for (size_t depth = 1;
+       depth <= inlineTrie_.maxDepth && depth <= length - paragraphStart;
+       depth++) {
+    node = inlineTrie_.child(node, text[length - depth]);
+    if (node == 0)
+      break;
+    if (!inlineTrie_.nodes[node].shortcuts.empty())
+      closing.push_back({node, depth});
+  }
+
+  for (auto it = closing.rbegin(); it != closing.rend(); ++it) {
+    size_t triggerLength = it->second;
+    size_t closeStart = length - triggerLength;
+    const char16_t *trigger = text + closeStart;
+
+    // Last opening delimiter that ends before the closing one starts.
+    if (closeStart < paragraphStart + triggerLength)
+      continue;
+    size_t lastOpen = closeStart - triggerLength;
+    size_t firstOpen =
+        std::max(paragraphStart, lastOpen > kMaxInlineContentLength
+                                     ? lastOpen - kMaxInlineContentLength
+                                     : size_t(0));
+    size_t open = lastOpen + 1;
+    bool found = false;
+    while (open-- > firstOpen) {
+      if (std::equal(trigger, trigger + triggerLength, text + open)) {
+        found = true;
+        break;
+      }
+    }
+    if (!found || isPartOfLongerTrigger(text, open + triggerLength,
+                                        triggerLength))
+      continue;
+
+    size_t contentStart = open + triggerLength;
+    if (closeStart <= contentStart)
+      continue;
+    size_t contentLength = closeStart - contentStart;
+
+    for (uint32_t shortcut : inlineTrie_.nodes[it->first].shortcuts)
+      matches.push_back({shortcut,
+                         styles_[shortcut],
+                         {open, triggerLength},
+                         {closeStart, triggerLength},
+                         {contentStart, contentLength},
+                         {open, contentLength}});
+  }
+  return matches;
+}
+
+} // namespace enriched
@@ -0,0 +1,115 @@
+/**
+ * Markdown-style text shortcuts (`# ` -> H1, `**bold**` -> bold, ...)
+ * shared by both inputs.
+ */
+
+#pragma once
+
+#include "StyleType.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace enriched {
+
+struct TextShortcut {
+  std::u16string trigger;
+  /** Name used by the `textShortcuts` prop, e.g. "h1" or "inline_code". */
+  std::string style;
+};
+
+/**
+ * A shortcut completed by the last insertion, in coordinates of the text
+ * passed to the engine (which includes the inserted characters).
+ *
+ * Paragraph shortcuts only set `closeDelete`, the trigger itself. Inline
+ * shortcuts remove `closeDelete` first and `openDelete` second, then apply
+ * the style to `finalContent`.
+ */
+struct ShortcutMatch {
+  uint32_t shortcut; // index into the configured list
+  StyleType style;
+  TextRange openDelete;
+  TextRange closeDelete;
+  TextRange content;
+  TextRange finalContent;
+};
+
+/**
+ * Triggers are compiled into two tries: paragraph triggers forward from the
+ * paragraph start and inline triggers backwards from the cursor. Matching
+ * the closing delimiter and rejecting an opening delimiter that belongs to
+ * a longer trigger (`*` inside `**`) both cost O(trigger length).
+ *
+ * Finding the opening delimiter of an inline shortcut scans back from the
+ * closing one, so it costs O(content length), capped at
+ * kMaxInlineContentLength per keystroke regardless of paragraph length.
+ */
+class ShortcutEngine {
+public:
+  /** Inline shortcuts wrapping more text than this are not recognized. */
+  static constexpr size_t kMaxInlineContentLength = 1024;
+
+  ShortcutEngine() { reset({}); }
+  explicit ShortcutEngine(const std::vector<TextShortcut> &shortcuts) {
+    reset(shortcuts);
+  }
+
+  /** Shortcuts with an empty trigger or an unknown style are ignored. */
+  void reset(const std::vector<TextShortcut> &shortcuts);
+
+  bool empty() const { return paragraphCount_ == 0 && inlineCount_ == 0; }
+
+  /** Maps a `textShortcuts` style name to its StyleType, None if unknown. */
+  static StyleType styleForName(const std::string &name);
+  static bool isInlineStyle(StyleType style);
+
+  /**
+   * Paragraph shortcuts whose trigger spans exactly [triggerStart, length):
+   * `text` ends at the cursor and triggerStart is where the paragraph's
+   * content begins. Candidates come in configuration order; callers take
+   * the first one whose style isn't blocked.
+   */
+  std::vector<ShortcutMatch> paragraphMatches(const char16_t *text,
+                                              size_t length,
+                                              size_t triggerStart) const;
+
+  /**
+   * Inline shortcuts closed at the end of `text` (the cursor), opened
+   * earlier in the same paragraph, which begins at paragraphStart, at most
+   * kMaxInlineContentLength characters before the closing delimiter.
+   * Candidates come longest trigger first, so `**` is never pre-empted by
+   * `*`; callers take the first one whose style isn't blocked.
+   */
+  std::vector<ShortcutMatch> inlineMatches(const char16_t *text, size_t length,
+                                           size_t paragraphStart) const;
+
+private:
+  struct Trie {
+    struct Node {
+      std::vector<std::pair<char16_t, uint32_t>> edges; // sorted
+      std::vector<uint32_t> shortcuts; // in configuration order
+    };
+
+    std::vector<Node> nodes;
+    size_t maxDepth = 0;
+
+    void clear();
+    uint32_t insert(const char16_t *chars, size_t length, bool reversed);
+    /** Child node or 0 (the root is never a child). */
+    uint32_t child(uint32_t node, char16_t c) const;
+  };
+
+  /** Is the delimiter ending at `end` the tail of a longer trigger? */
+  bool isPartOfLongerTrigger(const char16_t *text, size_t end,
+                             size_t triggerLength) const;
+
+  std::vector<StyleType> styles_;
+  Trie paragraphTrie_;
+  Trie inlineTrie_;
+  size_t paragraphCount_ = 0;
+  size_t inlineCount_ = 0;
+};
+
+} // namespace enriched
@@ -0,0 +1,552 @@
+#include "TextSegmenter.hpp"
+
+#include "SegmentationTables.hpp"
+
+#include <algorithm>
+
+namespace enriched {
+
+namespace {
+
+using namespace unicode;
+
+/* --- Properties --- */
+
+uint16_t properties(char32_t c) {
+  uint32_t i;
+  if (c < kPlaneSplit)
+    i = c;
+  else if (c >= kTagsStart && c < kTagsEnd)
+    i = c - kTagsStart + kPlaneSplit;
+  else
+    return 0;
+  constexpr uint32_t kOffsetMask = (1u << kBlockShift) - 1;
+  uint32_t block = kBlockIndex[i >> kBlockShift];
+  return kValues[kBlocks[(block << kBlockShift) | (i & kOffsetMask)]];
+}
+
+GraphemeBreak graphemeBreak(char32_t c) {
+  return static_cast<GraphemeBreak>(properties(c) & 0xF);
+}
+
+WordBreak wordBreak(char32_t c) {
+  return static_cast<WordBreak>((properties(c) >> kWordShift) & 0x1F);
+}
+
+ConjunctBreak conjunctBreak(char32_t c) {
+  return static_cast<ConjunctBreak>((properties(c) >> kConjunctShift) & 0x3);
+}
+
+bool isPictographic(char32_t c) { return properties(c) & kPictographicBit; }
+
+/* --- Reading --- */
+
+bool isHighSurrogate(char16_t unit) { return unit >= 0xD800 && unit <= 0xDBFF; }
+bool isLowSurrogate(char16_t unit) { return unit >= 0xDC00 && unit <= 0xDFFF; }
+
+/**
+ * Code points of a window, addressed by text offsets. Reaching an edge of
+ * the window that isn't an edge of the text marks the result incomplete;
+ * unpaired surrogates read as themselves.
+ */
+class Reader {
+public:
+  explicit Reader(const TextWindow &window)
+      : data_(window.data), lo_(window.start),
+        hi_(window.start + window.length), textLength_(window.textLength) {}
+
+  bool incomplete() const { return incomplete_; }
+
+  /** Whether `p` is inside the window, counting its end. */
+  bool covers(size_t p) {
+    if (p >= lo_ && p <= hi_)
+      return true;
+    incomplete_ = true;
+    return false;
+  }
+
+  bool atStart(size_t p) {
+    if (p > lo_)
+      return false;
+    if (lo_ > 0)
+      incomplete_ = true;
+    return true;
+  }
+
+  bool atEnd(size_t p) {
+    if (p < hi_)
+      return false;
+    if (hi_ < textLength_)
+      incomplete_ = true;
+    return true;
+  }
+
+  /** Whether `p` falls inside a surrogate pair; `p` must be interior. */
+  bool splitsPair(size_t p) const {
+    return isLowSurrogate(unit(p)) && isHighSurrogate(unit(p - 1));
+  }
+
+  /** Code point starting at `p`, which must be before the end. */
+  char32_t after(size_t p, size_t &next) {
+    char16_t first = unit(p);
+    next = p + 1;
+    if (isHighSurrogate(first)) {
+      if (next < hi_ && isLowSurrogate(unit(next)))
+        return combine(first, unit(next++));
+      if (next == hi_ && hi_ < textLength_)
+        incomplete_ = true;
+    }
+    return first;
+  }
+
+  char32_t after(size_t p) {
+    size_t next;
+    return after(p, next);
+  }
+
+  /** Code point ending at `p`, which must be after the start. */
+  char32_t before(size_t p, size_t &previous) {
+    char16_t last = unit(p - 1);
+    previous = p - 1;
+    if (isLowSurrogate(last)) {
+      if (previous > lo_ && isHighSurrogate(unit(previous - 1)))
+        return combine(unit(--previous), last);
+      if (previous == lo_ && lo_ > 0)
+        incomplete_ = true;
+    }
+    return last;
+  }
+
+  char32_t before(size_t p) {
+    size_t previous;
+    return before(p, previous);
+  }
+
+private:
+  char16_t unit(size_t p) const { return data_[p - lo_]; }
+
+  static char32_t combine(char16_t high, char16_t low) {
+    return 0x10000 + ((char32_t(high) - 0xD800) << 10) + (low - 0xDC00);
+  }
+
+  const char16_t *data_;
+  size_t lo_;
+  size_t hi_;
+  size_t textLength_;
+  bool incomplete_ = false;
+};
+
+/* --- Grapheme clusters --- */
+
+bool isControl(GraphemeBreak g) {
+  return g == kGbCR || g == kGbLF || g == kGbControl;
+}
+
+/** GB6-GB8 */
+bool joinsHangul(GraphemeBreak before, GraphemeBreak after) {
+  switch (before) {
+  case kGbL:
+    return after == kGbL || after == kGbV || after == kGbLV || after == kGbLVT;
+  case kGbLV:
+  case kGbV:
+    return after == kGbV || after == kGbT;
+  case kGbLVT:
+  case kGbT:
+    return after == kGbT;
+  default:
+    return false;
+  }
+}
+
+/** GB9c: a consonant, then InCB extends and at least one linker, before p. */
+bool followsConjunctLinker(Reader &reader, size_t p) {
+  bool linked = false;
+  while (!reader.atStart(p)) {
+    switch (conjunctBreak(reader.before(p, p))) {
+    case kInCbLinker:
+      linked = true;
+      break;
+    case kInCbExtend:
+      break;
+    case kInCbConsonant:
+      return linked;
+    default:
+      return false;
+    }
+  }
+  return false;
+}
+
+/** GB11: a pictographic, then extends, then the ZWJ that ends at p. */
+bool followsPictographicZwj(Reader &reader, size_t p) {
+  reader.before(p, p);
+  while (!reader.atStart(p)) {
+    char32_t c = reader.before(p, p);
+    if (isPictographic(c))
+      return true;
+    if (graphemeBreak(c) != kGbExtend)
+      return false;
+  }
+  return false;
+}
+
+size_t regionalIndicatorsBefore(Reader &reader, size_t p) {
+  size_t count = 0;
+  while (!reader.atStart(p) &&
+         graphemeBreak(reader.before(p, p)) == kGbRegionalIndicator)
+    count++;
+  return count;
+}
+
+/**
+ * Whether a cluster boundary falls at p, looking only as far back as the
+ * rules need.
+ */
+bool isGraphemeBoundary(Reader &reader, size_t p) {
+  if (reader.atStart(p) || reader.atEnd(p))
+    return true; // GB1, GB2
+  if (reader.splitsPair(p))
+    return false;
+  char32_t before = reader.before(p);
+  char32_t after = reader.after(p);
+  GraphemeBreak gb = graphemeBreak(before);
+  GraphemeBreak ga = graphemeBreak(after);
+
+  if (gb == kGbCR && ga == kGbLF)
+    return false; // GB3
+  if (isControl(gb) || isControl(ga))
+    return true; // GB4, GB5
+  if (joinsHangul(gb, ga))
+    return false; // GB6-GB8
+  if (ga == kGbExtend || ga == kGbZWJ || ga == kGbSpacingMark)
+    return false; // GB9, GB9a
+  if (gb == kGbPrepend)
+    return false; // GB9b
+  if (conjunctBreak(after) == kInCbConsonant &&
+      followsConjunctLinker(reader, p))
+    return false; // GB9c
+  if (gb == kGbZWJ && isPictographic(after) &&
+      followsPictographicZwj(reader, p))
+    return false; // GB11
+  if (gb == kGbRegionalIndicator && ga == kGbRegionalIndicator)
+    return regionalIndicatorsBefore(reader, p) % 2 == 0; // GB12, GB13
+  return true;
+}
+
+/** Last cluster boundary at or before p. */
+size_t graphemeStart(Reader &reader, size_t p) {
+  while (!isGraphemeBoundary(reader, p))
+    reader.before(p, p);
+  return p;
+}
+
+/**
+ * End of the cluster starting at `start`, a boundary. Walking forward keeps
+ * the context the backward check has to look for, so runs of flags cost
+ * O(n) rather than O(n²).
+ */
+size_t graphemeEnd(Reader &reader, size_t start) {
+  enum { kNoEmoji, kPictographic, kPictographicZwj } emoji = kNoEmoji;
+  enum { kNoConjunct, kConsonant, kLinked } conjunct = kNoConjunct;
+  bool oddRegional = false;
+  GraphemeBreak previous = kGbControl;
+
+  size_t p = start;
+  while (!reader.atEnd(p)) {
+    size_t next;
+    char32_t c = reader.after(p, next);
+    GraphemeBreak g = graphemeBreak(c);
+    ConjunctBreak incb = conjunctBreak(c);
+
+    if (p != start) {
+      bool joins;
+      if (previous == kGbCR && g == kGbLF)
+        joins = true;
+      else if (isControl(previous) || isControl(g))
+        joins = false;
+      else
+        joins = joinsHangul(previous, g) || g == kGbExtend || g == kGbZWJ ||
+                g == kGbSpacingMark || previous == kGbPrepend ||
+                (incb == kInCbConsonant && conjunct == kLinked) ||
+                (isPictographic(c) && emoji == kPictographicZwj) ||
+                (g == kGbRegionalIndicator && oddRegional);
+      if (!joins)
+        return p;
+    }
+
+    oddRegional = g == kGbRegionalIndicator && !oddRegional;
+    if (isPictographic(c))
+      emoji = kPictographic;
+    else if (emoji == kPictographic && g == kGbZWJ)
+      emoji = kPictographicZwj;
+    else if (emoji != kPictographic || g != kGbExtend)
+      emoji = kNoEmoji;
+    if (incb == kInCbConsonant)
+      conjunct = kConsonant;
+    else if (conjunct != kNoConjunct && incb == kInCbLinker)
+      conjunct = kLinked;
+    else if (incb != kInCbExtend)
+      conjunct = kNoConjunct;
+    previous = g;
+    p = next;
+  }
+  return p;
+}
+
+/* --- Words --- */
+
+bool isIgnorable(WordBreak w) {
+  return w == kWbExtend || w == kWbFormat || w == kWbZWJ;
+}
+
+bool isNewline(WordBreak w) {
+  return w == kWbCR || w == kWbLF || w == kWbNewline;
+}
+
+bool isLetter(WordBreak w) { return w == kWbALetter || w == kWbHebrewLetter; }
+
+bool isMidLetter(WordBreak w) {
+  return w == kWbMidLetter || w == kWbMidNumLet || w == kWbSingleQuote;
+}
+
+bool isMidNum(WordBreak w) {
+  return w == kWbMidNum || w == kWbMidNumLet || w == kWbSingleQuote;
+}
+
+/**
+ * Class of the character WB4 attaches the ignorables before p to, and its
+ * start. Ignorables after a newline or the start of the text stand alone,
+ * and so does nothing at all: both read as kWbExtend, which no later rule
+ * matches.
+ */
+WordBreak wordBaseBefore(Reader &reader, size_t p, size_t &start) {
+  start = p;
+  bool ignored = false;
+  while (!reader.atStart(p)) {
+    WordBreak w = wordBreak(reader.before(p, p));
+    if (!isIgnorable(w)) {
+      if (ignored && isNewline(w))
+        return kWbExtend;
+      start = p;
+      return w;
+    }
+    ignored = true;
+  }
+  return kWbExtend;
+}
+
+WordBreak wordBaseBefore(Reader &reader, size_t p) {
+  size_t start;
+  return wordBaseBefore(reader, p, start);
+}
+
+/** First character at or after p that isn't ignorable, as kWbExtend if none. */
+WordBreak wordBaseAfter(Reader &reader, size_t p) {
+  while (!reader.atEnd(p)) {
+    WordBreak w = wordBreak(reader.after(p, p));
+    if (!isIgnorable(w))
+      return w;
+  }
+  return kWbExtend;
+}
+
+bool isWordBoundary(Reader &reader, size_t p) {
+  if (reader.atStart(p) || reader.atEnd(p))
+    return true; // WB1, WB2
+  if (reader.splitsPair(p))
+    return false;
+  size_t afterEnd;
+  char32_t after = reader.after(p, afterEnd);
+  WordBreak wb = wordBreak(reader.before(p));
+  WordBreak wa = wordBreak(after);
+
+  if (wb == kWbCR && wa == kWbLF)
+    return false; // WB3
+  if (isNewline(wb) || isNewline(wa))
+    return true; // WB3a, WB3b
+  if (wb == kWbZWJ && isPictographic(after))
+    return false; // WB3c
+  if (wb == kWbWSegSpace && wa == kWbWSegSpace)
+    return false; // WB3d
+  if (isIgnorable(wa))
+    return false; // WB4
+
+  size_t leftStart;
+  WordBreak left = wordBaseBefore(reader, p, leftStart);
+  if (isLetter(left) && isLetter(wa))
+    return false; // WB5
+  if (isLetter(left) && isMidLetter(wa) &&
+      isLetter(wordBaseAfter(reader, afterEnd)))
+    return false; // WB6
+  if (isMidLetter(left) && isLetter(wa) &&
+      isLetter(wordBaseBefore(reader, leftStart)))
+    return false; // WB7
+  if (left == kWbHebrewLetter && wa == kWbSingleQuote)
+    return false; // WB7a
+  if (left == kWbHebrewLetter && wa == kWbDoubleQuote &&
+      wordBaseAfter(reader, afterEnd) == kWbHebrewLetter)
+    return false; // WB7b
+  if (left == kWbDoubleQuote && wa == kWbHebrewLetter &&
+      wordBaseBefore(reader, leftStart) == kWbHebrewLetter)
+    return false; // WB7c
+  if ((left == kWbNumeric || isLetter(left)) && wa == kWbNumeric)
+    return false; // WB8, WB9
+  if (left == kWbNumeric && isLetter(wa))
+    return false; // WB10
+  if (isMidNum(left) && wa == kWbNumeric &&
+      wordBaseBefore(reader, leftStart) == kWbNumeric)
+    return false; // WB11
+  if (left == kWbNumeric && isMidNum(wa) &&
+      wordBaseAfter(reader, afterEnd) == kWbNumeric)
+    return false; // WB12
+  if (left == kWbKatakana && wa == kWbKatakana)
+    return false; // WB13
+  if ((isLetter(left) || left == kWbNumeric || left == kWbKatakana ||
+       left == kWbExtendNumLet) &&
+      wa == kWbExtendNumLet)
+    return false; // WB13a
+  if (left == kWbExtendNumLet &&
+      (isLetter(wa) || wa == kWbNumeric || wa == kWbKatakana))
+    return false; // WB13b
+  if (left == kWbRegionalIndicator && wa == kWbRegionalIndicator) {
+    size_t count = 0;
+    size_t q = p;
+    while (wordBaseBefore(reader, q, q) == kWbRegionalIndicator)
+      count++;
+    return count % 2 == 0; // WB15, WB16
+  }
+  return true;
+}
+
+/* --- Tokens --- */
+
+/** Whether a cluster starting with white space starts at p. */
+bool isSeparatorAt(Reader &reader, size_t p) {
+  return isWhiteSpace(reader.after(p)) && isGraphemeBoundary(reader, p);
+}
+
+bool findToken(Reader &reader, size_t position, TextRange &token) {
+  if (!reader.covers(position))
+    return false;
+  size_t p = graphemeStart(reader, position);
+
+  size_t start = p;
+  while (!reader.atStart(start)) {
+    size_t previous;
+    char32_t c = reader.before(start, previous);
+    if (isWhiteSpace(c) && isGraphemeBoundary(reader, previous)) {
+      // The separator cluster may carry marks up to p
+      start = graphemeEnd(reader, previous);
+      break;
+    }
+    start = previous;
+  }
+
+  size_t end = p;
+  while (!reader.atEnd(end) && !isSeparatorAt(reader, end))
+    reader.after(end, end);
+
+  token = {start, end - start};
+  return !reader.incomplete();
+}
+
+} // namespace
+
+const char *segmentationUnicodeVersion() { return kVersion; }
+
+bool isWhiteSpace(char32_t c) {
+  switch (c) {
+  case 0x09:
+  case 0x0A:
+  case 0x0B:
+  case 0x0C:
+  case 0x0D:
+  case 0x20:
+  case 0x85:
+  case 0xA0:
+  case 0x1680:
+  case 0x2028:
+  case 0x2029:
+  case 0x202F:
+  case 0x205F:
+  case 0x3000:
+    return true;
+  default:
+    return c >= 0x2000 && c <= 0x200A;
+  }
+}
+
+bool graphemeAt(const TextWindow &text, size_t index, TextRange &grapheme) {
+  if (index >= text.textLength) {
+    grapheme = {text.textLength, 0};
+    return true;
+  }
+  Reader reader(text);
+  if (!reader.covers(index) || reader.atEnd(index))
+    return false;
+  size_t start = graphemeStart(reader, index);
+  size_t end = graphemeEnd(reader, start);
+  grapheme = {start, end - start};
+  return !reader.incomplete();
+}
+
+bool wordSegmentAt(const TextWindow &text, size_t index,
+                   TextRange &segment) {
+  if (index >= text.textLength) {
+    segment = {text.textLength, 0};
+    return true;
+  }
+  Reader reader(text);
+  if (!reader.covers(index) || reader.atEnd(index))
+    return false;
+  size_t start = index;
+  while (!isWordBoundary(reader, start))
+    reader.before(start, start);
+  size_t end = start;
+  do
+    reader.after(end, end);
+  while (!isWordBoundary(reader, end));
+  segment = {start, end - start};
+  return !reader.incomplete();
+}
+
+bool tokenAt(const TextWindow &text, size_t position, TextRange &token) {
+  Reader reader(text);
+  return findToken(reader, std::min(position, text.textLength), token);
+}
+
+bool tokensIn(const TextWindow &text, TextRange range,
+              std::vector<TextRange> &tokens) {
+  Reader reader(text);
+  size_t rangeStart = std::min(range.start, text.textLength);
+  size_t rangeEnd = std::min(range.end(), text.textLength);
+  TextRange first, last;
+  if (!findToken(reader, rangeStart, first) ||
+      !findToken(reader, rangeEnd, last))
+    return false;
+
+  size_t end = last.end();
+  size_t tokenStart = first.start;
+  size_t found = tokens.size();
+  size_t p = tokenStart;
+  while (p < end) {
+    if (isSeparatorAt(reader, p)) {
+      if (tokenStart < p)
+        tokens.push_back({tokenStart, p - tokenStart});
+      p = graphemeEnd(reader, p);
+      tokenStart = p;
+    } else {
+      reader.after(p, p);
+    }
+  }
+  if (tokenStart < end)
+    tokens.push_back({tokenStart, end - tokenStart});
+
+  if (reader.incomplete()) {
+    tokens.resize(found);
+    return false;
+  }
+  return true;
+}
+
+} // namespace enriched
@@ -0,0 +1,99 @@
+/**
+ * Grapheme cluster and word segmentation (UAX #29) around an offset.
+ */
+
+#pragma once
+
+#include "StyleType.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace enriched {
+
+/**
+ * UTF-16 code units [start, start + length) of a text `textLength` long.
+ * Platforms pass a window around the offset they care about instead of
+ * copying the whole text. Each function below returns false when it needed
+ * code units outside the window; the caller retries with a wider one, so
+ * the cost stays proportional to the segment, not the text.
+ */
+struct TextWindow {
+  const char16_t *data = nullptr;
+  size_t start = 0;
+  size_t length = 0;
+  size_t textLength = 0;
+
+  TextWindow() = default;
+  TextWindow(const char16_t *data, size_t start, size_t length,
+             size_t textLength)
+      : data(data), start(start), length(length), textLength(textLength) {}
+  /** The whole text. */
+  TextWindow(const char16_t *text, size_t length)
+      : TextWindow(text, 0, length, length) {}
+  explicit TextWindow(const std::u16string &text)
+      : TextWindow(text.data(), text.size()) {}
+};
+
+/** Unicode version of the property tables. */
+const char *segmentationUnicodeVersion();
+
+/** Unicode White_Space, the separators between tokens. */
+bool isWhiteSpace(char32_t c);
+
+/**
+ * Extended grapheme cluster containing the code unit at `index`: emoji ZWJ
+ * sequences, flags, Hangul syllables and base characters with their
+ * combining marks stay whole. Empty at the end of the text.
+ */
+bool graphemeAt(const TextWindow &text, size_t index, TextRange &grapheme);
+
+/**
+ * UAX #29 word segment containing the code unit at `index`: a word, a
+ * number, a run of spaces or a single punctuation character.
+ */
+bool wordSegmentAt(const TextWindow &text, size_t index, TextRange &segment);
+
+/**
+ * The token touching caret position `position`, as link and mention
+ * detection see words: the run of grapheme clusters around it that don't
+ * start with white space. URLs and "@name" stay single tokens, which UAX #29
+ * words wouldn't. Empty when there's white space on both sides.
+ */
+bool tokenAt(const TextWindow &text, size_t position, TextRange &token);
+
+/**
+ * Tokens overlapping `range` once it's extended to token boundaries, in
+ * order. Appended to `tokens`, which is left unchanged on failure.
+ */
+bool tokensIn(const TextWindow &text, TextRange range,
+              std::vector<TextRange> &tokens);
+
+/* --- Whole-text conveniences; these can't fail. --- */
+
+inline TextRange graphemeAt(const std::u16string &text, size_t index) {
+  TextRange grapheme;
+  graphemeAt(TextWindow(text), index, grapheme);
+  return grapheme;
+}
+
+inline TextRange wordSegmentAt(const std::u16string &text, size_t index) {
+  TextRange segment;
+  wordSegmentAt(TextWindow(text), index, segment);
+  return segment;
+}
+
+inline TextRange tokenAt(const std::u16string &text, size_t position) {
+  TextRange token;
+  tokenAt(TextWindow(text), position, token);
+  return token;
+}
+
+inline std::vector<TextRange> tokensIn(const std::u16string &text) {
+  std::vector<TextRange> tokens;
+  tokensIn(TextWindow(text), {0, text.size()}, tokens);
+  return tokens;
+}
+
+} // namespace enriched
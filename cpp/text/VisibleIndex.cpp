@@ -0,0 +1,142 @@
+#include "VisibleIndex.hpp"
+#include "PlainText.hpp"
+
+#include <algorithm>
+
+namespace enriched {
+
+VisibleIndex::VisibleIndex() : runs_(1, 0) { rebuild(); }
+
+VisibleIndex::VisibleIndex(const std::u16string &text) { reset(text); }
+
+void VisibleIndex::reset(const std::u16string &text) {
+  reset(text.data(), text.size());
+}
+
+void VisibleIndex::reset(const char16_t *text, size_t length) {
+  runs_.clear();
+  size_t start = 0;
+  for (size_t i = 0; i < length; i++) {
+    if (text[i] == kZeroWidthSpace) {
+      runs_.push_back(i - start);
+      start = i + 1;
+    }
+  }
+  runs_.push_back(length - start);
+  rebuild();
+}
+
+void VisibleIndex::rebuild() {
+  size_t n = runs_.size();
+  tree_.assign(n + 1, 0);
+  visibleLength_ = 0;
+  for (size_t i = 1; i <= n; i++) {
+    tree_[i] += runs_[i - 1];
+    visibleLength_ += runs_[i - 1];
+    size_t parent = i + (i & (~i + 1));
+    if (parent <= n)
+      tree_[parent] += tree_[i];
+  }
+  highBit_ = 1;
+  while (highBit_ * 2 <= n)
+    highBit_ *= 2;
+}
+
+void VisibleIndex::add(size_t index, std::ptrdiff_t delta) {
+  runs_[index] += delta;
+  visibleLength_ += delta;
+  for (size_t i = index + 1; i < tree_.size(); i += i & (~i + 1))
+    tree_[i] += delta;
+}
+
+size_t VisibleIndex::prefix(size_t count) const {
+  size_t sum = 0;
+  for (size_t i = count; i > 0; i -= i & (~i + 1))
+    sum += tree_[i];
+  return sum;
+}
+
+size_t VisibleIndex::runAt(size_t storageIndex) const {
+  if (storageIndex >= length())
+    return runs_.size() - 1;
+  // Binary lifting over storage lengths: every run in a node is followed by
+  // its anchor, which is exact for all nodes below the last run.
+  size_t position = 0;
+  size_t remaining = storageIndex;
+  for (size_t step = highBit_; step > 0; step >>= 1) {
+    size_t next = position + step;
+    if (next < tree_.size() && tree_[next] + step <= remaining) {
+      position = next;
+      remaining -= tree_[next] + step;
+    }
+  }
+  return position;
+}
+
+size_t VisibleIndex::visibleIndex(size_t storageIndex) const {
+  if (storageIndex >= length())
+    return visibleLength_;
+  return storageIndex - runAt(storageIndex);
+}
+
+size_t VisibleIndex::storageIndex(size_t visibleIndex) const {
+  if (visibleIndex > visibleLength_)
+    return length();
+  // Every run that ends before the visible index puts its anchor before it.
+  size_t position = 0;
+  size_t remaining = visibleIndex;
+  for (size_t step = highBit_; step > 0; step >>= 1) {
+    size_t next = position + step;
+    if (next < tree_.size() && tree_[next] < remaining) {
+      position = next;
+      remaining -= tree_[next];
+    }
+  }
+  return visibleIndex + position;
+}
+
+void VisibleIndex::applyEdit(TextRange range,
+                             const std::u16string &replacement) {
+  applyEdit(range, replacement.data(), replacement.size());
+}
+
+void VisibleIndex::applyEdit(TextRange range, const char16_t *replacement,
+                             size_t replacementLength) {
+  size_t from = std::min(range.start, length());
+  size_t to = std::min(range.end(), length());
+  size_t first = runAt(from);
+  size_t last = runAt(to);
+
+  const char16_t *replacementEnd = replacement + replacementLength;
+  bool insertsAnchor =
+      std::find(replacement, replacementEnd, kZeroWidthSpace) != replacementEnd;
+  if (first == last && !insertsAnchor) {
+    add(first, static_cast<std::ptrdiff_t>(replacementLength) -
+                   static_cast<std::ptrdiff_t>(to - from));
+    return;
+  }
+
+  // Runs first..last collapse into prefix + replacement + suffix and are
+  // split again at the replacement's anchors. The anchor after `last`
+  // survives, the ones after first..last-1 were inside the range.
+  size_t prefixLength = from - runStart(first);
+  size_t suffixLength = runStart(last) + runs_[last] - to;
+
+  std::vector<size_t> runs;
+  size_t runBegin = 0;
+  for (size_t i = 0; i < replacementLength; i++) {
+    if (replacement[i] == kZeroWidthSpace) {
+      runs.push_back(i - runBegin);
+      runBegin = i + 1;
+    }
+  }
+  runs.push_back(replacementLength - runBegin);
+  runs.front() += prefixLength;
+  runs.back() += suffixLength;
+
+  runs_.erase(runs_.begin() + first, runs_.begin() + last + 1);
+  runs_.insert(runs_.begin() + first, runs.begin(), runs.end());
+  rebuild();
+}
+
+} // namespace enriched
@@ -0,0 +1,72 @@
+/**
+ * Visible <-> storage index translation for the selection APIs.
+ * JS counts positions without the zero-width spaces the inputs keep as
+ * paragraph anchors.
+ */
+
+#pragma once
+
+#include "StyleType.hpp"
+
+#include <string>
+#include <vector>
+
+namespace enriched {
+
+/**
+ * Fenwick tree over the visible runs between zero-width spaces: run i is
+ * followed by the i-th zero-width space, the last run by the end of the
+ * text. Like ParagraphIndex with the anchor as separator, but the sums
+ * count visible characters only; storage offsets add the number of anchors
+ * before them.
+ *
+ * Rank (storage -> visible) and select (visible -> storage) are O(log n).
+ * Edits that neither remove nor insert anchors are O(log n); the others
+ * splice the run list and rebuild in time linear in the anchor count.
+ *
+ * Attachment placeholders stay visible, as they do in `onChangeText`.
+ * All offsets are UTF-16 code units.
+ */
+class VisibleIndex {
+public:
+  VisibleIndex();
+  explicit VisibleIndex(const std::u16string &text);
+
+  void reset(const std::u16string &text);
+  void reset(const char16_t *text, size_t length);
+
+  size_t length() const { return visibleLength_ + runs_.size() - 1; }
+  size_t visibleLength() const { return visibleLength_; }
+  size_t anchorCount() const { return runs_.size() - 1; }
+
+  /** Visible characters before the storage offset. */
+  size_t visibleIndex(size_t storageIndex) const;
+  /**
+   * First storage offset with the given visible index: a position right
+   * before a run of anchors maps to the start of the run, matching the
+   * scan it replaces. Indices past the end clamp to length().
+   */
+  size_t storageIndex(size_t visibleIndex) const;
+
+  /** Text in the range was replaced with `replacement`. */
+  void applyEdit(TextRange range, const std::u16string &replacement);
+  void applyEdit(TextRange range, const char16_t *replacement,
+                 size_t replacementLength);
+
+private:
+  void rebuild();
+  void add(size_t index, std::ptrdiff_t delta);
+  /** Visible characters in the first `count` runs. */
+  size_t prefix(size_t count) const;
+  /** Storage offset of run `index`. */
+  size_t runStart(size_t index) const { return prefix(index) + index; }
+  /** Run containing the storage offset; an anchor belongs to its run. */
+  size_t runAt(size_t storageIndex) const;
+
+  std::vector<size_t> runs_;
+  std::vector<size_t> tree_; // 1-based Fenwick tree over runs_
+  size_t visibleLength_ = 0;
+  size_t highBit_ = 1;
+};
+
+} // namespace enriched
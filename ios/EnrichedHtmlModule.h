@@ -0,0 +1,9 @@
+#import <React/RCTBridgeModule.h>
+#pragma once
+
+/**
+ * Installs the JSI binding of the native HTML engine
+ * (cpp/jsi/EnrichedHtmlHostObject) into the JS runtime.
+ */
+@interface EnrichedHtmlModule : NSObject <RCTBridgeModule>
+@end
@@ -0,0 +1,23 @@
+#import "EnrichedHtmlModule.h"
+#import <React/RCTBridge+Private.h>
+
+#include "EnrichedHtmlHostObject.hpp"
+
+@implementation EnrichedHtmlModule
+
+@synthesize bridge = _bridge;
+
+RCT_EXPORT_MODULE(EnrichedHtml)
+
+// Blocking, so it runs on the JS thread where the runtime may be touched.
+RCT_EXPORT_BLOCKING_SYNCHRONOUS_METHOD(install) {
+  RCTCxxBridge *cxxBridge = (RCTCxxBridge *)self.bridge;
+  if (cxxBridge == nil || cxxBridge.runtime == nullptr) {
+    return @NO;
+  }
+  enriched::EnrichedHtmlHostObject::install(
+      *static_cast<facebook::jsi::Runtime *>(cxxBridge.runtime));
+  return @YES;
+}
+
+@end
@@ -15,6 +15,8 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class HtmlNormalizationTask;
+
 @interface EnrichedTextInputView
     : RCTViewComponentView <EnrichedViewHost, MediaAttachmentDelegate> {
 @public
@@ -29,8 +31,7 @@ NS_ASSUME_NONNULL_BEGIN
   NSMutableDictionary<NSAttributedStringKey, id> *defaultTypingAttributes;
 @public
   NSDictionary<NSNumber *, id> *stylesDict;
-  NSMutableDictionary<NSNumber *, NSArray<NSNumber *> *> *conflictingStyles;
-  NSMutableDictionary<NSNumber *, NSArray<NSNumber *> *> *blockingStyles;
+  enriched::StyleRules styleRules;
 @public
   BOOL blockEmitting;
 @public
@@ -39,13 +40,20 @@ NS_ASSUME_NONNULL_BEGIN
   NSValue *dotReplacementRange;
 @public
   NSArray<NSDictionary *> *textShortcuts;
+@public
+  HtmlNormalizationTask *_Nullable pendingPaste;
 }
 - (CGSize)measureSize:(CGFloat)maxWidth;
 - (void)emitOnLinkDetectedEvent:(LinkData *)linkData range:(NSRange)range;
 - (void)emitOnMentionEvent:(NSString *)indicator text:(nullable NSString *)text;
 - (void)emitOnPasteImagesEvent:(NSArray<NSDictionary *> *)images;
+- (void)emitOnPastePendingEvent:(BOOL)isPending;
 - (void)anyTextMayHaveBeenModified;
+- (void)cancelPendingPaste;
 - (void)scheduleRelayoutIfNeeded;
+// Union of the paragraphs touched by the range, from the paragraph index
+// rather than a newline scan.
+- (NSRange)paragraphRangeForRange:(NSRange)range;
 
 @end
 
@@ -2,7 +2,9 @@
 #import "AlignmentUtils.h"
 #import "AttachmentLayoutUtils.h"
 #import "CoreText/CoreText.h"
+#import "DocumentSnapshotUtils.h"
 #import "DotReplacementUtils.h"
+#import "EditHistory.h"
 #import "HtmlParser.h"
 #import "ImageAttachment.h"
 #import "KeyboardUtils.h"
@@ -19,18 +21,23 @@
 #import "WordsUtils.h"
 #import "ZeroWidthSpaceUtils.h"
 #import <React/RCTConversions.h>
+#import <React/RCTLog.h>
 #import <ReactNativeEnriched/EnrichedTextInputViewComponentDescriptor.h>
 #import <ReactNativeEnriched/EventEmitters.h>
 #import <ReactNativeEnriched/Props.h>
 #import <ReactNativeEnriched/RCTComponentViewHelpers.h>
 #import <folly/dynamic.h>
 #import <react/utils/ManagedObjectWrapper.h>
+#include "ParagraphIndex.hpp"
+#include "StyleIntervalTree.hpp"
+#include "VisibleIndex.hpp"
+#include <vector>
 
 #define GET_STYLE_STATE(TYPE_ENUM)                                             \
   {                                                                            \
     .isActive = [self isStyleActive:TYPE_ENUM],                                \
-    .isBlocking = [self isStyle:TYPE_ENUM activeInMap:blockingStyles],         \
-    .isConflicting = [self isStyle:TYPE_ENUM activeInMap:conflictingStyles]    \
+    .isBlocking = [self isStyleBlocked:TYPE_ENUM],                             \
+    .isConflicting = [self isStyleConflicting:TYPE_ENUM]                       \
   }
 
 using namespace facebook::react;
@@ -45,6 +52,8 @@ using namespace facebook::react;
   EnrichedTextInputViewShadowNode::ConcreteState::Shared _state;
   int _componentViewHeightUpdateCounter;
   NSMutableSet<NSNumber *> *_activeStyles;
+  // _activeStyles as a mask, for checking them against styleRules
+  enriched::StyleMask _activeStylesMask;
   NSMutableSet<NSNumber *> *_blockedStyles;
   LinkData *_recentlyActiveLinkData;
   NSRange _recentlyActiveLinkRange;
@@ -52,6 +61,8 @@ using namespace facebook::react;
   MentionParams *_recentlyActiveMentionParams;
   NSRange _recentlyActiveMentionRange;
   NSString *_recentlyEmittedHtml;
+  // Whether _recentlyEmittedHtml reflects the latest text change.
+  BOOL _recentlyEmittedHtmlIsCurrent;
   BOOL _emitHtml;
   UILabel *_placeholderLabel;
   UIColor *_placeholderColor;
@@ -62,6 +73,23 @@ using namespace facebook::react;
   NSString *_submitBehavior;
   NSDictionary<NSAttributedStringKey, id> *_capturedAttributesBeforeChange;
   NSString *_recentlyEmittedAlignment;
+  // Visible (JS) <-> storage index translation, kept in step with edits in
+  // didProcessEditing:.
+  enriched::VisibleIndex _visibleIndex;
+  // Style runs of the text storage, kept in step the same way, so selection
+  // changes don't enumerate attributes of every style.
+  enriched::StyleIntervalTree _styleIndex;
+  // Set until the index is first built from the text storage; while set,
+  // edits aren't applied to it.
+  BOOL _styleIndexIsStale;
+  // Styles by the attributes they're stored under, for reindexing a range in
+  // a single pass over its attribute runs.
+  NSDictionary<NSAttributedStringKey, NSArray<NSNumber *> *> *_styleTypesByKey;
+  // Paragraph boundaries of the text storage, for paragraph styles and list
+  // toggles. Built on first use, then kept in step by didProcessEditing:.
+  enriched::ParagraphIndex _paragraphIndex;
+  BOOL _paragraphIndexIsStale;
+  EditHistory *_editHistory;
 }
 
 @synthesize blockEmitting = blockEmitting;
@@ -99,12 +127,8 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
   return attributesManager;
 }
 
-- (NSMutableDictionary<NSNumber *, NSArray<NSNumber *> *> *)conflictingStyles {
-  return conflictingStyles;
-}
-
-- (NSMutableDictionary<NSNumber *, NSArray<NSNumber *> *> *)blockingStyles {
-  return blockingStyles;
+- (enriched::StyleRules)styleRules {
+  return styleRules;
 }
 
 - (NSMutableDictionary<NSAttributedStringKey, id> *)defaultTypingAttributes {
@@ -145,8 +169,19 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
       [[NSMutableDictionary<NSAttributedStringKey, id> alloc] init];
 
   stylesDict = [StyleUtils stylesDictForHost:self isInput:YES];
-  conflictingStyles = [[StyleUtils conflictMap] mutableCopy];
-  blockingStyles = [[StyleUtils blockingMap] mutableCopy];
+  NSMutableDictionary<NSAttributedStringKey, NSMutableArray<NSNumber *> *>
+      *styleTypesByKey = [[NSMutableDictionary alloc] init];
+  for (NSNumber *type in stylesDict) {
+    for (NSString *key in [stylesDict[type] getKeys]) {
+      if (styleTypesByKey[key] == nil) {
+        styleTypesByKey[key] = [[NSMutableArray alloc] init];
+      }
+      [styleTypesByKey[key] addObject:type];
+    }
+  }
+  _styleTypesByKey = styleTypesByKey;
+  _styleIndexIsStale = YES;
+  _paragraphIndexIsStale = YES;
 
   parser = [[InputHtmlParser alloc] initWithInput:self];
   _attachmentViews = [[NSMutableDictionary alloc] init];
@@ -162,6 +197,7 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
   textView.input = self;
   textView.layoutManager.input = self;
   textView.textStorage.delegate = self;
+  _editHistory = [[EditHistory alloc] initWithTextView:textView];
 
   textView.adjustsFontForContentSizeCategory = YES;
   [textView addGestureRecognizer:[[TextBlockTapGestureRecognizer alloc]
@@ -269,13 +305,8 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
     [newConfig setH1Bold:newViewProps.htmlStyle.h1.bold];
 
     // Update style blocks and conflicts for bold
-    if (newViewProps.htmlStyle.h1.bold) {
-      [StyleUtils addStyleBlock:H1 to:Bold forHost:self];
-      [StyleUtils addStyleConflict:Bold to:H1 forHost:self];
-    } else {
-      [StyleUtils removeStyleBlock:H1 from:Bold forHost:self];
-      [StyleUtils removeStyleConflict:Bold from:H1 forHost:self];
-    }
+    styleRules.setHeadingBold(enriched::StyleType::H1,
+                              newViewProps.htmlStyle.h1.bold);
 
     stylePropChanged = YES;
   }
@@ -290,13 +321,8 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
     [newConfig setH2Bold:newViewProps.htmlStyle.h2.bold];
 
     // Update style blocks and conflicts for bold
-    if (newViewProps.htmlStyle.h2.bold) {
-      [StyleUtils addStyleBlock:H2 to:Bold forHost:self];
-      [StyleUtils addStyleConflict:Bold to:H2 forHost:self];
-    } else {
-      [StyleUtils removeStyleBlock:H2 from:Bold forHost:self];
-      [StyleUtils removeStyleConflict:Bold from:H2 forHost:self];
-    }
+    styleRules.setHeadingBold(enriched::StyleType::H2,
+                              newViewProps.htmlStyle.h2.bold);
 
     stylePropChanged = YES;
   }
@@ -311,13 +337,8 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
     [newConfig setH3Bold:newViewProps.htmlStyle.h3.bold];
 
     // Update style blocks and conflicts for bold
-    if (newViewProps.htmlStyle.h3.bold) {
-      [StyleUtils addStyleBlock:H3 to:Bold forHost:self];
-      [StyleUtils addStyleConflict:Bold to:H3 forHost:self];
-    } else {
-      [StyleUtils removeStyleBlock:H3 from:Bold forHost:self];
-      [StyleUtils removeStyleConflict:Bold from:H3 forHost:self];
-    }
+    styleRules.setHeadingBold(enriched::StyleType::H3,
+                              newViewProps.htmlStyle.h3.bold);
 
     stylePropChanged = YES;
   }
@@ -332,13 +353,8 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
     [newConfig setH4Bold:newViewProps.htmlStyle.h4.bold];
 
     // Update style blocks and conflicts for bold
-    if (newViewProps.htmlStyle.h4.bold) {
-      [StyleUtils addStyleBlock:H4 to:Bold forHost:self];
-      [StyleUtils addStyleConflict:Bold to:H4 forHost:self];
-    } else {
-      [StyleUtils removeStyleBlock:H4 from:Bold forHost:self];
-      [StyleUtils removeStyleConflict:Bold from:H4 forHost:self];
-    }
+    styleRules.setHeadingBold(enriched::StyleType::H4,
+                              newViewProps.htmlStyle.h4.bold);
 
     stylePropChanged = YES;
   }
@@ -353,13 +369,8 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
     [newConfig setH5Bold:newViewProps.htmlStyle.h5.bold];
 
     // Update style blocks and conflicts for bold
-    if (newViewProps.htmlStyle.h5.bold) {
-      [StyleUtils addStyleBlock:H5 to:Bold forHost:self];
-      [StyleUtils addStyleConflict:Bold to:H5 forHost:self];
-    } else {
-      [StyleUtils removeStyleBlock:H5 from:Bold forHost:self];
-      [StyleUtils removeStyleConflict:Bold from:H5 forHost:self];
-    }
+    styleRules.setHeadingBold(enriched::StyleType::H5,
+                              newViewProps.htmlStyle.h5.bold);
 
     stylePropChanged = YES;
   }
@@ -374,13 +385,8 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
     [newConfig setH6Bold:newViewProps.htmlStyle.h6.bold];
 
     // Update style blocks and conflicts for bold
-    if (newViewProps.htmlStyle.h6.bold) {
-      [StyleUtils addStyleBlock:H6 to:Bold forHost:self];
-      [StyleUtils addStyleConflict:Bold to:H6 forHost:self];
-    } else {
-      [StyleUtils removeStyleBlock:H6 from:Bold forHost:self];
-      [StyleUtils removeStyleConflict:Bold from:H6 forHost:self];
-    }
+    styleRules.setHeadingBold(enriched::StyleType::H6,
+                              newViewProps.htmlStyle.h6.bold);
 
     stylePropChanged = YES;
   }
@@ -735,6 +741,7 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
       [parser replaceWholeFromHtml:initiallyProcessedHtml];
     }
     textView.selectedRange = NSRange(textView.textStorage.string.length, 0);
+    [_editHistory clear];
   }
 
   // placeholderTextColor
@@ -1005,6 +1012,16 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
   // headings might change in reaction to prop change) so they also are kept
   // separately
   NSMutableSet *newBlockedStyles = [_blockedStyles mutableCopy];
+  enriched::StyleMask blockedMask = styleRules.blockedBy(_activeStylesMask);
+
+  // A cursor reads the typing attributes, a range needs every position styled
+  NSRange selectedRange = textView.selectedRange;
+  enriched::StyleMask coveringMask = 0;
+  if (selectedRange.length > 0) {
+    [self syncStyleIndex];
+    coveringMask = _styleIndex.stylesCovering(
+        {selectedRange.location, selectedRange.length});
+  }
 
   // data for onLinkDetected event
   LinkData *detectedLinkData;
@@ -1020,11 +1037,22 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
     StyleBase *style = stylesDict[type];
 
     BOOL wasActive = [newActiveStyles containsObject:type];
-    BOOL isActive = [style detect:textView.selectedRange];
+    BOOL isActive;
+    if (selectedRange.length == 0) {
+      isActive = [style detect:selectedRange];
+    } else {
+      isActive =
+          (coveringMask & enrichedStyleBit((StyleType)[type integerValue])) !=
+          0;
+      // a selection spanning two different links doesn't count as a link
+      if (isActive && [type integerValue] == [LinkStyle getType]) {
+        isActive = [style detect:selectedRange];
+      }
+    }
 
     BOOL wasBlocked = [newBlockedStyles containsObject:type];
-    BOOL isBlocked = [self isStyle:(StyleType)[type integerValue]
-                       activeInMap:blockingStyles];
+    BOOL isBlocked =
+        (blockedMask & enrichedStyleBit((StyleType)[type integerValue])) != 0;
 
     if (wasActive != isActive) {
       updateNeeded = YES;
@@ -1125,6 +1153,10 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
     if (emitter != nullptr) {
       // update activeStyles and blockedStyles only if emitter is available
       _activeStyles = newActiveStyles;
+      _activeStylesMask = 0;
+      for (NSNumber *type in newActiveStyles) {
+        _activeStylesMask |= enrichedStyleBit((StyleType)[type integerValue]);
+      }
       _blockedStyles = newBlockedStyles;
       _recentlyEmittedAlignment = currentAlignment;
 
@@ -1183,20 +1215,13 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
   return [_activeStyles containsObject:@(type)];
 }
 
-- (bool)isStyle:(StyleType)type activeInMap:(NSDictionary *)styleMap {
-  NSArray *relatedStyles = styleMap[@(type)];
-
-  if (!relatedStyles) {
-    return false;
-  }
-
-  for (NSNumber *style in relatedStyles) {
-    if ([_activeStyles containsObject:style]) {
-      return true;
-    }
-  }
+- (bool)isStyleBlocked:(StyleType)type {
+  return (styleRules.blocks(enrichedStyleType(type)) & _activeStylesMask) != 0;
+}
 
-  return false;
+- (bool)isStyleConflicting:(StyleType)type {
+  return (styleRules.conflicts(enrichedStyleType(type)) & _activeStylesMask) !=
+         0;
 }
 
 - (bool)textInputShouldReturn {
@@ -1282,6 +1307,16 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
   } else if ([commandName isEqualToString:@"requestHTML"]) {
     NSInteger requestId = [((NSNumber *)args[0]) integerValue];
     [self requestHTML:requestId];
+  } else if ([commandName isEqualToString:@"requestSnapshot"]) {
+    NSInteger requestId = [((NSNumber *)args[0]) integerValue];
+    [self requestSnapshot:requestId];
+  } else if ([commandName isEqualToString:@"setSnapshot"]) {
+    NSString *snapshot = (NSString *)args[0];
+    [self setSnapshot:snapshot];
+  } else if ([commandName isEqualToString:@"undo"]) {
+    [self undo];
+  } else if ([commandName isEqualToString:@"redo"]) {
+    [self redo];
   } else if ([commandName isEqualToString:@"setTextAlignment"]) {
     NSString *alignmentString = (NSString *)args[0];
 
@@ -1318,6 +1353,11 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
 }
 
 - (void)setValue:(NSString *)value {
+  // The value replaces whatever a pending paste would have landed in.
+  [self cancelPendingPaste];
+  if ([self isValueShown:value]) {
+    return;
+  }
   NSString *initiallyProcessedHtml = [parser initiallyProcessHtml:value];
   if (initiallyProcessedHtml == nullptr) {
     // reset the text first and reset typing attributes
@@ -1333,46 +1373,69 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
   // set selectedRange and check for changes
   textView.selectedRange = NSRange(textView.textStorage.string.length, 0);
   [self anyTextMayHaveBeenModified];
+  // a new value starts a new history, its edits aren't undoable
+  [_editHistory clear];
 }
 
-- (void)setCustomSelection:(NSInteger)visibleStart end:(NSInteger)visibleEnd {
-  NSString *text = textView.textStorage.string;
-
-  NSUInteger actualStart = [self getActualIndex:visibleStart text:text];
-  NSUInteger actualEnd = [self getActualIndex:visibleEnd text:text];
+- (void)setSnapshot:(NSString *)snapshot {
+  [self cancelPendingPaste];
+  if (![DocumentSnapshotUtils restoreSnapshot:snapshot input:self]) {
+    RCTLogWarn(@"[EnrichedTextInput]: Ignoring malformed snapshot.");
+    return;
+  }
 
-  textView.selectedRange = NSMakeRange(actualStart, actualEnd - actualStart);
+  // set selectedRange and check for changes
+  textView.selectedRange = NSRange(textView.textStorage.string.length, 0);
+  [self anyTextMayHaveBeenModified];
+  [_editHistory clear];
 }
 
-// Helper: Walks through the string skipping ZWSPs to find the Nth visible
-// character
-- (NSUInteger)getActualIndex:(NSInteger)visibleIndex text:(NSString *)text {
-  NSUInteger currentVisibleCount = 0;
-  NSUInteger actualIndex = 0;
+- (void)undo {
+  if ([_editHistory undo]) {
+    [self anyTextMayHaveBeenModified];
+  }
+}
 
-  while (actualIndex < text.length) {
-    if (currentVisibleCount == visibleIndex) {
-      return actualIndex;
-    }
+- (void)redo {
+  if ([_editHistory redo]) {
+    [self anyTextMayHaveBeenModified];
+  }
+}
 
-    // If the current char is not a hidden space, it counts towards our visible
-    // index.
-    if ([text characterAtIndex:actualIndex] != 0x200B) {
-      currentVisibleCount++;
-    }
+/**
+ * Whether `value` is the content, typically our own onChangeHtml output
+ * coming back from JS. Re-parsing it would rebuild identical runs and move
+ * the cursor. Internal HTML is parsed as is, so only the exact string is
+ * known to match: the normalizer drops alignment and custom mention
+ * attributes that the parser keeps.
+ */
+- (BOOL)isValueShown:(NSString *)value {
+  return _recentlyEmittedHtmlIsCurrent &&
+         [value isEqualToString:_recentlyEmittedHtml];
+}
 
-    actualIndex++;
+- (void)setCustomSelection:(NSInteger)visibleStart end:(NSInteger)visibleEnd {
+  NSString *text = textView.textStorage.string;
+  // Text set before the delegate was attached never went through
+  // didProcessEditing:.
+  if (_visibleIndex.length() != text.length) {
+    std::vector<unichar> chars(text.length);
+    [text getCharacters:chars.data() range:NSMakeRange(0, text.length)];
+    _visibleIndex.reset(reinterpret_cast<const char16_t *>(chars.data()),
+                        chars.size());
   }
 
-  return actualIndex;
+  NSUInteger actualStart = _visibleIndex.storageIndex(visibleStart);
+  NSUInteger actualEnd = _visibleIndex.storageIndex(visibleEnd);
+
+  textView.selectedRange = NSMakeRange(actualStart, actualEnd - actualStart);
 }
 
 - (void)emitOnSubmitEdittingEvent {
   auto emitter = [self getEventEmitter];
   if (emitter != nullptr) {
-    NSString *stringToBeEmitted = [[textView.textStorage.string
-        stringByReplacingOccurrencesOfString:@"\u200B"
-                                  withString:@""] copy];
+    NSString *stringToBeEmitted = [ZeroWidthSpaceUtils
+        stringByRemovingZeroWidthSpaces:textView.textStorage.string];
 
     emitter->onSubmitEditing({
         .text = [stringToBeEmitted toCppString],
@@ -1422,6 +1485,13 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
   }
 }
 
+- (void)emitOnPastePendingEvent:(BOOL)isPending {
+  auto emitter = [self getEventEmitter];
+  if (emitter != nullptr) {
+    emitter->onPastePending({.isPending = static_cast<bool>(isPending)});
+  }
+}
+
 - (void)emitOnMentionDetectedEvent:(NSString *)text
                          indicator:(NSString *)indicator
                         attributes:(NSString *)attributes {
@@ -1447,6 +1517,7 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
 }
 
 - (void)tryEmittingOnChangeHtmlEvent {
+  _recentlyEmittedHtmlIsCurrent = NO;
   if (!_emitHtml || textView.markedTextRange != nullptr) {
     return;
   }
@@ -1455,6 +1526,7 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
     NSString *htmlOutput = [HtmlParser
         parseToHtmlFromRange:NSMakeRange(0, textView.textStorage.string.length)
                         host:self];
+    _recentlyEmittedHtmlIsCurrent = YES;
     // make sure html really changed
     if (![htmlOutput isEqualToString:_recentlyEmittedHtml]) {
       _recentlyEmittedHtml = htmlOutput;
@@ -1480,6 +1552,22 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
   }
 }
 
+- (void)requestSnapshot:(NSInteger)requestId {
+  auto emitter = [self getEventEmitter];
+  if (emitter != nullptr) {
+    NSString *snapshot = [DocumentSnapshotUtils snapshotOfInput:self];
+    if (snapshot != nil) {
+      emitter->onRequestSnapshotResult(
+          {.requestId = static_cast<int>(requestId),
+           .snapshot = [snapshot toCppString]});
+    } else {
+      emitter->onRequestSnapshotResult(
+          {.requestId = static_cast<int>(requestId),
+           .snapshot = folly::dynamic(nullptr)});
+    }
+  }
+}
+
 - (void)emitOnKeyPressEvent:(NSString *)key {
   auto emitter = [self getEventEmitter];
   if (emitter != nullptr) {
@@ -1493,7 +1581,7 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
   StyleBase *style = stylesDict[@(type)];
   NSRange range = textView.selectedRange;
   if ([style isParagraph]) {
-    range = [textView.textStorage.string paragraphRangeForRange:range];
+    range = [self paragraphRangeForRange:range];
   }
   if ([StyleUtils handleStyleBlocksAndConflicts:type
                                           range:range
@@ -1509,8 +1597,7 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
   if (style == nullptr) {
     return;
   }
-  NSRange range = [textView.textStorage.string
-      paragraphRangeForRange:textView.selectedRange];
+  NSRange range = [self paragraphRangeForRange:textView.selectedRange];
   if ([StyleUtils handleStyleBlocksAndConflicts:[CheckboxListStyle getType]
                                           range:range
                                         forHost:self]) {
@@ -1661,6 +1748,15 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
   }
 }
 
+- (void)cancelPendingPaste {
+  if (pendingPaste == nil) {
+    return;
+  }
+  [pendingPaste cancel];
+  pendingPaste = nil;
+  [self emitOnPastePendingEvent:NO];
+}
+
 - (void)anyTextMayHaveBeenModified {
   // we don't do no text changes when working with iOS marked text
   if (textView.markedTextRange != nullptr) {
@@ -1729,9 +1825,8 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
       _recentInputString = [textView.textStorage.string copy];
 
       // emit string without zero width spaces
-      NSString *stringToBeEmitted = [[textView.textStorage.string
-          stringByReplacingOccurrencesOfString:@"\u200B"
-                                    withString:@""] copy];
+      NSString *stringToBeEmitted = [ZeroWidthSpaceUtils
+          stringByRemovingZeroWidthSpaces:textView.textStorage.string];
 
       emitter->onChangeText({.value = [stringToBeEmitted toCppString]});
     }
@@ -2083,7 +2178,7 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
 
       NSString *fullText = textView.textStorage.string;
       NSRange paragraphRange =
-          [fullText paragraphRangeForRange:NSMakeRange(charIndex, 0)];
+          [self paragraphRangeForRange:NSMakeRange(charIndex, 0)];
       NSUInteger endOfLineIndex = NSMaxRange(paragraphRange);
 
       // If the paragraph ends with a newline, step back by 1 so the cursor
@@ -2143,10 +2238,96 @@ Class<RCTComponentViewProtocol> EnrichedTextInputViewCls(void) {
     [attributesManager shiftDirtyRangesWithEditedRange:editedRange
                                         changeInLength:delta];
 
+    std::vector<unichar> inserted(editedRange.length);
+    [textStorage.string getCharacters:inserted.data() range:editedRange];
+    _visibleIndex.applyEdit(
+        {editedRange.location, editedRange.length - delta},
+        reinterpret_cast<const char16_t *>(inserted.data()), inserted.size());
+    if (!_paragraphIndexIsStale) {
+      _paragraphIndex.applyEdit(
+          {editedRange.location, editedRange.length - delta},
+          std::u16string(reinterpret_cast<const char16_t *>(inserted.data()),
+                         inserted.size()));
+    }
+
     // Add dirty ranges. We also add zero-length ranges because they are useful
     // for word modification-based changes.
     [attributesManager addDirtyRange:editedRange];
+
+    if (!_styleIndexIsStale) {
+      _styleIndex.applyDeletion(
+          {editedRange.location, editedRange.length - delta});
+      _styleIndex.applyInsertion(editedRange.location, editedRange.length);
+    }
+  }
+
+  if (!_styleIndexIsStale) {
+    [self reindexStylesInRange:editedRange];
+  }
+  [_editHistory textStorage:textStorage
+          didProcessEditing:editedMask
+                      range:editedRange
+             changeInLength:delta];
+}
+
+// Rebuilds the style index runs of the range from the text storage. Runs
+// outside of it were shifted by the edit and still hold, so only the
+// attribute runs of the range are read, once for all the styles.
+- (void)reindexStylesInRange:(NSRange)range {
+  if (range.length == 0) {
+    return;
+  }
+  enriched::TextRange indexRange{range.location, range.length};
+  for (NSNumber *type in stylesDict) {
+    _styleIndex.remove(indexRange, static_cast<enriched::StyleType>(
+                                       [type integerValue]));
+  }
+  [textView.textStorage
+      enumerateAttributesInRange:range
+                         options:0
+                      usingBlock:^(NSDictionary<NSAttributedStringKey, id> *attrs,
+                                   NSRange runRange, BOOL *stop) {
+                        for (NSAttributedStringKey key in attrs) {
+                          for (NSNumber *type in _styleTypesByKey[key]) {
+                            if (![stylesDict[type] styleCondition:attrs[key]
+                                                            range:runRange]) {
+                              continue;
+                            }
+                            // Touching runs of a style coalesce in the index
+                            _styleIndex.add(
+                                {{runRange.location, runRange.length},
+                                 static_cast<enriched::StyleType>(
+                                     [type integerValue])});
+                          }
+                        }
+                      }];
+}
+
+// Builds the index on first use; from then on didProcessEditing: keeps it in
+// step edit by edit.
+- (void)syncStyleIndex {
+  if (!_styleIndexIsStale) {
+    return;
   }
+  _styleIndex.clear();
+  _styleIndexIsStale = NO;
+  [self reindexStylesInRange:NSMakeRange(0, textView.textStorage.length)];
+}
+
+- (NSRange)paragraphRangeForRange:(NSRange)range {
+  NSString *string = textView.textStorage.string;
+  if (_paragraphIndexIsStale) {
+    std::u16string text(string.length, u'\0');
+    [string getCharacters:reinterpret_cast<unichar *>(text.data())
+                    range:NSMakeRange(0, string.length)];
+    _paragraphIndex.reset(text);
+    _paragraphIndexIsStale = NO;
+  }
+  NSUInteger location = MIN(range.location, string.length);
+  NSUInteger length = MIN(range.length, string.length - location);
+  enriched::TextRange paragraphs =
+      _paragraphIndex.paragraphRangeForRange({location, length});
+  return NSMakeRange(paragraphs.start, paragraphs.length);
 }
 
 // MARK: - Media attachments delegate
@@ -19,8 +19,7 @@ NS_ASSUME_NONNULL_BEGIN
   EnrichedConfig *config;
 @public
   NSDictionary<NSNumber *, id> *stylesDict;
-  NSMutableDictionary<NSNumber *, NSArray<NSNumber *> *> *conflictingStyles;
-  NSMutableDictionary<NSNumber *, NSArray<NSNumber *> *> *blockingStyles;
+  enriched::StyleRules styleRules;
   NSMutableDictionary<NSAttributedStringKey, id> *defaultTypingAttributes;
 @public
   BOOL useHtmlNormalizer;
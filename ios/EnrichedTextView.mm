@@ -3,6 +3,7 @@
 #import "EnrichedTextStyleHeaders.h"
 #import "EnrichedTextTextView.h"
 #import "EnrichedTextTouchHandler.h"
+#import "HtmlParser.h"
 #import "LayoutManagerExtension.h"
 #import "LinkData.h"
 #import "MentionParams.h"
@@ -30,6 +31,12 @@ using namespace facebook::react;
   EnrichedTextTouchHandler *_touchHandler;
   TextHtmlParser *_textParser;
   NSString *_content;
+  // Canonical hash of _content as rendered when it went through the
+  // normalizer, 0 otherwise.
+  uint64_t _contentHash;
+  // The normalizer's output for _content, so rendering doesn't normalize it
+  // a second time; nil when _content isn't normalized.
+  NSString *_normalizedContent;
 }
 
 @synthesize blockEmitting = _blockEmitting;
@@ -83,8 +90,6 @@ Class<RCTComponentViewProtocol> EnrichedTextViewCls(void) {
 
 - (void)setupStyles {
   stylesDict = [StyleUtils stylesDictForHost:self isInput:NO];
-  conflictingStyles = [[StyleUtils conflictMap] mutableCopy];
-  blockingStyles = [[StyleUtils blockingMap] mutableCopy];
 }
 
 // MARK: - EnrichedViewHost protocol
@@ -101,12 +106,8 @@ Class<RCTComponentViewProtocol> EnrichedTextViewCls(void) {
   return stylesDict;
 }
 
-- (NSMutableDictionary<NSNumber *, NSArray<NSNumber *> *> *)conflictingStyles {
-  return conflictingStyles;
-}
-
-- (NSMutableDictionary<NSNumber *, NSArray<NSNumber *> *> *)blockingStyles {
-  return blockingStyles;
+- (enriched::StyleRules)styleRules {
+  return styleRules;
 }
 
 - (NSMutableDictionary<NSAttributedStringKey, id> *)defaultTypingAttributes {
@@ -195,13 +196,8 @@ Class<RCTComponentViewProtocol> EnrichedTextViewCls(void) {
     [newConfig setH1Bold:newViewProps.htmlStyle.h1.bold];
 
     // Update style blocks and conflicts for bold
-    if (newViewProps.htmlStyle.h1.bold) {
-      [StyleUtils addStyleBlock:H1 to:Bold forHost:self];
-      [StyleUtils addStyleConflict:Bold to:H1 forHost:self];
-    } else {
-      [StyleUtils removeStyleBlock:H1 from:Bold forHost:self];
-      [StyleUtils removeStyleConflict:Bold from:H1 forHost:self];
-    }
+    styleRules.setHeadingBold(enriched::StyleType::H1,
+                              newViewProps.htmlStyle.h1.bold);
 
     stylePropChanged = YES;
   }
@@ -216,13 +212,8 @@ Class<RCTComponentViewProtocol> EnrichedTextViewCls(void) {
     [newConfig setH2Bold:newViewProps.htmlStyle.h2.bold];
 
     // Update style blocks and conflicts for bold
-    if (newViewProps.htmlStyle.h2.bold) {
-      [StyleUtils addStyleBlock:H2 to:Bold forHost:self];
-      [StyleUtils addStyleConflict:Bold to:H2 forHost:self];
-    } else {
-      [StyleUtils removeStyleBlock:H2 from:Bold forHost:self];
-      [StyleUtils removeStyleConflict:Bold from:H2 forHost:self];
-    }
+    styleRules.setHeadingBold(enriched::StyleType::H2,
+                              newViewProps.htmlStyle.h2.bold);
 
     stylePropChanged = YES;
   }
@@ -237,13 +228,8 @@ Class<RCTComponentViewProtocol> EnrichedTextViewCls(void) {
     [newConfig setH3Bold:newViewProps.htmlStyle.h3.bold];
 
     // Update style blocks and conflicts for bold
-    if (newViewProps.htmlStyle.h3.bold) {
-      [StyleUtils addStyleBlock:H3 to:Bold forHost:self];
-      [StyleUtils addStyleConflict:Bold to:H3 forHost:self];
-    } else {
-      [StyleUtils removeStyleBlock:H3 from:Bold forHost:self];
-      [StyleUtils removeStyleConflict:Bold from:H3 forHost:self];
-    }
+    styleRules.setHeadingBold(enriched::StyleType::H3,
+                              newViewProps.htmlStyle.h3.bold);
 
     stylePropChanged = YES;
   }
@@ -258,13 +244,8 @@ Class<RCTComponentViewProtocol> EnrichedTextViewCls(void) {
     [newConfig setH4Bold:newViewProps.htmlStyle.h4.bold];
 
     // Update style blocks and conflicts for bold
-    if (newViewProps.htmlStyle.h4.bold) {
-      [StyleUtils addStyleBlock:H4 to:Bold forHost:self];
-      [StyleUtils addStyleConflict:Bold to:H4 forHost:self];
-    } else {
-      [StyleUtils removeStyleBlock:H4 from:Bold forHost:self];
-      [StyleUtils removeStyleConflict:Bold from:H4 forHost:self];
-    }
+    styleRules.setHeadingBold(enriched::StyleType::H4,
+                              newViewProps.htmlStyle.h4.bold);
 
     stylePropChanged = YES;
   }
@@ -279,13 +260,8 @@ Class<RCTComponentViewProtocol> EnrichedTextViewCls(void) {
     [newConfig setH5Bold:newViewProps.htmlStyle.h5.bold];
 
     // Update style blocks and conflicts for bold
-    if (newViewProps.htmlStyle.h5.bold) {
-      [StyleUtils addStyleBlock:H5 to:Bold forHost:self];
-      [StyleUtils addStyleConflict:Bold to:H5 forHost:self];
-    } else {
-      [StyleUtils removeStyleBlock:H5 from:Bold forHost:self];
-      [StyleUtils removeStyleConflict:Bold from:H5 forHost:self];
-    }
+    styleRules.setHeadingBold(enriched::StyleType::H5,
+                              newViewProps.htmlStyle.h5.bold);
 
     stylePropChanged = YES;
   }
@@ -300,13 +276,8 @@ Class<RCTComponentViewProtocol> EnrichedTextViewCls(void) {
     [newConfig setH6Bold:newViewProps.htmlStyle.h6.bold];
 
     // Update style blocks and conflicts for bold
-    if (newViewProps.htmlStyle.h6.bold) {
-      [StyleUtils addStyleBlock:H6 to:Bold forHost:self];
-      [StyleUtils addStyleConflict:Bold to:H6 forHost:self];
-    } else {
-      [StyleUtils removeStyleBlock:H6 from:Bold forHost:self];
-      [StyleUtils removeStyleConflict:Bold from:H6 forHost:self];
-    }
+    styleRules.setHeadingBold(enriched::StyleType::H6,
+                              newViewProps.htmlStyle.h6.bold);
 
     stylePropChanged = YES;
   }
@@ -582,6 +553,8 @@ Class<RCTComponentViewProtocol> EnrichedTextViewCls(void) {
   // useHtmlNormalizer
   if (newViewProps.useHtmlNormalizer != oldViewProps.useHtmlNormalizer) {
     useHtmlNormalizer = newViewProps.useHtmlNormalizer;
+    _contentHash = 0;
+    _normalizedContent = nil;
   }
 
   // allowFontScaling
@@ -596,6 +569,22 @@ Class<RCTComponentViewProtocol> EnrichedTextViewCls(void) {
 
   [self syncDefaultTypingAttributesFromConfig];
 
+  // External HTML that normalizes to what's shown would only rebuild
+  // identical runs. Internal HTML is parsed as is, and the normalizer drops
+  // things the parser renders (alignment, custom mention attributes), so a
+  // changed internal string always re-renders; plain text is shown verbatim.
+  if (textChanged) {
+    uint64_t hash = 0;
+    _normalizedContent =
+        useHtmlNormalizer && [HtmlParser isExternalHtml:_content]
+            ? [HtmlParser normalizeExternalHtml:_content hash:&hash]
+            : nil;
+    if (hash != 0 && hash == _contentHash) {
+      textChanged = NO;
+    }
+    _contentHash = hash;
+  }
+
   if (textChanged || stylePropChanged) {
     [self renderContent];
   }
@@ -626,7 +615,8 @@ Class<RCTComponentViewProtocol> EnrichedTextViewCls(void) {
         setAttributedString:[[NSAttributedString alloc] initWithString:@""]];
     return;
   }
-  [_textParser replaceWholeFromHtml:_content];
+  [_textParser replaceWholeFromHtml:_content
+                     normalizedHtml:_normalizedContent];
   [self layoutAttachments];
 }
 
@@ -107,6 +107,7 @@
 - (LinkRegexConfig *)linkRegexConfig;
 - (void)setLinkRegexConfig:(LinkRegexConfig *)newValue;
 - (NSRegularExpression *)parsedLinkRegex;
+- (BOOL)linkRegexMatchesWord:(NSString *)word;
 
 // MARK: - Text only props
 - (UIColor *)linkPressColor;
@@ -1,5 +1,15 @@
 #import <EnrichedConfig.h>
 #import <React/RCTFont.h>
+#include "LinkDetector.hpp"
+#include <memory>
+#include <string>
+
+static std::u16string toUtf16(NSString *string) {
+  std::u16string out(string.length, u'\0');
+  [string getCharacters:reinterpret_cast<unichar *>(out.data())
+                  range:NSMakeRange(0, string.length)];
+  return out;
+}
 
 @implementation EnrichedConfig {
   // shared (text and input)
@@ -58,6 +68,7 @@
   // input only
   LinkRegexConfig *_linkRegexConfig;
   NSRegularExpression *_parsedLinkRegex;
+  std::shared_ptr<enriched::LinkDetector> _linkDetector;
 
   // text only
   UIColor *_linkPressColor;
@@ -126,6 +137,7 @@
   // input only
   copy->_linkRegexConfig = [_linkRegexConfig copy];
   copy->_parsedLinkRegex = [_parsedLinkRegex copy];
+  copy->_linkDetector = _linkDetector;
 
   // text only
   copy->_linkPressColor = [_linkPressColor copy];
@@ -684,12 +696,25 @@
 
 - (void)setLinkRegexConfig:(LinkRegexConfig *)newValue {
   _linkRegexConfig = newValue;
+  _linkDetector = nullptr;
+  _parsedLinkRegex = nullptr;
 
   // try initializing the native regular expression if it applies
   if (_linkRegexConfig.isDefault || _linkRegexConfig.isDisabled) {
     return;
   }
 
+  // patterns within the DFA subset skip NSRegularExpression altogether
+  enriched::LinkRegexConfig config;
+  config.pattern = toUtf16(_linkRegexConfig.pattern);
+  config.caseInsensitive = _linkRegexConfig.caseInsensitive;
+  config.dotAll = _linkRegexConfig.dotAll;
+  config.isDefault = NO;
+  _linkDetector = enriched::LinkDetector::fromConfig(config);
+  if (_linkDetector != nullptr) {
+    return;
+  }
+
   NSError *regexInitError;
   NSRegularExpressionOptions options =
       (_linkRegexConfig.caseInsensitive ? NSRegularExpressionCaseInsensitive
@@ -714,6 +739,22 @@
   return _parsedLinkRegex;
 }
 
+- (BOOL)linkRegexMatchesWord:(NSString *)word {
+  if (_linkDetector == nullptr && _parsedLinkRegex != nullptr) {
+    return [_parsedLinkRegex numberOfMatchesInString:word
+                                             options:0
+                                               range:NSMakeRange(
+                                                         0, word.length)] > 0;
+  }
+
+  // invalid user patterns fall back to the default grammar
+  static enriched::LinkDetector defaultDetector;
+  const enriched::LinkDetector &detector =
+      _linkDetector != nullptr ? *_linkDetector : defaultDetector;
+  std::u16string text = toUtf16(word);
+  return detector.matches(text.data(), text.size());
+}
+
 // MARK: - Text only props
 
 - (UIColor *)linkPressColor {
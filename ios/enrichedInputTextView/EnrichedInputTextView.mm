@@ -5,8 +5,13 @@
 #import "StringExtension.h"
 #import "TextInsertionUtils.h"
 #import "TextListsUtils.h"
+#import "ZeroWidthSpaceUtils.h"
 #import <UniformTypeIdentifiers/UniformTypeIdentifiers.h>
 
+// Pasted external html at least this long (in UTF-16 code units) is
+// normalized off the main thread.
+static const NSUInteger kBackgroundNormalizationThreshold = 16 * 1024;
+
 @implementation EnrichedInputTextView
 
 - (void)layoutSubviews {
@@ -71,7 +76,7 @@
   NSString *plainText = [typedInput->textView.textStorage.string
       substringWithRange:typedInput->textView.selectedRange];
   NSString *fixedPlainText =
-      [plainText stringByReplacingOccurrencesOfString:@"\u200B" withString:@""];
+      [ZeroWidthSpaceUtils stringByRemovingZeroWidthSpaces:plainText];
 
   NSString *parsedHtml =
       [HtmlParser parseToHtmlFromRange:typedInput->textView.selectedRange
@@ -107,6 +112,9 @@
     return;
   }
 
+  // A newer paste supersedes one still being normalized.
+  [typedInput cancelPendingPaste];
+
   UIPasteboard *pasteboard = [UIPasteboard generalPasteboard];
   NSArray<NSString *> *pasteboardTypes = pasteboard.pasteboardTypes;
   NSRange currentRange = typedInput->textView.selectedRange;
@@ -191,23 +199,22 @@
       htmlString = htmlValue;
     }
 
-    // validate the html
-    NSString *initiallyProcessedHtml =
-        [typedInput->parser initiallyProcessHtml:htmlString];
-
-    if (initiallyProcessedHtml != nullptr) {
-      // valid html, let's apply it
-      currentRange.length > 0
-          ? [typedInput->parser replaceFromHtml:initiallyProcessedHtml
-                                          range:currentRange]
-          : [typedInput->parser insertFromHtml:initiallyProcessedHtml
-                                      location:currentRange.location];
-    } else {
-      // fall back to plain text, otherwise do nothing
-      [self tryHandlingPlainTextItemsIn:pasteboard
-                                  range:currentRange
-                                  input:typedInput];
+    // Large external html is normalized in the background and pasted once
+    // ready, so it doesn't block input handling.
+    if (htmlString != nil && typedInput->useHtmlNormalizer &&
+        htmlString.length >= kBackgroundNormalizationThreshold &&
+        [HtmlParser isExternalHtml:htmlString]) {
+      [self pasteHtmlInBackground:htmlString
+                       pasteboard:pasteboard
+                            input:typedInput];
+      return;
     }
+
+    [self pasteHtml:htmlString
+        normalizedHtml:nil
+                 range:currentRange
+            pasteboard:pasteboard
+                 input:typedInput];
   } else {
     [self tryHandlingPlainTextItemsIn:pasteboard
                                 range:currentRange
@@ -217,6 +224,64 @@
   [typedInput anyTextMayHaveBeenModified];
 }
 
+- (void)pasteHtml:(NSString *)html
+    normalizedHtml:(NSString *)normalizedHtml
+             range:(NSRange)range
+        pasteboard:(UIPasteboard *)pasteboard
+             input:(EnrichedTextInputView *)input {
+  // validate the html
+  NSString *initiallyProcessedHtml =
+      [input->parser initiallyProcessHtml:html normalizedHtml:normalizedHtml];
+
+  if (initiallyProcessedHtml != nullptr) {
+    // valid html, let's apply it
+    range.length > 0
+        ? [input->parser replaceFromHtml:initiallyProcessedHtml range:range]
+        : [input->parser insertFromHtml:initiallyProcessedHtml
+                               location:range.location];
+  } else {
+    // fall back to plain text, otherwise do nothing
+    [self tryHandlingPlainTextItemsIn:pasteboard range:range input:input];
+  }
+}
+
+- (void)pasteHtmlInBackground:(NSString *)html
+                   pasteboard:(UIPasteboard *)pasteboard
+                        input:(EnrichedTextInputView *)input {
+  NSInteger changeCount = pasteboard.changeCount;
+  __weak EnrichedInputTextView *weakSelf = self;
+  __weak EnrichedTextInputView *weakInput = input;
+
+  void (^completion)(NSString *) = ^(NSString *normalized) {
+    EnrichedInputTextView *strongSelf = weakSelf;
+    EnrichedTextInputView *strongInput = weakInput;
+    if (strongSelf == nil || strongInput == nil) {
+      return;
+    }
+    strongInput->pendingPaste = nil;
+
+    // Lands at the selection as it is now.
+    NSRange range = strongInput->textView.selectedRange;
+    if (normalized != nil) {
+      [strongSelf pasteHtml:html
+             normalizedHtml:normalized
+                      range:range
+                 pasteboard:pasteboard
+                      input:strongInput];
+    } else if (pasteboard.changeCount == changeCount) {
+      [strongSelf tryHandlingPlainTextItemsIn:pasteboard
+                                        range:range
+                                        input:strongInput];
+    }
+    [strongInput anyTextMayHaveBeenModified];
+    [strongInput emitOnPastePendingEvent:NO];
+  };
+
+  input->pendingPaste =
+      [HtmlParser normalizeExternalHtmlInBackground:html completion:completion];
+  [input emitOnPastePendingEvent:YES];
+}
+
 - (NSDictionary *)detectImageFormat:(NSString *)type {
   if ([type isEqual:UTTypeJPEG.identifier]) {
     return @{@"ext" : @"jpg", @"mime" : @"image/jpeg"};
@@ -2,6 +2,7 @@
 #import "EnrichedTextTouchHandler.h"
 #import "EnrichedTextView.h"
 #import "HtmlParser.h"
+#import "ZeroWidthSpaceUtils.h"
 #import <UniformTypeIdentifiers/UniformTypeIdentifiers.h>
 
 @implementation EnrichedTextTextView
@@ -16,7 +17,7 @@
   NSString *plainText = [host.textView.textStorage.string
       substringWithRange:host.textView.selectedRange];
   NSString *fixedPlainText =
-      [plainText stringByReplacingOccurrencesOfString:@"\u200B" withString:@""];
+      [ZeroWidthSpaceUtils stringByRemovingZeroWidthSpaces:plainText];
 
   NSString *parsedHtml =
       [HtmlParser parseToHtmlFromRange:host.textView.selectedRange host:host];
@@ -5,10 +5,100 @@
 #import "StyleHeaders.h"
 #import "WeakBox.h"
 #import <objc/runtime.h>
+#include "ListNumbering.hpp"
+#include <string>
+
+/// Ordered-list numbers of a layout manager's text, updated edit by edit in
+/// processEditing so drawing a marker doesn't walk back through the list.
+@interface EnrichedListNumberingCache : NSObject
+- (NSUInteger)numberAt:(NSUInteger)index host:(id<EnrichedViewHost>)host;
+- (void)textStorage:(NSTextStorage *)textStorage
+     didEditCharacters:(BOOL)editedCharacters
+                 range:(NSRange)newCharRange
+        changeInLength:(NSInteger)delta
+                  host:(id<EnrichedViewHost>)host;
+@end
+
+@implementation EnrichedListNumberingCache {
+  enriched::ListNumbering _numbering;
+  BOOL _valid;
+}
+
+- (void)refreshParagraphs:(enriched::TextRange)paragraphs
+                     host:(id<EnrichedViewHost>)host {
+  OrderedListStyle *olStyle = host.stylesDict[@([OrderedListStyle getType])];
+  const enriched::ParagraphIndex &index = _numbering.paragraphs();
+  for (size_t p = paragraphs.start;
+       p < paragraphs.end() && p < index.paragraphCount(); p++) {
+    enriched::TextRange range = index.paragraphRange(p);
+    // An empty last paragraph has no marker; detecting at the end of the
+    // text would look at typing attributes.
+    BOOL isItem = olStyle != nullptr && range.length > 0 &&
+                  [olStyle detect:NSMakeRange(range.start, 0)];
+    _numbering.setItem(p, isItem);
+  }
+}
+
+- (void)rebuild:(id<EnrichedViewHost>)host {
+  NSString *text = host.textView.textStorage.string;
+  std::u16string chars(text.length, u'\0');
+  [text getCharacters:reinterpret_cast<unichar *>(&chars[0])
+                range:NSMakeRange(0, text.length)];
+  _numbering.reset(chars);
+  [self refreshParagraphs:{0, _numbering.paragraphCount()} host:host];
+  _valid = YES;
+}
+
+- (NSUInteger)numberAt:(NSUInteger)index host:(id<EnrichedViewHost>)host {
+  if (!_valid || _numbering.length() != host.textView.textStorage.length) {
+    [self rebuild:host];
+  }
+  size_t paragraph = _numbering.paragraphs().paragraphAt(index);
+  if (!_numbering.isItem(paragraph)) {
+    // Drawn as a list item, so the attributes changed without an edit
+    // reaching us; re-read this one.
+    [self refreshParagraphs:{paragraph, 1} host:host];
+  }
+  return MAX(_numbering.number(paragraph), (size_t)1);
+}
+
+- (void)textStorage:(NSTextStorage *)textStorage
+     didEditCharacters:(BOOL)editedCharacters
+                 range:(NSRange)newCharRange
+        changeInLength:(NSInteger)delta
+                  host:(id<EnrichedViewHost>)host {
+  // Built on the first draw; until then there's nothing to keep in step.
+  if (!_valid) {
+    return;
+  }
+  if (_numbering.length() + delta != textStorage.length) {
+    _valid = NO;
+    return;
+  }
+
+  enriched::TextRange touched;
+  if (editedCharacters) {
+    std::u16string inserted(newCharRange.length, u'\0');
+    [textStorage.string getCharacters:reinterpret_cast<unichar *>(&inserted[0])
+                                range:newCharRange];
+    touched = _numbering.applyEdit(
+        {newCharRange.location, newCharRange.length - delta}, inserted.data(),
+        inserted.size());
+  } else {
+    const enriched::ParagraphIndex &index = _numbering.paragraphs();
+    size_t first = index.paragraphAt(newCharRange.location);
+    size_t last = index.paragraphAt(NSMaxRange(newCharRange));
+    touched = {first, last - first + 1};
+  }
+  [self refreshParagraphs:touched host:host];
+}
+
+@end
 
 @implementation NSLayoutManager (LayoutManagerExtension)
 
 static void const *kInputKey = &kInputKey;
+static void const *kListNumberingKey = &kListNumberingKey;
 
 - (id)input {
   WeakBox *box = objc_getAssociatedObject(self, kInputKey);
@@ -22,29 +112,71 @@ static void const *kInputKey = &kInputKey;
                            OBJC_ASSOCIATION_RETAIN_NONATOMIC);
 }
 
+- (EnrichedListNumberingCache *)listNumbering {
+  EnrichedListNumberingCache *cache =
+      objc_getAssociatedObject(self, kListNumberingKey);
+  if (cache == nullptr) {
+    cache = [EnrichedListNumberingCache new];
+    objc_setAssociatedObject(self, kListNumberingKey, cache,
+                             OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+  }
+  return cache;
+}
+
+static void swizzle(Class myClass, SEL originalSelector,
+                    SEL swizzledSelector) {
+  Method originalMethod = class_getInstanceMethod(myClass, originalSelector);
+  Method swizzledMethod = class_getInstanceMethod(myClass, swizzledSelector);
+
+  BOOL didAddMethod = class_addMethod(
+      myClass, originalSelector, method_getImplementation(swizzledMethod),
+      method_getTypeEncoding(swizzledMethod));
+
+  if (didAddMethod) {
+    class_replaceMethod(myClass, swizzledSelector,
+                        method_getImplementation(originalMethod),
+                        method_getTypeEncoding(originalMethod));
+  } else {
+    method_exchangeImplementations(originalMethod, swizzledMethod);
+  }
+}
+
 + (void)load {
   static dispatch_once_t onceToken;
   dispatch_once(&onceToken, ^{
     Class myClass = [NSLayoutManager class];
-    SEL originalSelector = @selector(drawBackgroundForGlyphRange:atPoint:);
-    SEL swizzledSelector = @selector(my_drawBackgroundForGlyphRange:atPoint:);
-    Method originalMethod = class_getInstanceMethod(myClass, originalSelector);
-    Method swizzledMethod = class_getInstanceMethod(myClass, swizzledSelector);
-
-    BOOL didAddMethod = class_addMethod(
-        myClass, originalSelector, method_getImplementation(swizzledMethod),
-        method_getTypeEncoding(swizzledMethod));
-
-    if (didAddMethod) {
-      class_replaceMethod(myClass, swizzledSelector,
-                          method_getImplementation(originalMethod),
-                          method_getTypeEncoding(originalMethod));
-    } else {
-      method_exchangeImplementations(originalMethod, swizzledMethod);
-    }
+    swizzle(myClass, @selector(drawBackgroundForGlyphRange:atPoint:),
+            @selector(my_drawBackgroundForGlyphRange:atPoint:));
+    swizzle(
+        myClass,
+        @selector
+        (processEditingForTextStorage:edited:range:changeInLength:invalidatedRange:),
+        @selector
+        (my_processEditingForTextStorage:edited:range:changeInLength:invalidatedRange:));
   });
 }
 
+- (void)my_processEditingForTextStorage:(NSTextStorage *)textStorage
+                                 edited:(NSTextStorageEditActions)editMask
+                                  range:(NSRange)newCharRange
+                         changeInLength:(NSInteger)delta
+                       invalidatedRange:(NSRange)invalidatedCharRange {
+  id<EnrichedViewHost> host = self.input;
+  if (host != nullptr && textStorage == host.textView.textStorage) {
+    [[self listNumbering]
+              textStorage:textStorage
+        didEditCharacters:(editMask & NSTextStorageEditedCharacters) != 0
+                    range:newCharRange
+           changeInLength:delta
+                     host:host];
+  }
+  [self my_processEditingForTextStorage:textStorage
+                                 edited:editMask
+                                  range:newCharRange
+                         changeInLength:delta
+                       invalidatedRange:invalidatedCharRange];
+}
+
 - (void)my_drawBackgroundForGlyphRange:(NSRange)glyphRange
                                atPoint:(CGPoint)origin {
   [self my_drawBackgroundForGlyphRange:glyphRange atPoint:origin];
@@ -343,43 +475,8 @@ static void const *kInputKey = &kInputKey;
 
 - (NSString *)getDecimalMarkerForList:(id<EnrichedViewHost>)host
                             charIndex:(NSUInteger)index {
-  NSString *fullText = host.textView.textStorage.string;
-  NSInteger itemNumber = 1;
-
-  NSRange currentParagraph =
-      [fullText paragraphRangeForRange:NSMakeRange(index, 0)];
-  if (currentParagraph.location > 0) {
-    OrderedListStyle *olStyle = host.stylesDict[@([OrderedListStyle getType])];
-
-    NSInteger prevParagraphsCount = 0;
-    NSInteger recentParagraphLocation =
-        [fullText paragraphRangeForRange:NSMakeRange(
-                                             currentParagraph.location - 1, 0)]
-            .location;
-
-    // seek for previous lists
-    while (true) {
-      if ([olStyle detect:NSMakeRange(recentParagraphLocation, 0)]) {
-        prevParagraphsCount += 1;
-
-        if (recentParagraphLocation > 0) {
-          recentParagraphLocation =
-              [fullText
-                  paragraphRangeForRange:NSMakeRange(
-                                             recentParagraphLocation - 1, 0)]
-                  .location;
-        } else {
-          break;
-        }
-      } else {
-        break;
-      }
-    }
-
-    itemNumber = prevParagraphsCount + 1;
-  }
-
-  return [NSString stringWithFormat:@"%ld.", (long)(itemNumber)];
+  NSUInteger itemNumber = [[self listNumbering] numberAt:index host:host];
+  return [NSString stringWithFormat:@"%lu.", (unsigned long)itemNumber];
 }
 
 // Returns a usedRect adjusted to cover only the text portion of the line.
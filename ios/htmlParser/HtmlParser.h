@@ -2,9 +2,42 @@
 #import "EnrichedViewHost.h"
 #import <UIKit/UIKit.h>
 
+/**
+ * Normalization of external HTML on the shared background worker
+ * (cpp/parser/NormalizationWorker).
+ */
+@interface HtmlNormalizationTask : NSObject
+@property(nonatomic, readonly) BOOL cancelled;
+/** Drops the result; the completion won't run. Main thread only. */
+- (void)cancel;
+@end
+
 @interface HtmlParser : NSObject
 + (NSString *_Nullable)initiallyProcessHtml:(NSString *_Nonnull)html
                           useHtmlNormalizer:(BOOL)useHtmlNormalizer;
+/** Same, with the normalizer's output for `html` already at hand. */
++ (NSString *_Nullable)initiallyProcessHtml:(NSString *_Nonnull)html
+                          useHtmlNormalizer:(BOOL)useHtmlNormalizer
+                             normalizedHtml:(NSString *_Nullable)normalizedHtml;
+/** Whether initiallyProcessHtml would run `html` through the normalizer. */
++ (BOOL)isExternalHtml:(NSString *_Nonnull)html;
+/**
+ * Normalizes external HTML for a view to load, and sets `hash` to
+ * GumboParser::hashNormalized of the result: equal for values that normalize
+ * to the same HTML, so views can skip re-parsing one they already show and
+ * otherwise render from the returned string. nil, leaving `hash` as it was,
+ * when normalization fails.
+ */
++ (NSString *_Nullable)normalizeExternalHtml:(NSString *_Nonnull)html
+                                        hash:(uint64_t *_Nullable)hash;
+/**
+ * Normalizes `html` off the main thread; `completion` runs on the main thread
+ * with the result (nil on failure) unless the task was cancelled first.
+ */
++ (HtmlNormalizationTask *_Nonnull)
+    normalizeExternalHtmlInBackground:(NSString *_Nonnull)html
+                           completion:(void (^_Nonnull)(NSString *_Nullable))
+                                          completion;
 + (NSArray *_Nonnull)getTextAndStylesFromHtml:(NSString *_Nonnull)fixedHtml;
 + (NSString *_Nonnull)parseToHtmlFromRange:(NSRange)range
                                       host:(id<EnrichedViewHost>)host;
@@ -8,7 +8,61 @@
 #import "StyleHeaders.h"
 #import "StylePair.h"
 
+#include "BlobStore.hpp"
 #include "GumboParser.hpp"
+#include "NormalizationWorker.hpp"
+
+// All of the string's UTF-8 bytes; UTF8String would end at an embedded NUL.
+static std::string toUtf8(NSString *string) {
+  std::string utf8(
+      [string maximumLengthOfBytesUsingEncoding:NSUTF8StringEncoding], '\0');
+  NSUInteger used = 0;
+  [string getBytes:utf8.data()
+           maxLength:utf8.size()
+          usedLength:&used
+            encoding:NSUTF8StringEncoding
+             options:NSStringEncodingConversionAllowLossy
+               range:NSMakeRange(0, string.length)
+      remainingRange:NULL];
+  utf8.resize(used);
+  return utf8;
+}
+
+@implementation HtmlNormalizationTask {
+  std::shared_ptr<enriched::CancellationToken> _token;
+}
+
+- (instancetype)initWithHtml:(NSString *)html
+                  completion:(void (^)(NSString *_Nullable))completion {
+  self = [super init];
+  if (self) {
+    HtmlNormalizationTask *task = self;
+    _token = enriched::NormalizationWorker::shared().submit(
+        toUtf8(html),
+        [task, completion](const char *data, size_t length) {
+          NSString *normalized = nil;
+          if (data != nullptr && length > 0) {
+            normalized = [[NSString alloc] initWithBytes:data
+                                                  length:length
+                                                encoding:NSUTF8StringEncoding];
+          }
+          dispatch_async(dispatch_get_main_queue(), ^{
+            // A cancel may have landed after the worker finished.
+            if (!task.cancelled) {
+              completion(normalized);
+            }
+          });
+        });
+  }
+  return self;
+}
+
+- (void)cancel {
+  _cancelled = YES;
+  _token->cancel();
+}
+
+@end
 
 @implementation HtmlParser
 
@@ -140,11 +194,25 @@
  * strips unknown tags while preserving text
  */
 + (NSString *_Nullable)normalizeExternalHtml:(NSString *_Nonnull)html {
-  std::string result =
-      GumboParser::normalizeHtml(std::string([html UTF8String]));
-  if (result.empty())
-    return nil;
-  return [NSString stringWithUTF8String:result.c_str()];
+  return [self normalizeExternalHtml:html hash:NULL];
+}
+
++ (NSString *_Nullable)normalizeExternalHtml:(NSString *_Nonnull)html
+                                        hash:(uint64_t *_Nullable)hash {
+  std::string utf8 = toUtf8(html);
+  NSString *result = nil;
+  GumboParser::normalizeHtmlForView(
+      utf8.data(), utf8.size(), [&](const char *data, size_t length) {
+        if (hash != NULL) {
+          *hash = GumboParser::hashNormalized(data, length);
+        }
+        if (length > 0) {
+          result = [[NSString alloc] initWithBytes:data
+                                            length:length
+                                          encoding:NSUTF8StringEncoding];
+        }
+      });
+  return result;
 }
 
 + (void)finalizeTagEntry:(NSMutableString *)tagName
@@ -206,8 +274,32 @@
   return statesInRange;
 }
 
++ (HtmlNormalizationTask *_Nonnull)
+    normalizeExternalHtmlInBackground:(NSString *_Nonnull)html
+                           completion:(void (^_Nonnull)(NSString *_Nullable))
+                                          completion {
+  return [[HtmlNormalizationTask alloc] initWithHtml:html
+                                          completion:completion];
+}
+
++ (BOOL)isExternalHtml:(NSString *_Nonnull)html {
+  NSString *trimmed = [html
+      stringByTrimmingCharactersInSet:[NSCharacterSet
+                                          whitespaceAndNewlineCharacterSet]];
+  return !([trimmed hasPrefix:@"<html>"] && [trimmed hasSuffix:@"</html>"]);
+}
+
 + (NSString *_Nullable)initiallyProcessHtml:(NSString *_Nonnull)html
                           useHtmlNormalizer:(BOOL)useHtmlNormalizer {
+  return [self initiallyProcessHtml:html
+                  useHtmlNormalizer:useHtmlNormalizer
+                     normalizedHtml:nil];
+}
+
++ (NSString *_Nullable)initiallyProcessHtml:(NSString *_Nonnull)html
+                          useHtmlNormalizer:(BOOL)useHtmlNormalizer
+                             normalizedHtml:
+                                 (NSString *_Nullable)normalizedHtml {
   NSString *htmlWithoutSpaces = [self stripExtraWhiteSpacesAndNewlines:html];
   NSString *fixedHtml = nullptr;
 
@@ -235,7 +327,8 @@
       // External HTML (from Google Docs, Word, web pages, etc.)
       // Run through the Gumbo-based normalizer to convert arbitrary HTML
       // into our canonical tag subset.
-      NSString *normalized = [self normalizeExternalHtml:html];
+      NSString *normalized =
+          normalizedHtml ?: [self normalizeExternalHtml:html];
       if (normalized != nil) {
         fixedHtml = normalized;
       }
@@ -1314,9 +1407,18 @@
       if (imageStyle != nullptr) {
         ImageData *data = [imageStyle getImageDataAt:location];
         if (data != nullptr && data.uri != nullptr) {
+          NSString *src = data.uri;
+          // Pasted data: URI images are held as blob store handles; export
+          // restores the original URI so the HTML stands on its own.
+          if (enriched::BlobStore::isHandle([src toCppString])) {
+            std::string dataUri =
+                enriched::BlobStore::shared().dataUri([src toCppString]);
+            if (!dataUri.empty())
+              src = [NSString fromCppString:dataUri];
+          }
           return [NSString
               stringWithFormat:@"img src=\"%@\" width=\"%f\" height=\"%f\"",
-                               data.uri, data.width, data.height];
+                               src, data.width, data.height];
         }
       }
       return @"img";
@@ -1,10 +1,17 @@
 #pragma once
+#import "AlignmentEntry.h"
 #import <UIKit/UIKit.h>
 
 @interface InputHtmlParser : NSObject
 - (instancetype _Nonnull)initWithInput:(id _Nonnull)input;
 - (void)replaceWholeFromHtml:(NSString *_Nonnull)html;
+// Replaces the text with already processed styles, as returned by HtmlParser
+- (void)replaceWholeFromText:(NSString *_Nonnull)text
+             processedStyles:(NSArray *_Nonnull)processedStyles
+                  alignments:(NSArray<AlignmentEntry *> *_Nonnull)alignments;
 - (void)replaceFromHtml:(NSString *_Nonnull)html range:(NSRange)range;
 - (void)insertFromHtml:(NSString *_Nonnull)html location:(NSInteger)location;
 - (NSString *_Nullable)initiallyProcessHtml:(NSString *_Nonnull)html;
+- (NSString *_Nullable)initiallyProcessHtml:(NSString *_Nonnull)html
+                             normalizedHtml:(NSString *_Nullable)normalizedHtml;
 @end
@@ -25,19 +25,9 @@
 
   @try {
     NSArray *processingResult = [HtmlParser getTextAndStylesFromHtml:html];
-    NSString *plainText = (NSString *)processingResult[0];
-    NSArray *stylesInfo = (NSArray *)processingResult[1];
-    NSArray *alignments = (NSArray *)processingResult[2];
-
-    // set new text
-    _input->textView.text = plainText;
-
-    // re-apply the styles
-    [self applyProcessedStyles:stylesInfo
-           offsetFromBeginning:0
-               plainTextLength:plainText.length];
-    [self applyProcessedAlignments:alignments offset:0];
-    [_input anyTextMayHaveBeenModified];
+    [self replaceWholeFromText:(NSString *)processingResult[0]
+               processedStyles:(NSArray *)processingResult[1]
+                    alignments:(NSArray *)processingResult[2]];
   } @catch (NSException *exception) {
     RCTLogWarn(@"[EnrichedTextInput]: Failed to parse HTML: (%@), falling back "
                @"to raw input.",
@@ -48,6 +38,23 @@
   }
 }
 
+- (void)replaceWholeFromText:(NSString *_Nonnull)text
+             processedStyles:(NSArray *_Nonnull)processedStyles
+                  alignments:(NSArray<AlignmentEntry *> *_Nonnull)alignments {
+  _input->textView.text = @"";
+  _input->textView.typingAttributes = _input->defaultTypingAttributes;
+
+  // set new text
+  _input->textView.text = text;
+
+  // re-apply the styles
+  [self applyProcessedStyles:processedStyles
+         offsetFromBeginning:0
+             plainTextLength:text.length];
+  [self applyProcessedAlignments:alignments offset:0];
+  [_input anyTextMayHaveBeenModified];
+}
+
 - (void)replaceFromHtml:(NSString *_Nonnull)html range:(NSRange)range {
   @try {
     NSArray *processingResult = [HtmlParser getTextAndStylesFromHtml:html];
@@ -222,4 +229,12 @@
                         useHtmlNormalizer:_input->useHtmlNormalizer];
 }
 
+- (NSString *_Nullable)initiallyProcessHtml:(NSString *_Nonnull)html
+                             normalizedHtml:
+                                 (NSString *_Nullable)normalizedHtml {
+  return [HtmlParser initiallyProcessHtml:html
+                        useHtmlNormalizer:_input->useHtmlNormalizer
+                           normalizedHtml:normalizedHtml];
+}
+
 @end
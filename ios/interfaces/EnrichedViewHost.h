@@ -3,6 +3,7 @@
 #import "InputAttributesManager.h"
 #import "StyleTypeEnum.h"
 #import <UIKit/UIKit.h>
+#include "StyleRules.hpp"
 
 @protocol EnrichedViewHost <NSObject>
 @required
@@ -10,10 +11,7 @@
 @property(nonatomic, readonly) EnrichedConfig *_Nonnull config;
 @property(nonatomic, readonly)
     NSDictionary<NSNumber *, id> *_Nonnull stylesDict;
-@property(nonatomic, readonly, nullable)
-    NSMutableDictionary<NSNumber *, NSArray<NSNumber *> *> *conflictingStyles;
-@property(nonatomic, readonly, nullable)
-    NSMutableDictionary<NSNumber *, NSArray<NSNumber *> *> *blockingStyles;
+@property(nonatomic, readonly) enriched::StyleRules styleRules;
 @property(nonatomic, readonly, nullable)
     NSMutableDictionary<NSAttributedStringKey, id> *defaultTypingAttributes;
 @property(nonatomic) BOOL blockEmitting;
@@ -23,4 +21,5 @@
 - (void)emitOnLinkDetectedEvent:(id _Nonnull)linkData range:(NSRange)range;
 - (void)emitOnMentionEvent:(NSString *_Nonnull)indicator
                       text:(NSString *_Nullable)text;
+- (NSRange)paragraphRangeForRange:(NSRange)range;
 @end
@@ -1,5 +1,8 @@
 #import "ImageAttachment.h"
 #import "ImageExtension.h"
+#import "StringExtension.h"
+
+#include "BlobStore.hpp"
 
 // NSTextStorage frequently recreates NSTextAttachment objects during attribute
 // invalidation (e.g. on every keystroke). Without this cache each recreation
@@ -79,8 +82,18 @@ static NSCache<NSString *, UIImage *> *ImageAttachmentCache(void) {
     return;
   }
 
+  // Images pasted as data: URIs live in the blob store, which never frees
+  // them, so they are decoded from its memory without a copy.
+  const enriched::Blob *blob =
+      enriched::BlobStore::shared().get([self.uri toCppString]);
+
   dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
-    NSData *bytes = [NSData dataWithContentsOfURL:url];
+    NSData *bytes =
+        blob != nullptr
+            ? [NSData dataWithBytesNoCopy:(void *)blob->bytes.data()
+                                   length:blob->bytes.size()
+                             freeWhenDone:NO]
+            : [NSData dataWithContentsOfURL:url];
 
     // We pass all image data (including static formats like PNG or JPEG)
     // through the animated image parser. It safely acts as a universal parser,
@@ -9,6 +9,7 @@
 @property(nonatomic, weak) id<EnrichedViewHost> host;
 + (StyleType)getType;
 - (NSString *)getKey;
+- (NSArray<NSString *> *)getKeys;
 - (NSString *)getValue;
 - (NSString *)getMarkerPrefix;
 - (BOOL)isParagraph;
@@ -16,6 +17,7 @@
 - (BOOL)appliesStylingToTyping;
 - (instancetype)initWithHost:(id<EnrichedViewHost>)host;
 - (NSRange)actualUsedRange:(NSRange)range;
+- (NSRange)paragraphRangeForRange:(NSRange)range;
 - (void)toggle:(NSRange)range;
 - (void)add:(NSRange)range
         withTyping:(BOOL)withTyping
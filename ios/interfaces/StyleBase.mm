@@ -20,6 +20,11 @@
   return @"NoneAttribute";
 }
 
+// Every attribute the style can be stored under; only links use more than one
+- (NSArray<NSString *> *)getKeys {
+  return @[ [self getKey] ];
+}
+
 // Basic inline styles will use this default value, paragraph styles will
 // override it and parametrised ones completely don't use it
 - (NSString *)getValue {
@@ -55,6 +60,14 @@
 - (NSRange)actualUsedRange:(NSRange)range {
   if (![self isParagraph])
     return range;
+  return [self paragraphRangeForRange:range];
+}
+
+// Hosts that index their paragraphs answer this themselves
+- (NSRange)paragraphRangeForRange:(NSRange)range {
+  if ([self.host respondsToSelector:@selector(paragraphRangeForRange:)]) {
+    return [self.host paragraphRangeForRange:range];
+  }
   return [self.host.textView.textStorage.string paragraphRangeForRange:range];
 }
 
@@ -54,8 +54,7 @@
 }
 
 - (NSRange)actualUsedRange:(NSRange)range {
-  NSRange paragraphRange =
-      [self.host.textView.textStorage.string paragraphRangeForRange:range];
+  NSRange paragraphRange = [self paragraphRangeForRange:range];
   return [self expandRangeToContiguousList:paragraphRange];
 }
 
@@ -135,7 +134,7 @@
 
   // Expand Backward
   NSRange startParagraph =
-      [text paragraphRangeForRange:NSMakeRange(range.location, 0)];
+      [self paragraphRangeForRange:NSMakeRange(range.location, 0)];
 
   // Find which list style is active at the start
   StyleBase *activeStartStyle = nil;
@@ -151,7 +150,7 @@
     NSRange currentPara = startParagraph;
     while (currentPara.location > 0) {
       // Check the paragraph before the current one
-      NSRange prevPara = [text
+      NSRange prevPara = [self
           paragraphRangeForRange:NSMakeRange(currentPara.location - 1, 0)];
 
       if ([activeStartStyle detect:prevPara]) {
@@ -168,7 +167,7 @@
   // Expand forward, we check the paragraph at the end of the current selection
   NSUInteger endLoc =
       (range.length > 0) ? (NSMaxRange(range) - 1) : range.location;
-  NSRange endParagraph = [text paragraphRangeForRange:NSMakeRange(endLoc, 0)];
+  NSRange endParagraph = [self paragraphRangeForRange:NSMakeRange(endLoc, 0)];
 
   // Find which list style is active at the end
   StyleBase *activeEndStyle = nil;
@@ -185,7 +184,7 @@
     while (NSMaxRange(currentPara) < text.length) {
       // Check the paragraph after the current one
       NSRange nextPara =
-          [text paragraphRangeForRange:NSMakeRange(NSMaxRange(currentPara), 0)];
+          [self paragraphRangeForRange:NSMakeRange(NSMaxRange(currentPara), 0)];
 
       if ([activeEndStyle detect:nextPara]) {
         // It's still the same list -> expand our range.
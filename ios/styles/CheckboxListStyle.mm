@@ -108,8 +108,8 @@
   BOOL isCurrentlyChecked =
       [list.markerFormat isEqualToString:@"EnrichedCheckbox1"];
 
-  NSRange paragraphRange = [self.host.textView.textStorage.string
-      paragraphRangeForRange:NSMakeRange(location, 0)];
+  NSRange paragraphRange =
+      [self paragraphRangeForRange:NSMakeRange(location, 0)];
 
   [self addWithChecked:!isCurrentlyChecked
                  range:paragraphRange
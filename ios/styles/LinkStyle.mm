@@ -20,6 +20,10 @@ static NSString *const AutomaticLinkAttributeName = @"EnrichedAutomaticLink";
   return ManualLinkAttributeName;
 }
 
+- (NSArray<NSString *> *)getKeys {
+  return @[ ManualLinkAttributeName, AutomaticLinkAttributeName ];
+}
+
 - (BOOL)isParagraph {
   return NO;
 }
@@ -327,27 +331,8 @@ static NSString *const AutomaticLinkAttributeName = @"EnrichedAutomaticLink";
 
   // all conditions are met; try matching the word to a proper regex
 
-  NSString *regexPassedUrl = nullptr;
-  NSRange matchingRange = NSMakeRange(0, word.length);
-
-  if (linkRegexConfig.isDefault) {
-    // use default regex
-    regexPassedUrl = [self tryMatchingDefaultLinkRegex:word
-                                            matchRange:matchingRange];
-  } else {
-    // use user defined regex if it exists
-    NSRegularExpression *userRegex = [self.host.config parsedLinkRegex];
-
-    if (userRegex == nullptr) {
-      // fallback to default regex
-      regexPassedUrl = [self tryMatchingDefaultLinkRegex:word
-                                              matchRange:matchingRange];
-    } else if ([userRegex numberOfMatchesInString:word
-                                          options:0
-                                            range:matchingRange]) {
-      regexPassedUrl = word;
-    }
-  }
+  NSString *regexPassedUrl =
+      [self.host.config linkRegexMatchesWord:word] ? word : nullptr;
 
   if (regexPassedUrl != nullptr) {
     // add style only if needed
@@ -378,23 +363,6 @@ static NSString *const AutomaticLinkAttributeName = @"EnrichedAutomaticLink";
   }
 }
 
-- (NSString *)tryMatchingDefaultLinkRegex:(NSString *)word
-                               matchRange:(NSRange)range {
-  if ([[LinkStyle fullRegex] numberOfMatchesInString:word
-                                             options:0
-                                               range:range] ||
-      [[LinkStyle wwwRegex] numberOfMatchesInString:word
-                                            options:0
-                                              range:range] ||
-      [[LinkStyle bareRegex] numberOfMatchesInString:word
-                                             options:0
-                                               range:range]) {
-    return word;
-  }
-
-  return nullptr;
-}
-
 // handles refreshing manual links
 - (void)handleManualLinks:(NSString *)word inRange:(NSRange)wordRange {
   // look for manual links within the word
@@ -486,47 +454,4 @@ static NSString *const AutomaticLinkAttributeName = @"EnrichedAutomaticLink";
   }
 }
 
-+ (NSRegularExpression *)fullRegex {
-  static NSRegularExpression *regex;
-  static dispatch_once_t onceToken;
-  dispatch_once(&onceToken, ^{
-    regex =
-        [NSRegularExpression regularExpressionWithPattern:
-                                 @"http(s)?:\\/\\/"
-                                 @"www\\.[-a-zA-Z0-9@:%._\\+~#=]{1,256}\\.[a-"
-                                 @"z]{2,6}\\b([-a-zA-Z0-9@:%_\\+.~#?&//=]*)"
-                                                  options:0
-                                                    error:nullptr];
-  });
-  return regex;
-}
-
-+ (NSRegularExpression *)wwwRegex {
-  static NSRegularExpression *regex;
-  static dispatch_once_t onceToken;
-  dispatch_once(&onceToken, ^{
-    regex =
-        [NSRegularExpression regularExpressionWithPattern:
-                                 @"www\\.[-a-zA-Z0-9@:%._\\+~#=]{1,256}\\.[a-"
-                                 @"z]{2,6}\\b([-a-zA-Z0-9@:%_\\+.~#?&//=]*)"
-                                                  options:0
-                                                    error:nullptr];
-  });
-  return regex;
-}
-
-+ (NSRegularExpression *)bareRegex {
-  static NSRegularExpression *regex;
-  static dispatch_once_t onceToken;
-  dispatch_once(&onceToken, ^{
-    regex =
-        [NSRegularExpression regularExpressionWithPattern:
-                                 @"[-a-zA-Z0-9@:%._\\+~#=]{1,256}\\.[a-z]{2,"
-                                 @"6}\\b([-a-zA-Z0-9@:%_\\+.~#?&//=]*)"
-                                                  options:0
-                                                    error:nullptr];
-  });
-  return regex;
-}
-
 @end
@@ -2,6 +2,7 @@
 #import "ColorExtension.h"
 #import "EnrichedTextInputView.h"
 #import "StyleHeaders.h"
+#import "StyleUtils.h"
 #import "TextInsertionUtils.h"
 #import "UIView+React.h"
 #import "WordsUtils.h"
@@ -311,14 +312,16 @@ static NSString *const MentionAttributeName = @"EnrichedMention";
 
   // get style classes that the mention shouldn't be recognized in, together
   // with other mentions
-  NSArray *conflicts = self.host.conflictingStyles[@([MentionStyle getType])];
-  NSArray *blocks = self.host.blockingStyles[@([MentionStyle getType])];
-  NSArray *allConflicts = [[conflicts arrayByAddingObjectsFromArray:blocks]
-      arrayByAddingObject:@([MentionStyle getType])];
+  enriched::StyleRules rules = self.host.styleRules;
+  enriched::StyleType mention = enrichedStyleType([MentionStyle getType]);
+  enriched::StyleMask allConflicts = rules.conflicts(mention) |
+                                     rules.blocks(mention) |
+                                     enriched::styleBit(mention);
   BOOL conflictingStyle = NO;
 
-  for (NSNumber *styleType in allConflicts) {
-    StyleBase *styleInst = self.host.stylesDict[styleType];
+  for (; allConflicts != 0; allConflicts &= allConflicts - 1) {
+    StyleBase *styleInst =
+        self.host.stylesDict[@((StyleType)enriched::firstStyle(allConflicts))];
     if (styleInst != nullptr && [styleInst any:candidateRange]) {
       conflictingStyle = YES;
       break;
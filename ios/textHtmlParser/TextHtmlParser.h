@@ -6,5 +6,7 @@
 @interface TextHtmlParser : NSObject
 @property(nonatomic, weak) EnrichedTextView *view;
 - (instancetype _Nonnull)initWithView:(EnrichedTextView *_Nonnull)view;
-- (void)replaceWholeFromHtml:(NSString *_Nonnull)html;
+/** `normalizedHtml` is the normalizer's output for `html`, if already known. */
+- (void)replaceWholeFromHtml:(NSString *_Nonnull)html
+              normalizedHtml:(NSString *_Nullable)normalizedHtml;
 @end
@@ -17,11 +17,13 @@
   return self;
 }
 
-- (void)replaceWholeFromHtml:(NSString *_Nonnull)html {
+- (void)replaceWholeFromHtml:(NSString *_Nonnull)html
+              normalizedHtml:(NSString *_Nullable)normalizedHtml {
   @try {
     NSString *normalized =
         [HtmlParser initiallyProcessHtml:html
-                       useHtmlNormalizer:_view->useHtmlNormalizer];
+                       useHtmlNormalizer:_view->useHtmlNormalizer
+                          normalizedHtml:normalizedHtml];
     if (normalized == nil) {
       [_view->textView.textStorage
           setAttributedString:[[NSAttributedString alloc]
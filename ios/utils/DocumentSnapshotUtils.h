@@ -0,0 +1,19 @@
+#pragma once
+#import "EnrichedTextInputView.h"
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Base64 encoded cpp/document/DocumentSnapshot of the input, in the same format
+// as on Android.
+@interface DocumentSnapshotUtils : NSObject
+
++ (NSString *_Nullable)snapshotOfInput:(EnrichedTextInputView *)input;
+
+// Returns NO and leaves the input untouched for malformed snapshots.
++ (BOOL)restoreSnapshot:(NSString *)snapshot
+                  input:(EnrichedTextInputView *)input;
+
+@end
+
+NS_ASSUME_NONNULL_END
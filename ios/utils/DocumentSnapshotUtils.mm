@@ -0,0 +1,238 @@
+#import "DocumentSnapshotUtils.h"
+#import "AlignmentUtils.h"
+#import "ImageData.h"
+#import "LinkData.h"
+#import "MentionParams.h"
+#import "StringExtension.h"
+#import "StyleHeaders.h"
+#import "TextListsUtils.h"
+#include "BlobStore.hpp"
+#include "DocumentSnapshot.hpp"
+#include <string>
+
+using enriched::DocumentSnapshot;
+using enriched::StyleInterval;
+
+// Payloads are shared with Android: the href for links, the CSS value for
+// alignment, "checked" for checked checkbox items and JSON objects for
+// mentions and images.
+static NSString *const CheckedPayload = @"checked";
+static NSString *const CheckedCheckboxMarker = @"EnrichedCheckbox1";
+
+static NSString *jsonString(NSDictionary *object) {
+  NSData *data = [NSJSONSerialization dataWithJSONObject:object
+                                                 options:0
+                                                   error:nil];
+  return data == nil ? nil
+                     : [[NSString alloc] initWithData:data
+                                             encoding:NSUTF8StringEncoding];
+}
+
+static NSDictionary *jsonObject(NSString *string) {
+  NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+  id object = data == nil ? nil
+                          : [NSJSONSerialization JSONObjectWithData:data
+                                                            options:0
+                                                              error:nil];
+  return [object isKindOfClass:[NSDictionary class]] ? object : nil;
+}
+
+// Like exported HTML, a snapshot stands on its own: blob store images are
+// stored as their data: URIs and go back into the store on restore.
+static NSString *exportedImageSource(NSString *src) {
+  if (src == nil || !enriched::BlobStore::isHandle([src toCppString])) {
+    return src;
+  }
+  std::string dataUri =
+      enriched::BlobStore::shared().dataUri([src toCppString]);
+  return dataUri.empty() ? src : [NSString fromCppString:dataUri];
+}
+
+static NSString *importedImageSource(id src) {
+  if (![src isKindOfClass:[NSString class]] || ![src hasPrefix:@"data:"]) {
+    return src;
+  }
+  std::string handle = enriched::BlobStore::shared().put([src toCppString]);
+  return handle.empty() ? src : [NSString fromCppString:handle];
+}
+
+static NSString *payloadForPair(StyleType type, StylePair *pair) {
+  switch (type) {
+  case Link:
+    return ((LinkData *)pair.styleValue).url;
+  case Mention: {
+    MentionParams *params = (MentionParams *)pair.styleValue;
+    return jsonString(@{
+      @"text" : params.text ?: @"",
+      @"indicator" : params.indicator ?: @"",
+      @"attributes" : jsonObject(params.attributes) ?: @{}
+    });
+  }
+  case Image: {
+    ImageData *data = (ImageData *)pair.styleValue;
+    return jsonString(@{
+      @"uri" : exportedImageSource(data.uri) ?: @"",
+      @"width" : @(data.width),
+      @"height" : @(data.height)
+    });
+  }
+  case CheckboxList: {
+    NSParagraphStyle *pStyle = (NSParagraphStyle *)pair.styleValue;
+    return [TextListsUtils textLists:pStyle.textLists
+                       containsValue:CheckedCheckboxMarker]
+               ? CheckedPayload
+               : nil;
+  }
+  case Alignment: {
+    NSParagraphStyle *pStyle = (NSParagraphStyle *)pair.styleValue;
+    NSString *marker = [TextListsUtils
+        firstTextListWithPrefix:@"EnrichedAlignment"
+                        inArray:pStyle.textLists]
+                           .markerFormat;
+    return [AlignmentUtils
+        cssValueForAlignment:[AlignmentUtils markerToAlignment:marker]];
+  }
+  default:
+    return nil;
+  }
+}
+
+@implementation DocumentSnapshotUtils
+
++ (NSString *_Nullable)snapshotOfInput:(EnrichedTextInputView *)input {
+  NSString *text = input->textView.textStorage.string;
+  NSRange fullRange = NSMakeRange(0, text.length);
+
+  DocumentSnapshot snapshot;
+  snapshot.text.resize(text.length);
+  [text getCharacters:reinterpret_cast<unichar *>(snapshot.text.data())
+                range:fullRange];
+
+  for (NSNumber *key in input->stylesDict) {
+    StyleType type = (StyleType)[key integerValue];
+    StyleBase *style = input->stylesDict[key];
+    for (StylePair *pair in [style all:fullRange]) {
+      NSRange range = [pair.rangeValue rangeValue];
+      NSString *payload = payloadForPair(type, pair);
+      // Natural alignment is the default and isn't stored
+      if (type == Alignment && payload == nil) {
+        continue;
+      }
+
+      StyleInterval run;
+      run.range = {range.location, range.length};
+      run.type = static_cast<enriched::StyleType>(type);
+      run.value = payload == nil
+                      ? DocumentSnapshot::kNoString
+                      : snapshot.internString(payload.UTF8String ?: "");
+      snapshot.runs.push_back(run);
+    }
+  }
+
+  std::string bytes = snapshot.serialize();
+  return [[NSData dataWithBytes:bytes.data() length:bytes.size()]
+      base64EncodedStringWithOptions:0];
+}
+
++ (BOOL)restoreSnapshot:(NSString *)snapshot
+                  input:(EnrichedTextInputView *)input {
+  NSData *data = [[NSData alloc] initWithBase64EncodedString:snapshot
+                                                     options:0];
+  DocumentSnapshot parsed;
+  if (data == nil ||
+      !DocumentSnapshot::deserialize(static_cast<const char *>(data.bytes),
+                                     data.length, parsed)) {
+    return NO;
+  }
+
+  NSString *text = [NSString
+      stringWithCharacters:reinterpret_cast<const unichar *>(parsed.text.data())
+                    length:parsed.text.size()];
+  NSMutableArray *processedStyles = [[NSMutableArray alloc] init];
+  NSMutableArray<AlignmentEntry *> *alignments = [[NSMutableArray alloc] init];
+
+  for (const StyleInterval &run : parsed.runs) {
+    if (run.range.end() > text.length ||
+        run.type == enriched::StyleType::None) {
+      continue;
+    }
+    StyleType type = (StyleType)run.type;
+    NSRange range = NSMakeRange(run.range.start, run.range.length);
+    NSString *payload =
+        run.value < parsed.strings.size()
+            ? [NSString stringWithUTF8String:parsed.strings[run.value].c_str()]
+            : nil;
+
+    id styleValue = nil;
+    if (type == Alignment) {
+      if (payload == nil) {
+        continue;
+      }
+      AlignmentEntry *entry = [[AlignmentEntry alloc] init];
+      entry.range = range;
+      entry.alignment = [AlignmentUtils stringToAlignment:payload];
+      [alignments addObject:entry];
+      continue;
+    } else if (type == Link) {
+      if (payload == nil) {
+        continue;
+      }
+      LinkData *linkData = [[LinkData alloc] init];
+      linkData.text = [text substringWithRange:range];
+      linkData.url = payload;
+      linkData.isManual = YES;
+      styleValue = linkData;
+    } else if (type == Mention) {
+      NSDictionary *mention = jsonObject(payload);
+      if (mention == nil) {
+        continue;
+      }
+      MentionParams *params = [[MentionParams alloc] init];
+      params.text = mention[@"text"];
+      params.indicator = mention[@"indicator"];
+      params.attributes = jsonString(mention[@"attributes"] ?: @{});
+      styleValue = params;
+    } else if (type == Image) {
+      NSDictionary *image = jsonObject(payload);
+      if (image == nil) {
+        continue;
+      }
+      ImageData *imageData = [[ImageData alloc] init];
+      imageData.uri = importedImageSource(image[@"uri"]);
+      imageData.width = [image[@"width"] doubleValue];
+      imageData.height = [image[@"height"] doubleValue];
+      styleValue = imageData;
+    } else if (type == CheckboxList &&
+               [payload isEqualToString:CheckedPayload]) {
+      // checked state keyed by paragraph start, like HtmlParser does
+      NSMutableDictionary *checkboxStates = [[NSMutableDictionary alloc] init];
+      NSUInteger location = range.location;
+      while (location < NSMaxRange(range)) {
+        NSRange paragraph =
+            [text paragraphRangeForRange:NSMakeRange(location, 0)];
+        checkboxStates[@(paragraph.location)] = @YES;
+        location = NSMaxRange(paragraph);
+      }
+      styleValue = checkboxStates;
+    }
+
+    StylePair *pair = [[StylePair alloc] init];
+    pair.rangeValue = [NSValue valueWithRange:range];
+    pair.styleValue = styleValue;
+    [processedStyles addObject:@[ @(type), pair ]];
+  }
+
+  // Paragraph styles go first, in the order HtmlParser emits tags
+  [processedStyles sortWithOptions:NSSortStable
+                   usingComparator:^NSComparisonResult(NSArray *a,
+                                                       NSArray *b) {
+                     return [(NSNumber *)a[0] compare:(NSNumber *)b[0]];
+                   }];
+
+  [input->parser replaceWholeFromText:text
+                      processedStyles:processedStyles
+                           alignments:alignments];
+  return YES;
+}
+
+@end
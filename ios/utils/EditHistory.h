@@ -0,0 +1,28 @@
+#pragma once
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Undo/redo of the input on top of cpp/document/OperationLog. Edits are
+// recorded as the text storage processes them; everything recorded while
+// handling one UI event becomes one undo step.
+@interface EditHistory : NSObject
+
+- (instancetype)initWithTextView:(UITextView *)textView;
+
+// Called at the end of the text storage delegate's didProcessEditing:.
+- (void)textStorage:(NSTextStorage *)textStorage
+    didProcessEditing:(NSTextStorageEditActions)editedMask
+                range:(NSRange)editedRange
+       changeInLength:(NSInteger)delta;
+
+// Both return NO when there was nothing to undo or redo.
+- (BOOL)undo;
+- (BOOL)redo;
+
+// Forgets the history, e.g. when a new value is set.
+- (void)clear;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,270 @@
+#import "EditHistory.h"
+#import <QuartzCore/QuartzCore.h>
+#include "OperationLog.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using enriched::EditOperation;
+using enriched::OperationLog;
+using enriched::StyleInterval;
+using enriched::StyleType;
+
+// NSDictionary hashes by its count, which most attribute dictionaries share.
+static NSUInteger attributesHash(NSDictionary *attributes) {
+  NSUInteger hash = attributes.count;
+  for (id key in attributes) {
+    hash ^= [key hash] * 31 + [attributes[key] hash];
+  }
+  return hash;
+}
+
+static std::u16string toU16String(NSString *string) {
+  std::u16string result(string.length, u'\0');
+  [string getCharacters:reinterpret_cast<unichar *>(result.data())
+                  range:NSMakeRange(0, string.length)];
+  return result;
+}
+
+static NSString *toNSString(const std::u16string &string) {
+  return [NSString
+      stringWithCharacters:reinterpret_cast<const unichar *>(string.data())
+                    length:string.size()];
+}
+
+// Whether every operation of the step fits the text as the ones before it
+// leave it.
+static BOOL stepFits(const std::vector<EditOperation> &operations,
+                     size_t length) {
+  for (const EditOperation &operation : operations) {
+    size_t removedEnd = operation.range.start + operation.removedText.size();
+    if (operation.range.end() > length || removedEnd > length) {
+      return NO;
+    }
+    if (operation.kind == EditOperation::Kind::ReplaceText) {
+      length = length - operation.removedText.size() +
+               operation.insertedText.size();
+    }
+  }
+  return YES;
+}
+
+@implementation EditHistory {
+  __weak UITextView *_textView;
+  OperationLog _log;
+  // The text storage as of the last processed edit, so the removed text and
+  // attributes are still known once an edit was made.
+  NSMutableAttributedString *_shadow;
+  // Attribute runs are recorded as StyleIntervals whose value indexes these,
+  // so undo brings back exactly the attributes the text had. Dropped once no
+  // kept step refers to them; freed slots hold NSNull and are reused.
+  NSMutableArray *_attributes;
+  std::unordered_multimap<NSUInteger, uint32_t> _attributeValues;
+  std::vector<uint32_t> _freeAttributeValues;
+  BOOL _isGroupOpen;
+  BOOL _isApplying;
+}
+
+- (instancetype)initWithTextView:(UITextView *)textView {
+  if (self = [super init]) {
+    _textView = textView;
+    _shadow = [textView.textStorage mutableCopy];
+    _attributes = [[NSMutableArray alloc] init];
+  }
+  return self;
+}
+
+- (void)textStorage:(NSTextStorage *)textStorage
+    didProcessEditing:(NSTextStorageEditActions)editedMask
+                range:(NSRange)editedRange
+       changeInLength:(NSInteger)delta {
+  NSRange previousRange =
+      NSMakeRange(editedRange.location, editedRange.length - delta);
+  if (NSMaxRange(previousRange) > _shadow.length ||
+      _shadow.length + delta != textStorage.length) {
+    // Text changed before the delegate was attached; start over from here
+    [self clear];
+    return;
+  }
+
+  if (!_isApplying) {
+    [self openGroup];
+    if ((editedMask & NSTextStorageEditedCharacters) != 0) {
+      _log.recordReplace(
+          editedRange.location,
+          toU16String([_shadow.string substringWithRange:previousRange]),
+          toU16String([textStorage.string substringWithRange:editedRange]),
+          static_cast<uint64_t>(CACurrentMediaTime() * 1000),
+          [self runsOf:_shadow inRange:previousRange],
+          [self runsOf:textStorage inRange:editedRange]);
+    } else {
+      _log.recordStyles({editedRange.location, editedRange.length},
+                        [self runsOf:_shadow inRange:editedRange],
+                        [self runsOf:textStorage inRange:editedRange]);
+    }
+    [self dropReleasedAttributes];
+  }
+
+  NSAttributedString *edited =
+      [textStorage attributedSubstringFromRange:editedRange];
+  [_shadow replaceCharactersInRange:previousRange withAttributedString:edited];
+}
+
+- (BOOL)undo {
+  [self closeGroup];
+  if (!_log.canUndo()) {
+    return NO;
+  }
+  [self apply:_log.undo()];
+  return YES;
+}
+
+- (BOOL)redo {
+  [self closeGroup];
+  if (!_log.canRedo()) {
+    return NO;
+  }
+  [self apply:_log.redo()];
+  return YES;
+}
+
+- (void)clear {
+  [self closeGroup];
+  _log.clear();
+  _log.takeReleasedValues();
+  [_attributes removeAllObjects];
+  _attributeValues.clear();
+  _freeAttributeValues.clear();
+  _shadow = [_textView.textStorage mutableCopy]
+                ?: [[NSMutableAttributedString alloc] init];
+}
+
+// MARK: - Private
+
+- (void)openGroup {
+  if (_isGroupOpen) {
+    return;
+  }
+  _isGroupOpen = YES;
+  _log.beginGroup();
+  __weak EditHistory *weakSelf = self;
+  dispatch_async(dispatch_get_main_queue(), ^{
+    [weakSelf closeGroup];
+  });
+}
+
+- (void)closeGroup {
+  if (!_isGroupOpen) {
+    return;
+  }
+  _isGroupOpen = NO;
+  _log.endGroup();
+}
+
+- (uint32_t)valueForAttributes:(NSDictionary *)attributes {
+  NSUInteger hash = attributesHash(attributes);
+  auto candidates = _attributeValues.equal_range(hash);
+  for (auto it = candidates.first; it != candidates.second; ++it) {
+    if ([_attributes[it->second] isEqualToDictionary:attributes]) {
+      return it->second;
+    }
+  }
+  uint32_t value;
+  if (_freeAttributeValues.empty()) {
+    value = static_cast<uint32_t>(_attributes.count);
+    [_attributes addObject:[attributes copy]];
+  } else {
+    value = _freeAttributeValues.back();
+    _freeAttributeValues.pop_back();
+    _attributes[value] = [attributes copy];
+  }
+  _attributeValues.emplace(hash, value);
+  // A rough size of the dictionary, which counts toward the history's limit
+  _log.setValueSize(value, 64 + attributes.count * 4 * sizeof(void *));
+  return value;
+}
+
+- (void)dropReleasedAttributes {
+  for (uint32_t value : _log.takeReleasedValues()) {
+    if (value >= _attributes.count || _attributes[value] == [NSNull null]) {
+      continue;
+    }
+    auto candidates = _attributeValues.equal_range(
+        attributesHash(_attributes[value]));
+    for (auto it = candidates.first; it != candidates.second; ++it) {
+      if (it->second == value) {
+        _attributeValues.erase(it);
+        break;
+      }
+    }
+    _attributes[value] = [NSNull null];
+    _freeAttributeValues.push_back(value);
+  }
+}
+
+- (std::vector<StyleInterval>)runsOf:(NSAttributedString *)string
+                             inRange:(NSRange)range {
+  std::vector<StyleInterval> runs;
+  NSUInteger location = range.location;
+  while (location < NSMaxRange(range)) {
+    NSRange runRange;
+    NSDictionary *attributes = [string attributesAtIndex:location
+                                          effectiveRange:&runRange];
+    NSUInteger end = MIN(NSMaxRange(runRange), NSMaxRange(range));
+    runs.push_back({{location, end - location},
+                    StyleType::None,
+                    [self valueForAttributes:attributes]});
+    location = end;
+  }
+  return runs;
+}
+
+- (void)apply:(const std::vector<EditOperation> &)operations {
+  NSTextStorage *textStorage = _textView.textStorage;
+  NSRange selection = _textView.selectedRange;
+
+  if (!stepFits(operations, textStorage.length)) {
+    // The history no longer matches the text; start over from here
+    [self clear];
+    return;
+  }
+
+  _isApplying = YES;
+  [textStorage beginEditing];
+  for (const EditOperation &operation : operations) {
+    NSRange range =
+        NSMakeRange(operation.range.start, operation.range.length);
+    if (operation.kind == EditOperation::Kind::ReplaceText) {
+      NSString *insertedText = toNSString(operation.insertedText);
+      [textStorage
+          replaceCharactersInRange:NSMakeRange(operation.range.start,
+                                               operation.removedText.size())
+                        withString:insertedText];
+      range = NSMakeRange(operation.range.start, insertedText.length);
+      selection = NSMakeRange(NSMaxRange(range), 0);
+    } else if (operation.kind == EditOperation::Kind::ReplaceStyles) {
+      selection = range;
+    } else {
+      continue;
+    }
+
+    for (const StyleInterval &run : operation.spans) {
+      if (run.value < _attributes.count &&
+          _attributes[run.value] != [NSNull null] &&
+          run.range.end() <= NSMaxRange(range)) {
+        [textStorage setAttributes:_attributes[run.value]
+                             range:NSMakeRange(run.range.start,
+                                               run.range.length)];
+      }
+    }
+  }
+  [textStorage endEditing];
+  _isApplying = NO;
+
+  _textView.selectedRange = NSMakeRange(
+      MIN(selection.location, textStorage.length),
+      MIN(selection.length,
+          textStorage.length - MIN(selection.location, textStorage.length)));
+}
+
+@end
@@ -28,7 +28,7 @@
 
   // find a non-newline range of the paragraph
   NSRange paragraphRange =
-      [typedInput->textView.textStorage.string paragraphRangeForRange:range];
+      [typedInput paragraphRangeForRange:range];
 
   NSArray *paragraphs = [RangeUtils getNonNewlineRangesIn:typedInput->textView
                                                     range:paragraphRange];
@@ -141,8 +141,8 @@
     return NO;
   }
 
-  NSRange leftRange = [typedInput->textView.textStorage.string
-      paragraphRangeForRange:NSMakeRange(range.location, 0)];
+  NSRange leftRange =
+      [typedInput paragraphRangeForRange:NSMakeRange(range.location, 0)];
 
   StyleBase *leftParagraphStyle = nullptr;
   for (NSNumber *key in typedInput->stylesDict) {
@@ -162,24 +162,21 @@
     return NO;
   }
 
-  NSRange rightRange = [typedInput->textView.textStorage.string
-      paragraphRangeForRange:NSMakeRange(rightRangeStart, 1)];
+  NSRange rightRange =
+      [typedInput paragraphRangeForRange:NSMakeRange(rightRangeStart, 1)];
 
   StyleType type = [[leftParagraphStyle class] getType];
 
-  NSArray *conflictingStyles = [StyleUtils
-      getPresentStyleTypesFrom:typedInput->conflictingStyles[@(type)]
-                         range:rightRange
-                       forHost:typedInput];
-  NSArray *blockingStyles =
-      [StyleUtils getPresentStyleTypesFrom:typedInput->blockingStyles[@(type)]
-                                     range:rightRange
-                                   forHost:typedInput];
-  NSArray *allToBeRemoved =
-      [conflictingStyles arrayByAddingObjectsFromArray:blockingStyles];
+  const enriched::StyleRules &rules = typedInput->styleRules;
+  enriched::StyleMask allToBeRemoved =
+      [StyleUtils presentStyles:rules.conflicts(enrichedStyleType(type)) |
+                                rules.blocks(enrichedStyleType(type))
+                          range:rightRange
+                        forHost:typedInput];
 
-  for (NSNumber *style in allToBeRemoved) {
-    StyleBase *styleToRemove = typedInput->stylesDict[style];
+  for (; allToBeRemoved != 0; allToBeRemoved &= allToBeRemoved - 1) {
+    StyleType styleType = (StyleType)enriched::firstStyle(allToBeRemoved);
+    StyleBase *styleToRemove = typedInput->stylesDict[@(styleType)];
 
     // for ranges, we need to remove each occurence
     NSArray<StylePair *> *allOccurences = [styleToRemove all:rightRange];
@@ -226,7 +223,7 @@
   }
 
   NSRange leftParagraphRange =
-      [storageString paragraphRangeForRange:NSMakeRange(range.location, 0)];
+      [typedInput paragraphRangeForRange:NSMakeRange(range.location, 0)];
   BOOL isLeftLineEmpty = [self isParagraphEmpty:leftParagraphRange
                                        inString:storageString];
 
@@ -235,7 +232,7 @@
 
   if (rightRangeStart < storageString.length) {
     NSRange rightParagraphRange =
-        [storageString paragraphRangeForRange:NSMakeRange(rightRangeStart, 0)];
+        [typedInput paragraphRangeForRange:NSMakeRange(rightRangeStart, 0)];
     isRightLineEmpty = [self isParagraphEmpty:rightParagraphRange
                                      inString:storageString];
   }
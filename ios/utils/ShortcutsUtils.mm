@@ -3,6 +3,30 @@
 #import "StyleBase.h"
 #import "StyleUtils.h"
 #import "TextInsertionUtils.h"
+#import <objc/runtime.h>
+#include "ShortcutEngine.hpp"
+#include <string>
+#include <vector>
+
+/// The engine compiled from one `textShortcuts` array, attached to that
+/// array so it is rebuilt only when the prop changes.
+@interface ShortcutEngineBox : NSObject {
+@public
+  enriched::ShortcutEngine engine;
+}
+@end
+
+@implementation ShortcutEngineBox
+@end
+
+static void const *kShortcutEngineKey = &kShortcutEngineKey;
+
+static std::u16string toUtf16(NSString *string) {
+  std::u16string out(string.length, u'\0');
+  [string getCharacters:reinterpret_cast<unichar *>(out.data())
+                  range:NSMakeRange(0, string.length)];
+  return out;
+}
 
 typedef struct {
   EnrichedTextInputView *input;
@@ -12,18 +36,6 @@ typedef struct {
   NSString *replacementText;
 } ShortcutsTextContext;
 
-typedef struct {
-  ShortcutsTextContext text;
-  NSArray<NSDictionary *> *inlineShortcuts;
-} ShortcutsInlineContext;
-
-typedef struct {
-  NSString *trigger;
-  StyleType styleType;
-  NSInteger delimStart;
-  NSInteger delimPrefixLen;
-} ShortcutsTriggerMatch;
-
 typedef struct {
   NSRange finalContentRange;
   NSRange closeDeleteRange;
@@ -65,21 +77,6 @@ typedef struct {
   return styleType ? (StyleType)[styleType integerValue] : None;
 }
 
-+ (BOOL)isInlineShortcutStyleName:(NSString *)name
-                            input:(EnrichedTextInputView *)input {
-  StyleType type = [self styleTypeForShortcutName:name];
-  if (type == None) {
-    return NO;
-  }
-
-  StyleBase *style = input->stylesDict[@(type)];
-  if (style == nil) {
-    return NO;
-  }
-
-  return ![style isParagraph];
-}
-
 + (BOOL)anyTextShortcutsInInput:(EnrichedTextInputView *)input {
   return input != nullptr && input->textShortcuts != nil &&
          input->textShortcuts.count > 0;
@@ -99,127 +96,67 @@ typedef struct {
   };
 }
 
-+ (ShortcutsInlineContext)
-    inlineContextWithChangeRange:(NSRange)changeRange
-                 replacementText:(NSString *)replacementText
-                           input:(EnrichedTextInputView *)input {
-  return (ShortcutsInlineContext){
-      .text = [self textContextWithChangeRange:changeRange
-                               replacementText:replacementText
-                                         input:input],
-      .inlineShortcuts = [self inlineShortcutsFrom:input->textShortcuts
-                                             input:input],
-  };
-}
-
-+ (NSArray<NSDictionary *> *)
-    inlineShortcutsFrom:(NSArray<NSDictionary *> *)textShortcuts
-                  input:(EnrichedTextInputView *)input {
-  NSMutableArray<NSDictionary *> *inlineShortcuts = [NSMutableArray array];
-  for (NSDictionary *shortcut in textShortcuts) {
-    if ([self isInlineShortcutStyleName:shortcut[@"style"] input:input]) {
-      [inlineShortcuts addObject:shortcut];
++ (const enriched::ShortcutEngine &)shortcutEngineForInput:
+    (EnrichedTextInputView *)input {
+  NSArray<NSDictionary *> *shortcuts = input->textShortcuts;
+  ShortcutEngineBox *box =
+      objc_getAssociatedObject(shortcuts, kShortcutEngineKey);
+  if (box == nil) {
+    std::vector<enriched::TextShortcut> config;
+    config.reserve(shortcuts.count);
+    for (NSDictionary *shortcut in shortcuts) {
+      NSString *style = shortcut[@"style"];
+      config.push_back(
+          {toUtf16(shortcut[@"trigger"]), style.UTF8String ?: ""});
     }
+    box = [ShortcutEngineBox new];
+    box->engine.reset(config);
+    objc_setAssociatedObject(shortcuts, kShortcutEngineKey, box,
+                             OBJC_ASSOCIATION_RETAIN_NONATOMIC);
   }
-  [inlineShortcuts sortUsingComparator:^NSComparisonResult(NSDictionary *a,
-                                                           NSDictionary *b) {
-    NSUInteger lenA = [a[@"trigger"] length];
-    NSUInteger lenB = [b[@"trigger"] length];
-    if (lenA > lenB) {
-      return NSOrderedAscending;
-    }
-    if (lenA < lenB) {
-      return NSOrderedDescending;
-    }
-    return NSOrderedSame;
-  }];
-  return inlineShortcuts;
+  return box->engine;
 }
 
-/// When [requiredDelimStart] is NSNotFound, the trigger may appear anywhere in
-/// the text. Otherwise the matched delimiter must start at that index
-/// (paragraph shortcuts at paragraph start).
-+ (BOOL)isCompletingTrigger:(NSString *)trigger
-                    context:(const ShortcutsTextContext *)context
-         requiredDelimStart:(NSInteger)requiredDelimStart
-                      match:(ShortcutsTriggerMatch *)outMatch {
-  if (trigger.length == 0) {
-    return NO;
-  }
-
-  NSString *lastTriggerChar = [trigger substringFromIndex:trigger.length - 1];
-  if (![context->replacementText isEqualToString:lastTriggerChar]) {
-    return NO;
-  }
-
-  NSInteger delimPrefixLen = (NSInteger)trigger.length - 1;
-  if (delimPrefixLen > 0) {
-    if (context->changeRange.location < delimPrefixLen) {
-      return NO;
-    }
-    NSString *prefix = [trigger substringToIndex:delimPrefixLen];
-    NSString *beforeCursor = [context->fullText
-        substringWithRange:NSMakeRange(context->changeRange.location -
-                                           delimPrefixLen,
-                                       delimPrefixLen)];
-    if (![beforeCursor isEqualToString:prefix]) {
-      return NO;
-    }
-  }
-
-  NSInteger delimStart = context->changeRange.location - delimPrefixLen;
-  if (requiredDelimStart != NSNotFound && delimStart != requiredDelimStart) {
+/// The paragraph up to the cursor with the pending insertion applied: the
+/// engine expects triggers to end at the end of the text it is given.
+/// Shortcuts only complete on a single typed character.
++ (BOOL)paragraphText:(std::u16string *)outText
+          withContext:(const ShortcutsTextContext *)context {
+  if (context->replacementText.length != 1 ||
+      context->changeRange.location < context->paragraphRange.location) {
     return NO;
   }
-
-  if (outMatch != nullptr) {
-    outMatch->trigger = trigger;
-    outMatch->delimStart = delimStart;
-    outMatch->delimPrefixLen = delimPrefixLen;
-  }
+  NSRange prefixRange = NSMakeRange(
+      context->paragraphRange.location,
+      context->changeRange.location - context->paragraphRange.location);
+  *outText = toUtf16([context->fullText substringWithRange:prefixRange]);
+  outText->push_back([context->replacementText characterAtIndex:0]);
   return YES;
 }
 
-/// Delimiter at [delimStart] is part of a longer inline trigger (e.g. `*`
-/// inside `**`).
-+ (BOOL)isDelimiterPartOfLongerInlineTrigger:(NSString *)trigger
-                                  delimStart:(NSInteger)delimStart
-                                     context:(const ShortcutsInlineContext *)
-                                                 context {
-  NSInteger delimEnd = delimStart + trigger.length;
-  NSString *fullText = context->text.fullText;
-
-  for (NSDictionary *shortcut in context->inlineShortcuts) {
-    NSString *longerTrigger = shortcut[@"trigger"];
-    if (longerTrigger.length <= trigger.length) {
-      continue;
-    }
-    if (![longerTrigger hasSuffix:trigger]) {
-      continue;
-    }
-
-    NSInteger longerStart = delimEnd - longerTrigger.length;
-    if (longerStart < 0 ||
-        longerStart + longerTrigger.length > fullText.length) {
-      continue;
-    }
+/// Engine ranges are relative to the paragraph and include the character
+/// being typed, which isn't in the text storage yet.
++ (NSRange)storageRangeFor:(enriched::TextRange)range
+                   context:(const ShortcutsTextContext *)context {
+  NSUInteger start = context->paragraphRange.location + range.start;
+  NSUInteger storageEnd = context->changeRange.location;
+  NSUInteger end = MIN(start + range.length, storageEnd);
+  return NSMakeRange(start, end > start ? end - start : 0);
+}
 
-    NSRange longerRange = NSMakeRange(longerStart, longerTrigger.length);
-    if ([[fullText substringWithRange:longerRange]
-            isEqualToString:longerTrigger]) {
-      return YES;
-    }
-  }
-  return NO;
++ (StyleType)styleTypeForMatch:(const enriched::ShortcutMatch &)match
+                         input:(EnrichedTextInputView *)input {
+  NSDictionary *shortcut = input->textShortcuts[match.shortcut];
+  return [self styleTypeForShortcutName:shortcut[@"style"]];
 }
 
 /// Removes delimiters (close first, then open), then applies [style] on
 /// [contentRange].
-+ (void)applyInlineShortcutWithMatch:(const ShortcutsTriggerMatch *)match
-                             context:(const ShortcutsInlineContext *)context
++ (void)applyInlineShortcutWithStyle:(StyleType)type
+                             context:(const ShortcutsTextContext *)context
                               ranges:
                                   (const ShortcutsInlineApplyRanges *)ranges {
-  EnrichedTextInputView *input = context->text.input;
+  EnrichedTextInputView *input = context->input;
   input->blockEmitting = YES;
 
   if (ranges->closeDeleteRange.length > 0) {
@@ -240,7 +177,7 @@ typedef struct {
 
   input->blockEmitting = NO;
 
-  StyleBase *style = input->stylesDict[@(match->styleType)];
+  StyleBase *style = input->stylesDict[@(type)];
   if (style == nil) {
     return;
   }
@@ -251,67 +188,6 @@ typedef struct {
   [style removeTyping];
 }
 
-+ (BOOL)applyInlineShortcutWithMatch:(const ShortcutsTriggerMatch *)match
-                             context:(const ShortcutsInlineContext *)context
-                        contentRange:(NSRange)contentRange
-                              ranges:
-                                  (const ShortcutsInlineApplyRanges *)ranges {
-  if (![StyleUtils handleStyleBlocksAndConflicts:match->styleType
-                                           range:contentRange
-                                         forHost:context->text.input]) {
-    return NO;
-  }
-
-  [self applyInlineShortcutWithMatch:match context:context ranges:ranges];
-  return YES;
-}
-
-/// Closing delimiter just completed: find opening trigger before content.
-+ (BOOL)tryInlineShortcutClosingFirst:(const ShortcutsTriggerMatch *)match
-                              context:(const ShortcutsInlineContext *)context {
-  const ShortcutsTextContext *text = &context->text;
-  NSInteger searchStart = text->paragraphRange.location;
-  NSInteger searchLength = match->delimStart - searchStart;
-  if (searchLength <= 0) {
-    return NO;
-  }
-
-  NSRange openRange =
-      [text->fullText rangeOfString:match->trigger
-                            options:NSBackwardsSearch
-                              range:NSMakeRange(searchStart, searchLength)];
-  if (openRange.location == NSNotFound) {
-    return NO;
-  }
-
-  if ([self isDelimiterPartOfLongerInlineTrigger:match->trigger
-                                      delimStart:openRange.location
-                                         context:context]) {
-    return NO;
-  }
-
-  NSInteger contentStart = openRange.location + match->trigger.length;
-  NSInteger contentEnd = match->delimStart;
-  if (contentEnd <= contentStart) {
-    return NO;
-  }
-
-  NSInteger finalContentEnd = match->delimStart - match->trigger.length;
-  ShortcutsInlineApplyRanges ranges = {
-      .finalContentRange =
-          NSMakeRange(openRange.location, finalContentEnd - openRange.location),
-      .closeDeleteRange = NSMakeRange(match->delimStart, match->delimPrefixLen),
-      .openDeleteRange = NSMakeRange(openRange.location, match->trigger.length),
-  };
-
-  return
-      [self applyInlineShortcutWithMatch:match
-                                 context:context
-                            contentRange:NSMakeRange(contentStart,
-                                                     contentEnd - contentStart)
-                                  ranges:&ranges];
-}
-
 /// Paragraph already has a paragraph-level style (list, quote, heading, …).
 /// Alignment is ignored.
 + (BOOL)paragraphHasActiveParagraphStyleInRange:(NSRange)paragraphRange
@@ -333,8 +209,9 @@ typedef struct {
 ///
 ///  1. Skip if no shortcuts configured, or the paragraph already has an active
 ///     paragraph style — triggers only apply to plain paragraphs.
-///  2. Find a paragraph shortcut whose trigger is anchored to the paragraph
-///     start. Skip if the resolved style is blocked by another active style.
+///  2. Ask the shortcut engine for paragraph shortcuts whose trigger spans
+///     from the paragraph start to the cursor. Skip if the resolved style is
+///     blocked by another active style.
 ///  3. Save the current text alignment.
 ///  4. Suppress events, delete the trigger text, unsuppress.
 ///  5. Remove styles from the range that conflict with the new style (e.g.
@@ -361,26 +238,15 @@ typedef struct {
     return NO;
   }
 
-  for (NSDictionary *shortcut in input->textShortcuts) {
-    if ([self isInlineShortcutStyleName:shortcut[@"style"] input:input]) {
-      continue;
-    }
-
-    NSString *trigger = shortcut[@"trigger"];
-    NSString *styleName = shortcut[@"style"];
-    if (trigger.length == 0 || styleName.length == 0) {
-      continue;
-    }
-
-    ShortcutsTriggerMatch match = {};
-    if (![self isCompletingTrigger:trigger
-                           context:&context
-                requiredDelimStart:context.paragraphRange.location
-                             match:&match]) {
-      continue;
-    }
+  std::u16string paragraph;
+  if (![self paragraphText:&paragraph withContext:&context]) {
+    return NO;
+  }
 
-    StyleType type = [self styleTypeForShortcutName:styleName];
+  const enriched::ShortcutEngine &engine = [self shortcutEngineForInput:input];
+  for (const enriched::ShortcutMatch &match :
+       engine.paragraphMatches(paragraph.data(), paragraph.size(), 0)) {
+    StyleType type = [self styleTypeForMatch:match input:input];
     if (type == None) {
       continue;
     }
@@ -396,7 +262,8 @@ typedef struct {
     NSTextAlignment savedAlignment =
         currentParaStyle ? currentParaStyle.alignment : NSTextAlignmentNatural;
 
-    NSRange triggerRange = NSMakeRange(match.delimStart, match.delimPrefixLen);
+    NSRange triggerRange = [self storageRangeFor:match.closeDelete
+                                         context:&context];
 
     input->blockEmitting = YES;
     [TextInsertionUtils replaceText:@""
@@ -432,16 +299,15 @@ typedef struct {
 /// Inline shortcuts are symmetric delimiter pairs — the same string opens and
 /// closes the style (e.g. `**`).
 ///
-///  1. Build the inline context: inline-only shortcuts sorted longest-first so
-///     `**` is never pre-empted by its shorter suffix `*`.
-///  2. Check if the just-typed character, together with the characters
-///     immediately before the cursor, completes a closing delimiter.
-///  3. Search backwards for a matching opening delimiter. Reject if it is part
-///     of a longer trigger, or if there is no content between the pair.
-///  4. Check style blocks/conflicts; skip if the style cannot be applied.
-///  5. Suppress events, delete the closing-delimiter prefix then the opening
+///  1. Ask the shortcut engine for inline shortcuts closed by the typed
+///     character, longest trigger first so `**` is never pre-empted by its
+///     shorter suffix `*`. The engine finds the last opening delimiter in the
+///     paragraph and rejects one that is part of a longer trigger or has no
+///     content after it.
+///  2. Check style blocks/conflicts; skip if the style cannot be applied.
+///  3. Suppress events, delete the closing-delimiter prefix then the opening
 ///     delimiter (close first so the open's earlier index stays valid).
-///  6. Apply the style to the content range, move the cursor to its end, and
+///  4. Apply the style to the content range, move the cursor to its end, and
 ///     clear the typing style.
 + (BOOL)tryHandlingInlineShortcutsInRange:(NSRange)range
                           replacementText:(NSString *)text
@@ -450,34 +316,41 @@ typedef struct {
     return NO;
   }
 
-  ShortcutsInlineContext context = [self inlineContextWithChangeRange:range
-                                                      replacementText:text
-                                                                input:input];
+  ShortcutsTextContext context = [self textContextWithChangeRange:range
+                                                  replacementText:text
+                                                            input:input];
 
-  for (NSDictionary *shortcut in context.inlineShortcuts) {
-    NSString *trigger = shortcut[@"trigger"];
-    NSString *styleName = shortcut[@"style"];
-    if (trigger.length == 0 || styleName.length == 0) {
-      continue;
-    }
+  std::u16string paragraph;
+  if (![self paragraphText:&paragraph withContext:&context]) {
+    return NO;
+  }
 
-    ShortcutsTriggerMatch match = {};
-    if (![self isCompletingTrigger:trigger
-                           context:&context.text
-                requiredDelimStart:NSNotFound
-                             match:&match]) {
+  const enriched::ShortcutEngine &engine = [self shortcutEngineForInput:input];
+  for (const enriched::ShortcutMatch &match :
+       engine.inlineMatches(paragraph.data(), paragraph.size(), 0)) {
+    StyleType type = [self styleTypeForMatch:match input:input];
+    if (type == None) {
       continue;
     }
 
-    StyleType type = [self styleTypeForShortcutName:styleName];
-    if (type == None) {
+    NSRange contentRange = [self storageRangeFor:match.content
+                                         context:&context];
+    if (![StyleUtils handleStyleBlocksAndConflicts:type
+                                             range:contentRange
+                                           forHost:input]) {
       continue;
     }
-    match.styleType = type;
 
-    if ([self tryInlineShortcutClosingFirst:&match context:&context]) {
-      return YES;
-    }
+    ShortcutsInlineApplyRanges ranges = {
+        .finalContentRange = [self storageRangeFor:match.finalContent
+                                           context:&context],
+        .closeDeleteRange = [self storageRangeFor:match.closeDelete
+                                          context:&context],
+        .openDeleteRange = [self storageRangeFor:match.openDelete
+                                         context:&context],
+    };
+    [self applyInlineShortcutWithStyle:type context:&context ranges:&ranges];
+    return YES;
   }
 
   return NO;
@@ -1,9 +1,17 @@
 #import "EnrichedTextStyleHeaders.h"
 #import "StyleHeaders.h"
+#include "StyleRules.hpp"
+
+// StyleType mirrors enriched::StyleType value for value
+static inline enriched::StyleType enrichedStyleType(StyleType type) {
+  return static_cast<enriched::StyleType>(type);
+}
+
+static inline enriched::StyleMask enrichedStyleBit(StyleType type) {
+  return enriched::styleBit(enrichedStyleType(type));
+}
 
 @interface StyleUtils : NSObject
-+ (NSDictionary<NSNumber *, NSArray<NSNumber *> *> *)conflictMap;
-+ (NSDictionary<NSNumber *, NSArray<NSNumber *> *> *)blockingMap;
 + (NSDictionary<NSNumber *, StyleBase *> *)stylesDictForHost:
                                                (id<EnrichedViewHost>)host
                                                      isInput:(BOOL)isInput;
@@ -14,20 +22,7 @@
 + (BOOL)handleStyleBlocksAndConflicts:(StyleType)type
                                 range:(NSRange)range
                               forHost:(id<EnrichedViewHost>)host;
-+ (NSArray<NSNumber *> *)getPresentStyleTypesFrom:(NSArray<NSNumber *> *)types
-                                            range:(NSRange)range
-                                          forHost:(id<EnrichedViewHost>)host;
-+ (void)addStyleBlock:(StyleType)blocking
-                   to:(StyleType)blocked
-              forHost:(id<EnrichedViewHost>)host;
-+ (void)removeStyleBlock:(StyleType)blocking
-                    from:(StyleType)blocked
-                 forHost:(id<EnrichedViewHost>)host;
-
-+ (void)addStyleConflict:(StyleType)conflicting
-                      to:(StyleType)conflicted
-                 forHost:(id<EnrichedViewHost>)host;
-+ (void)removeStyleConflict:(StyleType)conflicting
-                       from:(StyleType)conflicted
-                    forHost:(id<EnrichedViewHost>)host;
++ (enriched::StyleMask)presentStyles:(enriched::StyleMask)types
+                               range:(NSRange)range
+                             forHost:(id<EnrichedViewHost>)host;
 @end
@@ -1,81 +1,50 @@
 #import "WordsUtils.h"
+#include "TextSegmenter.hpp"
+#include <vector>
+
+static const NSUInteger kInitialWindowRadius = 64;
 
 @implementation WordsUtils
 
+/// Words are TextSegmenter tokens: grapheme clusters between Unicode white
+/// space, so emoji and combining marks never end up split. Only a window
+/// around the range is copied out of the string; it grows until the words
+/// touching the range fit.
 + (NSArray<NSDictionary *> *)getAffectedWordsFromText:(NSString *)text
                                     modificationRange:(NSRange)range {
-  if (text.length == 0) {
+  NSUInteger length = text.length;
+  if (length == 0) {
     return [[NSArray alloc] init];
   }
+  NSUInteger rangeStart = MIN(range.location, length);
+  NSUInteger rangeEnd = MIN(rangeStart + range.length, length);
 
-  NSInteger leftIt = range.location - 1;
-  leftIt = MIN(leftIt, NSInteger(text.length - 1));
-  if (leftIt > 0) {
-    while (leftIt >= 0) {
-      unichar charAtIndex = [text characterAtIndex:leftIt];
-      if ([[NSCharacterSet whitespaceAndNewlineCharacterSet]
-              characterIsMember:charAtIndex]) {
-        leftIt += 1;
-        break;
-      }
-      leftIt -= 1;
-    }
-  }
-  leftIt = MAX(0, leftIt);
-  leftIt = MIN(NSInteger(text.length - 1), leftIt);
-
-  NSInteger rightIt = range.location + range.length;
-  if (rightIt < text.length - 1) {
-    while (rightIt <= text.length - 1) {
-      unichar charAtIndex = [text characterAtIndex:rightIt];
-      if ([[NSCharacterSet whitespaceAndNewlineCharacterSet]
-              characterIsMember:charAtIndex]) {
-        rightIt -= 1;
-        break;
-      }
-      rightIt += 1;
+  std::vector<unichar> buffer;
+  std::vector<enriched::TextRange> tokens;
+  for (NSUInteger radius = kInitialWindowRadius;; radius *= 4) {
+    NSUInteger windowStart = rangeStart > radius ? rangeStart - radius : 0;
+    NSUInteger windowEnd = MIN(length, rangeEnd + radius);
+    buffer.resize(windowEnd - windowStart);
+    [text getCharacters:buffer.data()
+                  range:NSMakeRange(windowStart, buffer.size())];
+    enriched::TextWindow window(
+        reinterpret_cast<const char16_t *>(buffer.data()), windowStart,
+        buffer.size(), length);
+    if (enriched::tokensIn(window, {rangeStart, rangeEnd - rangeStart},
+                           tokens)) {
+      break;
     }
   }
-  rightIt = MIN(NSInteger(text.length - 1), rightIt);
-
-  if (leftIt > rightIt) {
-    return [[NSArray alloc] init];
-  }
 
   NSMutableArray<NSDictionary *> *separatedWords =
       [[NSMutableArray<NSDictionary *> alloc] init];
-  NSMutableString *currentWord = [[NSMutableString alloc] init];
-  NSInteger currentRangeStart = leftIt;
-  NSInteger currentIdx = leftIt;
-
-  while (currentIdx <= rightIt) {
-    unichar charAtIndex = [text characterAtIndex:currentIdx];
-    if ([[NSCharacterSet whitespaceAndNewlineCharacterSet]
-            characterIsMember:charAtIndex]) {
-      if (currentWord.length > 0) {
-        [separatedWords addObject:@{
-          @"word" : [currentWord copy],
-          @"range" : [NSValue
-              valueWithRange:NSMakeRange(currentRangeStart, currentWord.length)]
-        }];
-        [currentWord setString:@""];
-      }
-      currentRangeStart = currentIdx + 1;
-    } else {
-      [currentWord appendFormat:@"%C", charAtIndex];
-    }
-    currentIdx += 1;
-  }
-
-  if (currentWord.length > 0) {
+  for (const enriched::TextRange &token : tokens) {
+    NSRange wordRange = NSMakeRange(token.start, token.length);
     [separatedWords addObject:@{
-      @"word" : [currentWord copy],
-      @"range" :
-          [NSValue valueWithRange:NSMakeRange(currentRangeStart,
-                                              rightIt - currentRangeStart + 1)]
+      @"word" : [text substringWithRange:wordRange],
+      @"range" : [NSValue valueWithRange:wordRange]
     }];
   }
-
   return separatedWords;
 }
 
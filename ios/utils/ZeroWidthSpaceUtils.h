@@ -11,4 +11,5 @@
 + (BOOL)handleBackspaceInRange:(NSRange)range
                replacementText:(NSString *)text
                           host:(id<EnrichedViewHost>)host;
++ (NSString *)stringByRemovingZeroWidthSpaces:(NSString *)string;
 @end
@@ -3,6 +3,8 @@
 #import "StyleHeaders.h"
 #import "TextInsertionUtils.h"
 #import "UIView+React.h"
+#include "PlainText.hpp"
+#include <vector>
 
 @implementation ZeroWidthSpaceUtils
 + (void)handleZeroWidthSpacesInHost:(id<EnrichedViewHost>)host {
@@ -307,4 +309,17 @@
                       }];
 }
 
+/// Plain text for events and the clipboard, in one native pass instead of
+/// NSString's search-and-replace.
++ (NSString *)stringByRemovingZeroWidthSpaces:(NSString *)string {
+  if ([string rangeOfString:@"\u200B"].location == NSNotFound) {
+    return [string copy];
+  }
+  std::vector<unichar> buffer(string.length);
+  [string getCharacters:buffer.data() range:NSMakeRange(0, string.length)];
+  auto *chars = reinterpret_cast<char16_t *>(buffer.data());
+  size_t length = enriched::stripPlainText(chars, buffer.size(), chars);
+  return [NSString stringWithCharacters:buffer.data() length:length];
+}
+
 @end
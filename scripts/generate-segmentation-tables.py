@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+"""
+Generates cpp/text/SegmentationTables.hpp, the Unicode property tables
+behind cpp/text/TextSegmenter, from the Unicode Character Database.
+
+Usage:
+  scripts/generate-segmentation-tables.py <ucd-dir> <unicode-version>
+
+<ucd-dir> must hold GraphemeBreakProperty.txt and WordBreakProperty.txt
+(from ucd/auxiliary), emoji-data.txt (from ucd/emoji) and
+DerivedCoreProperties.txt, e.g. an unpacked
+https://www.unicode.org/Public/<version>/ucd/UCD.zip.
+"""
+
+import os
+import re
+import sys
+
+GRAPHEME = ['Other', 'CR', 'LF', 'Control', 'Extend', 'ZWJ',
+            'Regional_Indicator', 'Prepend', 'SpacingMark', 'L', 'V', 'T',
+            'LV', 'LVT']
+WORD = ['Other', 'CR', 'LF', 'Newline', 'Extend', 'ZWJ', 'Regional_Indicator',
+        'Format', 'Katakana', 'Hebrew_Letter', 'ALetter', 'Single_Quote',
+        'Double_Quote', 'MidNumLet', 'MidLetter', 'MidNum', 'Numeric',
+        'ExtendNumLet', 'WSegSpace']
+CONJUNCT = ['None', 'Consonant', 'Extend', 'Linker']
+
+# Bit layout of a packed property value
+WORD_SHIFT = 4
+CONJUNCT_SHIFT = 9
+PICTOGRAPHIC_BIT = 1 << 11
+
+# Everything outside these ranges has default properties (asserted below),
+# so the trie only spans them: planes 0-1, then the tags and variation
+# selectors at the start of plane 14.
+RANGES = [(0x0, 0x20000), (0xE0000, 0xE1000)]
+
+LINE = re.compile(r'^([0-9A-F]+)(?:\.\.([0-9A-F]+))?\s*;\s*([^#]*?)\s*(?:#.*)?$')
+
+
+def parse(path, accept):
+    """Yields (first, last, value) for lines whose fields `accept` maps."""
+    with open(path, encoding='utf-8') as f:
+        for line in f:
+            match = LINE.match(line.strip())
+            if not match:
+                continue
+            first = int(match.group(1), 16)
+            last = int(match.group(2) or match.group(1), 16)
+            fields = [field.strip() for field in match.group(3).split(';')]
+            value = accept(fields)
+            if value is not None:
+                yield first, last, value
+
+
+def load(ucd):
+    values = [0] * 0x110000
+
+    def path(name):
+        return os.path.join(ucd, name)
+
+    def assign(rows, shift, names):
+        for first, last, value in rows:
+            code = names.index(value) << shift
+            for cp in range(first, last + 1):
+                values[cp] |= code
+
+    assign(parse(path('GraphemeBreakProperty.txt'),
+                 lambda f: f[0] if f[0] in GRAPHEME else None),
+           0, GRAPHEME)
+    assign(parse(path('WordBreakProperty.txt'),
+                 lambda f: f[0] if f[0] in WORD else None),
+           WORD_SHIFT, WORD)
+    assign(parse(path('DerivedCoreProperties.txt'),
+                 lambda f: f[1] if f[0] == 'InCB' and len(f) > 1 else None),
+           CONJUNCT_SHIFT, CONJUNCT)
+    for first, last, _ in parse(
+            path('emoji-data.txt'),
+            lambda f: True if f[0] == 'Extended_Pictographic' else None):
+        for cp in range(first, last + 1):
+            values[cp] |= PICTOGRAPHIC_BIT
+    return values
+
+
+def build_trie(values, block_size):
+    indexed = [v for lo, hi in RANGES for v in values[lo:hi]]
+    distinct = sorted(set(indexed))
+    assert len(distinct) <= 256, 'property values no longer fit in a byte'
+    codes = [distinct.index(v) for v in indexed]
+
+    blocks, block_ids, index = [], {}, []
+    for start in range(0, len(codes), block_size):
+        block = tuple(codes[start:start + block_size])
+        if block not in block_ids:
+            block_ids[block] = len(blocks)
+            blocks.append(block)
+        index.append(block_ids[block])
+    return distinct, index, blocks
+
+
+def array(ctype, name, items, per_line):
+    lines = []
+    for i in range(0, len(items), per_line):
+        lines.append('    ' + ', '.join(str(x) for x in items[i:i + per_line]) +
+                     ',')
+    return 'constexpr %s %s[%d] = {\n%s\n};\n' % (ctype, name, len(items),
+                                                 '\n'.join(lines))
+
+
+def enum(name, prefix, values):
+    items = ',\n'.join('  %s%s' % (prefix, v.replace('_', '')) for v in values)
+    return 'enum %s : uint8_t {\n%s,\n};\n' % (name, items)
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    ucd, version = sys.argv[1], sys.argv[2]
+    values = load(ucd)
+
+    covered = set()
+    for lo, hi in RANGES:
+        covered.update(range(lo, hi))
+    for cp, value in enumerate(values):
+        assert value == 0 or cp in covered, 'U+%04X is outside the trie' % cp
+
+    # Smallest total size wins
+    best = None
+    for shift in range(4, 9):
+        distinct, index, blocks = build_trie(values, 1 << shift)
+        index_width = 1 if len(blocks) <= 256 else 2
+        size = (len(distinct) * 2 + len(index) * index_width +
+                (len(blocks) << shift))
+        if best is None or size < best[0]:
+            best = (size, shift, distinct, index, blocks)
+    _, shift, distinct, index, blocks = best
+    index_type = 'uint8_t' if len(blocks) <= 256 else 'uint16_t'
+
+    out = []
+    out.append('// Generated by scripts/generate-segmentation-tables.py from '
+               'the Unicode %s\n// character database. Do not edit.\n' %
+               version)
+    out.append('#pragma once\n\n#include <cstdint>\n\n'
+               'namespace enriched {\nnamespace unicode {\n')
+    out.append('constexpr const char *kVersion = "%s";\n' % version)
+    out.append(enum('GraphemeBreak', 'kGb', GRAPHEME))
+    out.append(enum('WordBreak', 'kWb', WORD))
+    out.append(enum('ConjunctBreak', 'kInCb', CONJUNCT))
+    out.append('constexpr unsigned kWordShift = %d;\n' % WORD_SHIFT +
+               'constexpr unsigned kConjunctShift = %d;\n' % CONJUNCT_SHIFT +
+               'constexpr uint16_t kPictographicBit = 0x%x;\n' %
+               PICTOGRAPHIC_BIT)
+    out.append('// Code points [0, 0x20000) followed by [0xE0000, 0xE1000);'
+               ' everything else\n// has value 0.\n'
+               'constexpr uint32_t kPlaneSplit = 0x20000;\n'
+               'constexpr uint32_t kTagsStart = 0xE0000;\n'
+               'constexpr uint32_t kTagsEnd = 0xE1000;\n'
+               'constexpr unsigned kBlockShift = %d;\n' % shift)
+    out.append(array('uint16_t', 'kValues', distinct, 12))
+    out.append(array(index_type, 'kBlockIndex', index, 16))
+    out.append(array('uint8_t', 'kBlocks', [c for b in blocks for c in b], 16))
+    out.append('} // namespace unicode\n} // namespace enriched\n')
+
+    target = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..',
+                          'cpp', 'text', 'SegmentationTables.hpp')
+    with open(target, 'w', encoding='utf-8') as f:
+        f.write('\n'.join(out))
+
+
+if __name__ == '__main__':
+    main()
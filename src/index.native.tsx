@@ -11,6 +11,7 @@ export type {
   OnChangeSelectionEvent,
   OnKeyPressEvent,
   OnPasteImagesEvent,
+  OnPastePendingEvent,
   OnSubmitEditing,
   HtmlStyle,
   MentionStyleProperties,
@@ -32,3 +33,7 @@ export type {
   OnMentionPressEvent,
   OnLinkPressEvent,
 } from './types';
+
+// EnrichedHtml
+export { EnrichedHtml } from './native/EnrichedHtml';
+export type { HtmlStats } from './types';
@@ -10,6 +10,7 @@ export type {
   OnChangeSelectionEvent,
   OnKeyPressEvent,
   OnPasteImagesEvent,
+  OnPastePendingEvent,
   OnSubmitEditing,
   HtmlStyle,
   MentionStyleProperties,
@@ -0,0 +1,41 @@
+import { NativeModules } from 'react-native';
+import type { HtmlStats } from '../types';
+
+interface EnrichedHtmlEngine {
+  normalizeHtml(html: string): string;
+  isCanonicalHtml(html: string): boolean;
+  toPlainText(html: string): string;
+  getStats(html: string): HtmlStats;
+}
+
+declare global {
+  // Installed by the EnrichedHtml native module.
+  var __enrichedHtml: EnrichedHtmlEngine | undefined;
+}
+
+const engine = (): EnrichedHtmlEngine => {
+  if (globalThis.__enrichedHtml == null) {
+    NativeModules.EnrichedHtml?.install();
+  }
+  if (globalThis.__enrichedHtml == null) {
+    throw new Error(
+      'react-native-enriched: the native HTML engine could not be installed'
+    );
+  }
+
+  return globalThis.__enrichedHtml;
+};
+
+/**
+ * Synchronous access to the HTML engine the components use.
+ */
+export const EnrichedHtml = {
+  /** Converts external HTML into the canonical subset, '' on failure. */
+  normalizeHtml: (html: string): string => engine().normalizeHtml(html),
+  /** Whether normalizing the HTML would leave it unchanged. */
+  isCanonicalHtml: (html: string): boolean => engine().isCanonicalHtml(html),
+  /** Text as the components show it, one line per paragraph. */
+  toPlainText: (html: string): string => engine().toPlainText(html),
+  /** Counts over the normalized HTML. */
+  getStats: (html: string): HtmlStats => engine().getStats(html),
+};
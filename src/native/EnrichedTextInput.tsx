@@ -13,6 +13,7 @@ import EnrichedTextInputNativeComponent, {
   type OnMentionEvent,
   type OnMentionDetectedInternal,
   type OnRequestHtmlResultEvent,
+  type OnRequestSnapshotResultEvent,
 } from '../spec/EnrichedTextInputNativeComponent';
 import type {
   HostInstance,
@@ -88,6 +89,8 @@ export const EnrichedTextInput = ({
 
   const nextHtmlRequestId = useRef(1);
   const pendingHtmlRequests = useRef(new Map<number, HtmlRequest>());
+  const nextSnapshotRequestId = useRef(1);
+  const pendingSnapshotRequests = useRef(new Map<number, HtmlRequest>());
 
   // Store onPress callbacks in a ref so native only receives serializable data
   const contextMenuCallbacksRef = useRef<
@@ -135,11 +138,14 @@ export const EnrichedTextInput = ({
 
   useEffect(() => {
     const pendingRequests = pendingHtmlRequests.current;
+    const pendingSnapshots = pendingSnapshotRequests.current;
     return () => {
-      pendingRequests.forEach(({ reject }) => {
-        reject(new Error('Component unmounted'));
+      [pendingRequests, pendingSnapshots].forEach((requests) => {
+        requests.forEach(({ reject }) => {
+          reject(new Error('Component unmounted'));
+        });
+        requests.clear();
       });
-      pendingRequests.clear();
     };
   }, []);
 
@@ -190,6 +196,22 @@ export const EnrichedTextInput = ({
         Commands.requestHTML(nullthrows(nativeRef.current), requestId);
       });
     },
+    getSnapshot: () => {
+      return new Promise<string>((resolve, reject) => {
+        const requestId = nextSnapshotRequestId.current++;
+        pendingSnapshotRequests.current.set(requestId, { resolve, reject });
+        Commands.requestSnapshot(nullthrows(nativeRef.current), requestId);
+      });
+    },
+    setSnapshot: (snapshot: string) => {
+      Commands.setSnapshot(nullthrows(nativeRef.current), snapshot);
+    },
+    undo: () => {
+      Commands.undo(nullthrows(nativeRef.current));
+    },
+    redo: () => {
+      Commands.redo(nullthrows(nativeRef.current));
+    },
     toggleBold: () => {
       Commands.toggleBold(nullthrows(nativeRef.current));
     },
@@ -327,6 +349,22 @@ export const EnrichedTextInput = ({
     pendingHtmlRequests.current.delete(requestId);
   };
 
+  const handleRequestSnapshotResult = (
+    e: NativeSyntheticEvent<OnRequestSnapshotResultEvent>
+  ) => {
+    const { requestId, snapshot } = e.nativeEvent;
+    const pending = pendingSnapshotRequests.current.get(requestId);
+    if (!pending) return;
+
+    if (snapshot === null || typeof snapshot !== 'string') {
+      pending.reject(new Error('Failed to create snapshot'));
+    } else {
+      pending.resolve(snapshot);
+    }
+
+    pendingSnapshotRequests.current.delete(requestId);
+  };
+
   return (
     <EnrichedTextInputNativeComponent
       ref={nativeRef}
@@ -354,6 +392,7 @@ export const EnrichedTextInput = ({
       onMention={handleMentionEvent}
       onChangeSelection={onChangeSelection}
       onRequestHtmlResult={handleRequestHtmlResult}
+      onRequestSnapshotResult={handleRequestSnapshotResult}
       onInputKeyPress={onKeyPress}
       contextMenuItems={nativeContextMenuItems}
       textShortcuts={textShortcuts}
@@ -161,6 +161,11 @@ export interface OnRequestHtmlResultEvent {
   html: UnsafeMixed;
 }
 
+export interface OnRequestSnapshotResultEvent {
+  requestId: Int32;
+  snapshot: UnsafeMixed;
+}
+
 export interface OnSubmitEditing {
   text: string;
 }
@@ -303,6 +308,10 @@ export interface OnPasteImagesEvent {
   }[];
 }
 
+export interface OnPastePendingEvent {
+  isPending: boolean;
+}
+
 type Heading = {
   fontSize?: Float;
   bold?: boolean;
@@ -389,8 +398,10 @@ export interface NativeProps extends ViewProps {
   onMention?: DirectEventHandler<OnMentionEvent>;
   onChangeSelection?: DirectEventHandler<OnChangeSelectionEvent>;
   onRequestHtmlResult?: DirectEventHandler<OnRequestHtmlResultEvent>;
+  onRequestSnapshotResult?: DirectEventHandler<OnRequestSnapshotResultEvent>;
   onInputKeyPress?: DirectEventHandler<OnKeyPressEvent>;
   onPasteImages?: DirectEventHandler<OnPasteImagesEvent>;
+  onPastePending?: DirectEventHandler<OnPastePendingEvent>;
   onContextMenuItemPress?: DirectEventHandler<OnContextMenuItemPressEvent>;
   onSubmitEditing?: BubblingEventHandler<OnSubmitEditing>;
 
@@ -478,6 +489,16 @@ interface NativeCommands {
     viewRef: React.ElementRef<ComponentType>,
     requestId: Int32
   ) => void;
+  requestSnapshot: (
+    viewRef: React.ElementRef<ComponentType>,
+    requestId: Int32
+  ) => void;
+  setSnapshot: (
+    viewRef: React.ElementRef<ComponentType>,
+    snapshot: string
+  ) => void;
+  undo: (viewRef: React.ElementRef<ComponentType>) => void;
+  redo: (viewRef: React.ElementRef<ComponentType>) => void;
   setTextAlignment: (
     viewRef: React.ElementRef<ComponentType>,
     alignment: string
@@ -515,6 +536,10 @@ export const Commands: NativeCommands = codegenNativeCommands<NativeCommands>({
     'startMention',
     'addMention',
     'requestHTML',
+    'requestSnapshot',
+    'setSnapshot',
+    'undo',
+    'redo',
     'setTextAlignment',
   ],
 });
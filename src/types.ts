@@ -405,6 +405,10 @@ export interface OnPasteImagesEvent {
   }[];
 }
 
+export interface OnPastePendingEvent {
+  isPending: boolean;
+}
+
 export interface OnSubmitEditing {
   text: string;
 }
@@ -421,6 +425,10 @@ export interface EnrichedTextInputInstance extends NativeMethods {
   setValue: (value: string) => void;
   setSelection: (start: number, end: number) => void;
   getHTML: () => Promise<string>;
+  getSnapshot: () => Promise<string>;
+  setSnapshot: (snapshot: string) => void;
+  undo: () => void;
+  redo: () => void;
 
   // Text formatting commands
   toggleBold: () => void;
@@ -509,6 +517,11 @@ export interface EnrichedTextInputProps extends Omit<ViewProps, 'children'> {
    * to avoid retaining blob memory. Native uses non-blob URIs; revoke does not apply.
    */
   onPasteImages?: (e: NativeSyntheticEvent<OnPasteImagesEvent>) => void;
+  /**
+   * Called with `isPending: true` when a large pasted HTML starts normalizing in the background
+   * and with `isPending: false` once it has been inserted, has failed or was superseded.
+   */
+  onPastePending?: (e: NativeSyntheticEvent<OnPastePendingEvent>) => void;
   contextMenuItems?: ContextMenuItem[];
   textShortcuts?: TextShortcut[];
   /**
@@ -579,3 +592,12 @@ export interface OnMentionPressEvent {
   indicator: string;
   attributes: Record<string, string>;
 }
+
+export interface HtmlStats {
+  /** Length of the plain text in UTF-16 code units. */
+  characters: number;
+  paragraphs: number;
+  links: number;
+  mentions: number;
+  images: number;
+}
@@ -318,6 +318,11 @@ export const EnrichedTextInput = ({
         );
       },
       getHTML: () => Promise.resolve(normalizeHtmlFromTiptap(editor.getHTML())),
+      getSnapshot: () =>
+        Promise.reject(new Error('Snapshots are not supported on web')),
+      setSnapshot: () => {},
+      undo: () => runFocused(editor, (c) => c.undo()),
+      redo: () => runFocused(editor, (c) => c.redo()),
       toggleBold: () => runFocused(editor, (c) => c.toggleBold()),
       toggleItalic: () => runFocused(editor, (c) => c.toggleItalic()),
       toggleUnderline: () => runFocused(editor, (c) => c.toggleUnderline()),